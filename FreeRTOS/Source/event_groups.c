@@ -63,8 +63,50 @@
         #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
             uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
         #endif
+
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+            portSPINLOCK_TYPE xObjectLock; /**< Protects uxEventBits and the check-then-block of waiting tasks.  Always taken after the kernel locks. */
+        #endif
     } EventGroup_t;
 
+/*
+ * With configUSE_PER_OBJECT_LOCKS set to 1 an event group has its own
+ * spinlock.  Setting bits nobody waits for, waiting for bits that are already
+ * set and clearing bits only take that lock.  Code that moves tasks between
+ * the event and ready lists still runs with the scheduler suspended and takes
+ * the kernel critical section before the event group lock
+ * (eventENTER_CRITICAL()).  Without per object locks eventENTER_CRITICAL() is
+ * empty, as the suspended scheduler already serialises the event groups.
+ */
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        #define eventLOCK( pxEventBits, uxSavedInterruptStatus )                                 \
+    do {                                                                                          \
+        ( uxSavedInterruptStatus ) = portSET_INTERRUPT_MASK();                                    \
+        portGET_SPINLOCK( portGET_CORE_ID(), &( ( pxEventBits )->xObjectLock ) );                 \
+    } while( 0 )
+
+        #define eventUNLOCK( pxEventBits, uxSavedInterruptStatus )                               \
+    do {                                                                                          \
+        portRELEASE_SPINLOCK( portGET_CORE_ID(), &( ( pxEventBits )->xObjectLock ) );             \
+        portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );                                       \
+    } while( 0 )
+
+        #define eventENTER_CRITICAL( pxEventBits )                                                \
+    do {                                                                                          \
+        taskENTER_CRITICAL();                                                                     \
+        portGET_SPINLOCK( portGET_CORE_ID(), &( ( pxEventBits )->xObjectLock ) );                 \
+    } while( 0 )
+
+        #define eventEXIT_CRITICAL( pxEventBits )                                                 \
+    do {                                                                                          \
+        portRELEASE_SPINLOCK( portGET_CORE_ID(), &( ( pxEventBits )->xObjectLock ) );             \
+        taskEXIT_CRITICAL();                                                                      \
+    } while( 0 )
+    #else
+        #define eventENTER_CRITICAL( pxEventBits )
+        #define eventEXIT_CRITICAL( pxEventBits )
+    #endif /* configUSE_PER_OBJECT_LOCKS */
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -79,6 +121,30 @@
                                             const EventBits_t uxBitsToWaitFor,
                                             const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+
+/*
+ * Set bits while holding only the event group lock.  Only succeeds if no task
+ * is waiting for bits, so no task has to be unblocked.  The resulting event
+ * bits are written to *puxReturnBits.
+ */
+        static BaseType_t prvTrySetBitsWithObjectLock( EventGroup_t * pxEventBits,
+                                                       const EventBits_t uxBitsToSet,
+                                                       EventBits_t * puxReturnBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Test the wait condition while holding only the event group lock, clearing
+ * the bits if it is met and xClearOnExit is set.  Returns pdTRUE if the wait
+ * condition was met, in which case the event bits before any clearing are
+ * written to *puxReturnBits.
+ */
+        static BaseType_t prvTryWaitBitsWithObjectLock( EventGroup_t * pxEventBits,
+                                                        const EventBits_t uxBitsToWaitFor,
+                                                        const BaseType_t xClearOnExit,
+                                                        const BaseType_t xWaitForAllBits,
+                                                        EventBits_t * puxReturnBits ) PRIVILEGED_FUNCTION;
+    #endif /* configUSE_PER_OBJECT_LOCKS */
+
 /*-----------------------------------------------------------*/
 
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -113,6 +179,12 @@
                 pxEventBits->uxEventBits = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                {
+                    portINIT_SPINLOCK( &( pxEventBits->xObjectLock ) );
+                }
+                #endif
+
                 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
                 {
                     /* Both static and dynamic allocation can be used, so note that
@@ -158,6 +230,12 @@
                 pxEventBits->uxEventBits = 0;
                 vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
 
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                {
+                    portINIT_SPINLOCK( &( pxEventBits->xObjectLock ) );
+                }
+                #endif
+
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
                     /* Both static and dynamic allocation can be used, so note this
@@ -208,6 +286,18 @@
 
             ( void ) xEventGroupSetBits( xEventGroup, uxBitsToSet );
 
+            eventENTER_CRITICAL( pxEventBits );
+
+            #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+            {
+                /* Bits may have been set by other cores without suspending the
+                 * scheduler since uxOriginalBitValue was read.  Include them,
+                 * otherwise this task could block on bits that are already
+                 * set. */
+                uxOriginalBitValue |= pxEventBits->uxEventBits;
+            }
+            #endif
+
             if( ( ( uxOriginalBitValue | uxBitsToSet ) & uxBitsToWaitFor ) == uxBitsToWaitFor )
             {
                 /* All the rendezvous bits are now set - no need to block. */
@@ -244,6 +334,8 @@
                     xTimeoutOccurred = pdTRUE;
                 }
             }
+
+            eventEXIT_CRITICAL( pxEventBits );
         }
         xAlreadyYielded = xTaskResumeAll();
 
@@ -267,7 +359,13 @@
             if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
             {
                 /* The task timed out, just return the current event bit value. */
-                taskENTER_CRITICAL();
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                    UBaseType_t uxSavedInterruptStatus;
+
+                    eventLOCK( pxEventBits, uxSavedInterruptStatus );
+                #else
+                    taskENTER_CRITICAL();
+                #endif
                 {
                     uxReturn = pxEventBits->uxEventBits;
 
@@ -284,7 +382,11 @@
                         mtCOVERAGE_TEST_MARKER();
                     }
                 }
-                taskEXIT_CRITICAL();
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                    eventUNLOCK( pxEventBits, uxSavedInterruptStatus );
+                #else
+                    taskEXIT_CRITICAL();
+                #endif
 
                 xTimeoutOccurred = pdTRUE;
             }
@@ -333,7 +435,22 @@
         }
         #endif
 
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        {
+            if( prvTryWaitBitsWithObjectLock( pxEventBits, uxBitsToWaitFor, xClearOnExit, xWaitForAllBits, &uxReturn ) != pdFALSE )
+            {
+                traceEVENT_GROUP_WAIT_BITS_END( xEventGroup, uxBitsToWaitFor, xTimeoutOccurred );
+                ( void ) xTimeoutOccurred;
+
+                traceRETURN_xEventGroupWaitBits( uxReturn );
+
+                return uxReturn;
+            }
+        }
+        #endif /* configUSE_PER_OBJECT_LOCKS */
+
         vTaskSuspendAll();
+        eventENTER_CRITICAL( pxEventBits );
         {
             const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -401,6 +518,7 @@
                 traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
             }
         }
+        eventEXIT_CRITICAL( pxEventBits );
         xAlreadyYielded = xTaskResumeAll();
 
         if( xTicksToWait != ( TickType_t ) 0 )
@@ -422,7 +540,13 @@
 
             if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
             {
-                taskENTER_CRITICAL();
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                    UBaseType_t uxSavedInterruptStatus;
+
+                    eventLOCK( pxEventBits, uxSavedInterruptStatus );
+                #else
+                    taskENTER_CRITICAL();
+                #endif
                 {
                     /* The task timed out, just return the current event bit value. */
                     uxReturn = pxEventBits->uxEventBits;
@@ -447,7 +571,11 @@
 
                     xTimeoutOccurred = pdTRUE;
                 }
-                taskEXIT_CRITICAL();
+                #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+                    eventUNLOCK( pxEventBits, uxSavedInterruptStatus );
+                #else
+                    taskEXIT_CRITICAL();
+                #endif
             }
             else
             {
@@ -475,6 +603,10 @@
         EventGroup_t * pxEventBits = xEventGroup;
         EventBits_t uxReturn;
 
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+            UBaseType_t uxSavedInterruptStatus;
+        #endif
+
         traceENTER_xEventGroupClearBits( xEventGroup, uxBitsToClear );
 
         /* Check the user is not attempting to clear the bits used by the kernel
@@ -482,7 +614,13 @@
         configASSERT( xEventGroup );
         configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-        taskENTER_CRITICAL();
+        /* Clearing bits never unblocks a task, so the event group lock is
+         * enough when there is one. */
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+            eventLOCK( pxEventBits, uxSavedInterruptStatus );
+        #else
+            taskENTER_CRITICAL();
+        #endif
         {
             traceEVENT_GROUP_CLEAR_BITS( xEventGroup, uxBitsToClear );
 
@@ -493,7 +631,11 @@
             /* Clear the bits. */
             pxEventBits->uxEventBits &= ~uxBitsToClear;
         }
-        taskEXIT_CRITICAL();
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+            eventUNLOCK( pxEventBits, uxSavedInterruptStatus );
+        #else
+            taskEXIT_CRITICAL();
+        #endif
 
         traceRETURN_xEventGroupClearBits( uxReturn );
 
@@ -562,9 +704,21 @@
         configASSERT( xEventGroup );
         configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        {
+            if( prvTrySetBitsWithObjectLock( pxEventBits, uxBitsToSet, &uxReturnBits ) != pdFALSE )
+            {
+                traceRETURN_xEventGroupSetBits( uxReturnBits );
+
+                return uxReturnBits;
+            }
+        }
+        #endif /* configUSE_PER_OBJECT_LOCKS */
+
         pxList = &( pxEventBits->xTasksWaitingForBits );
         pxListEnd = listGET_END_MARKER( pxList );
         vTaskSuspendAll();
+        eventENTER_CRITICAL( pxEventBits );
         {
             traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
@@ -639,6 +793,7 @@
             /* Snapshot resulting bits. */
             uxReturnBits = pxEventBits->uxEventBits;
         }
+        eventEXIT_CRITICAL( pxEventBits );
         ( void ) xTaskResumeAll();
 
         traceRETURN_xEventGroupSetBits( uxReturnBits );
@@ -659,6 +814,7 @@
         pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 
         vTaskSuspendAll();
+        eventENTER_CRITICAL( pxEventBits );
         {
             traceEVENT_GROUP_DELETE( xEventGroup );
 
@@ -670,6 +826,7 @@
                 vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
             }
         }
+        eventEXIT_CRITICAL( pxEventBits );
         ( void ) xTaskResumeAll();
 
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
@@ -812,6 +969,83 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+
+        static BaseType_t prvTrySetBitsWithObjectLock( EventGroup_t * pxEventBits,
+                                                       const EventBits_t uxBitsToSet,
+                                                       EventBits_t * puxReturnBits )
+        {
+            BaseType_t xReturn = pdFALSE;
+            UBaseType_t uxSavedInterruptStatus;
+
+            eventLOCK( pxEventBits, uxSavedInterruptStatus );
+            {
+                /* Tasks are only added to the list while this lock is held, so
+                 * an empty list cannot gain a waiter that misses these bits. */
+                if( listLIST_IS_EMPTY( &( pxEventBits->xTasksWaitingForBits ) ) != pdFALSE )
+                {
+                    traceEVENT_GROUP_SET_BITS( pxEventBits, uxBitsToSet );
+
+                    pxEventBits->uxEventBits |= uxBitsToSet;
+                    *puxReturnBits = pxEventBits->uxEventBits;
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            eventUNLOCK( pxEventBits, uxSavedInterruptStatus );
+
+            return xReturn;
+        }
+
+    #endif /* configUSE_PER_OBJECT_LOCKS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+
+        static BaseType_t prvTryWaitBitsWithObjectLock( EventGroup_t * pxEventBits,
+                                                        const EventBits_t uxBitsToWaitFor,
+                                                        const BaseType_t xClearOnExit,
+                                                        const BaseType_t xWaitForAllBits,
+                                                        EventBits_t * puxReturnBits )
+        {
+            BaseType_t xWaitConditionMet;
+            UBaseType_t uxSavedInterruptStatus;
+
+            eventLOCK( pxEventBits, uxSavedInterruptStatus );
+            {
+                const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
+
+                xWaitConditionMet = prvTestWaitCondition( uxCurrentEventBits, uxBitsToWaitFor, xWaitForAllBits );
+
+                if( xWaitConditionMet != pdFALSE )
+                {
+                    *puxReturnBits = uxCurrentEventBits;
+
+                    if( xClearOnExit != pdFALSE )
+                    {
+                        pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            eventUNLOCK( pxEventBits, uxSavedInterruptStatus );
+
+            return xWaitConditionMet;
+        }
+
+    #endif /* configUSE_PER_OBJECT_LOCKS */
+/*-----------------------------------------------------------*/
+
     #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
         BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
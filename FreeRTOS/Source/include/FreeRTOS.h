@@ -333,6 +333,22 @@
     #define configUSE_STREAM_BUFFERS    1
 #endif
 
+/* Set configUSE_MPMC_QUEUES to 1 to include the lock-free multi-producer/
+ * multi-consumer queues of mpmc_queue.c, which block on counting semaphores. */
+#ifndef configUSE_MPMC_QUEUES
+    #define configUSE_MPMC_QUEUES    0
+#endif
+
+#if ( ( configUSE_MPMC_QUEUES == 1 ) && ( configUSE_COUNTING_SEMAPHORES != 1 ) )
+    #error configUSE_COUNTING_SEMAPHORES must be set to 1 to use configUSE_MPMC_QUEUES
+#endif
+
+/* Data that different cores write often is kept this far apart, so the cores
+ * do not share a cache line for it. */
+#ifndef portCACHE_LINE_SIZE
+    #define portCACHE_LINE_SIZE    64
+#endif
+
 #ifndef configUSE_DAEMON_TASK_STARTUP_HOOK
     #define configUSE_DAEMON_TASK_STARTUP_HOOK    0
 #endif
@@ -426,6 +442,10 @@
 
 #endif /* portYIELD_CORE */
 
+#ifndef portHAS_NATIVE_ATOMICS
+    #define portHAS_NATIVE_ATOMICS    0
+#endif
+
 #ifndef portSET_INTERRUPT_MASK
 
     #if ( configNUMBER_OF_CORES > 1 )
@@ -482,6 +502,15 @@
 
 #endif /* portGET_ISR_LOCK */
 
+/* A port can define portGET_KERNEL_LOCKS( uxInterruptStatus, xIncludeISRLock )
+ * to take the task lock, and the ISR lock as well if xIncludeISRLock is pdTRUE,
+ * in place of portGET_TASK_LOCK() and portGET_ISR_LOCK() when a task enters its
+ * outermost critical section or suspends the scheduler.  It is called with
+ * interrupts masked by portSET_INTERRUPT_MASK(), which returned
+ * uxInterruptStatus, and may restore that state while it waits for a contended
+ * lock - the calling task can then be moved to another core, so the macro
+ * returns the ID of the core the locks were taken on. */
+
 #ifndef portENTER_CRITICAL_FROM_ISR
 
     #if ( configNUMBER_OF_CORES > 1 )
@@ -512,6 +541,152 @@
     #define configUSE_PASSIVE_IDLE_HOOK    0
 #endif /* configUSE_PASSIVE_IDLE_HOOK */
 
+#ifndef configUSE_PER_OBJECT_LOCKS
+    #define configUSE_PER_OBJECT_LOCKS    0
+#endif /* configUSE_PER_OBJECT_LOCKS */
+
+#if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    #ifndef portSPINLOCK_TYPE
+        #error portSPINLOCK_TYPE, portINIT_SPINLOCK, portGET_SPINLOCK and portRELEASE_SPINLOCK must be defined to use configUSE_PER_OBJECT_LOCKS
+    #endif
+#endif
+
+/* Set configUSE_PER_CORE_READY_LISTS to 1 to give every core a private set of
+ * ready lists for the tasks pinned to it.  Tasks that may run on more than one
+ * core stay in the shared ready lists, which every core falls back to (steals
+ * from) once its private list at a priority is empty. */
+#ifndef configUSE_PER_CORE_READY_LISTS
+    #define configUSE_PER_CORE_READY_LISTS    0
+#endif /* configUSE_PER_CORE_READY_LISTS */
+
+/* Set configUSE_PER_CORE_TICKS to 1 to give every core its own tick interrupt
+ * and its own delayed lists for the tasks pinned to it.  The tick count itself
+ * stays global and is still advanced by a single core, but each core times out
+ * and time slices its pinned tasks from its own tick, so no cross core yield is
+ * needed for them.  The port calls xTaskIncrementCoreTick() from the tick
+ * interrupt of every core. */
+#ifndef configUSE_PER_CORE_TICKS
+    #define configUSE_PER_CORE_TICKS    0
+#endif /* configUSE_PER_CORE_TICKS */
+
+/* Set configUSE_RUNNING_CORE_MASKS to 1 to keep a bit mask of the cores that
+ * are running their idle task and, for every priority, of the cores running a
+ * task of that priority.  A task that becomes ready then finds the core to
+ * preempt by intersecting these masks with its affinity mask instead of
+ * looking at the task running on every core. */
+#ifndef configUSE_RUNNING_CORE_MASKS
+    #define configUSE_RUNNING_CORE_MASKS    0
+#endif /* configUSE_RUNNING_CORE_MASKS */
+
+/* Set configUSE_CACHE_AFFINITY_WAKEUP to 1 to remember the core each task last
+ * ran on.  When a task that may run on more than one core becomes ready it is
+ * then placed back on that core, where its working set may still be in the
+ * cache, if the core is idle or running lower priority work and that work is
+ * no more than configCACHE_AFFINITY_TOLERANCE priority levels above the lowest
+ * priority work the task could preempt on another core.  The idle task counts
+ * as one level below tskIDLE_PRIORITY, so a tolerance of 0 only breaks ties. */
+#ifndef configUSE_CACHE_AFFINITY_WAKEUP
+    #define configUSE_CACHE_AFFINITY_WAKEUP    0
+#endif /* configUSE_CACHE_AFFINITY_WAKEUP */
+
+#ifndef configCACHE_AFFINITY_TOLERANCE
+    #define configCACHE_AFFINITY_TOLERANCE    0
+#endif /* configCACHE_AFFINITY_TOLERANCE */
+
+/* Set configUSE_LOAD_BALANCER to 1 to make uxTaskBalanceLoad() available.
+ * Each call compares how busy every core has been since the previous call,
+ * using the run time stats, and if the busiest and the least busy core differ
+ * by more than configLOAD_BALANCER_IMBALANCE_PERCENT percent of that time it
+ * pins tasks from the busiest core to the least busy one by changing their
+ * affinity mask.  Only tasks marked with xTaskSetMigratable() are moved, and
+ * at most configLOAD_BALANCER_MAX_TASKS tasks can be marked at the same time.
+ * The application calls uxTaskBalanceLoad() periodically, for example from a
+ * low priority task or a software timer. */
+#ifndef configUSE_LOAD_BALANCER
+    #define configUSE_LOAD_BALANCER    0
+#endif /* configUSE_LOAD_BALANCER */
+
+#ifndef configLOAD_BALANCER_MAX_TASKS
+    #define configLOAD_BALANCER_MAX_TASKS    8
+#endif /* configLOAD_BALANCER_MAX_TASKS */
+
+#ifndef configLOAD_BALANCER_IMBALANCE_PERCENT
+    #define configLOAD_BALANCER_IMBALANCE_PERCENT    20
+#endif /* configLOAD_BALANCER_IMBALANCE_PERCENT */
+
+/* Set configUSE_DELAY_WHEEL to 1 to hold the tasks that block with a timeout
+ * in a hierarchical timing wheel in front of the delayed lists, so blocking
+ * and unblocking take constant time however many tasks are delayed.  Each of
+ * the configDELAY_WHEEL_LEVELS levels has 32 slots, the first level one tick
+ * wide each and every further level 32 times as wide, so the wheel covers
+ * wake times up to 32, 1024 or 32768 ticks ahead.  Later wake times, and
+ * those beyond the next tick count overflow, are still kept in the sorted
+ * delayed lists.  With configUSE_PER_CORE_TICKS every core has a wheel of its
+ * own. */
+#ifndef configUSE_DELAY_WHEEL
+    #define configUSE_DELAY_WHEEL    0
+#endif /* configUSE_DELAY_WHEEL */
+
+#ifndef configDELAY_WHEEL_LEVELS
+    #define configDELAY_WHEEL_LEVELS    2
+#endif /* configDELAY_WHEEL_LEVELS */
+
+/* Set configUSE_PER_CORE_TIMER_TASKS to 1 to create one timer service task,
+ * pinned to its core, and one command queue of configTIMER_QUEUE_LENGTH
+ * commands for every core instead of a single pair for the whole system.  A
+ * timer belongs to the core it was created on unless vTimerSetCore() moves it,
+ * its commands go to that core's queue and its callback runs on that core.
+ * Functions pended with xTimerPendFunctionCall() and
+ * xTimerPendFunctionCallFromISR() run on the core they were pended from. */
+#ifndef configUSE_PER_CORE_TIMER_TASKS
+    #define configUSE_PER_CORE_TIMER_TASKS    0
+#endif /* configUSE_PER_CORE_TIMER_TASKS */
+
+/* Set configUSE_QUEUE_ZERO_COPY to 1 to include xQueueClaim(), vQueueCommit(),
+ * xQueueBorrow() and vQueueRelease(), which let a task fill in or read an item
+ * in place in the queue storage area instead of copying it in and out.  A
+ * queue has at most one claimed slot and one borrowed item at a time.  While a
+ * slot is claimed nothing else can be written to the queue, and while an item
+ * is borrowed nothing else can be read from the queue or written in front of
+ * the item. */
+#ifndef configUSE_QUEUE_ZERO_COPY
+    #define configUSE_QUEUE_ZERO_COPY    0
+#endif /* configUSE_QUEUE_ZERO_COPY */
+
+/* Set configUSE_QUEUE_BATCHING to 1 to include xQueueSendMultiple() and
+ * xQueueReceiveMultiple(), which move as many items as they can, up to a given
+ * number, with one critical section, at most two copies and one pass over the
+ * waiting tasks. */
+#ifndef configUSE_QUEUE_BATCHING
+    #define configUSE_QUEUE_BATCHING    0
+#endif /* configUSE_QUEUE_BATCHING */
+
+/* Set configUSE_QUEUE_WORD_COPY to 1 to copy the items of queues whose item
+ * size is 4 or 8 bytes, such as queues of pointers, handles or 32-bit IDs, with
+ * word loads and stores instead of memcpy().  Whether a queue qualifies is
+ * decided when it is created, and items sent from or received into a buffer
+ * that is not word aligned still use memcpy(). */
+#ifndef configUSE_QUEUE_WORD_COPY
+    #define configUSE_QUEUE_WORD_COPY    0
+#endif /* configUSE_QUEUE_WORD_COPY */
+
+/* Set configUSE_PRIORITY_QUEUES to 1 to include xQueueCreatePriority() and
+ * xQueueSendWithPriority(), for queues whose items are received highest
+ * priority first rather than in the order they were sent. */
+#ifndef configUSE_PRIORITY_QUEUES
+    #define configUSE_PRIORITY_QUEUES    0
+#endif /* configUSE_PRIORITY_QUEUES */
+
+/* Set configUSE_QUEUE_STATS to 1 to have every queue, semaphore and mutex
+ * count its sends, receives and blocked tasks, the time those tasks were
+ * blocked for, the most items it has held and the cross-core wakeups it
+ * caused, and to include vQueueGetStats(), vQueueResetStats() and
+ * uxQueueGetRegistryStats().  Blocked times are measured with the run time
+ * stats counter, so configGENERATE_RUN_TIME_STATS must also be set to 1. */
+#ifndef configUSE_QUEUE_STATS
+    #define configUSE_QUEUE_STATS    0
+#endif /* configUSE_QUEUE_STATS */
+
 /* The timers module relies on xTaskGetSchedulerState(). */
 #if configUSE_TIMERS == 1
 
@@ -1684,6 +1859,158 @@
     #define traceRETURN_vTimerSetTimerNumber()
 #endif
 
+#ifndef traceENTER_vTimerSetCore
+    #define traceENTER_vTimerSetCore( xTimer, xCoreID )
+#endif
+
+#ifndef traceRETURN_vTimerSetCore
+    #define traceRETURN_vTimerSetCore()
+#endif
+
+#ifndef traceENTER_xTimerGetCore
+    #define traceENTER_xTimerGetCore( xTimer )
+#endif
+
+#ifndef traceRETURN_xTimerGetCore
+    #define traceRETURN_xTimerGetCore( xCoreID )
+#endif
+
+#ifndef traceENTER_xQueueClaim
+    #define traceENTER_xQueueClaim( xQueue, ppvSlot, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueClaim
+    #define traceRETURN_xQueueClaim( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueClaimFromISR
+    #define traceENTER_xQueueClaimFromISR( xQueue, ppvSlot )
+#endif
+
+#ifndef traceRETURN_xQueueClaimFromISR
+    #define traceRETURN_xQueueClaimFromISR( xReturn )
+#endif
+
+#ifndef traceENTER_vQueueCommit
+    #define traceENTER_vQueueCommit( xQueue, pvSlot )
+#endif
+
+#ifndef traceRETURN_vQueueCommit
+    #define traceRETURN_vQueueCommit()
+#endif
+
+#ifndef traceENTER_vQueueCommitFromISR
+    #define traceENTER_vQueueCommitFromISR( xQueue, pvSlot, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_vQueueCommitFromISR
+    #define traceRETURN_vQueueCommitFromISR()
+#endif
+
+#ifndef traceENTER_xQueueBorrow
+    #define traceENTER_xQueueBorrow( xQueue, ppvItem, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueBorrow
+    #define traceRETURN_xQueueBorrow( xReturn )
+#endif
+
+#ifndef traceENTER_xQueueBorrowFromISR
+    #define traceENTER_xQueueBorrowFromISR( xQueue, ppvItem )
+#endif
+
+#ifndef traceRETURN_xQueueBorrowFromISR
+    #define traceRETURN_xQueueBorrowFromISR( xReturn )
+#endif
+
+#ifndef traceENTER_vQueueRelease
+    #define traceENTER_vQueueRelease( xQueue, pvItem )
+#endif
+
+#ifndef traceRETURN_vQueueRelease
+    #define traceRETURN_vQueueRelease()
+#endif
+
+#ifndef traceENTER_vQueueReleaseFromISR
+    #define traceENTER_vQueueReleaseFromISR( xQueue, pvItem, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_vQueueReleaseFromISR
+    #define traceRETURN_vQueueReleaseFromISR()
+#endif
+
+#ifndef traceENTER_xQueueSendMultiple
+    #define traceENTER_xQueueSendMultiple( xQueue, pvItems, uxItems, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultiple
+    #define traceRETURN_xQueueSendMultiple( uxItemsSent )
+#endif
+
+#ifndef traceENTER_xQueueSendMultipleFromISR
+    #define traceENTER_xQueueSendMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueSendMultipleFromISR
+    #define traceRETURN_xQueueSendMultipleFromISR( uxItemsSent )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultiple
+    #define traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxMaxItems, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultiple
+    #define traceRETURN_xQueueReceiveMultiple( uxItemsReceived )
+#endif
+
+#ifndef traceENTER_xQueueReceiveMultipleFromISR
+    #define traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxMaxItems, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_xQueueReceiveMultipleFromISR
+    #define traceRETURN_xQueueReceiveMultipleFromISR( uxItemsReceived )
+#endif
+
+#ifndef traceENTER_xQueueCreatePriority
+    #define traceENTER_xQueueCreatePriority( uxQueueLength, uxItemSize )
+#endif
+
+#ifndef traceRETURN_xQueueCreatePriority
+    #define traceRETURN_xQueueCreatePriority( xNewQueue )
+#endif
+
+#ifndef traceENTER_xQueueCreatePriorityStatic
+    #define traceENTER_xQueueCreatePriorityStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxStaticQueue )
+#endif
+
+#ifndef traceRETURN_xQueueCreatePriorityStatic
+    #define traceRETURN_xQueueCreatePriorityStatic( xNewQueue )
+#endif
+
+#ifndef traceENTER_vQueueGetStats
+    #define traceENTER_vQueueGetStats( xQueue, pxStats )
+#endif
+
+#ifndef traceRETURN_vQueueGetStats
+    #define traceRETURN_vQueueGetStats()
+#endif
+
+#ifndef traceENTER_vQueueResetStats
+    #define traceENTER_vQueueResetStats( xQueue )
+#endif
+
+#ifndef traceRETURN_vQueueResetStats
+    #define traceRETURN_vQueueResetStats()
+#endif
+
+#ifndef traceENTER_uxQueueGetRegistryStats
+    #define traceENTER_uxQueueGetRegistryStats( pxStatsArray, uxArraySize )
+#endif
+
+#ifndef traceRETURN_uxQueueGetRegistryStats
+    #define traceRETURN_uxQueueGetRegistryStats( uxCount )
+#endif
+
 #ifndef traceENTER_xTaskCreateStatic
     #define traceENTER_xTaskCreateStatic( pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority, puxStackBuffer, pxTaskBuffer )
 #endif
@@ -1852,6 +2179,46 @@
     #define traceRETURN_vTaskPreemptionEnable()
 #endif
 
+#ifndef traceENTER_vTaskSetCacheAffinityHint
+    #define traceENTER_vTaskSetCacheAffinityHint( xTask, xPreferLastCore )
+#endif
+
+#ifndef traceRETURN_vTaskSetCacheAffinityHint
+    #define traceRETURN_vTaskSetCacheAffinityHint()
+#endif
+
+#ifndef traceENTER_vTaskGetMigrationStats
+    #define traceENTER_vTaskGetMigrationStats( pxStats )
+#endif
+
+#ifndef traceRETURN_vTaskGetMigrationStats
+    #define traceRETURN_vTaskGetMigrationStats()
+#endif
+
+#ifndef traceENTER_vTaskResetMigrationStats
+    #define traceENTER_vTaskResetMigrationStats()
+#endif
+
+#ifndef traceRETURN_vTaskResetMigrationStats
+    #define traceRETURN_vTaskResetMigrationStats()
+#endif
+
+#ifndef traceENTER_xTaskSetMigratable
+    #define traceENTER_xTaskSetMigratable( xTask, xMigratable )
+#endif
+
+#ifndef traceRETURN_xTaskSetMigratable
+    #define traceRETURN_xTaskSetMigratable( xReturn )
+#endif
+
+#ifndef traceENTER_uxTaskBalanceLoad
+    #define traceENTER_uxTaskBalanceLoad()
+#endif
+
+#ifndef traceRETURN_uxTaskBalanceLoad
+    #define traceRETURN_uxTaskBalanceLoad( uxMoved )
+#endif
+
 #ifndef traceENTER_vTaskSuspend
     #define traceENTER_vTaskSuspend( xTaskToSuspend )
 #endif
@@ -2016,6 +2383,14 @@
     #define traceRETURN_xTaskIncrementTick( xSwitchRequired )
 #endif
 
+#ifndef traceENTER_xTaskIncrementCoreTick
+    #define traceENTER_xTaskIncrementCoreTick()
+#endif
+
+#ifndef traceRETURN_xTaskIncrementCoreTick
+    #define traceRETURN_xTaskIncrementCoreTick( xSwitchRequired )
+#endif
+
 #ifndef traceENTER_vTaskSetApplicationTaskTag
     #define traceENTER_vTaskSetApplicationTaskTag( xTask, pxHookFunction )
 #endif
@@ -2152,6 +2527,14 @@
     #define traceRETURN_eTaskConfirmSleepModeStatus( eReturn )
 #endif
 
+#ifndef traceENTER_xTaskGetExpectedIdleTime
+    #define traceENTER_xTaskGetExpectedIdleTime()
+#endif
+
+#ifndef traceRETURN_xTaskGetExpectedIdleTime
+    #define traceRETURN_xTaskGetExpectedIdleTime( xReturn )
+#endif
+
 #ifndef traceENTER_vTaskSetThreadLocalStoragePointer
     #define traceENTER_vTaskSetThreadLocalStoragePointer( xTaskToSet, xIndex, pvValue )
 #endif
@@ -2312,6 +2695,14 @@
     #define traceRETURN_uxTaskResetEventItemValue( uxReturn )
 #endif
 
+#ifndef traceENTER_uxTaskGetRemoteYieldCount
+    #define traceENTER_uxTaskGetRemoteYieldCount()
+#endif
+
+#ifndef traceRETURN_uxTaskGetRemoteYieldCount
+    #define traceRETURN_uxTaskGetRemoteYieldCount( uxReturn )
+#endif
+
 #ifndef traceENTER_pvTaskIncrementMutexHeldCount
     #define traceENTER_pvTaskIncrementMutexHeldCount()
 #endif
@@ -2706,6 +3097,14 @@
     #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )
 #endif
 
+/* Called in SMP builds whenever a task that may run on the cores set in
+ * uxCoreMask is added to a ready list, so a port whose idle cores sleep can
+ * wake one of them even when no yield is requested (for example when
+ * configUSE_PREEMPTION is 0). */
+#ifndef portWAKE_SLEEPING_CORES
+    #define portWAKE_SLEEPING_CORES( uxCoreMask )
+#endif
+
 #ifndef configEXPECTED_IDLE_TIME_BEFORE_SLEEP
     #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    2
 #endif
@@ -2892,8 +3291,64 @@
     #error configUSE_CORE_AFFINITY is not supported in single core FreeRTOS
 #endif
 
-#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 ) )
-    #error configUSE_PORT_OPTIMISED_TASK_SELECTION is not supported in SMP FreeRTOS
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_PER_OBJECT_LOCKS != 0 ) )
+    #error configUSE_PER_OBJECT_LOCKS is not supported in single core FreeRTOS
+#endif
+
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_PER_CORE_READY_LISTS != 0 ) )
+    #error configUSE_PER_CORE_READY_LISTS is not supported in single core FreeRTOS
+#endif
+
+#if ( ( configUSE_PER_CORE_READY_LISTS != 0 ) && ( configUSE_CORE_AFFINITY == 0 ) )
+    #error configUSE_CORE_AFFINITY must be set to 1 to use configUSE_PER_CORE_READY_LISTS
+#endif
+
+#if ( ( configUSE_PER_CORE_TICKS != 0 ) && ( configUSE_PER_CORE_READY_LISTS == 0 ) )
+    #error configUSE_PER_CORE_READY_LISTS must be set to 1 to use configUSE_PER_CORE_TICKS
+#endif
+
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_RUNNING_CORE_MASKS != 0 ) )
+    #error configUSE_RUNNING_CORE_MASKS is not supported in single core FreeRTOS
+#endif
+
+#if ( ( configUSE_RUNNING_CORE_MASKS != 0 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) )
+    #error configUSE_PORT_OPTIMISED_TASK_SELECTION must be set to 1 to use configUSE_RUNNING_CORE_MASKS
+#endif
+
+#if ( ( configUSE_RUNNING_CORE_MASKS != 0 ) && ( configRUN_MULTIPLE_PRIORITIES == 0 ) )
+    #error configRUN_MULTIPLE_PRIORITIES must be set to 1 to use configUSE_RUNNING_CORE_MASKS
+#endif
+
+#if ( ( configUSE_CACHE_AFFINITY_WAKEUP != 0 ) && ( configUSE_RUNNING_CORE_MASKS == 0 ) )
+    #error configUSE_RUNNING_CORE_MASKS must be set to 1 to use configUSE_CACHE_AFFINITY_WAKEUP
+#endif
+
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_LOAD_BALANCER != 0 ) )
+    #error configUSE_LOAD_BALANCER is not supported in single core FreeRTOS
+#endif
+
+#if ( ( configUSE_LOAD_BALANCER != 0 ) && ( configUSE_CORE_AFFINITY == 0 ) )
+    #error configUSE_CORE_AFFINITY must be set to 1 to use configUSE_LOAD_BALANCER
+#endif
+
+#if ( ( configUSE_LOAD_BALANCER != 0 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) )
+    #error configGENERATE_RUN_TIME_STATS must be set to 1 to use configUSE_LOAD_BALANCER
+#endif
+
+#if ( ( configUSE_DELAY_WHEEL != 0 ) && ( ( configDELAY_WHEEL_LEVELS < 1 ) || ( configDELAY_WHEEL_LEVELS > 3 ) ) )
+    #error configDELAY_WHEEL_LEVELS must be 1, 2 or 3
+#endif
+
+#if ( ( configNUMBER_OF_CORES == 1 ) && ( configUSE_PER_CORE_TIMER_TASKS != 0 ) )
+    #error configUSE_PER_CORE_TIMER_TASKS is not supported in single core FreeRTOS
+#endif
+
+#if ( ( configUSE_PER_CORE_TIMER_TASKS != 0 ) && ( configUSE_CORE_AFFINITY == 0 ) )
+    #error configUSE_CORE_AFFINITY must be set to 1 to use configUSE_PER_CORE_TIMER_TASKS
+#endif
+
+#if ( ( configUSE_QUEUE_STATS != 0 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) )
+    #error configGENERATE_RUN_TIME_STATS must be set to 1 to use configUSE_QUEUE_STATS
 #endif
 
 #ifndef configINITIAL_TICK_COUNT
@@ -3170,6 +3625,9 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_CORE_AFFINITY == 1 ) && ( configNUMBER_OF_CORES > 1 )
         UBaseType_t uxDummy26;
     #endif
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        BaseType_t xDummy27;
+    #endif
     StaticListItem_t xDummy3[ 2 ];
     UBaseType_t uxDummy5;
     void * pxDummy6;
@@ -3261,6 +3719,29 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        portSPINLOCK_TYPE xDummy10;
+    #endif
+
+    #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        void * pvDummy11[ 2 ];
+    #endif
+
+    #if ( configUSE_QUEUE_WORD_COPY == 1 )
+        uint8_t ucDummy12;
+    #endif
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+        UBaseType_t uxDummy13[ 2 ];
+    #endif
+
+    #if ( configUSE_QUEUE_STATS == 1 )
+        uint32_t ulDummy14[ 4 ];
+        configRUN_TIME_COUNTER_TYPE ulDummy15[ 2 ];
+        UBaseType_t uxDummy16;
+        uint32_t ulDummy17;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -3290,6 +3771,10 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        portSPINLOCK_TYPE xDummy5;
+    #endif
 } StaticEventGroup_t;
 
 /*
@@ -3317,6 +3802,9 @@ typedef struct xSTATIC_TIMER
         UBaseType_t uxDummy7;
     #endif
     uint8_t ucDummy8;
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+        uint8_t ucDummy9;
+    #endif
 } StaticTimer_t;
 
 /*
@@ -32,7 +32,14 @@
  *
  * This file implements atomic functions by disabling interrupts globally.
  * Implementations with architecture specific atomic instructions can be
- * provided under each compiler directory.
+ * provided under each compiler directory: a port that sets
+ * portHAS_NATIVE_ATOMICS to 1 supplies all of the functions below in its own
+ * portatomic.h instead.
+ *
+ * The _Acquire and _Release variants of an operation only promise the named
+ * ordering, which lets a native implementation use a cheaper instruction.  In
+ * the critical section based implementation they are the fully ordered
+ * operation.
  *
  * The atomic interface can be used in FreeRTOS tasks on all FreeRTOS ports. It
  * can also be used in Interrupt Service Routines (ISRs) on FreeRTOS ports that
@@ -98,6 +105,10 @@
 #define ATOMIC_COMPARE_AND_SWAP_SUCCESS    0x1U     /**< Compare and swap succeeded, swapped. */
 #define ATOMIC_COMPARE_AND_SWAP_FAILURE    0x0U     /**< Compare and swap failed, did not swap. */
 
+#if ( portHAS_NATIVE_ATOMICS == 1 )
+    #include "portatomic.h"
+#else
+
 /*----------------------------- Swap && CAS ------------------------------*/
 
 /**
@@ -139,6 +150,34 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32( uint32_t volatile *
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * Atomic swap
+ *
+ * @brief Atomically sets the value of the specified pointer points to and
+ *        returns the previous value.
+ *
+ * @param[in, out] pulDestination  Pointer to memory location from where value is
+ *                               to be loaded and written back to.
+ * @param[in] ulExchange         Value to be written to *pulDestination.
+ *
+ * @return The initial value of *pulDestination.
+ */
+static portFORCE_INLINE uint32_t Atomic_Swap_u32( uint32_t volatile * pulDestination,
+                                                  uint32_t ulExchange )
+{
+    uint32_t ulReturnValue;
+
+    ATOMIC_ENTER_CRITICAL();
+    {
+        ulReturnValue = *pulDestination;
+        *pulDestination = ulExchange;
+    }
+    ATOMIC_EXIT_CRITICAL();
+
+    return ulReturnValue;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * Atomic swap (pointers)
  *
@@ -418,6 +457,70 @@ static portFORCE_INLINE uint32_t Atomic_XOR_u32( uint32_t volatile * pulDestinat
     return ulCurrent;
 }
 
+/*----------------------------- Load && Store ------------------------------*/
+
+/**
+ * Atomic load-acquire
+ *
+ * @brief Loads the value of the specified pointer points to.  Memory accesses
+ *        that follow cannot be performed before the load.
+ *
+ * @param[in] pulSource  Pointer to memory location to be loaded.
+ *
+ * @return The value of *pulSource.
+ */
+static portFORCE_INLINE uint32_t Atomic_Load_u32_Acquire( uint32_t const volatile * pulSource )
+{
+    uint32_t ulCurrent;
+
+    ATOMIC_ENTER_CRITICAL();
+    {
+        ulCurrent = *pulSource;
+    }
+    ATOMIC_EXIT_CRITICAL();
+
+    return ulCurrent;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic store-release
+ *
+ * @brief Stores a value to the location the specified pointer points to.
+ *        Memory accesses that precede cannot be performed after the store.
+ *
+ * @param[out] pulDestination  Pointer to memory location to be written.
+ * @param[in] ulValue          Value to be written to *pulDestination.
+ */
+static portFORCE_INLINE void Atomic_Store_u32_Release( uint32_t volatile * pulDestination,
+                                                       uint32_t ulValue )
+{
+    ATOMIC_ENTER_CRITICAL();
+    {
+        *pulDestination = ulValue;
+    }
+    ATOMIC_EXIT_CRITICAL();
+}
+
+/*----------------------------- Ordered variants ------------------------------*/
+
+    #define Atomic_CompareAndSwap_u32_Acquire            Atomic_CompareAndSwap_u32
+    #define Atomic_CompareAndSwap_u32_Release            Atomic_CompareAndSwap_u32
+    #define Atomic_Swap_u32_Acquire                      Atomic_Swap_u32
+    #define Atomic_Swap_u32_Release                      Atomic_Swap_u32
+    #define Atomic_CompareAndSwapPointers_p32_Acquire    Atomic_CompareAndSwapPointers_p32
+    #define Atomic_CompareAndSwapPointers_p32_Release    Atomic_CompareAndSwapPointers_p32
+    #define Atomic_Add_u32_Acquire                       Atomic_Add_u32
+    #define Atomic_Add_u32_Release                       Atomic_Add_u32
+    #define Atomic_Subtract_u32_Acquire                  Atomic_Subtract_u32
+    #define Atomic_Subtract_u32_Release                  Atomic_Subtract_u32
+    #define Atomic_OR_u32_Acquire                        Atomic_OR_u32
+    #define Atomic_OR_u32_Release                        Atomic_OR_u32
+    #define Atomic_AND_u32_Acquire                       Atomic_AND_u32
+    #define Atomic_AND_u32_Release                       Atomic_AND_u32
+
+#endif /* portHAS_NATIVE_ATOMICS */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -0,0 +1,173 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include mpmc_queue.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A bounded multi-producer/multi-consumer queue of fixed size items that does
+ * not use the kernel locks.
+ *
+ * Every slot of the ring carries a sequence number that tells producers and
+ * consumers whether it is free or holds an item for the position they have
+ * reached.  A producer or consumer claims a position with a single
+ * compare-and-swap and then copies its item without any lock held, so any
+ * number of cores can send and receive at the same time.  The kernel is only
+ * called when a task has to block because the queue is full or empty, or when
+ * such a blocked task has to be woken.
+ *
+ * Items are copied in FIFO order of the positions claimed, but unlike a queue
+ * created with xQueueCreate() there is no priority ordering of the tasks
+ * blocked on an MPMC queue, and it cannot be added to a queue set.
+ *
+ * configUSE_MPMC_QUEUES must be set to 1 in FreeRTOSConfig.h for this API to
+ * be available.
+ */
+struct MpmcQueueDefinition;
+typedef struct MpmcQueueDefinition * MpmcQueueHandle_t;
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * MpmcQueueHandle_t xMpmcQueueCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize );
+ * @endcode
+ *
+ * Creates an MPMC queue that holds up to uxQueueLength items of uxItemSize
+ * bytes each.  The length is rounded up to the next power of two.
+ *
+ * @return The handle of the queue, or NULL if it could not be allocated.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    MpmcQueueHandle_t xMpmcQueueCreate( UBaseType_t uxQueueLength,
+                                        UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * void vMpmcQueueDelete( MpmcQueueHandle_t xQueue );
+ * @endcode
+ *
+ * Deletes a queue created with xMpmcQueueCreate().  No task may be blocked on
+ * the queue or use it afterwards.
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    void vMpmcQueueDelete( MpmcQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * BaseType_t xMpmcQueueSend( MpmcQueueHandle_t xQueue, const void * pvItemToQueue, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Copies the item at pvItemToQueue to the back of the queue, waiting up to
+ * xTicksToWait ticks for space if the queue is full.
+ *
+ * @return pdPASS if the item was queued, otherwise errQUEUE_FULL.
+ */
+BaseType_t xMpmcQueueSend( MpmcQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * BaseType_t xMpmcQueueReceive( MpmcQueueHandle_t xQueue, void * pvBuffer, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Copies the item at the front of the queue to pvBuffer and removes it,
+ * waiting up to xTicksToWait ticks for an item if the queue is empty.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ */
+BaseType_t xMpmcQueueReceive( MpmcQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * BaseType_t xMpmcQueueSendFromISR( MpmcQueueHandle_t xQueue, const void * pvItemToQueue, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Version of xMpmcQueueSend() that can be called from an ISR.  It never
+ * blocks.  *pxHigherPriorityTaskWoken is set to pdTRUE if a receiver that is
+ * waiting for the item has a higher priority than the interrupted task, in
+ * which case a context switch should be requested before the ISR exits.
+ *
+ * @return pdPASS if the item was queued, otherwise errQUEUE_FULL.
+ */
+BaseType_t xMpmcQueueSendFromISR( MpmcQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * BaseType_t xMpmcQueueReceiveFromISR( MpmcQueueHandle_t xQueue, void * pvBuffer, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Version of xMpmcQueueReceive() that can be called from an ISR.  It never
+ * blocks.  *pxHigherPriorityTaskWoken is set to pdTRUE if a sender that is
+ * waiting for space has a higher priority than the interrupted task.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ */
+BaseType_t xMpmcQueueReceiveFromISR( MpmcQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpmc_queue.h
+ * @code{c}
+ * UBaseType_t uxMpmcQueueMessagesWaiting( MpmcQueueHandle_t xQueue );
+ * @endcode
+ *
+ * @return The number of items in the queue.  With other cores sending and
+ * receiving at the same time the value is only a snapshot.
+ */
+UBaseType_t uxMpmcQueueMessagesWaiting( MpmcQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MPMC_QUEUE_H */
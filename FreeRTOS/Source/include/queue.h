@@ -64,11 +64,44 @@ typedef struct QueueDefinition   * QueueSetHandle_t;
  */
 typedef struct QueueDefinition   * QueueSetMemberHandle_t;
 
+/**
+ * Used with vQueueGetStats() and uxQueueGetRegistryStats() to return what a
+ * queue, semaphore or mutex has been used for.  Only available when
+ * configUSE_QUEUE_STATS is set to 1.  Times are in the units of the run time
+ * stats counter.
+ */
+typedef struct xQUEUE_STATS
+{
+    uint32_t ulSends;                               /* The number of items written to the queue, or the number of times the semaphore was given. */
+    uint32_t ulReceives;                            /* The number of items read from the queue, or the number of times the semaphore was taken.  Peeks are not counted. */
+    uint32_t ulFullBlocks;                          /* The number of times a task blocked because the queue was full. */
+    uint32_t ulEmptyBlocks;                         /* The number of times a task blocked because the queue was empty, or the semaphore or mutex was not available. */
+    configRUN_TIME_COUNTER_TYPE ulBlockedTime;      /* The total time tasks spent blocked on the queue, until they ran again. */
+    configRUN_TIME_COUNTER_TYPE ulPeakBlockedTime;  /* The longest time a task spent blocked on the queue. */
+    UBaseType_t uxMessagesWaitingHighWaterMark;     /* The most items the queue has held at once. */
+    uint32_t ulCrossCoreWakeups;                    /* The number of times a task unblocked by the queue was sent to a core other than the one that unblocked it. */
+} QueueStats_t;
+
+/**
+ * Used with uxQueueGetRegistryStats() to return the statistics of each queue
+ * in the queue registry.
+ */
+typedef struct xQUEUE_REGISTRY_STATS
+{
+    const char * pcQueueName; /* The name the queue was added to the registry with. */
+    QueueHandle_t xHandle;    /* The handle of the queue. */
+    QueueStats_t xStats;      /* The statistics of the queue. */
+} QueueRegistryStats_t;
+
 /* For internal use only. */
 #define queueSEND_TO_BACK                     ( ( BaseType_t ) 0 )
 #define queueSEND_TO_FRONT                    ( ( BaseType_t ) 1 )
 #define queueOVERWRITE                        ( ( BaseType_t ) 2 )
 
+/* For internal use only.  An item sent to a priority queue with priority
+ * uxPriority is sent to position ( queueSEND_BY_PRIORITY + uxPriority ). */
+#define queueSEND_BY_PRIORITY                 ( ( BaseType_t ) 3 )
+
 /* For internal use only.  These definitions *must* match those in queue.c. */
 #define queueQUEUE_TYPE_BASE                  ( ( uint8_t ) 0U )
 #define queueQUEUE_TYPE_MUTEX                 ( ( uint8_t ) 1U )
@@ -76,6 +109,7 @@ typedef struct QueueDefinition   * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE      ( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX       ( ( uint8_t ) 4U )
 #define queueQUEUE_TYPE_SET                   ( ( uint8_t ) 5U )
+#define queueQUEUE_TYPE_PRIORITY              ( ( uint8_t ) 6U )
 
 /**
  * queue. h
@@ -1456,6 +1490,609 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueClaim(
+ *                          QueueHandle_t xQueue,
+ *                          void **ppvSlot,
+ *                          TickType_t xTicksToWait
+ *                       );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_ZERO_COPY is set to 1.
+ *
+ * Reserve the slot at the back of a queue so the item can be written to it in
+ * place, instead of being built in a buffer and copied in by xQueueSend().
+ * The item does not become visible to receivers until the slot is passed to
+ * vQueueCommit().  A queue has at most one claimed slot, and while it is
+ * claimed no other task or interrupt can send to the queue, so fill it in and
+ * commit it without blocking in between.
+ *
+ * A task that has to wait for a slot blocks exactly as it would in
+ * xQueueSend(), and is unblocked by a receive, a release or a commit.
+ *
+ * @param xQueue The handle to the queue in which to claim a slot.
+ *
+ * @param ppvSlot Set to the slot, which is uxQueueGetQueueItemSize() bytes
+ * long and holds whatever was last stored in it.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a slot, should the queue be full or another slot be claimed.
+ *
+ * @return pdPASS if a slot was claimed, otherwise errQUEUE_FULL.
+ *
+ * Example usage:
+ * @code{c}
+ * struct APath
+ * {
+ *  uint16_t usPoints;
+ *  Point_t xPoints[ 64 ];
+ * } *pxPath;
+ *
+ * void vProducer( void *pvParameters )
+ * {
+ *  for( ;; )
+ *  {
+ *      if( xQueueClaim( xPathQueue, ( void ** ) &pxPath, portMAX_DELAY ) == pdPASS )
+ *      {
+ *          // Build the path directly in the queue storage area.
+ *          pxPath->usPoints = usPlanPath( pxPath->xPoints );
+ *          vQueueCommit( xPathQueue, pxPath );
+ *      }
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueClaim xQueueClaim
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    BaseType_t xQueueClaim( QueueHandle_t xQueue,
+                            void ** const ppvSlot,
+                            TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueClaimFromISR(
+ *                                 QueueHandle_t xQueue,
+ *                                 void **ppvSlot
+ *                              );
+ * @endcode
+ *
+ * A version of xQueueClaim() that can be called from an ISR.  It never
+ * blocks.
+ *
+ * @return pdPASS if a slot was claimed, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xQueueClaimFromISR xQueueClaimFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    BaseType_t xQueueClaimFromISR( QueueHandle_t xQueue,
+                                   void ** const ppvSlot ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueCommit( QueueHandle_t xQueue, void *pvSlot );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_ZERO_COPY is set to 1.
+ *
+ * Add the item written to a slot claimed with xQueueClaim() to the back of the
+ * queue.  This unblocks a task waiting to receive from the queue, as
+ * xQueueSend() does, and the tasks that were waiting to send while the slot
+ * was claimed.
+ *
+ * @param xQueue The handle to the queue the slot was claimed in.
+ *
+ * @param pvSlot The slot returned by xQueueClaim().
+ *
+ * \defgroup vQueueCommit vQueueCommit
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    void vQueueCommit( QueueHandle_t xQueue,
+                       void * const pvSlot ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueCommitFromISR( QueueHandle_t xQueue, void *pvSlot, BaseType_t *pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of vQueueCommit() that can be called from an ISR.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the slot
+ * unblocked a task with a priority higher than the running task, in which case
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * \defgroup vQueueCommitFromISR vQueueCommitFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    void vQueueCommitFromISR( QueueHandle_t xQueue,
+                              void * const pvSlot,
+                              BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueBorrow(
+ *                           QueueHandle_t xQueue,
+ *                           void **ppvItem,
+ *                           TickType_t xTicksToWait
+ *                        );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_ZERO_COPY is set to 1.
+ *
+ * Get a pointer to the item at the front of a queue so it can be used in
+ * place, instead of being copied out by xQueueReceive().  The item stays in the
+ * queue, and keeps its slot, until it is passed to vQueueRelease().  A queue
+ * has at most one borrowed item, and while it is borrowed no other task or
+ * interrupt can receive from the queue, send to the front of it or overwrite
+ * it, so release the item as soon as it has been used.  Sending to the back of
+ * the queue is not affected.
+ *
+ * A task that has to wait for an item blocks exactly as it would in
+ * xQueueReceive(), and is unblocked by a send, a commit or a release.
+ *
+ * @param xQueue The handle to the queue from which to borrow the item.
+ *
+ * @param ppvItem Set to the item, which is uxQueueGetQueueItemSize() bytes
+ * long.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item, should the queue be empty or its front item be
+ * borrowed.
+ *
+ * @return pdPASS if an item was borrowed, otherwise errQUEUE_EMPTY.
+ *
+ * Example usage:
+ * @code{c}
+ * void vConsumer( void *pvParameters )
+ * {
+ * struct APath *pxPath;
+ *
+ *  for( ;; )
+ *  {
+ *      if( xQueueBorrow( xPathQueue, ( void ** ) &pxPath, portMAX_DELAY ) == pdPASS )
+ *      {
+ *          // Use the path where it is, then hand the slot back.
+ *          vFollowPath( pxPath->xPoints, pxPath->usPoints );
+ *          vQueueRelease( xPathQueue, pxPath );
+ *      }
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueBorrow xQueueBorrow
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    BaseType_t xQueueBorrow( QueueHandle_t xQueue,
+                             void ** const ppvItem,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueBorrowFromISR(
+ *                                  QueueHandle_t xQueue,
+ *                                  void **ppvItem
+ *                               );
+ * @endcode
+ *
+ * A version of xQueueBorrow() that can be called from an ISR.  It never
+ * blocks.
+ *
+ * @return pdPASS if an item was borrowed, otherwise pdFAIL.
+ *
+ * \defgroup xQueueBorrowFromISR xQueueBorrowFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    BaseType_t xQueueBorrowFromISR( QueueHandle_t xQueue,
+                                    void ** const ppvItem ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueRelease( QueueHandle_t xQueue, void *pvItem );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_ZERO_COPY is set to 1.
+ *
+ * Remove an item borrowed with xQueueBorrow() from the queue, freeing its
+ * slot.  This unblocks the tasks waiting to send to the queue, and the tasks
+ * that were waiting to receive while the item was borrowed.
+ *
+ * @param xQueue The handle to the queue the item was borrowed from.
+ *
+ * @param pvItem The item returned by xQueueBorrow().
+ *
+ * \defgroup vQueueRelease vQueueRelease
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    void vQueueRelease( QueueHandle_t xQueue,
+                        void * const pvItem ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueReleaseFromISR( QueueHandle_t xQueue, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * A version of vQueueRelease() that can be called from an ISR.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the item
+ * unblocked a task with a priority higher than the running task, in which case
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * \defgroup vQueueReleaseFromISR vQueueReleaseFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    void vQueueReleaseFromISR( QueueHandle_t xQueue,
+                               void * const pvItem,
+                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueSendMultiple(
+ *                                  QueueHandle_t xQueue,
+ *                                  const void *pvItems,
+ *                                  UBaseType_t uxItems,
+ *                                  TickType_t xTicksToWait
+ *                               );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_BATCHING is set to 1.
+ *
+ * Post up to uxItems items, stored one after the other at pvItems, to the back
+ * of a queue.  As many items as there is room for are posted at once, which
+ * costs one critical section and at most two copies however many items there
+ * are, and one task waiting to receive is unblocked for each item.  The task
+ * only blocks if there is no room for any item, so the items left over have to
+ * be posted by a further call.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItems A pointer to the items to be placed on the queue.
+ *
+ * @param uxItems The number of items at pvItems.  Must be at least 1.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for room for at least one item, should the queue be full.
+ *
+ * @return The number of items posted, from the front of pvItems, or 0 if the
+ * queue stayed full.
+ *
+ * Example usage:
+ * @code{c}
+ * void vUARTDrainTask( void *pvParameters )
+ * {
+ * char cRxedChars[ 32 ];
+ * UBaseType_t uxRxed, uxSent;
+ *
+ *  for( ;; )
+ *  {
+ *      uxRxed = uxReadUARTFifo( cRxedChars, sizeof( cRxedChars ) );
+ *
+ *      for( uxSent = 0; uxSent < uxRxed; )
+ *      {
+ *          uxSent += xQueueSendMultiple( xCharQueue, &cRxedChars[ uxSent ], uxRxed - uxSent, portMAX_DELAY );
+ *      }
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCHING == 1 )
+    UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                    const void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueSendMultipleFromISR(
+ *                                         QueueHandle_t xQueue,
+ *                                         const void *pvItems,
+ *                                         UBaseType_t uxItems,
+ *                                         BaseType_t *pxHigherPriorityTaskWoken
+ *                                      );
+ * @endcode
+ *
+ * A version of xQueueSendMultiple() that can be called from an ISR.  It never
+ * blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if posting the items
+ * unblocked a task with a priority higher than the running task, in which case
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return The number of items posted, from the front of pvItems, or 0 if the
+ * queue was full.
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCHING == 1 )
+    UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                           const void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueReceiveMultiple(
+ *                                     QueueHandle_t xQueue,
+ *                                     void *pvBuffer,
+ *                                     UBaseType_t uxMaxItems,
+ *                                     TickType_t xTicksToWait
+ *                                  );
+ * @endcode
+ *
+ * Only available when configUSE_QUEUE_BATCHING is set to 1.
+ *
+ * Receive up to uxMaxItems items from the front of a queue into pvBuffer, one
+ * after the other.  All the items in the queue, up to uxMaxItems, are received
+ * at once, which costs one critical section and at most two copies however
+ * many items there are, and one task waiting to send is unblocked for each
+ * item.  The task only blocks if the queue is empty.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received items will be
+ * copied.  It must have room for uxMaxItems items.
+ *
+ * @param uxMaxItems The most items to receive.  Must be at least 1.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for at least one item, should the queue be empty.
+ *
+ * @return The number of items received, or 0 if the queue stayed empty.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCHING == 1 )
+    UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                       void * const pvBuffer,
+                                       const UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueReceiveMultipleFromISR(
+ *                                            QueueHandle_t xQueue,
+ *                                            void *pvBuffer,
+ *                                            UBaseType_t uxMaxItems,
+ *                                            BaseType_t *pxHigherPriorityTaskWoken
+ *                                         );
+ * @endcode
+ *
+ * A version of xQueueReceiveMultiple() that can be called from an ISR.  It
+ * never blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving the items
+ * unblocked a task with a priority higher than the running task, in which case
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return The number of items received, or 0 if the queue was empty.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_QUEUE_BATCHING == 1 )
+    UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                              void * const pvBuffer,
+                                              const UBaseType_t uxMaxItems,
+                                              BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * The highest priority an item sent to a priority queue can have.  The
+ * lowest is 0.
+ */
+#define queueMAX_ITEM_PRIORITY    ( ( UBaseType_t ) 255U )
+
+/*
+ * The number of bytes a priority queue stores for each item: the item's
+ * priority and sequence number, followed by the item padded to a whole number
+ * of UBaseType_t.  For internal use, and to size the storage area passed to
+ * xQueueCreatePriorityStatic().  This definition *must* match
+ * QueuePriorityHeader_t in queue.c.
+ */
+#define queuePRIORITY_QUEUE_ENTRY_SIZE( uxItemSize ) \
+    ( ( 2U * sizeof( UBaseType_t ) ) + ( ( ( size_t ) ( uxItemSize ) + sizeof( UBaseType_t ) - 1U ) & ~( sizeof( UBaseType_t ) - 1U ) ) )
+
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreatePriority(
+ *                                      UBaseType_t uxQueueLength,
+ *                                      UBaseType_t uxItemSize
+ *                                   );
+ * @endcode
+ *
+ * Only available when configUSE_PRIORITY_QUEUES is set to 1.
+ *
+ * Creates a queue that is received from in item priority order instead of in
+ * the order the items were sent.  Items sent with xQueueSendWithPriority()
+ * carry a priority from 0 to queueMAX_ITEM_PRIORITY, and xQueueReceive() and
+ * xQueuePeek() always get the item with the highest priority.  Items of equal
+ * priority are received in the order they were sent.  Sending to the back of
+ * the queue sends with priority 0, and sending to the front of the queue sends
+ * with priority queueMAX_ITEM_PRIORITY.
+ *
+ * The items are kept in a binary heap, so sending and receiving take time
+ * proportional to the logarithm of the number of items in the queue, and
+ * every item uses queuePRIORITY_QUEUE_ENTRY_SIZE( uxItemSize ) bytes.  Apart
+ * from the order the queue behaves as any other: tasks block to send and
+ * receive in the same way, and it can be added to a queue set.  It cannot be
+ * used with xQueueClaim(), xQueueBorrow(), xQueueSendMultiple(),
+ * xQueueReceiveMultiple() or co-routines.
+ *
+ * @param uxQueueLength The maximum number of items that the queue can contain.
+ *
+ * @param uxItemSize The number of bytes each item in the queue will require,
+ * which must not be zero.
+ *
+ * @return If the queue is successfully created then a handle to the newly
+ * created queue is returned.  If the queue cannot be created then 0 is
+ * returned.
+ *
+ * Example usage:
+ * @code{c}
+ * #define WORK_PRIORITY     0
+ * #define CANCEL_PRIORITY   1
+ *
+ * void vCoordinator( void *pvParameters )
+ * {
+ * QueueHandle_t xWorkQueue;
+ * struct AJob *pxJob, *pxCancel;
+ *
+ *  xWorkQueue = xQueueCreatePriority( 32, sizeof( struct AJob * ) );
+ *
+ *  // ... Queue work.
+ *  xQueueSendWithPriority( xWorkQueue, &pxJob, WORK_PRIORITY, portMAX_DELAY );
+ *
+ *  // A cancel request overtakes all the work still in the queue.
+ *  xQueueSendWithPriority( xWorkQueue, &pxCancel, CANCEL_PRIORITY, portMAX_DELAY );
+ * }
+ * @endcode
+ * \defgroup xQueueCreatePriority xQueueCreatePriority
+ * \ingroup QueueManagement
+ */
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    QueueHandle_t xQueueCreatePriority( const UBaseType_t uxQueueLength,
+                                        const UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreatePriorityStatic(
+ *                                            UBaseType_t uxQueueLength,
+ *                                            UBaseType_t uxItemSize,
+ *                                            uint8_t *pucQueueStorage,
+ *                                            StaticQueue_t *pxQueueBuffer
+ *                                         );
+ * @endcode
+ *
+ * Only available when configUSE_PRIORITY_QUEUES is set to 1.
+ *
+ * A version of xQueueCreatePriority() that uses memory provided by the
+ * application writer, as xQueueCreateStatic() does.
+ *
+ * @param pucQueueStorage Must point to an array of at least
+ * ( uxQueueLength * queuePRIORITY_QUEUE_ENTRY_SIZE( uxItemSize ) ) bytes,
+ * aligned to a UBaseType_t.
+ *
+ * @param pxQueueBuffer Must point to a variable of type StaticQueue_t, which
+ * will be used to hold the queue's data structure.
+ *
+ * @return If the queue is created then a handle to the created queue is
+ * returned.  If pxQueueBuffer is NULL then NULL is returned.
+ *
+ * \defgroup xQueueCreatePriorityStatic xQueueCreatePriorityStatic
+ * \ingroup QueueManagement
+ */
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    QueueHandle_t xQueueCreatePriorityStatic( const UBaseType_t uxQueueLength,
+                                              const UBaseType_t uxItemSize,
+                                              uint8_t * pucQueueStorage,
+                                              StaticQueue_t * pxStaticQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendWithPriority(
+ *                                     QueueHandle_t xQueue,
+ *                                     const void *pvItemToQueue,
+ *                                     UBaseType_t uxPriority,
+ *                                     TickType_t xTicksToWait
+ *                                  );
+ * @endcode
+ *
+ * Only available when configUSE_PRIORITY_QUEUES is set to 1.
+ *
+ * Post an item to a queue created with xQueueCreatePriority().  The item is
+ * received after every item in the queue with a priority of uxPriority or
+ * higher, and before every item with a lower priority.  Blocks, and returns,
+ * exactly as xQueueSend() does.
+ *
+ * @param xQueue The handle to the queue on which the item is to be posted.
+ *
+ * @param pvItemToQueue A pointer to the item that is to be placed on the
+ * queue.
+ *
+ * @param uxPriority The priority of the item, from 0 to
+ * queueMAX_ITEM_PRIORITY.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it already be
+ * full.
+ *
+ * @return pdTRUE if the item was successfully posted, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xQueueSendWithPriority xQueueSendWithPriority
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+    #define xQueueSendWithPriority( xQueue, pvItemToQueue, uxPriority, xTicksToWait ) \
+    xQueueGenericSend( ( xQueue ), ( pvItemToQueue ), ( xTicksToWait ), queueSEND_BY_PRIORITY + ( BaseType_t ) ( uxPriority ) )
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendWithPriorityFromISR(
+ *                                            QueueHandle_t xQueue,
+ *                                            const void *pvItemToQueue,
+ *                                            UBaseType_t uxPriority,
+ *                                            BaseType_t *pxHigherPriorityTaskWoken
+ *                                         );
+ * @endcode
+ *
+ * A version of xQueueSendWithPriority() that can be called from an ISR.  It
+ * never blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the item
+ * unblocked a task with a priority higher than the running task, in which case
+ * a context switch should be requested before the interrupt is exited.
+ *
+ * @return pdTRUE if the item was successfully posted, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xQueueSendWithPriorityFromISR xQueueSendWithPriorityFromISR
+ * \ingroup QueueManagement
+ */
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+    #define xQueueSendWithPriorityFromISR( xQueue, pvItemToQueue, uxPriority, pxHigherPriorityTaskWoken ) \
+    xQueueGenericSendFromISR( ( xQueue ), ( pvItemToQueue ), ( pxHigherPriorityTaskWoken ), queueSEND_BY_PRIORITY + ( BaseType_t ) ( uxPriority ) )
+#endif
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -1595,6 +2232,56 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
     const char * pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * Only available when configUSE_QUEUE_STATS is set to 1.
+ *
+ * Copies the statistics the queue, semaphore or mutex has gathered since it
+ * was created or vQueueResetStats() was last called into *pxStats.
+ *
+ * @param xQueue The handle of the queue, semaphore or mutex.
+ *
+ * @param pxStats The structure the statistics are copied to.
+ */
+#if ( configUSE_QUEUE_STATS == 1 )
+    void vQueueGetStats( QueueHandle_t xQueue,
+                         QueueStats_t * pxStats ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Only available when configUSE_QUEUE_STATS is set to 1.
+ *
+ * Sets the statistics of the queue, semaphore or mutex back to zero, apart
+ * from the high water mark of the number of items in the queue, which is set
+ * to the number of items the queue holds now.
+ *
+ * @param xQueue The handle of the queue, semaphore or mutex.
+ */
+#if ( configUSE_QUEUE_STATS == 1 )
+    void vQueueResetStats( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Only available when configUSE_QUEUE_STATS is set to 1 and
+ * configQUEUE_REGISTRY_SIZE is greater than 0.
+ *
+ * Fills in a QueueRegistryStats_t structure, with the name, handle and
+ * statistics, for each queue, semaphore and mutex in the queue registry.  The
+ * statistics of each queue are copied in one go, so they agree with each
+ * other, but the queues are not all copied at the same moment.
+ *
+ * @param pxStatsArray The array the structures are written to.
+ *
+ * @param uxArraySize The number of structures pxStatsArray can hold.  Passing
+ * configQUEUE_REGISTRY_SIZE is always enough.
+ *
+ * @return The number of structures written to pxStatsArray, which is the
+ * number of queues in the registry unless uxArraySize is smaller.
+ */
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
+    UBaseType_t uxQueueGetRegistryStats( QueueRegistryStats_t * const pxStatsArray,
+                                         const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Generic version of the function used to create a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
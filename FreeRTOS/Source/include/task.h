@@ -180,6 +180,15 @@ typedef struct xTASK_STATUS
     #endif
 } TaskStatus_t;
 
+/* Used with vTaskGetMigrationStats() to return how often tasks moved between
+ * cores. */
+typedef struct xTASK_MIGRATION_STATS
+{
+    uint32_t ulMigrations;       /* The number of times a task was switched in on a core other than the one it last ran on. */
+    uint32_t ulLastCoreWakeups;  /* The number of times a task that became ready was sent to the core it last ran on. */
+    uint32_t ulOtherCoreWakeups; /* The number of times a task that became ready was sent to another core. */
+} TaskMigrationStats_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -1483,6 +1492,94 @@ BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume ) PRIVILEGED_FUNCTION;
     void vTaskPreemptionEnable( const TaskHandle_t xTask );
 #endif
 
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+
+/**
+ * @brief Sets whether a task is placed back on the core it last ran on when it
+ * becomes ready.
+ *
+ * configUSE_CACHE_AFFINITY_WAKEUP must be defined as 1 for this function to be
+ * available.  The hint is on for every task when it is created.
+ *
+ * @param xTask The handle of the task.  Passing NULL sets the hint of the
+ * calling task.
+ *
+ * @param xPreferLastCore pdTRUE to prefer the core the task last ran on, within
+ * configCACHE_AFFINITY_TOLERANCE, or pdFALSE to place the task on the core
+ * running the lowest priority work only.
+ */
+    void vTaskSetCacheAffinityHint( TaskHandle_t xTask,
+                                    BaseType_t xPreferLastCore );
+
+/**
+ * @brief Returns the number of task migrations and where the tasks that became
+ * ready were sent since the scheduler started or the counters were reset.
+ *
+ * configUSE_CACHE_AFFINITY_WAKEUP must be defined as 1 for this function to be
+ * available.
+ *
+ * @param pxStats The structure the counters are copied to.
+ */
+    void vTaskGetMigrationStats( TaskMigrationStats_t * pxStats );
+
+/**
+ * @brief Resets the counters returned by vTaskGetMigrationStats().
+ *
+ * configUSE_CACHE_AFFINITY_WAKEUP must be defined as 1 for this function to be
+ * available.
+ */
+    void vTaskResetMigrationStats( void );
+#endif /* #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 ) */
+
+#if ( configUSE_LOAD_BALANCER == 1 )
+
+/**
+ * @brief Lets uxTaskBalanceLoad() move a task between cores.
+ *
+ * configUSE_LOAD_BALANCER must be defined as 1 for this function to be
+ * available.
+ *
+ * A migratable task is kept on one core of the affinity mask it had when it
+ * was marked, and uxTaskBalanceLoad() changes that core as the load of the
+ * cores changes.  Tasks created with xTaskCreateAffinitySet() or one of its
+ * variants have a hard affinity and cannot be marked.  Calling
+ * vTaskCoreAffinitySet() on a migratable task unmarks it, as does deleting it.
+ *
+ * @param xTask The handle of the task.  Passing NULL marks the calling task.
+ *
+ * @param xMigratable pdTRUE to mark the task, pdFALSE to unmark it.  The task
+ * keeps the affinity mask the balancer last gave it when it is unmarked.
+ *
+ * @return pdPASS if the task was marked or unmarked, pdFAIL if it has a hard
+ * affinity or configLOAD_BALANCER_MAX_TASKS tasks are already marked.
+ */
+    BaseType_t xTaskSetMigratable( TaskHandle_t xTask,
+                                   BaseType_t xMigratable );
+
+/**
+ * @brief Evens out the load of the cores by moving migratable tasks from the
+ * busiest core to the least busy one.
+ *
+ * configUSE_LOAD_BALANCER must be defined as 1 for this function to be
+ * available.
+ *
+ * The load of a core is the time it spent running tasks other than an idle
+ * task since the previous call, and the load of a task is its run time over
+ * the same period.  While the busiest and the least busy core differ by more
+ * than configLOAD_BALANCER_IMBALANCE_PERCENT percent of the period, the
+ * migratable task with the highest load that last ran on the busiest core and
+ * whose move narrows the difference is pinned to the least busy core.  Each
+ * task is moved at most once per call.
+ *
+ * The function is meant to be called periodically, for example every few
+ * hundred milliseconds from a low priority task or a software timer.  The
+ * first call only starts the measurement period.
+ *
+ * @return The number of tasks that were moved.
+ */
+    UBaseType_t uxTaskBalanceLoad( void );
+#endif /* #if ( configUSE_LOAD_BALANCER == 1 ) */
+
 /*-----------------------------------------------------------
 * SCHEDULER CONTROL
 *----------------------------------------------------------*/
@@ -1978,6 +2075,9 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) PRIVILEGED_FUNCTION;
  * @endcode
  *
  * This hook function is called in the system tick handler after any OS work is completed.
+ * It runs in interrupt context, so ports that do not save the FPU registers on
+ * interrupt entry (for example the RISC-V port built with configENABLE_FPU) do
+ * not allow it to use the FPU.
  */
     /* MISRA Ref 8.6.1 [External linkage] */
     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-86 */
@@ -3500,6 +3600,23 @@ void vTaskResetState( void ) PRIVILEGED_FUNCTION;
  */
 BaseType_t xTaskIncrementTick( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
+ * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
+ * AN INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * Called from the tick interrupt of every core when configUSE_PER_CORE_TICKS
+ * is 1, after xTaskIncrementTick() if the calling core also owns the global
+ * tick.  It does not change the tick count.  Instead it brings the calling
+ * core's view of the tick count up to date, moves the tasks pinned to the
+ * core whose timeout has expired from the core's delayed lists to its ready
+ * lists, and time slices the core.  If a non-zero value is returned then the
+ * calling core should perform a context switch.
+ */
+#if ( configUSE_PER_CORE_TICKS == 1 )
+    BaseType_t xTaskIncrementCoreTick( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS AN
  * INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
@@ -3600,6 +3717,19 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
  */
 TickType_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS USED BY THE
+ * QUEUE STATISTICS AND MUST BE CALLED FROM A CRITICAL SECTION.
+ *
+ * Returns the number of times the calling core has asked another core to
+ * yield.  Comparing the count from before and after a call to
+ * xTaskRemoveFromEventList() tells whether the task it unblocked is going to
+ * run on another core.
+ */
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    UBaseType_t uxTaskGetRemoteYieldCount( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Return the handle of the calling task.
  */
@@ -3691,6 +3821,21 @@ void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder,
     eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * Only available when configUSE_TICKLESS_IDLE is set to 1 in an SMP build.
+ *
+ * In SMP builds the scheduler is not suspended around
+ * portSUPPRESS_TICKS_AND_SLEEP(), as that would stop every other core from
+ * scheduling too.  Instead the port calls eTaskConfirmSleepModeStatus(),
+ * xTaskGetExpectedIdleTime() and vTaskStepTick() with interrupts masked from
+ * within taskENTER_CRITICAL_FROM_ISR().  xTaskGetExpectedIdleTime() returns the
+ * number of ticks until the next delayed task is due to unblock, or 0 if a
+ * ready task is waiting for the calling core.
+ */
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+    TickType_t xTaskGetExpectedIdleTime( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * For internal use only.  Increment the mutex held count when a mutex is
  * taken and return the handle of the task that has taken the mutex.
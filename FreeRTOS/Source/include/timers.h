@@ -451,6 +451,8 @@ BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  *
  * Simply returns the handle of the timer service/daemon task.  It it not valid
  * to call xTimerGetTimerDaemonTaskHandle() before the scheduler has been started.
+ * When configUSE_PER_CORE_TIMER_TASKS is set to 1 there is a timer service task
+ * on every core, and the one of the calling core is returned.
  */
 TaskHandle_t xTimerGetTimerDaemonTaskHandle( void ) PRIVILEGED_FUNCTION;
 
@@ -1328,6 +1330,40 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+/**
+ * void vTimerSetCore( TimerHandle_t xTimer, BaseType_t xCoreID );
+ *
+ * Only available when configUSE_PER_CORE_TIMER_TASKS is set to 1.
+ *
+ * Moves a timer to the timer service task of core xCoreID, so its commands
+ * are queued to that task and its callback runs on that core.  A timer
+ * belongs to the core it was created on until this is called.  The timer must
+ * be dormant, and no command for it may be waiting in a timer command queue,
+ * so call this before the timer is first started or after it has been
+ * stopped and the stop command has been processed.
+ *
+ * @param xTimer The handle of the timer being moved.
+ *
+ * @param xCoreID The core whose timer service task will run the timer.
+ */
+#if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+    void vTimerSetCore( TimerHandle_t xTimer,
+                        BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * BaseType_t xTimerGetCore( TimerHandle_t xTimer );
+ *
+ * Only available when configUSE_PER_CORE_TIMER_TASKS is set to 1.
+ *
+ * @param xTimer The handle of the timer being queried.
+ *
+ * @return The core whose timer service task runs the timer.
+ */
+#if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+    BaseType_t xTimerGetCore( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * BaseType_t xTimerGetStaticBuffer( TimerHandle_t xTimer,
  *                                   StaticTimer_t ** ppxTimerBuffer );
@@ -1401,6 +1437,28 @@ BaseType_t xTimerGenericCommandFromISR( TimerHandle_t xTimer,
                                          StackType_t ** ppxTimerTaskStackBuffer,
                                          configSTACK_DEPTH_TYPE * puxTimerTaskStackSize );
 
+/**
+ * timers.h
+ * @code{c}
+ * void vApplicationGetCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer, StackType_t ** ppxTimerTaskStackBuffer, configSTACK_DEPTH_TYPE * puxTimerTaskStackSize, BaseType_t xCoreID )
+ * @endcode
+ *
+ * This function is used to provide statically allocated blocks of memory to FreeRTOS to hold the Timer Task TCBs of
+ * cores 1 to ( configNUMBER_OF_CORES - 1 ) when configUSE_PER_CORE_TIMER_TASKS is set to 1.  The Timer Task of core 0
+ * still gets its memory from vApplicationGetTimerTaskMemory().
+ *
+ * @param ppxTimerTaskTCBBuffer   A handle to a statically allocated TCB buffer
+ * @param ppxTimerTaskStackBuffer A handle to a statically allocated Stack buffer for the timer task
+ * @param puxTimerTaskStackSize   A pointer to the number of elements that will fit in the allocated stack buffer
+ * @param xCoreID                 The core the timer task is created for
+ */
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+        void vApplicationGetCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                                 StackType_t ** ppxTimerTaskStackBuffer,
+                                                 configSTACK_DEPTH_TYPE * puxTimerTaskStackSize,
+                                                 BaseType_t xCoreID );
+    #endif
+
 #endif
 
 #if ( configUSE_DAEMON_TASK_STARTUP_HOOK != 0 )
@@ -0,0 +1,506 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include "mpmc_queue.h"
+
+/* The MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+ * to include MPMC queue functionality.  This #if is closed at the very bottom of
+ * this file.  If you want to include MPMC queues then ensure
+ * configUSE_MPMC_QUEUES is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_MPMC_QUEUES == 1 )
+
+/* A slot of the ring.  ulSequence equals the position of the slot while it is
+ * free for the producer that claims that position, the position + 1 while it
+ * holds the item for the consumer of that position, and the position + the
+ * queue length once that consumer has emptied it again. */
+    typedef struct MpmcCell
+    {
+        volatile uint32_t ulSequence;
+        uint8_t ucItem[]; /**< uxItemSize bytes, padded to a multiple of the sequence word. */
+    } MpmcCell_t;
+
+/* Producers only write ulEnqueuePosition and consumers only write
+ * ulDequeuePosition, so each gets a cache line of its own. */
+    typedef struct MpmcQueueDefinition
+    {
+        uint8_t * pucCells;
+        uint32_t ulMask;                      /**< Queue length - 1, the length is a power of two. */
+        size_t xCellSize;
+        size_t xItemSize;
+        SemaphoreHandle_t xItemsAvailable;    /**< Given for the receivers blocked on an empty queue. */
+        SemaphoreHandle_t xSpaceAvailable;    /**< Given for the senders blocked on a full queue. */
+        volatile uint32_t ulWaitingReceivers; /**< Receivers blocked, or about to block, on xItemsAvailable. */
+        volatile uint32_t ulWaitingSenders;   /**< Senders blocked, or about to block, on xSpaceAvailable. */
+        uint8_t ucPadding0[ portCACHE_LINE_SIZE ];
+        volatile uint32_t ulEnqueuePosition;
+        uint8_t ucPadding1[ portCACHE_LINE_SIZE - sizeof( uint32_t ) ];
+        volatile uint32_t ulDequeuePosition;
+        uint8_t ucPadding2[ portCACHE_LINE_SIZE - sizeof( uint32_t ) ];
+    } MpmcQueue_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Claim the next position to write or read and copy the item, without
+ * blocking.  Return pdPASS, or errQUEUE_FULL/errQUEUE_EMPTY.
+ */
+    static BaseType_t prvTrySend( MpmcQueue_t * const pxQueue,
+                                  const void * pvItemToQueue ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvTryReceive( MpmcQueue_t * const pxQueue,
+                                     void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Wake one of the tasks counted in *pulWaiting, if there is any.  Called after
+ * an item or a slot has been published, which the fence orders before the read
+ * of the count - the waiting task increments the count before it checks the
+ * queue once more, so one of the two always sees the other.
+ */
+    static void prvWakeWaiter( volatile uint32_t * pulWaiting,
+                               SemaphoreHandle_t xSignal,
+                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    static portFORCE_INLINE MpmcCell_t * prvCell( const MpmcQueue_t * const pxQueue,
+                                                  uint32_t ulPosition )
+    {
+        return ( MpmcCell_t * ) &( pxQueue->pucCells[ ( size_t ) ( ulPosition & pxQueue->ulMask ) * pxQueue->xCellSize ] );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvTrySend( MpmcQueue_t * const pxQueue,
+                                  const void * pvItemToQueue )
+    {
+        uint32_t ulPosition = pxQueue->ulEnqueuePosition;
+        MpmcCell_t * pxCell;
+        int32_t lDifference;
+
+        for( ; ; )
+        {
+            pxCell = prvCell( pxQueue, ulPosition );
+            lDifference = ( int32_t ) ( Atomic_Load_u32_Acquire( &( pxCell->ulSequence ) ) - ulPosition );
+
+            if( lDifference == 0 )
+            {
+                /* The slot is free for this position - claim the position. */
+                if( Atomic_CompareAndSwap_u32( &( pxQueue->ulEnqueuePosition ), ulPosition + 1U, ulPosition ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+                {
+                    break;
+                }
+            }
+            else if( lDifference < 0 )
+            {
+                /* The slot still holds the item written one lap earlier. */
+                return errQUEUE_FULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Another producer got the position first. */
+            ulPosition = pxQueue->ulEnqueuePosition;
+        }
+
+        ( void ) memcpy( pxCell->ucItem, pvItemToQueue, pxQueue->xItemSize );
+        Atomic_Store_u32_Release( &( pxCell->ulSequence ), ulPosition + 1U );
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvTryReceive( MpmcQueue_t * const pxQueue,
+                                     void * pvBuffer )
+    {
+        uint32_t ulPosition = pxQueue->ulDequeuePosition;
+        MpmcCell_t * pxCell;
+        int32_t lDifference;
+
+        for( ; ; )
+        {
+            pxCell = prvCell( pxQueue, ulPosition );
+            lDifference = ( int32_t ) ( Atomic_Load_u32_Acquire( &( pxCell->ulSequence ) ) - ( ulPosition + 1U ) );
+
+            if( lDifference == 0 )
+            {
+                if( Atomic_CompareAndSwap_u32( &( pxQueue->ulDequeuePosition ), ulPosition + 1U, ulPosition ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+                {
+                    break;
+                }
+            }
+            else if( lDifference < 0 )
+            {
+                /* Nothing has been published for this position yet. */
+                return errQUEUE_EMPTY;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            ulPosition = pxQueue->ulDequeuePosition;
+        }
+
+        ( void ) memcpy( pvBuffer, pxCell->ucItem, pxQueue->xItemSize );
+
+        /* Hand the slot to the producer one lap ahead. */
+        Atomic_Store_u32_Release( &( pxCell->ulSequence ), ulPosition + pxQueue->ulMask + 1U );
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWakeWaiter( volatile uint32_t * pulWaiting,
+                               SemaphoreHandle_t xSignal,
+                               BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        portMEMORY_BARRIER();
+
+        if( *pulWaiting != 0U )
+        {
+            if( pxHigherPriorityTaskWoken == NULL )
+            {
+                ( void ) xSemaphoreGive( xSignal );
+            }
+            else
+            {
+                ( void ) xSemaphoreGiveFromISR( xSignal, pxHigherPriorityTaskWoken );
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * The blocking side of xMpmcQueueSend() and xMpmcQueueReceive().  The task
+ * announces itself in *pulWaiting, tries once more so an item or slot published
+ * in the meantime is not missed, and then waits for xSignal.  A signal can be
+ * left over from a task that gave up waiting, so a woken task simply tries
+ * again.
+ */
+    static BaseType_t prvBlockingTry( MpmcQueue_t * const pxQueue,
+                                      void * pvItem,
+                                      TickType_t xTicksToWait,
+                                      BaseType_t xSending )
+    {
+        BaseType_t xReturn;
+        TimeOut_t xTimeOut;
+        volatile uint32_t * const pulWaiting = ( xSending != pdFALSE ) ? &( pxQueue->ulWaitingSenders ) : &( pxQueue->ulWaitingReceivers );
+        const SemaphoreHandle_t xSignal = ( xSending != pdFALSE ) ? pxQueue->xSpaceAvailable : pxQueue->xItemsAvailable;
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        for( ; ; )
+        {
+            ( void ) Atomic_Increment_u32( pulWaiting );
+
+            xReturn = ( xSending != pdFALSE ) ? prvTrySend( pxQueue, pvItem ) : prvTryReceive( pxQueue, pvItem );
+
+            if( xReturn != pdPASS )
+            {
+                ( void ) xSemaphoreTake( xSignal, xTicksToWait );
+            }
+
+            ( void ) Atomic_Decrement_u32( pulWaiting );
+
+            if( xReturn == pdPASS )
+            {
+                break;
+            }
+
+            xReturn = ( xSending != pdFALSE ) ? prvTrySend( pxQueue, pvItem ) : prvTryReceive( pxQueue, pvItem );
+
+            if( ( xReturn == pdPASS ) || ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) )
+            {
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        MpmcQueueHandle_t xMpmcQueueCreate( UBaseType_t uxQueueLength,
+                                            UBaseType_t uxItemSize )
+        {
+            MpmcQueue_t * pxQueue;
+            uint32_t ulLength = 1U;
+            size_t xCellSize;
+            uint32_t ul;
+
+            configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+            configASSERT( uxQueueLength <= ( UBaseType_t ) 0x40000000U );
+            configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+            while( ulLength < ( uint32_t ) uxQueueLength )
+            {
+                ulLength <<= 1;
+            }
+
+            /* Keep the sequence word of every cell aligned. */
+            xCellSize = ( sizeof( MpmcCell_t ) + ( size_t ) uxItemSize + sizeof( uint32_t ) - 1U ) & ~( sizeof( uint32_t ) - 1U );
+
+            /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+            /* coverity[misra_c_2012_rule_11_5_violation] */
+            pxQueue = ( MpmcQueue_t * ) pvPortMalloc( sizeof( MpmcQueue_t ) + ( ( size_t ) ulLength * xCellSize ) );
+
+            if( pxQueue != NULL )
+            {
+                pxQueue->pucCells = ( ( uint8_t * ) pxQueue ) + sizeof( MpmcQueue_t );
+                pxQueue->ulMask = ulLength - 1U;
+                pxQueue->xCellSize = xCellSize;
+                pxQueue->xItemSize = ( size_t ) uxItemSize;
+                pxQueue->ulWaitingReceivers = 0U;
+                pxQueue->ulWaitingSenders = 0U;
+                pxQueue->ulEnqueuePosition = 0U;
+                pxQueue->ulDequeuePosition = 0U;
+
+                for( ul = 0U; ul < ulLength; ul++ )
+                {
+                    prvCell( pxQueue, ul )->ulSequence = ul;
+                }
+
+                /* The signals only count wake ups, so they never need to saturate. */
+                pxQueue->xItemsAvailable = xSemaphoreCreateCounting( ~( UBaseType_t ) 0U, 0U );
+                pxQueue->xSpaceAvailable = xSemaphoreCreateCounting( ~( UBaseType_t ) 0U, 0U );
+
+                if( ( pxQueue->xItemsAvailable == NULL ) || ( pxQueue->xSpaceAvailable == NULL ) )
+                {
+                    if( pxQueue->xItemsAvailable != NULL )
+                    {
+                        vSemaphoreDelete( pxQueue->xItemsAvailable );
+                    }
+
+                    if( pxQueue->xSpaceAvailable != NULL )
+                    {
+                        vSemaphoreDelete( pxQueue->xSpaceAvailable );
+                    }
+
+                    vPortFree( pxQueue );
+                    pxQueue = NULL;
+                }
+                else
+                {
+                    /* The cells must be initialised before the handle is
+                     * passed to other cores. */
+                    portMEMORY_BARRIER();
+                }
+            }
+
+            return pxQueue;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        void vMpmcQueueDelete( MpmcQueueHandle_t xQueue )
+        {
+            MpmcQueue_t * const pxQueue = xQueue;
+
+            configASSERT( pxQueue );
+            configASSERT( ( pxQueue->ulWaitingReceivers == 0U ) && ( pxQueue->ulWaitingSenders == 0U ) );
+
+            vSemaphoreDelete( pxQueue->xItemsAvailable );
+            vSemaphoreDelete( pxQueue->xSpaceAvailable );
+            vPortFree( pxQueue );
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMpmcQueueSend( MpmcQueueHandle_t xQueue,
+                               const void * pvItemToQueue,
+                               TickType_t xTicksToWait )
+    {
+        MpmcQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0U ) ) );
+        }
+        #endif
+
+        xReturn = prvTrySend( pxQueue, pvItemToQueue );
+
+        if( ( xReturn != pdPASS ) && ( xTicksToWait != ( TickType_t ) 0U ) )
+        {
+            /* Casting away const is safe, the sending side only reads the item. */
+            xReturn = prvBlockingTry( pxQueue, ( void * ) pvItemToQueue, xTicksToWait, pdTRUE );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            prvWakeWaiter( &( pxQueue->ulWaitingReceivers ), pxQueue->xItemsAvailable, NULL );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMpmcQueueReceive( MpmcQueueHandle_t xQueue,
+                                  void * pvBuffer,
+                                  TickType_t xTicksToWait )
+    {
+        MpmcQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0U ) ) );
+        }
+        #endif
+
+        xReturn = prvTryReceive( pxQueue, pvBuffer );
+
+        if( ( xReturn != pdPASS ) && ( xTicksToWait != ( TickType_t ) 0U ) )
+        {
+            xReturn = prvBlockingTry( pxQueue, pvBuffer, xTicksToWait, pdFALSE );
+        }
+
+        if( xReturn == pdPASS )
+        {
+            prvWakeWaiter( &( pxQueue->ulWaitingSenders ), pxQueue->xSpaceAvailable, NULL );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMpmcQueueSendFromISR( MpmcQueueHandle_t xQueue,
+                                      const void * pvItemToQueue,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        MpmcQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+        BaseType_t xWoken = pdFALSE;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+
+        xReturn = prvTrySend( pxQueue, pvItemToQueue );
+
+        if( xReturn == pdPASS )
+        {
+            prvWakeWaiter( &( pxQueue->ulWaitingReceivers ), pxQueue->xItemsAvailable, &xWoken );
+        }
+
+        if( ( pxHigherPriorityTaskWoken != NULL ) && ( xWoken != pdFALSE ) )
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMpmcQueueReceiveFromISR( MpmcQueueHandle_t xQueue,
+                                         void * pvBuffer,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        MpmcQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+        BaseType_t xWoken = pdFALSE;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+
+        xReturn = prvTryReceive( pxQueue, pvBuffer );
+
+        if( xReturn == pdPASS )
+        {
+            prvWakeWaiter( &( pxQueue->ulWaitingSenders ), pxQueue->xSpaceAvailable, &xWoken );
+        }
+
+        if( ( pxHigherPriorityTaskWoken != NULL ) && ( xWoken != pdFALSE ) )
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxMpmcQueueMessagesWaiting( MpmcQueueHandle_t xQueue )
+    {
+        const MpmcQueue_t * const pxQueue = xQueue;
+        uint32_t ulDequeued;
+        uint32_t ulCount;
+
+        configASSERT( pxQueue );
+
+        /* Read the consumer position first so the difference cannot go
+         * negative, and clamp it as producers may have moved on meanwhile. */
+        ulDequeued = Atomic_Load_u32_Acquire( &( pxQueue->ulDequeuePosition ) );
+        ulCount = pxQueue->ulEnqueuePosition - ulDequeued;
+
+        if( ulCount > ( pxQueue->ulMask + 1U ) )
+        {
+            ulCount = pxQueue->ulMask + 1U;
+        }
+
+        return ( UBaseType_t ) ulCount;
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include MPMC queue functionality.  If you want to include MPMC queues then
+ * ensure configUSE_MPMC_QUEUES is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_MPMC_QUEUES == 1 */
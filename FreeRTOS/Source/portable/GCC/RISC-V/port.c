@@ -34,10 +34,18 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "portmacro.h"
+#include "atomic.h"
 #include <stdbool.h>
 
 /* Standard includes. */
 #include "string.h"
+#include <stddef.h>
+
+/* The spinlocks below are built on atomic.h, which must not fall back to
+ * critical sections here. */
+#if (portHAS_NATIVE_ATOMICS != 1)
+#error "The RISC-V port needs the A extension"
+#endif
 
 /* Let the user override the pre-loading of the initial RA. */
 #ifdef configTASK_RETURN_ADDRESS
@@ -46,12 +54,7 @@
 #define portTASK_RETURN_ADDRESS 0
 #endif
 
-/* Used to keep track of the number of nested calls to taskENTER_CRITICAL(). */
-// size_t volatile pxCriticalNesting[ configNUMBER_OF_CORES ] = { 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa };
-
-
 UBaseType_t const ullMachineSoftwareInterruptRegisterBase = configMSIP_BASE_ADDRESS;
-volatile BaseType_t xYieldRequest[configNUMBER_OF_CORES] = {pdFALSE};
 
 extern void freertos_risc_v_trap_handler(void);
 
@@ -59,7 +62,6 @@ extern void freertos_risc_v_trap_handler(void);
 /* The stack used by interrupt service routines. */
 #if ( configNUMBER_OF_CORES > 1 )
     __attribute__((aligned(16))) StackType_t xISRStack[ configNUMBER_OF_CORES ][ configISR_STACK_SIZE_WORDS ];
-    const size_t xSingleISRStackSizeInBytes = configISR_STACK_SIZE_WORDS * sizeof( StackType_t );
 #else
     #ifdef configISR_STACK_SIZE_WORDS
         static __attribute__((aligned(16))) StackType_t xISRStack[ configISR_STACK_SIZE_WORDS ] = { 0 };
@@ -79,14 +81,46 @@ void vPortSetupTimerInterrupt(void) __attribute__((weak));
 
 /*-----------------------------------------------------------*/
 
-/* Used to program the machine timer compare register. */
+/* The hart whose machine timer increments the tick count. */
+#define portTICK_CORE 0
+
+/* Used to program the machine timer compare register.  The tick interrupt
+ * indexes ullNextTime and the compare registers by mhartid, so each hart that
+ * takes timer interrupts keeps its own next compare value. */
 volatile uint32_t ullPortSchedularRunning = false;
-volatile uint64_t ullNextTime = 0ULL;
-const uint64_t *pullNextTime = &ullNextTime;
+volatile uint64_t ullNextTime[configNUMBER_OF_CORES] = {0ULL};
+const uint64_t *pullNextTime = ullNextTime;
 const size_t uxTimerIncrementsForOneTick = (size_t)((configCPU_CLOCK_HZ) / (configTICK_RATE_HZ));
 UBaseType_t const ullMachineTimerCompareRegisterBase = configMTIMECMP_BASE_ADDRESS;
 volatile uint64_t *pullMachineTimerCompareRegister = NULL;
 
+#if (configUSE_PER_CORE_TICKS == 1)
+
+/* The time of the first tick.  The ticks of the other harts stay in phase
+ * with it, but run portCORE_TICK_OFFSET behind, so that the tick core has
+ * normally incremented the tick count by the time they process it. */
+static uint64_t ullFirstTickTime = 0ULL;
+
+#define portCORE_TICK_OFFSET ((uint64_t)(uxTimerIncrementsForOneTick / 8U))
+
+#endif /* configUSE_PER_CORE_TICKS */
+
+/* The CPU-local block of every hart, see portmacro.h.  The assembly code
+ * reaches the first fields through the portCPU_LOCAL_* offsets in
+ * portContext.h, which must match. */
+PortCpuLocal_t xPortCpuLocal[configNUMBER_OF_CORES];
+
+_Static_assert(offsetof(PortCpuLocal_t, pxISRStackTop) == 0 * sizeof(UBaseType_t), "portCPU_LOCAL_ISR_STACK_TOP");
+_Static_assert(offsetof(PortCpuLocal_t, uxCoreID) == 1 * sizeof(UBaseType_t), "portCPU_LOCAL_CORE_ID");
+_Static_assert(offsetof(PortCpuLocal_t, ppxCurrentTCB) == 2 * sizeof(UBaseType_t), "portCPU_LOCAL_CURRENT_TCB");
+_Static_assert(offsetof(PortCpuLocal_t, pvFPUContext) == 4 * sizeof(UBaseType_t), "portCPU_LOCAL_FPU_CONTEXT");
+_Static_assert(offsetof(PortCpuLocal_t, pvFPUOwner) == 5 * sizeof(UBaseType_t), "portCPU_LOCAL_FPU_OWNER");
+_Static_assert(offsetof(PortCpuLocal_t, uxTrapStart) == 6 * sizeof(UBaseType_t), "portCPU_LOCAL_TRAP_START");
+_Static_assert(offsetof(PortCpuLocal_t, uxTraps) == 7 * sizeof(UBaseType_t), "portCPU_LOCAL_TRAPS");
+_Static_assert(offsetof(PortCpuLocal_t, uxTrapEntryCycles) == 8 * sizeof(UBaseType_t), "portCPU_LOCAL_TRAP_ENTRY_CYCLES");
+_Static_assert(offsetof(PortCpuLocal_t, uxTrapExitCycles) == 9 * sizeof(UBaseType_t), "portCPU_LOCAL_TRAP_EXIT_CYCLES");
+_Static_assert(offsetof(PortCpuLocal_t, uxTrapFastReturns) == 10 * sizeof(UBaseType_t), "portCPU_LOCAL_TRAP_FAST_RETURNS");
+
 /* Used to catch tasks that attempt to return from their implementing function. */
 size_t xTaskReturnAddress = (size_t)portTASK_RETURN_ADDRESS;
 
@@ -94,13 +128,11 @@ size_t xTaskReturnAddress = (size_t)portTASK_RETURN_ADDRESS;
 
 #if (configMTIME_BASE_ADDRESS != 0) && (configMTIMECMP_BASE_ADDRESS != 0)
 
-void vPortSetupTimerInterrupt(void)
+static uint64_t prvReadMachineTime(void)
 {
-    uint32_t ulCurrentTimeHigh, ulCurrentTimeLow;
     volatile uint32_t *const pulTimeHigh = (volatile uint32_t *const)((configMTIME_BASE_ADDRESS) + 4UL);
     volatile uint32_t *const pulTimeLow = (volatile uint32_t *const)(configMTIME_BASE_ADDRESS);
-
-    pullMachineTimerCompareRegister = (volatile uint64_t *)(ullMachineTimerCompareRegisterBase);
+    uint32_t ulCurrentTimeHigh, ulCurrentTimeLow;
 
     do
     {
@@ -108,32 +140,96 @@ void vPortSetupTimerInterrupt(void)
         ulCurrentTimeLow = *pulTimeLow;
     } while (ulCurrentTimeHigh != *pulTimeHigh);
 
-    ullNextTime = (uint64_t)ulCurrentTimeHigh;
-    ullNextTime <<= 32ULL;
-    ullNextTime |= (uint64_t)ulCurrentTimeLow;
-    ullNextTime += (uint64_t)uxTimerIncrementsForOneTick;
+    return ((uint64_t)ulCurrentTimeHigh << 32ULL) | (uint64_t)ulCurrentTimeLow;
+}
+
+static void prvWriteMachineTimerCompare(BaseType_t xHart, uint64_t ullCompare)
+{
+    volatile uint32_t *const pulCompare = (volatile uint32_t *)(ullMachineTimerCompareRegisterBase + ((UBaseType_t)xHart * sizeof(uint64_t)));
+
+    /* Same order as portUPDATE_MTIMER_COMPARE_REGISTER, so the compare value
+     * never passes through a value lower than both the old and new ones. */
+    pulCompare[0] = 0xFFFFFFFFUL;
+    pulCompare[1] = (uint32_t)(ullCompare >> 32ULL);
+    pulCompare[0] = (uint32_t)ullCompare;
+}
+
+void vPortSetupTimerInterrupt(void)
+{
     volatile uint32_t ulHartId;
     __asm volatile("csrr %0, mhartid" : "=r"(ulHartId));
-    volatile uint64_t * registers_base_address;
-    registers_base_address = pullMachineTimerCompareRegister + ulHartId;
-    *registers_base_address = ullNextTime;
+
+    pullMachineTimerCompareRegister = (volatile uint64_t *)(ullMachineTimerCompareRegisterBase);
+
+    ullNextTime[ulHartId] = prvReadMachineTime() + (uint64_t)uxTimerIncrementsForOneTick;
+    prvWriteMachineTimerCompare((BaseType_t)ulHartId, ullNextTime[ulHartId]);
+
+    #if (configUSE_PER_CORE_TICKS == 1)
+    {
+        ullFirstTickTime = ullNextTime[ulHartId];
+    }
+    #endif
 
     /* Prepare the time to use after the next tick interrupt. */
-    ullNextTime += (uint64_t)uxTimerIncrementsForOneTick;
+    ullNextTime[ulHartId] += (uint64_t)uxTimerIncrementsForOneTick;
 }
 
+#if (configUSE_PER_CORE_TICKS == 1)
+
+/* Start the tick of a hart other than the tick core on the next boundary
+ * that has not passed yet. */
+static void prvSetupCoreTimerInterrupt(BaseType_t xHart)
+{
+    const uint64_t ullNow = prvReadMachineTime();
+    uint64_t ullNextTick = ullFirstTickTime + portCORE_TICK_OFFSET;
+
+    if (ullNow >= ullNextTick)
+    {
+        ullNextTick += (((ullNow - ullNextTick) / uxTimerIncrementsForOneTick) + 1U) * (uint64_t)uxTimerIncrementsForOneTick;
+    }
+
+    prvWriteMachineTimerCompare(xHart, ullNextTick);
+    ullNextTime[xHart] = ullNextTick + (uint64_t)uxTimerIncrementsForOneTick;
+}
+
+#endif /* configUSE_PER_CORE_TICKS */
+
 #endif /* ( configMTIME_BASE_ADDRESS != 0 ) && ( configMTIME_BASE_ADDRESS != 0 ) */
 
 /*-----------------------------------------------------------*/
 
+/* Fills in the CPU-local block of the calling hart and points mscratch at it.
+ * Must run before the hart takes its first trap. */
+static void prvSetupCpuLocal(void)
+{
+    extern void *volatile pxCurrentTCBs[configNUMBER_OF_CORES];
+    const BaseType_t xCoreID = portGET_CORE_ID();
+    PortCpuLocal_t *pxCpuLocal = &(xPortCpuLocal[xCoreID]);
+
+    #if (configNUMBER_OF_CORES > 1)
+    {
+        pxCpuLocal->pxISRStackTop = &(xISRStack[xCoreID][configISR_STACK_SIZE_WORDS]);
+    }
+    #else
+    {
+        pxCpuLocal->pxISRStackTop = (StackType_t *)xISRStackTop;
+    }
+    #endif
+    pxCpuLocal->uxCoreID = (UBaseType_t)xCoreID;
+    pxCpuLocal->ppxCurrentTCB = &(pxCurrentTCBs[xCoreID]);
+
+    __asm volatile("csrw mscratch, %0" ::"r"(pxCpuLocal) : "memory");
+}
+
 BaseType_t xPortStartScheduler(void)
 {
     extern void xPortStartFirstTask(void);
-    BaseType_t xCore = rtos_core_id_get();
+    BaseType_t xCore = portGET_CORE_ID();
 
     uintptr_t trap_addr = ((uintptr_t)freertos_risc_v_trap_handler);
     __asm__ volatile("csrw mtvec, %0" ::"r"(trap_addr));
 
+    prvSetupCpuLocal();
     vPortSetupTimerInterrupt();
 
 
@@ -155,6 +251,7 @@ BaseType_t xPortStartSchedulerOncore(void){
 
     uintptr_t trap_addr = ((uintptr_t)freertos_risc_v_trap_handler);
     __asm__ volatile("csrw mtvec, %0" ::"r"(trap_addr));
+    prvSetupCpuLocal();
     // vPortSetupTimerInterrupt();
 
     while (!ullPortSchedularRunning)
@@ -162,7 +259,13 @@ BaseType_t xPortStartSchedulerOncore(void){
         __asm__ volatile("fence");
     }
 
-    #if ((configMTIME_BASE_ADDRESS != 0) && (configMTIMECMP_BASE_ADDRESS != 0))
+    #if ((configMTIME_BASE_ADDRESS != 0) && (configMTIMECMP_BASE_ADDRESS != 0) && (configUSE_PER_CORE_TICKS == 1))
+    {
+        /* Every hart takes its own tick interrupt. */
+        prvSetupCoreTimerInterrupt(portGET_CORE_ID());
+        __asm volatile("csrs mie, %0" ::"r"(0x88U));
+    }
+    #elif ((configMTIME_BASE_ADDRESS != 0) && (configMTIMECMP_BASE_ADDRESS != 0))
     {
 
         __asm volatile("csrs mie, %0" ::"r"(0x8U));  
@@ -187,114 +290,1103 @@ void vPortEndScheduler(void)
 /* SMP utilities */
 BaseType_t rtos_core_id_get(void)
 {
-    int xCoreID;
+    return xPortGetCoreID();
+}
 
-    __asm volatile("csrr %0, mhartid" : "=r"(xCoreID));
+/*-----------------------------------------------------------*/
 
-    return xCoreID;
+/* Spinlocks */
+
+#if (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_TAS)
+
+static inline BaseType_t prvSpinlockIsFree(const PortSpinlock_t *pxLock)
+{
+    return (pxLock->ulLock == 0U) ? pdTRUE : pdFALSE;
 }
 
-void vPortYieldOtherCore(UBaseType_t xCoreID)
+BaseType_t xPortSpinlockTryTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
 {
-    if (xCoreID < (UBaseType_t)configNUMBER_OF_CORES)
+    return (Atomic_Swap_u32_Acquire(&pxLock->ulLock, (uint32_t)xCoreID + 1U) == 0U) ? pdTRUE : pdFALSE;
+}
+
+void vPortSpinlockTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    for (;;)
     {
-        xYieldRequest[xCoreID] = pdTRUE;
-        volatile uint32_t *pulMSIPRegister = (volatile uint32_t *)(configMSIP_BASE_ADDRESS + (xCoreID * 4));
-        *pulMSIPRegister = 1UL;
+        if (xPortSpinlockTryTake(pxLock, xCoreID) != pdFALSE)
+        {
+            return;
+        }
+
+        /* Wait with plain loads so the line stays shared between the waiting
+         * harts until the owner releases it. */
+        while (pxLock->ulLock != 0U)
+        {
+        }
     }
 }
 
-volatile uint32_t xIsrLock = 0;
-volatile uint32_t xTaskLock = 0;
+void vPortSpinlockGive(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    (void)xCoreID;
+    configASSERT(pxLock->ulLock == (uint32_t)xCoreID + 1U);
+    Atomic_Store_u32_Release(&pxLock->ulLock, 0U);
+}
+
+#elif (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_TICKET)
 
-uint8_t ucOwnedByCore[configNUMBER_OF_CORES][2] = {0};
-uint8_t ucRecursionCount[configNUMBER_OF_CORES][2] = {0};
+static inline BaseType_t prvSpinlockIsFree(const PortSpinlock_t *pxLock)
+{
+    return (pxLock->ulNextTicket == pxLock->ulNowServing) ? pdTRUE : pdFALSE;
+}
 
-bool SpinTryLock(volatile uint32_t *lock)
+BaseType_t xPortSpinlockTryTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
 {
-    uint32_t ulHartId = rtos_core_id_get() + 1;
-    uint32_t ulPrevVal;
+    uint32_t ulTicket = pxLock->ulNowServing;
 
-    __asm__ volatile(
-        "amoswap.w.aqrl %0, %2, %1"
-        : "=r"(ulPrevVal), "+A"(*lock)
-        : "r"(ulHartId)
-        : "memory");
+    (void)xCoreID;
 
-    return (ulPrevVal == 0);
+    /* Only take a ticket when it would be served straight away. */
+    return (Atomic_CompareAndSwap_u32_Acquire(&pxLock->ulNextTicket, ulTicket + 1U, ulTicket) == ATOMIC_COMPARE_AND_SWAP_SUCCESS) ? pdTRUE : pdFALSE;
 }
 
-void SpinLock(volatile uint32_t *lock)
+void vPortSpinlockTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
 {
-    for (;;)
+    uint32_t ulTicket;
+
+    (void)xCoreID;
+
+    ulTicket = Atomic_Increment_u32(&pxLock->ulNextTicket);
+
+    while (pxLock->ulNowServing != ulTicket)
     {
-        if (SpinTryLock(lock))
+    }
+
+    __asm__ volatile("fence r, rw" ::: "memory");
+}
+
+void vPortSpinlockGive(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    (void)xCoreID;
+
+    /* Only the owner writes ulNowServing, so a plain increment is enough. */
+    Atomic_Store_u32_Release(&pxLock->ulNowServing, pxLock->ulNowServing + 1U);
+}
+
+#elif (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_MCS)
+
+typedef struct xPORT_MCS_NODE
+{
+    struct xPORT_MCS_NODE *volatile pxNext;   /* Next hart in the wait queue. */
+    volatile uint32_t ulLocked;               /* Cleared by the predecessor to pass the lock on. */
+    uint32_t ulInUse;                         /* Only accessed by the hart that owns the node. */
+} portCACHE_LINE_ALIGNED PortMcsNode_t;
+
+static PortMcsNode_t xMcsNodes[configNUMBER_OF_CORES][configPORT_MCS_NODES_PER_CORE];
+
+static inline PortMcsNode_t *prvSwapTail(PortSpinlock_t *pxLock, PortMcsNode_t *pxNew)
+{
+    return (PortMcsNode_t *)Atomic_SwapPointers_p32((void *volatile *)&(pxLock->pxTail), pxNew);
+}
+
+static inline BaseType_t prvCompareAndSwapTail(PortSpinlock_t *pxLock, PortMcsNode_t *pxExpected, PortMcsNode_t *pxNew)
+{
+    return (Atomic_CompareAndSwapPointers_p32((void *volatile *)&(pxLock->pxTail), pxNew, pxExpected) == ATOMIC_COMPARE_AND_SWAP_SUCCESS) ? pdTRUE : pdFALSE;
+}
+
+static inline BaseType_t prvSpinlockIsFree(const PortSpinlock_t *pxLock)
+{
+    return (pxLock->pxTail == NULL) ? pdTRUE : pdFALSE;
+}
+
+static PortMcsNode_t *prvAllocateMcsNode(BaseType_t xCoreID)
+{
+    UBaseType_t x;
+
+    for (x = 0; x < configPORT_MCS_NODES_PER_CORE; x++)
+    {
+        if (xMcsNodes[xCoreID][x].ulInUse == 0U)
         {
+            xMcsNodes[xCoreID][x].ulInUse = 1U;
+            xMcsNodes[xCoreID][x].pxNext = NULL;
+            xMcsNodes[xCoreID][x].ulLocked = 1U;
+            return &(xMcsNodes[xCoreID][x]);
+        }
+    }
+
+    /* More locks held at once than configPORT_MCS_NODES_PER_CORE. */
+    configASSERT(pdFALSE);
+    return NULL;
+}
+
+BaseType_t xPortSpinlockTryTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    PortMcsNode_t *pxNode;
+
+    if (pxLock->pxTail != NULL)
+    {
+        return pdFALSE;
+    }
+
+    pxNode = prvAllocateMcsNode(xCoreID);
+
+    if (prvCompareAndSwapTail(pxLock, NULL, pxNode) == pdFALSE)
+    {
+        pxNode->ulInUse = 0U;
+        return pdFALSE;
+    }
+
+    pxLock->pxOwnerNode = pxNode;
+    return pdTRUE;
+}
+
+void vPortSpinlockTake(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    PortMcsNode_t *pxNode = prvAllocateMcsNode(xCoreID);
+    PortMcsNode_t *pxPredecessor;
+
+    pxPredecessor = prvSwapTail(pxLock, pxNode);
+
+    if (pxPredecessor != NULL)
+    {
+        /* Queue behind the previous tail and spin on our own cache line. */
+        pxPredecessor->pxNext = pxNode;
+
+        while (pxNode->ulLocked != 0U)
+        {
+        }
+
+        __asm__ volatile("fence r, rw" ::: "memory");
+    }
+
+    pxLock->pxOwnerNode = pxNode;
+}
+
+void vPortSpinlockGive(PortSpinlock_t *pxLock, BaseType_t xCoreID)
+{
+    PortMcsNode_t *pxNode = pxLock->pxOwnerNode;
+    PortMcsNode_t *pxSuccessor = pxNode->pxNext;
+
+    (void)xCoreID;
+
+    if (pxSuccessor == NULL)
+    {
+        /* Nobody queued behind us - try to mark the lock free. */
+        if (prvCompareAndSwapTail(pxLock, pxNode, NULL) != pdFALSE)
+        {
+            pxNode->ulInUse = 0U;
             return;
         }
+
+        /* A hart swapped itself in as the tail but has not linked itself
+         * behind us yet. */
+        while ((pxSuccessor = pxNode->pxNext) == NULL)
+        {
+        }
     }
+
+    Atomic_Store_u32_Release(&(pxSuccessor->ulLocked), 0U);
+    pxNode->ulInUse = 0U;
 }
 
-void SpinUnlock(volatile uint32_t *lock)
+#endif /* configPORT_SPINLOCK_TYPE */
+
+void vPortSpinlockInit(PortSpinlock_t *pxLock)
 {
+    memset((void *)pxLock, 0, sizeof(PortSpinlock_t));
     portMEMORY_BARRIER();
-    __asm__ volatile("amoswap.w.rl zero, zero, %0" : : "A"(*lock) : "memory");
 }
 
+/*-----------------------------------------------------------*/
+
+/* The two kernel locks each get a cache line of their own, so harts waiting
+ * for one do not disturb the owner of the other. */
+static portCACHE_LINE_ALIGNED PortSpinlock_t xIsrLock = portSPINLOCK_STATIC_INIT;
+static portCACHE_LINE_ALIGNED PortSpinlock_t xTaskLock = portSPINLOCK_STATIC_INIT;
+
+/* Ownership and recursion depth of the kernel locks are kept in the
+ * CPU-local block, which only its own hart writes. */
+static inline BaseType_t prvHoldsKernelLock(BaseType_t xCoreID)
+{
+    return ((xPortCpuLocal[xCoreID].ucOwnedByCore[0] != 0U) || (xPortCpuLocal[xCoreID].ucOwnedByCore[1] != 0U)) ? pdTRUE : pdFALSE;
+}
+
+static void prvSendDeferredIPIs(BaseType_t xCoreID);
+
+#if (configPORT_IRQ_OFF_STATS == 1)
+
+/* Interrupt-off time of the kernel critical sections, from the moment the
+ * hart masked interrupts for the acquisition that got the kernel locks to the
+ * release of the ISR lock (or of the last kernel lock held).  Only written by
+ * the hart it belongs to. */
+typedef struct xPORT_IRQ_OFF_LOCAL
+{
+    uint32_t ulStart;               /* mcycle when the current section masked interrupts. */
+    uint32_t ulArmed;               /* A section is being timed. */
+    uint32_t ulMaxCycles;
+    uint32_t ulTotalCycles;
+    uint32_t ulSections;
+} portCACHE_LINE_ALIGNED PortIrqOffLocal_t;
+
+static PortIrqOffLocal_t xIrqOffLocal[configNUMBER_OF_CORES];
+
+static inline uint32_t prvReadCycles(void)
+{
+    uint32_t ulCycles;
+
+    __asm volatile("csrr %0, mcycle" : "=r"(ulCycles));
+
+    return ulCycles;
+}
+
+static inline void prvIrqOffStart(BaseType_t xCoreID, uint32_t ulStart)
+{
+    if (xIrqOffLocal[xCoreID].ulArmed == 0U)
+    {
+        xIrqOffLocal[xCoreID].ulStart = ulStart;
+        xIrqOffLocal[xCoreID].ulArmed = 1U;
+    }
+}
+
+static inline void prvIrqOffEnd(BaseType_t xCoreID)
+{
+    PortIrqOffLocal_t *pxLocal = &(xIrqOffLocal[xCoreID]);
+    uint32_t ulCycles;
+
+    if (pxLocal->ulArmed != 0U)
+    {
+        ulCycles = prvReadCycles() - pxLocal->ulStart;
+        pxLocal->ulArmed = 0U;
+        pxLocal->ulTotalCycles += ulCycles;
+        pxLocal->ulSections++;
+
+        if (ulCycles > pxLocal->ulMaxCycles)
+        {
+            pxLocal->ulMaxCycles = ulCycles;
+        }
+    }
+}
+
+void vPortGetIrqOffStats(UBaseType_t xCoreID, PortIrqOffStats_t *pxStats)
+{
+    configASSERT(xCoreID < (UBaseType_t)configNUMBER_OF_CORES);
+
+    pxStats->ulMaxCycles = xIrqOffLocal[xCoreID].ulMaxCycles;
+    pxStats->ulTotalCycles = xIrqOffLocal[xCoreID].ulTotalCycles;
+    pxStats->ulSections = xIrqOffLocal[xCoreID].ulSections;
+}
+
+void vPortResetIrqOffStats(void)
+{
+    UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+    PortIrqOffLocal_t *pxLocal = &(xIrqOffLocal[portGET_CORE_ID()]);
+
+    pxLocal->ulMaxCycles = 0U;
+    pxLocal->ulTotalCycles = 0U;
+    pxLocal->ulSections = 0U;
+
+    portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+}
+
+#endif /* configPORT_IRQ_OFF_STATS */
+
 void vPortRecursiveLock(BaseType_t xCoreID,
                         uint32_t ulLockNum,
                         BaseType_t uxAcquire)
 {
-    volatile uint32_t *pulLock = (ulLockNum == 0) ? &xIsrLock : &xTaskLock;
+    PortSpinlock_t *pxLock = (ulLockNum == 0) ? &xIsrLock : &xTaskLock;
+    PortCpuLocal_t *pxState = &(xPortCpuLocal[xCoreID]);
 
-    configASSERT(ulLockNum < 2);
+    configASSERT(ulLockNum < RTOS_LOCK_COUNT);
 
     if (uxAcquire)
     {
-        if (!SpinTryLock(pulLock))
+        /* Only this hart writes its own entry, so the ownership can be
+         * checked before touching the shared lock word. */
+        if (pxState->ucOwnedByCore[ulLockNum])
         {
-            if (ucOwnedByCore[xCoreID][ulLockNum])
+            configASSERT(pxState->ucRecursionCount[ulLockNum] < 255);
+            pxState->ucRecursionCount[ulLockNum]++;
+            return;
+        }
+
+        vPortSpinlockTake(pxLock, xCoreID);
+
+        configASSERT(pxState->ucRecursionCount[ulLockNum] == 0);
+        pxState->ucRecursionCount[ulLockNum] = 1;
+        pxState->ucOwnedByCore[ulLockNum] = 1;
+    }
+    else
+    {
+        configASSERT(pxState->ucOwnedByCore[ulLockNum]);
+        configASSERT(pxState->ucRecursionCount[ulLockNum] > 0);
+
+        if (--(pxState->ucRecursionCount[ulLockNum]) == 0)
+        {
+            pxState->ucOwnedByCore[ulLockNum] = 0;
+            vPortSpinlockGive(pxLock, xCoreID);
+
+            if (prvHoldsKernelLock(xCoreID) == pdFALSE)
             {
-                configASSERT(ucRecursionCount[xCoreID][ulLockNum] < 255);
-                ucRecursionCount[xCoreID][ulLockNum]++;
-                return;
-            }
+                prvSendDeferredIPIs(xCoreID);
 
-            SpinLock(pulLock);
+                #if (configPORT_IRQ_OFF_STATS == 1)
+                prvIrqOffEnd(xCoreID);
+                #endif
+            }
+            #if (configPORT_IRQ_OFF_STATS == 1)
+            else if (ulLockNum == 0)
+            {
+                /* The task lock alone is held with interrupts enabled. */
+                prvIrqOffEnd(xCoreID);
+            }
+            #endif
         }
+    }
+}
+
+#if (configPORT_INTERRUPTIBLE_LOCK_WAIT == 1)
+
+/* Takes kernel lock ulLockNum if it is free right now, without queueing
+ * behind the harts waiting for it.  Only used by a hart that holds neither
+ * kernel lock, with interrupts disabled. */
+static BaseType_t prvTryTakeKernelLock(BaseType_t xCoreID, uint32_t ulLockNum)
+{
+    PortSpinlock_t *pxLock = (ulLockNum == 0) ? &xIsrLock : &xTaskLock;
+    PortCpuLocal_t *pxState = &(xPortCpuLocal[xCoreID]);
+
+    if (xPortSpinlockTryTake(pxLock, xCoreID) == pdFALSE)
+    {
+        return pdFALSE;
+    }
+
+    configASSERT(pxState->ucRecursionCount[ulLockNum] == 0);
+    pxState->ucRecursionCount[ulLockNum] = 1;
+    pxState->ucOwnedByCore[ulLockNum] = 1;
+    return pdTRUE;
+}
+
+/* Polled with interrupts enabled, so the result is only a hint for when to
+ * try again. */
+static BaseType_t prvKernelLocksLookFree(BaseType_t xIncludeIsrLock)
+{
+    if (prvSpinlockIsFree(&xTaskLock) == pdFALSE)
+    {
+        return pdFALSE;
+    }
+
+    if ((xIncludeIsrLock != pdFALSE) && (prvSpinlockIsFree(&xIsrLock) == pdFALSE))
+    {
+        return pdFALSE;
+    }
+
+    return pdTRUE;
+}
+
+#endif /* configPORT_INTERRUPTIBLE_LOCK_WAIT */
+
+BaseType_t xPortTakeKernelLocks(UBaseType_t uxInterruptStatus, BaseType_t xIncludeIsrLock)
+{
+    BaseType_t xCoreID = portGET_CORE_ID();
 
-        configASSERT(ucRecursionCount[xCoreID][ulLockNum] == 0);
-        ucRecursionCount[xCoreID][ulLockNum] = 1;
-        ucOwnedByCore[xCoreID][ulLockNum] = 1;
+    #if (configPORT_IRQ_OFF_STATS == 1)
+    uint32_t ulMasked = prvReadCycles();
+    #endif
+
+    #if (configPORT_INTERRUPTIBLE_LOCK_WAIT == 1)
+    /* Only the outermost acquirer may wait with interrupts enabled.  The task
+     * lock is held with interrupts enabled between vTaskSuspendAll() and
+     * xTaskResumeAll(), and a hart that already owns a kernel lock must keep
+     * it while it waits for the other one, so a nested call takes the fair
+     * masked path below instead. */
+    if ((uxInterruptStatus != 0U) && (prvHoldsKernelLock(xCoreID) == pdFALSE))
+    {
+        for (;;)
+        {
+            if (prvTryTakeKernelLock(xCoreID, 1) != pdFALSE)
+            {
+                if ((xIncludeIsrLock == pdFALSE) || (prvTryTakeKernelLock(xCoreID, 0) != pdFALSE))
+                {
+                    break;
+                }
+
+                /* Give the task lock back before interrupts are enabled: a
+                 * context switch on this hart would otherwise run the next
+                 * task with a lock taken on behalf of this one. */
+                vPortRecursiveLock(xCoreID, 1, pdFALSE);
+            }
+
+            /* A ticket or MCS queue position cannot be kept while interrupts
+             * are enabled either, so wait outside the queue until the locks
+             * look free and then try again with interrupts masked.  Harts
+             * waiting this way are not served in FIFO order. */
+            portCLEAR_INTERRUPT_MASK(uxInterruptStatus);
+
+            while (prvKernelLocksLookFree(xIncludeIsrLock) == pdFALSE)
+            {
+            }
+
+            (void)portSET_INTERRUPT_MASK();
+            xCoreID = portGET_CORE_ID();
+
+            #if (configPORT_IRQ_OFF_STATS == 1)
+            ulMasked = prvReadCycles();
+            #endif
+        }
     }
     else
+    #endif /* configPORT_INTERRUPTIBLE_LOCK_WAIT */
     {
-        configASSERT(ucOwnedByCore[xCoreID][ulLockNum]);
-        configASSERT(ucRecursionCount[xCoreID][ulLockNum] > 0);
+        (void)uxInterruptStatus;
 
-        if (--(ucRecursionCount[xCoreID][ulLockNum]) == 0)
+        vPortRecursiveLock(xCoreID, 1, pdTRUE);
+
+        if (xIncludeIsrLock != pdFALSE)
         {
-            ucOwnedByCore[xCoreID][ulLockNum] = 0;
-            SpinUnlock(pulLock);
+            vPortRecursiveLock(xCoreID, 0, pdTRUE);
         }
     }
+
+    #if (configPORT_IRQ_OFF_STATS == 1)
+    prvIrqOffStart(xCoreID, ulMasked);
+    #endif
+
+    return xCoreID;
 }
 
-BaseType_t xPortTickInterruptHandler(void)
+/*-----------------------------------------------------------*/
+
+#define portALL_HARTS_MASK ((uint32_t)((1ULL << configNUMBER_OF_CORES) - 1ULL))
+
+/* Inter-processor interrupts.  A hart is interrupted through its MSIP bit,
+ * and the senders accumulate the reasons for the interrupt in the hart's
+ * ulReasons word, which the hart collects with a single swap. */
+typedef struct xPORT_IPI_STATE
 {
+    volatile uint32_t ulReasons;    /* portIPI_REASON_* bits not handled yet. */
+} portCACHE_LINE_ALIGNED PortIPIState_t;
+
+static PortIPIState_t xIPIState[configNUMBER_OF_CORES];
+
+/* IPI bookkeeping that is only written by the hart it belongs to. */
+typedef struct xPORT_IPI_LOCAL
+{
+    uint32_t ulDeferred;            /* Harts to interrupt once this hart has released the kernel locks. */
+    uint32_t ulSent;
+    uint32_t ulSuppressed;
+    uint32_t ulReceived;
+} portCACHE_LINE_ALIGNED PortIPILocal_t;
+
+static PortIPILocal_t xIPILocal[configNUMBER_OF_CORES];
+
+static inline volatile uint32_t *prvMSIPRegister(UBaseType_t xCoreID)
+{
+    return (volatile uint32_t *)(ullMachineSoftwareInterruptRegisterBase + (xCoreID * sizeof(uint32_t)));
+}
+
+/* Must be called with interrupts disabled. */
+static void prvRaiseIPIs(BaseType_t xCoreID, uint32_t ulTargets)
+{
+    UBaseType_t uxTarget;
+
+    /* The reasons must be visible before the interrupts are taken. */
+    portMEMORY_BARRIER();
+
+    while (ulTargets != 0U)
+    {
+        uxTarget = (UBaseType_t)__builtin_ctz(ulTargets);
+        *prvMSIPRegister(uxTarget) = 1UL;
+        xIPILocal[xCoreID].ulSent++;
+        ulTargets &= ~(1UL << uxTarget);
+    }
+}
+
+static void prvSendDeferredIPIs(BaseType_t xCoreID)
+{
+    const uint32_t ulTargets = xIPILocal[xCoreID].ulDeferred;
+
+    if (ulTargets != 0U)
+    {
+        xIPILocal[xCoreID].ulDeferred = 0U;
+        prvRaiseIPIs(xCoreID, ulTargets);
+    }
+}
+
+void vPortSendIPI(UBaseType_t xCoreID, uint32_t ulReasons)
+{
+    UBaseType_t uxSavedInterruptStatus;
+    BaseType_t xSelf;
+
+    if (xCoreID < (UBaseType_t)configNUMBER_OF_CORES)
+    {
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+        xSelf = portGET_CORE_ID();
+
+        if (Atomic_OR_u32(&(xIPIState[xCoreID].ulReasons), ulReasons) != 0U)
+        {
+            /* The target has not collected its earlier reasons yet, so the
+             * interrupt raised for those picks these up as well. */
+            xIPILocal[xSelf].ulSuppressed++;
+        }
+        else if (prvHoldsKernelLock(xSelf) != pdFALSE)
+        {
+            /* Interrupted now, the target would most likely just spin on the
+             * kernel lock this hart holds.  The interrupt is raised when the
+             * lock is released instead - by then every other request for the
+             * target made in the meantime has been merged into this one. */
+            xIPILocal[xSelf].ulDeferred |= 1UL << xCoreID;
+        }
+        else
+        {
+            prvRaiseIPIs(xSelf, 1UL << xCoreID);
+        }
+
+        portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+    }
+}
+
+void vPortGetIPIStats(UBaseType_t xCoreID, PortIPIStats_t *pxStats)
+{
+    configASSERT(xCoreID < (UBaseType_t)configNUMBER_OF_CORES);
+
+    pxStats->ulSent = xIPILocal[xCoreID].ulSent;
+    pxStats->ulSuppressed = xIPILocal[xCoreID].ulSuppressed;
+    pxStats->ulReceived = xIPILocal[xCoreID].ulReceived;
+}
+
+void vPortYieldOtherCore(UBaseType_t xCoreID)
+{
+    vPortSendIPI(xCoreID, portIPI_REASON_YIELD);
+}
+
+#if (configUSE_PORT_REMOTE_CALLS == 1)
+
+typedef struct xPORT_REMOTE_CALL
+{
+    PortRemoteFunction_t pxFunction;
+    void *pvParameter;
+    PortRemoteCallCompletion_t *pxCompletion;   /* NULL if nobody waits for the call. */
+} PortRemoteCall_t;
+
+/* The calls queued for a hart.  Any hart adds calls at ulTail, only the
+ * owning hart removes them at ulHead. */
+typedef struct xPORT_MAILBOX
+{
+    PortSpinlock_t xLock;
+    uint32_t ulHead;
+    uint32_t ulTail;
+    PortRemoteCall_t xCalls[configPORT_REMOTE_CALL_QUEUE_LENGTH];
+} portCACHE_LINE_ALIGNED PortMailbox_t;
+
+static PortMailbox_t xMailboxes[configNUMBER_OF_CORES];
+
+/* Must be called with interrupts disabled.  Returns pdFALSE if the mailbox
+ * of the target hart is full. */
+static BaseType_t prvPostRemoteCall(BaseType_t xCoreID, UBaseType_t uxTarget, const PortRemoteCall_t *pxCall)
+{
+    PortMailbox_t *pxMailbox = &(xMailboxes[uxTarget]);
+    BaseType_t xPosted = pdFALSE;
+
+    vPortSpinlockTake(&(pxMailbox->xLock), xCoreID);
+    {
+        if ((pxMailbox->ulTail - pxMailbox->ulHead) < (uint32_t)configPORT_REMOTE_CALL_QUEUE_LENGTH)
+        {
+            pxMailbox->xCalls[pxMailbox->ulTail % (uint32_t)configPORT_REMOTE_CALL_QUEUE_LENGTH] = *pxCall;
+            pxMailbox->ulTail++;
+            xPosted = pdTRUE;
+        }
+    }
+    vPortSpinlockGive(&(pxMailbox->xLock), xCoreID);
+
+    return xPosted;
+}
+
+/* Runs the calls queued for the calling hart.  Must be called with interrupts
+ * disabled.  Returns pdTRUE if one of the functions requires a context
+ * switch. */
+static BaseType_t prvRunRemoteCalls(BaseType_t xCoreID)
+{
+    PortMailbox_t *pxMailbox = &(xMailboxes[xCoreID]);
+    PortRemoteCall_t xCall;
+    BaseType_t xSwitchRequired = pdFALSE;
+
+    for (;;)
+    {
+        vPortSpinlockTake(&(pxMailbox->xLock), xCoreID);
+
+        if (pxMailbox->ulHead == pxMailbox->ulTail)
+        {
+            vPortSpinlockGive(&(pxMailbox->xLock), xCoreID);
+            break;
+        }
+
+        xCall = pxMailbox->xCalls[pxMailbox->ulHead % (uint32_t)configPORT_REMOTE_CALL_QUEUE_LENGTH];
+        pxMailbox->ulHead++;
+
+        vPortSpinlockGive(&(pxMailbox->xLock), xCoreID);
+
+        /* The slot is free again, so the function may queue further calls,
+         * even for this hart. */
+        if (xCall.pxFunction(xCall.pvParameter) != pdFALSE)
+        {
+            xSwitchRequired = pdTRUE;
+        }
+
+        if (xCall.pxCompletion != NULL)
+        {
+            (void)Atomic_Decrement_u32(&(xCall.pxCompletion->ulPending));
+        }
+    }
+
+    return xSwitchRequired;
+}
+
+/* Runs the calls queued for this hart from a context that cannot take the
+ * software interrupt, and defers any context switch they request until it
+ * can. */
+static void prvPollRemoteCalls(BaseType_t xCoreID)
+{
+    if (prvRunRemoteCalls(xCoreID) != pdFALSE)
+    {
+        vPortSendIPI((UBaseType_t)xCoreID, portIPI_REASON_YIELD);
+    }
+}
+
+/* One step of waiting for another hart.  If the caller had interrupts enabled
+ * they are enabled for a moment, so this hart still takes its software and
+ * timer interrupts however long the wait lasts; otherwise the calls queued for
+ * this hart are run here.  Either way two harts waiting for each other both
+ * get their calls run.  The calling task may have moved to another hart
+ * meanwhile, so the ID of the hart it is on now is returned.  Must be called
+ * with interrupts disabled, and returns with them disabled. */
+static BaseType_t prvRemoteCallWait(UBaseType_t uxSavedInterruptStatus)
+{
+    BaseType_t xCoreID;
+
+    portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+    (void)portSET_INTERRUPT_MASK();
+
+    xCoreID = portGET_CORE_ID();
+    prvPollRemoteCalls(xCoreID);
+
+    return xCoreID;
+}
+
+static BaseType_t prvRemoteCall(UBaseType_t uxCoreMask,
+                                PortRemoteFunction_t pxFunction,
+                                void *pvParameter,
+                                PortRemoteCallCompletion_t *pxCompletion,
+                                BaseType_t xWait)
+{
+    const PortRemoteCall_t xCall = {pxFunction, pvParameter, pxCompletion};
+    uint32_t ulTargets = (uint32_t)uxCoreMask & portALL_HARTS_MASK;
+    UBaseType_t uxSavedInterruptStatus;
+    UBaseType_t uxTarget;
+    BaseType_t xCoreID;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT(pxFunction != NULL);
+    configASSERT((xWait == pdFALSE) || (pxCompletion != NULL));
+
+    if (pxCompletion != NULL)
+    {
+        pxCompletion->ulPending = (uint32_t)__builtin_popcount(ulTargets);
+    }
+
+    /* Interrupts are disabled while a call is posted, so the hart ID used for
+     * the mailbox locks stays that of the hart the task runs on.  They are
+     * only enabled again, if they were enabled before, between the steps of
+     * a wait. */
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+    xCoreID = portGET_CORE_ID();
+
+    /* A hart spinning for a kernel lock held by this hart would never run the
+     * call. */
+    configASSERT((xWait == pdFALSE) || (prvHoldsKernelLock(xCoreID) == pdFALSE));
+
+    while (ulTargets != 0U)
+    {
+        uxTarget = (UBaseType_t)__builtin_ctz(ulTargets);
+
+        if (prvPostRemoteCall(xCoreID, uxTarget, &xCall) != pdFALSE)
+        {
+            vPortSendIPI(uxTarget, portIPI_REASON_CALL);
+            ulTargets &= ~(1UL << uxTarget);
+        }
+        else if (xWait != pdFALSE)
+        {
+            /* Wait for room in the target's mailbox.  The target may itself
+             * be waiting for room in ours. */
+            xCoreID = prvRemoteCallWait(uxSavedInterruptStatus);
+        }
+        else
+        {
+            if (pxCompletion != NULL)
+            {
+                (void)Atomic_Decrement_u32(&(pxCompletion->ulPending));
+            }
+
+            ulTargets &= ~(1UL << uxTarget);
+            xReturn = pdFAIL;
+        }
+    }
+
+    if (xWait != pdFALSE)
+    {
+        /* This also runs the call queued for this hart if it is one of the
+         * targets. */
+        while (pxCompletion->ulPending != 0U)
+        {
+            xCoreID = prvRemoteCallWait(uxSavedInterruptStatus);
+        }
+    }
+
+    portCLEAR_INTERRUPT_MASK(uxSavedInterruptStatus);
+
+    return xReturn;
+}
+
+BaseType_t xPortRemoteCall(UBaseType_t uxCoreMask, PortRemoteFunction_t pxFunction, void *pvParameter)
+{
+    PortRemoteCallCompletion_t xCompletion;
+
+    return prvRemoteCall(uxCoreMask, pxFunction, pvParameter, &xCompletion, pdTRUE);
+}
+
+BaseType_t xPortRemoteCallAsync(UBaseType_t uxCoreMask,
+                                PortRemoteFunction_t pxFunction,
+                                void *pvParameter,
+                                PortRemoteCallCompletion_t *pxCompletion)
+{
+    return prvRemoteCall(uxCoreMask, pxFunction, pvParameter, pxCompletion, pdFALSE);
+}
+
+#endif /* configUSE_PORT_REMOTE_CALLS */
+
+#if (configUSE_TICKLESS_IDLE != 0)
+
+/* One bit per hart that is waiting in vPortSuppressTicksAndSleep() for the
+ * tick hart to correct the tick count.  Such a hart takes its software
+ * interrupt, but must not switch to a task yet, so the switch is recorded in
+ * ulPortDeferredYields and made once the wait is over. */
+static volatile uint32_t ulPortTickWaitingHarts = 0;
+static volatile uint32_t ulPortDeferredYields = 0;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+/* Called from the trap handler for a machine software interrupt.  Returns
+ * pdTRUE if this hart has to reschedule. */
+BaseType_t xPortSoftwareInterruptHandler(void)
+{
+    const BaseType_t xCoreID = portGET_CORE_ID();
     BaseType_t xSwitchRequired;
+    uint32_t ulReasons;
+
+    /* Clear MSIP before collecting the reasons, so a reason added from now
+     * on interrupts this hart again rather than being missed. */
+    *prvMSIPRegister((UBaseType_t)xCoreID) = 0UL;
+    portMEMORY_BARRIER();
+    ulReasons = Atomic_Swap_u32(&(xIPIState[xCoreID].ulReasons), 0U);
+    xIPILocal[xCoreID].ulReceived++;
+
+    xSwitchRequired = ((ulReasons & portIPI_REASON_YIELD) != 0U) ? pdTRUE : pdFALSE;
+
+    #if (configUSE_PORT_REMOTE_CALLS == 1)
+    {
+        if ((ulReasons & portIPI_REASON_CALL) != 0U)
+        {
+            if (prvRunRemoteCalls(xCoreID) != pdFALSE)
+            {
+                xSwitchRequired = pdTRUE;
+            }
+        }
+    }
+    #endif
+
+    #if (configUSE_TICKLESS_IDLE != 0)
+    {
+        if ((xSwitchRequired != pdFALSE) && ((ulPortTickWaitingHarts & (1UL << xCoreID)) != 0U))
+        {
+            (void)Atomic_OR_u32(&ulPortDeferredYields, 1UL << xCoreID);
+            xSwitchRequired = pdFALSE;
+        }
+    }
+    #endif
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortTickInterruptHandler(void)
+{
+    BaseType_t xSwitchRequired = pdFALSE;
     UBaseType_t uxSavedInterruptStatus;
 
     if (ullPortSchedularRunning == true)
     {
         uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
         {
+            #if (configUSE_PER_CORE_TICKS == 1)
+            {
+                /* Only the tick core advances the tick count, every hart then
+                 * services the timeouts and time slice of its own tasks. */
+                if (portGET_CORE_ID() == portTICK_CORE)
+                {
+                    xSwitchRequired = xTaskIncrementTick();
+                }
 
-            xSwitchRequired = xTaskIncrementTick();
+                if (xTaskIncrementCoreTick() != pdFALSE)
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+            }
+            #else
+            {
+                xSwitchRequired = xTaskIncrementTick();
+            }
+            #endif
         }
         taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
     }
 
     return xSwitchRequired;
 }
+/*-----------------------------------------------------------*/
+
+#if (configUSE_TICKLESS_IDLE != 0)
+
+/* One bit per hart that is sleeping in vPortSuppressTicksAndSleep().  A hart
+ * sets its own bit, the bit is cleared by whichever hart wakes it. */
+volatile uint32_t ulPortSleepingHarts = 0;
+
+/* Non-zero while the tick hart has stopped the tick.  A hart that wakes up in
+ * the meantime must not run tasks until the tick count has been corrected. */
+static volatile uint32_t ulTickSuppressed = 0;
+
+void vPortWakeSleepingCores(UBaseType_t uxCoreMask)
+{
+    uint32_t ulCandidates = ulPortSleepingHarts & (uint32_t)uxCoreMask & ~(1UL << portGET_CORE_ID());
+    uint32_t ulHartBit;
+
+    /* Wake a single hart.  Its bit is cleared here rather than when it wakes
+     * up, so a second task made ready before then goes to another hart. */
+    while (ulCandidates != 0U)
+    {
+        ulHartBit = ulCandidates & (~ulCandidates + 1U);
+
+        if ((Atomic_AND_u32(&ulPortSleepingHarts, ~ulHartBit) & ulHartBit) != 0U)
+        {
+            vPortYieldOtherCore((UBaseType_t)__builtin_ctz(ulHartBit));
+            break;
+        }
+
+        ulCandidates &= ~ulHartBit;
+    }
+}
+
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    const BaseType_t xCoreID = portGET_CORE_ID();
+    const uint32_t ulCoreBit = 1UL << xCoreID;
+    UBaseType_t uxSavedInterruptStatus;
+    UBaseType_t uxSavedMIE;
+    eSleepModeStatus eSleepStatus;
+    BaseType_t xTickStopped = pdFALSE;
+    BaseType_t xCoreTickStopped = pdFALSE;
+    BaseType_t xYieldDeferred = pdFALSE;
+    uint32_t ulWaitingHarts;
+    TickType_t xCompletedTicks = 0;
+    uint64_t ullNextTick = 0ULL;
+    uint64_t ullNow;
+
+    /* Interrupts stay masked until the end of this function, apart from the
+     * wait for the tick hart below.  wfi still returns when an enabled
+     * interrupt becomes pending, and the interrupt is taken once mstatus.MIE
+     * is set again. */
+    portDISABLE_INTERRUPTS();
+
+    /* Advertise that this hart is going to sleep before the final check, so
+     * a task made ready from now on sends it a software interrupt, which
+     * stops the wfi below from sleeping. */
+    (void)Atomic_OR_u32(&ulPortSleepingHarts, ulCoreBit);
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        eSleepStatus = eTaskConfirmSleepModeStatus();
+    }
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    if (eSleepStatus != eAbortSleep)
+    {
+        if ((xCoreID == portTICK_CORE) && (xExpectedIdleTime >= (TickType_t)configEXPECTED_IDLE_TIME_BEFORE_SLEEP))
+        {
+            /* The tick can only be stopped while every other hart sleeps, as
+             * a running task could otherwise read a stale tick count or
+             * delay itself for less time than this hart is about to sleep.
+             * ulTickSuppressed is set before the other harts are checked so a
+             * hart that wakes up concurrently is guaranteed to notice it. */
+            ulTickSuppressed = 1U;
+            portMEMORY_BARRIER();
+
+            if (ulPortSleepingHarts == portALL_HARTS_MASK)
+            {
+                /* Nothing can change the delayed lists any more, so this
+                 * value holds until this hart wakes up. */
+                uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+                {
+                    xExpectedIdleTime = xTaskGetExpectedIdleTime();
+                }
+                taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+                if (xExpectedIdleTime >= (TickType_t)configEXPECTED_IDLE_TIME_BEFORE_SLEEP)
+                {
+                    /* The compare register currently holds the time of the
+                     * next tick, and ullNextTime the one after that. */
+                    ullNextTick = ullNextTime[portTICK_CORE] - (uint64_t)uxTimerIncrementsForOneTick;
+                    prvWriteMachineTimerCompare(portTICK_CORE, ullNextTick + ((uint64_t)(xExpectedIdleTime - 1U) * uxTimerIncrementsForOneTick));
+                    xTickStopped = pdTRUE;
+                }
+            }
+
+            if (xTickStopped == pdFALSE)
+            {
+                ulTickSuppressed = 0U;
+                portMEMORY_BARRIER();
+            }
+        }
+
+        #if (configUSE_PER_CORE_TICKS == 1)
+        {
+            /* The other harts stop their own tick while they sleep.  The tick
+             * core wakes them when a task pinned to them times out. */
+            if ((xCoreID != portTICK_CORE) && (xExpectedIdleTime >= (TickType_t)configEXPECTED_IDLE_TIME_BEFORE_SLEEP))
+            {
+                __asm volatile("csrc mie, %0" ::"r"(0x80U));
+                xCoreTickStopped = pdTRUE;
+            }
+        }
+        #endif
+
+        configPRE_SLEEP_PROCESSING(xExpectedIdleTime);
+
+        if (xExpectedIdleTime > 0)
+        {
+            __asm volatile("wfi" ::: "memory");
+        }
+
+        configPOST_SLEEP_PROCESSING(xExpectedIdleTime);
+
+        if (xTickStopped != pdFALSE)
+        {
+            /* Count the tick periods that ended while the tick was stopped,
+             * then restart the tick on the first boundary that has not
+             * passed yet.  Moving the compare register also clears a pending
+             * timer interrupt, whose tick is already counted here. */
+            ullNow = prvReadMachineTime();
+
+            if (ullNow >= ullNextTick)
+            {
+                xCompletedTicks = (TickType_t)(((ullNow - ullNextTick) / uxTimerIncrementsForOneTick) + 1U);
+            }
+
+            ullNextTick += (uint64_t)xCompletedTicks * uxTimerIncrementsForOneTick;
+            prvWriteMachineTimerCompare(portTICK_CORE, ullNextTick);
+            ullNextTime[portTICK_CORE] = ullNextTick + (uint64_t)uxTimerIncrementsForOneTick;
+        }
+    }
+
+    (void)Atomic_AND_u32(&ulPortSleepingHarts, ~ulCoreBit);
+
+    if (xTickStopped != pdFALSE)
+    {
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            vTaskStepTick(xCompletedTicks);
+
+            #if (configUSE_PER_CORE_TICKS == 1)
+            {
+                (void)xTaskIncrementCoreTick();
+            }
+            #endif
+        }
+        taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+        portMEMORY_BARRIER();
+        ulTickSuppressed = 0U;
+        portMEMORY_BARRIER();
+
+        /* Wake the harts that woke up while the tick was stopped. */
+        ulWaitingHarts = ulPortTickWaitingHarts;
+
+        while (ulWaitingHarts != 0U)
+        {
+            vPortYieldOtherCore((UBaseType_t)__builtin_ctz(ulWaitingHarts));
+            ulWaitingHarts &= ulWaitingHarts - 1U;
+        }
+    }
+    else
+    {
+        portMEMORY_BARRIER();
+
+        if (ulTickSuppressed != 0U)
+        {
+            /* The tick hart stopped the tick while this hart was asleep.
+             * Wake it up and sleep until it has corrected the tick count and
+             * woken this hart in turn.  Meanwhile only the software interrupt
+             * is enabled, and taken after every wfi, so remote calls still
+             * run here; a task switch it asks for waits for the end of the
+             * loop.  The timer and external interrupts stay pending until
+             * then.  Interrupts are masked again before ulTickSuppressed is
+             * read, so the wake-up cannot be taken before the wfi. */
+            __asm volatile("csrr %0, mie" : "=r"(uxSavedMIE));
+            __asm volatile("csrw mie, %0" ::"r"(0x8U));
+            (void)Atomic_OR_u32(&ulPortTickWaitingHarts, ulCoreBit);
+
+            vPortYieldOtherCore(portTICK_CORE);
+
+            while (ulTickSuppressed != 0U)
+            {
+                __asm volatile("wfi" ::: "memory");
+                portENABLE_INTERRUPTS();
+                portDISABLE_INTERRUPTS();
+            }
+
+            (void)Atomic_AND_u32(&ulPortTickWaitingHarts, ~ulCoreBit);
+            __asm volatile("csrw mie, %0" ::"r"(uxSavedMIE));
+
+            if ((Atomic_AND_u32(&ulPortDeferredYields, ~ulCoreBit) & ulCoreBit) != 0U)
+            {
+                xYieldDeferred = pdTRUE;
+            }
+        }
+    }
+
+    #if (configUSE_PER_CORE_TICKS == 1)
+    {
+        if (xCoreTickStopped != pdFALSE)
+        {
+            /* Restart this hart's tick and catch up with the ticks it missed
+             * now, rather than on its next tick. */
+            prvSetupCoreTimerInterrupt(xCoreID);
+            __asm volatile("csrs mie, %0" ::"r"(0x80U));
+
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                (void)xTaskIncrementCoreTick();
+            }
+            taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+        }
+    }
+    #endif
+
+    portENABLE_INTERRUPTS();
+
+    if ((xTickStopped != pdFALSE) || (xCoreTickStopped != pdFALSE) || (xYieldDeferred != pdFALSE))
+    {
+        /* Tasks unblocked while catching up with the tick, or while waiting
+         * for the tick hart to do so, may be waiting for this hart. */
+        portYIELD();
+    }
+}
 
+#endif /* configUSE_TICKLESS_IDLE */
@@ -29,8 +29,14 @@
 #ifndef PORTCONTEXT_H
 #define PORTCONTEXT_H
 
+/* The FPU context is switched whenever the compiler targets an FPU, e.g.
+ * -march=rv32imaf or rv32imafd. */
 #ifndef configENABLE_FPU
-    #define configENABLE_FPU 0
+    #ifdef __riscv_flen
+        #define configENABLE_FPU 1
+    #else
+        #define configENABLE_FPU 0
+    #endif
 #endif
 
 #ifndef configENABLE_VPU
@@ -64,6 +70,62 @@
     #define portCRITICAL_NESTING_OFFSET    30
 #endif
 
+/* Offsets into the CPU-local block (PortCpuLocal_t in portmacro.h) of the
+ * trapping hart, whose address every hart keeps in mscratch. */
+#define portCPU_LOCAL_ISR_STACK_TOP        ( 0 * portWORD_SIZE )
+#define portCPU_LOCAL_CORE_ID              ( 1 * portWORD_SIZE )
+#define portCPU_LOCAL_CURRENT_TCB          ( 2 * portWORD_SIZE )   /* Address of the hart's pxCurrentTCBs[] entry. */
+#define portCPU_LOCAL_FPU_CONTEXT          ( 4 * portWORD_SIZE )
+#define portCPU_LOCAL_FPU_OWNER            ( 5 * portWORD_SIZE )
+#define portCPU_LOCAL_TRAP_START           ( 6 * portWORD_SIZE )
+#define portCPU_LOCAL_TRAPS                ( 7 * portWORD_SIZE )
+#define portCPU_LOCAL_TRAP_ENTRY_CYCLES    ( 8 * portWORD_SIZE )
+#define portCPU_LOCAL_TRAP_EXIT_CYCLES     ( 9 * portWORD_SIZE )
+#define portCPU_LOCAL_TRAP_FAST_RETURNS    ( 10 * portWORD_SIZE )
+
+/* Set with "make TRAP_STATS=1", which defines it for the C files as well. */
+#ifndef configPORT_TRAP_CYCLE_STATS
+    #define configPORT_TRAP_CYCLE_STATS    0
+#endif
+
+/* A trap first saves only the registers the C handlers may clobber - ra,
+ * t0-t6, a0-a7 - into a full-size frame.  The callee-saved registers are
+ * still live when a handler returns, so a trap that does not switch tasks
+ * returns with the short restore of portcontextRESTORE_CALLER_SAVED_CONTEXT.
+ * Only when a switch is requested is the frame completed, before
+ * vTaskSwitchContext() can make the task runnable on another hart.  The
+ * vector and chip specific registers are pushed below the frame, so a port
+ * with either always saves the whole context.
+ *
+ * The FPU registers are not saved on trap entry either, they may hold the
+ * dirty state of the interrupted task (see the lazy FPU switching below).  So
+ * the handlers - the tick and software interrupt handlers, the tick hook and
+ * the functions run by xPortRemoteCall() - must not use the FPU.  The trap
+ * entry turns the FPU off (mstatus.FS = Off) until the frame is completed or
+ * the trap returns, so a handler that does use it stops in the exception
+ * handler with an illegal instruction rather than corrupting the task. */
+#if ( configENABLE_VPU == 0 ) && ( portasmADDITIONAL_CONTEXT_SIZE == 0 )
+    #define portasmFAST_TRAP_RETURN        1
+#else
+    #define portasmFAST_TRAP_RETURN        0
+#endif
+
+/* With portasmFAST_TRAP_RETURN a voluntary switch (portYIELD(), which calls
+ * vPortYield()) saves only what a function call has to preserve, in a
+ * compact frame:
+ *   word 0      portVOLUNTARY_FRAME_MARKER, where an interrupt frame holds
+ *               mepc - which is never odd
+ *   word 1      mstatus, with the interrupt enable of the caller
+ *   word 2      ra
+ *   words 3-14  s0-s11
+ *   word 15     the task's FPU context area (configENABLE_FPU)
+ * The critical nesting count is not part of it, the kernel never switches a
+ * task out inside a critical section and the count lives in the CPU-local
+ * block. */
+#define portVOLUNTARY_FRAME_MARKER         1
+#define portVOLUNTARY_CONTEXT_SIZE         ( 16 * portWORD_SIZE )
+#define portVOLUNTARY_FPU_CONTEXT_SLOT     15
+
 #if ( configENABLE_FPU == 1 )
     /* Bit [14:13] in the mstatus encode the status of FPU state which is one of
      * the following values:
@@ -89,10 +151,28 @@
             #error Assembler did not define __riscv_flen
         #endif
 
+        /* The FPU context is switched lazily.  Every task owns an FPU
+         * context area, reserved above its initial stack frame by
+         * pxPortInitialiseStack, and the address of the area travels with the
+         * task in slot portFPU_CONTEXT_SLOT of its stack frame.
+         *
+         * - A task starts with mstatus.FS = Initial and is never restored
+         *   until it has used the FPU.
+         * - When a task is switched out with FS = Dirty its registers are
+         *   written to its area and FS becomes Clean.  A task whose FS is not
+         *   Dirty has not touched the FPU since its area was last written, so
+         *   nothing is saved.
+         * - When a task whose saved FS is Clean is switched in, its area is
+         *   loaded unless the hart's registers still hold it - that is, the
+         *   hart was the last to load or save the area (recorded in the
+         *   area's owner word) and no other area has been loaded or saved on
+         *   the hart since (recorded in the hart's CPU-local block). */
         #define portFPU_REG_SIZE                ( __riscv_flen / 8 )
         #define portFPU_REG_COUNT               33 /* 32 Floating point registers plus one CSR. */
-        #define portFPU_REG_OFFSET( regIndex )  ( ( 2 * portWORD_SIZE ) + ( regIndex * portFPU_REG_SIZE ) )
-        #define portFPU_CONTEXT_SIZE            ( portFPU_REG_SIZE * portFPU_REG_COUNT )
+        #define portFPU_AREA_OWNER_OFFSET       0  /* mhartid + 1 of the hart whose registers hold the area, 0 if none. */
+        #define portFPU_REG_OFFSET( regIndex )  ( 8 + ( regIndex * portFPU_REG_SIZE ) )
+        #define portFPU_CONTEXT_SIZE            ( ( portFPU_REG_OFFSET( portFPU_REG_COUNT ) + 15 ) & ~15 )
+        #define portFPU_CONTEXT_SLOT            31 /* Stack frame slot holding the address of the task's FPU context area. */
     #else
         #error configENABLE_FPU must not be set to 1 if the hardware does not have FPU
     #endif
@@ -119,89 +199,84 @@
 /*-----------------------------------------------------------*/
 .extern uxYieldRequested
 .extern pxCurrentTCBs
-.extern xISRStackTop
-.extern xCriticalNesting
-.extern pxCriticalNesting
 .extern xYieldPendings
 /*-----------------------------------------------------------*/
 
-    .macro portcontexSAVE_FPU_CONTEXT
-addi sp, sp, -( portFPU_CONTEXT_SIZE )
-/* Store the FPU registers. */
-store_f f0,  portFPU_REG_OFFSET( 0  )( sp )
-store_f f1,  portFPU_REG_OFFSET( 1  )( sp )
-store_f f2,  portFPU_REG_OFFSET( 2  )( sp )
-store_f f3,  portFPU_REG_OFFSET( 3  )( sp )
-store_f f4,  portFPU_REG_OFFSET( 4  )( sp )
-store_f f5,  portFPU_REG_OFFSET( 5  )( sp )
-store_f f6,  portFPU_REG_OFFSET( 6  )( sp )
-store_f f7,  portFPU_REG_OFFSET( 7  )( sp )
-store_f f8,  portFPU_REG_OFFSET( 8  )( sp )
-store_f f9,  portFPU_REG_OFFSET( 9  )( sp )
-store_f f10, portFPU_REG_OFFSET( 10 )( sp )
-store_f f11, portFPU_REG_OFFSET( 11 )( sp )
-store_f f12, portFPU_REG_OFFSET( 12 )( sp )
-store_f f13, portFPU_REG_OFFSET( 13 )( sp )
-store_f f14, portFPU_REG_OFFSET( 14 )( sp )
-store_f f15, portFPU_REG_OFFSET( 15 )( sp )
-store_f f16, portFPU_REG_OFFSET( 16 )( sp )
-store_f f17, portFPU_REG_OFFSET( 17 )( sp )
-store_f f18, portFPU_REG_OFFSET( 18 )( sp )
-store_f f19, portFPU_REG_OFFSET( 19 )( sp )
-store_f f20, portFPU_REG_OFFSET( 20 )( sp )
-store_f f21, portFPU_REG_OFFSET( 21 )( sp )
-store_f f22, portFPU_REG_OFFSET( 22 )( sp )
-store_f f23, portFPU_REG_OFFSET( 23 )( sp )
-store_f f24, portFPU_REG_OFFSET( 24 )( sp )
-store_f f25, portFPU_REG_OFFSET( 25 )( sp )
-store_f f26, portFPU_REG_OFFSET( 26 )( sp )
-store_f f27, portFPU_REG_OFFSET( 27 )( sp )
-store_f f28, portFPU_REG_OFFSET( 28 )( sp )
-store_f f29, portFPU_REG_OFFSET( 29 )( sp )
-store_f f30, portFPU_REG_OFFSET( 30 )( sp )
-store_f f31, portFPU_REG_OFFSET( 31 )( sp )
-csrr t0, fcsr
-store_x t0,  portFPU_REG_OFFSET( 32 )( sp )
+    .macro portcontexSAVE_FPU_CONTEXT base
+/* Store the FPU registers into the FPU context area at \base. */
+store_f f0,  portFPU_REG_OFFSET( 0  )( \base )
+store_f f1,  portFPU_REG_OFFSET( 1  )( \base )
+store_f f2,  portFPU_REG_OFFSET( 2  )( \base )
+store_f f3,  portFPU_REG_OFFSET( 3  )( \base )
+store_f f4,  portFPU_REG_OFFSET( 4  )( \base )
+store_f f5,  portFPU_REG_OFFSET( 5  )( \base )
+store_f f6,  portFPU_REG_OFFSET( 6  )( \base )
+store_f f7,  portFPU_REG_OFFSET( 7  )( \base )
+store_f f8,  portFPU_REG_OFFSET( 8  )( \base )
+store_f f9,  portFPU_REG_OFFSET( 9  )( \base )
+store_f f10, portFPU_REG_OFFSET( 10 )( \base )
+store_f f11, portFPU_REG_OFFSET( 11 )( \base )
+store_f f12, portFPU_REG_OFFSET( 12 )( \base )
+store_f f13, portFPU_REG_OFFSET( 13 )( \base )
+store_f f14, portFPU_REG_OFFSET( 14 )( \base )
+store_f f15, portFPU_REG_OFFSET( 15 )( \base )
+store_f f16, portFPU_REG_OFFSET( 16 )( \base )
+store_f f17, portFPU_REG_OFFSET( 17 )( \base )
+store_f f18, portFPU_REG_OFFSET( 18 )( \base )
+store_f f19, portFPU_REG_OFFSET( 19 )( \base )
+store_f f20, portFPU_REG_OFFSET( 20 )( \base )
+store_f f21, portFPU_REG_OFFSET( 21 )( \base )
+store_f f22, portFPU_REG_OFFSET( 22 )( \base )
+store_f f23, portFPU_REG_OFFSET( 23 )( \base )
+store_f f24, portFPU_REG_OFFSET( 24 )( \base )
+store_f f25, portFPU_REG_OFFSET( 25 )( \base )
+store_f f26, portFPU_REG_OFFSET( 26 )( \base )
+store_f f27, portFPU_REG_OFFSET( 27 )( \base )
+store_f f28, portFPU_REG_OFFSET( 28 )( \base )
+store_f f29, portFPU_REG_OFFSET( 29 )( \base )
+store_f f30, portFPU_REG_OFFSET( 30 )( \base )
+store_f f31, portFPU_REG_OFFSET( 31 )( \base )
+csrr t2, fcsr
+store_x t2,  portFPU_REG_OFFSET( 32 )( \base )
     .endm
 /*-----------------------------------------------------------*/
 
-    .macro portcontextRESTORE_FPU_CONTEXT
-/* Restore the FPU registers. */
-load_f f0,  portFPU_REG_OFFSET( 0  )( sp )
-load_f f1,  portFPU_REG_OFFSET( 1  )( sp )
-load_f f2,  portFPU_REG_OFFSET( 2  )( sp )
-load_f f3,  portFPU_REG_OFFSET( 3  )( sp )
-load_f f4,  portFPU_REG_OFFSET( 4  )( sp )
-load_f f5,  portFPU_REG_OFFSET( 5  )( sp )
-load_f f6,  portFPU_REG_OFFSET( 6  )( sp )
-load_f f7,  portFPU_REG_OFFSET( 7  )( sp )
-load_f f8,  portFPU_REG_OFFSET( 8  )( sp )
-load_f f9,  portFPU_REG_OFFSET( 9  )( sp )
-load_f f10, portFPU_REG_OFFSET( 10 )( sp )
-load_f f11, portFPU_REG_OFFSET( 11 )( sp )
-load_f f12, portFPU_REG_OFFSET( 12 )( sp )
-load_f f13, portFPU_REG_OFFSET( 13 )( sp )
-load_f f14, portFPU_REG_OFFSET( 14 )( sp )
-load_f f15, portFPU_REG_OFFSET( 15 )( sp )
-load_f f16, portFPU_REG_OFFSET( 16 )( sp )
-load_f f17, portFPU_REG_OFFSET( 17 )( sp )
-load_f f18, portFPU_REG_OFFSET( 18 )( sp )
-load_f f19, portFPU_REG_OFFSET( 19 )( sp )
-load_f f20, portFPU_REG_OFFSET( 20 )( sp )
-load_f f21, portFPU_REG_OFFSET( 21 )( sp )
-load_f f22, portFPU_REG_OFFSET( 22 )( sp )
-load_f f23, portFPU_REG_OFFSET( 23 )( sp )
-load_f f24, portFPU_REG_OFFSET( 24 )( sp )
-load_f f25, portFPU_REG_OFFSET( 25 )( sp )
-load_f f26, portFPU_REG_OFFSET( 26 )( sp )
-load_f f27, portFPU_REG_OFFSET( 27 )( sp )
-load_f f28, portFPU_REG_OFFSET( 28 )( sp )
-load_f f29, portFPU_REG_OFFSET( 29 )( sp )
-load_f f30, portFPU_REG_OFFSET( 30 )( sp )
-load_f f31, portFPU_REG_OFFSET( 31 )( sp )
-load_x t0,  portFPU_REG_OFFSET( 32 )( sp )
-csrw fcsr, t0
-addi sp, sp, ( portFPU_CONTEXT_SIZE )
+    .macro portcontextRESTORE_FPU_CONTEXT base
+/* Restore the FPU registers from the FPU context area at \base. */
+load_f f0,  portFPU_REG_OFFSET( 0  )( \base )
+load_f f1,  portFPU_REG_OFFSET( 1  )( \base )
+load_f f2,  portFPU_REG_OFFSET( 2  )( \base )
+load_f f3,  portFPU_REG_OFFSET( 3  )( \base )
+load_f f4,  portFPU_REG_OFFSET( 4  )( \base )
+load_f f5,  portFPU_REG_OFFSET( 5  )( \base )
+load_f f6,  portFPU_REG_OFFSET( 6  )( \base )
+load_f f7,  portFPU_REG_OFFSET( 7  )( \base )
+load_f f8,  portFPU_REG_OFFSET( 8  )( \base )
+load_f f9,  portFPU_REG_OFFSET( 9  )( \base )
+load_f f10, portFPU_REG_OFFSET( 10 )( \base )
+load_f f11, portFPU_REG_OFFSET( 11 )( \base )
+load_f f12, portFPU_REG_OFFSET( 12 )( \base )
+load_f f13, portFPU_REG_OFFSET( 13 )( \base )
+load_f f14, portFPU_REG_OFFSET( 14 )( \base )
+load_f f15, portFPU_REG_OFFSET( 15 )( \base )
+load_f f16, portFPU_REG_OFFSET( 16 )( \base )
+load_f f17, portFPU_REG_OFFSET( 17 )( \base )
+load_f f18, portFPU_REG_OFFSET( 18 )( \base )
+load_f f19, portFPU_REG_OFFSET( 19 )( \base )
+load_f f20, portFPU_REG_OFFSET( 20 )( \base )
+load_f f21, portFPU_REG_OFFSET( 21 )( \base )
+load_f f22, portFPU_REG_OFFSET( 22 )( \base )
+load_f f23, portFPU_REG_OFFSET( 23 )( \base )
+load_f f24, portFPU_REG_OFFSET( 24 )( \base )
+load_f f25, portFPU_REG_OFFSET( 25 )( \base )
+load_f f26, portFPU_REG_OFFSET( 26 )( \base )
+load_f f27, portFPU_REG_OFFSET( 27 )( \base )
+load_f f28, portFPU_REG_OFFSET( 28 )( \base )
+load_f f29, portFPU_REG_OFFSET( 29 )( \base )
+load_f f30, portFPU_REG_OFFSET( 30 )( \base )
+load_f f31, portFPU_REG_OFFSET( 31 )( \base )
+load_x t2,  portFPU_REG_OFFSET( 32 )( \base )
+csrw fcsr, t2
     .endm
 /*-----------------------------------------------------------*/
 
@@ -271,14 +346,86 @@ add sp, sp, -( 2 * portWORD_SIZE )
     .endm
 /*-----------------------------------------------------------*/
 
-   .macro portcontextSAVE_CONTEXT_INTERNAL
+   .macro portcontextSAVE_FPU_STATE slot
+/* Records the FPU context area of the task being switched out in slot \slot
+ * of its frame at sp, and writes the FPU registers to the area if they have
+ * changed.  Clobbers t0-t2. */
+#if( configENABLE_FPU == 1 )
+    csrr t0, mscratch
+    load_x t1, portCPU_LOCAL_FPU_CONTEXT( t0 )  /* t1 = FPU context area of the task being switched out. */
+    store_x t1, \slot * portWORD_SIZE( sp )
+
+    csrr t2, mstatus
+    srl t2, t2, MSTATUS_FS_OFFSET
+    andi t2, t2, 3
+    addi t2, t2, -3
+    bnez t2, 1f /* If FPU status is not dirty, the area is already up to date. */
+
+    portcontexSAVE_FPU_CONTEXT t1
+
+    /* The registers now match the area, so this hart owns it. */
+    load_x t2, portCPU_LOCAL_CORE_ID( t0 )
+    addi t2, t2, 1
+    store_x t2, portFPU_AREA_OWNER_OFFSET( t1 )
+    store_x t1, portCPU_LOCAL_FPU_OWNER( t0 )
+
+    /* Mark the FPU as clean. */
+    li t2, MSTATUS_FS_MASK
+    csrc mstatus, t2
+    li t2, MSTATUS_FS_CLEAN
+    csrs mstatus, t2
+1:
+#endif
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextRESTORE_FPU_STATE slot
+/* Makes the FPU context area in slot \slot of the frame at sp current on this
+ * hart, and loads it if the task has used the FPU and the hart's registers do
+ * not hold it already.  Expects the CPU-local block in t0, clobbers t1-t3. */
+#if( configENABLE_FPU == 1 )
+    /* The live FS state is that of the task just switched out, which is never
+     * Off, so the FPU is accessible here. */
+    load_x t1, \slot * portWORD_SIZE( sp )
+    store_x t1, portCPU_LOCAL_FPU_CONTEXT( t0 )
+
+    /* A task whose FS is still Initial has never used the FPU. */
+    load_x t3, 1 * portWORD_SIZE( sp )
+    srl t3, t3, MSTATUS_FS_OFFSET
+    andi t3, t3, 3
+    addi t3, t3, -( MSTATUS_FS_CLEAN >> MSTATUS_FS_OFFSET )
+    bnez t3, 8f
+
+    /* Skip the load if this hart's registers still hold the area. */
+    load_x t3, portCPU_LOCAL_FPU_OWNER( t0 )
+    load_x t2, portCPU_LOCAL_CORE_ID( t0 )
+    addi t2, t2, 1
+    bne t3, t1, 7f
+    load_x t3, portFPU_AREA_OWNER_OFFSET( t1 )
+    beq t3, t2, 8f
+7:
+    store_x t1, portCPU_LOCAL_FPU_OWNER( t0 )
+    store_x t2, portFPU_AREA_OWNER_OFFSET( t1 )
+    portcontextRESTORE_FPU_CONTEXT t1
+8:
+#endif
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextSAVE_CALLER_SAVED_CONTEXT
+/* Reserves the frame, stores ra, t0-t6, a0-a7 and mstatus into it and records
+ * it in the TCB of the interrupted task.  Leaves the address of the hart's
+ * CPU-local block in t0. */
 addi sp, sp, -portCONTEXT_SIZE
 store_x x1,  2  * portWORD_SIZE( sp )
 store_x x5,  3  * portWORD_SIZE( sp )
 store_x x6,  4  * portWORD_SIZE( sp )
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    csrr t0, mcycle                     /* The trap entry starts being timed as soon as t0 and t1 are free. */
+    csrr t1, mscratch
+    store_x t0, portCPU_LOCAL_TRAP_START( t1 )
+#endif
 store_x x7,  5  * portWORD_SIZE( sp )
-store_x x8,  6  * portWORD_SIZE( sp )
-store_x x9,  7  * portWORD_SIZE( sp )
 store_x x10, 8  * portWORD_SIZE( sp )
 store_x x11, 9  * portWORD_SIZE( sp )
 store_x x12, 10 * portWORD_SIZE( sp )
@@ -288,6 +435,33 @@ store_x x15, 13 * portWORD_SIZE( sp )
 #ifndef __riscv_32e
     store_x x16, 14 * portWORD_SIZE( sp )
     store_x x17, 15 * portWORD_SIZE( sp )
+    store_x x28, 26 * portWORD_SIZE( sp )
+    store_x x29, 27 * portWORD_SIZE( sp )
+    store_x x30, 28 * portWORD_SIZE( sp )
+    store_x x31, 29 * portWORD_SIZE( sp )
+#endif /* ifndef __riscv_32e */
+
+csrr t0, mstatus
+store_x t0, 1 * portWORD_SIZE( sp )
+#if( configENABLE_FPU == 1 )
+    li t0, MSTATUS_FS_MASK              /* FPU off until portcontextSAVE_CALLEE_SAVED_CONTEXT or the restore of mstatus. */
+    csrc mstatus, t0
+#endif
+
+csrr    t0, mscratch
+load_x  t1, portCPU_LOCAL_CURRENT_TCB( t0 )
+load_x  t1, 0( t1 )
+store_x sp, 0( t1 )                             /* Write sp to first TCB member. */
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextSAVE_CALLEE_SAVED_CONTEXT
+/* Completes the frame at sp, started by portcontextSAVE_CALLER_SAVED_CONTEXT,
+ * with s0-s11 and the FPU, vector and chip specific state.  Leaves the
+ * address of the hart's CPU-local block in t0. */
+store_x x8,  6  * portWORD_SIZE( sp )
+store_x x9,  7  * portWORD_SIZE( sp )
+#ifndef __riscv_32e
     store_x x18, 16 * portWORD_SIZE( sp )
     store_x x19, 17 * portWORD_SIZE( sp )
     store_x x20, 18 * portWORD_SIZE( sp )
@@ -298,32 +472,13 @@ store_x x15, 13 * portWORD_SIZE( sp )
     store_x x25, 23 * portWORD_SIZE( sp )
     store_x x26, 24 * portWORD_SIZE( sp )
     store_x x27, 25 * portWORD_SIZE( sp )
-    store_x x28, 26 * portWORD_SIZE( sp )
-    store_x x29, 27 * portWORD_SIZE( sp )
-    store_x x30, 28 * portWORD_SIZE( sp )
-    store_x x31, 29 * portWORD_SIZE( sp )
 #endif /* ifndef __riscv_32e */
 
-// load_x t0, xCriticalNesting                                   /* Load the value of xCriticalNesting into t0. */
-// store_x t0, portCRITICAL_NESTING_OFFSET * portWORD_SIZE( sp ) /* Store the critical nesting value to the stack. */
-/* SMP */
-// csrr  t1, mhartid
-// slli  t1, t1, 2                          
-// la        t2, pxCriticalNesting
-// add   t2, t2, t1                          
-// load_x t0, 0(t2)                         
-// store_x t0, portCRITICAL_NESTING_OFFSET*portWORD_SIZE(sp)
-
 #if( configENABLE_FPU == 1 )
-    csrr t0, mstatus
-    srl t1, t0, MSTATUS_FS_OFFSET
-    andi t1, t1, 3
-    addi t2, x0, 3
-    bne t1, t2, 1f /* If FPU status is not dirty, do not save FPU registers. */
-
-    portcontexSAVE_FPU_CONTEXT
-1:
+    load_x t0, 1 * portWORD_SIZE( sp )  /* Turn the FPU back on with the FS state of the task, the trap entry turned it off. */
+    csrw mstatus, t0
 #endif
+portcontextSAVE_FPU_STATE portFPU_CONTEXT_SLOT
 
 #if( configENABLE_VPU == 1 )
     csrr t0, mstatus
@@ -341,21 +496,6 @@ portasmSAVE_ADDITIONAL_REGISTERS /* Defined in freertos_risc_v_chip_specific_ext
 csrr t0, mstatus
 store_x t0, 1 * portWORD_SIZE( sp )
 
-#if( configENABLE_FPU == 1 )
-    /* Mark the FPU as clean, if it was dirty and we saved FPU registers. */
-    srl t1, t0, MSTATUS_FS_OFFSET
-    andi t1, t1, 3
-    addi t2, x0, 3
-    bne t1, t2, 3f
-
-    li t1, ~MSTATUS_FS_MASK
-    and t0, t0, t1
-    li t1, MSTATUS_FS_CLEAN
-    or t0, t0, t1
-    csrw mstatus, t0
-3:
-#endif
-
 #if( configENABLE_VPU == 1 )
     /* Mark the VPU as clean, if it was dirty and we saved VPU registers. */
     srl t1, t0, MSTATUS_VS_OFFSET
@@ -375,13 +515,36 @@ store_x t0, 1 * portWORD_SIZE( sp )
 // store_x sp, 0 ( t0 )             /* Write sp to first TCB member. */
 
 /* SMP */
-csrr    t0, mhartid
-slli    t0, t0, 2             
-la      t1, pxCurrentTCBs     
-add     t1, t1, t0            
-load_x  t2, 0(t1)             
-store_x sp, 0(t2)             
+csrr    t0, mscratch
+load_x  t1, portCPU_LOCAL_CURRENT_TCB( t0 )    /* t1 = &pxCurrentTCBs[ hart ]. */
+load_x  t2, 0( t1 )
+store_x sp, 0( t2 )                             /* Write sp to first TCB member. */
+
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextSAVE_CONTEXT_INTERNAL
+/* Saves the whole context.  Leaves the address of the hart's CPU-local block
+ * in t0. */
+portcontextSAVE_CALLER_SAVED_CONTEXT
+portcontextSAVE_CALLEE_SAVED_CONTEXT
+   .endm
+/*-----------------------------------------------------------*/
 
+   .macro portcontextRECORD_TRAP_ENTRY
+/* Called once the trap handler has switched to the ISR stack, with the
+ * CPU-local block in t0. */
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    csrr t1, mcycle
+    load_x t2, portCPU_LOCAL_TRAP_START( t0 )
+    sub t1, t1, t2
+    load_x t2, portCPU_LOCAL_TRAP_ENTRY_CYCLES( t0 )
+    add t2, t2, t1
+    store_x t2, portCPU_LOCAL_TRAP_ENTRY_CYCLES( t0 )
+    load_x t2, portCPU_LOCAL_TRAPS( t0 )
+    addi t2, t2, 1
+    store_x t2, portCPU_LOCAL_TRAPS( t0 )
+#endif
    .endm
 /*-----------------------------------------------------------*/
 
@@ -391,7 +554,7 @@ csrr a0, mcause
 csrr a1, mepc
 addi a1, a1, 4          /* Synchronous so update exception return address to the instruction after the instruction that generated the exception. */
 store_x a1, 0 ( sp )    /* Save updated exception return address. */
-load_x sp, xISRStackTop /* Switch to ISR stack. */
+load_x sp, portCPU_LOCAL_ISR_STACK_TOP( t0 ) /* Switch to ISR stack. */
    .endm
 /*-----------------------------------------------------------*/
 
@@ -400,7 +563,35 @@ portcontextSAVE_CONTEXT_INTERNAL
 csrr a0, mcause
 csrr a1, mepc
 store_x a1, 0 ( sp )    /* Asynchronous interrupt so save unmodified exception return address. */
-load_x sp, xISRStackTop /* Switch to ISR stack. */
+load_x sp, portCPU_LOCAL_ISR_STACK_TOP( t0 ) /* Switch to ISR stack. */
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextRESTORE_VOLUNTARY_CONTEXT
+/* Resumes the task whose voluntary frame is at sp by returning from its
+ * vPortYield() call.  Expects the CPU-local block in t0. */
+portcontextRESTORE_FPU_STATE portVOLUNTARY_FPU_CONTEXT_SLOT
+
+load_x x1,  2  * portWORD_SIZE( sp )
+load_x x8,  3  * portWORD_SIZE( sp )
+load_x x9,  4  * portWORD_SIZE( sp )
+#ifndef __riscv_32e
+    load_x x18, 5  * portWORD_SIZE( sp )
+    load_x x19, 6  * portWORD_SIZE( sp )
+    load_x x20, 7  * portWORD_SIZE( sp )
+    load_x x21, 8  * portWORD_SIZE( sp )
+    load_x x22, 9  * portWORD_SIZE( sp )
+    load_x x23, 10 * portWORD_SIZE( sp )
+    load_x x24, 11 * portWORD_SIZE( sp )
+    load_x x25, 12 * portWORD_SIZE( sp )
+    load_x x26, 13 * portWORD_SIZE( sp )
+    load_x x27, 14 * portWORD_SIZE( sp )
+#endif /* ifndef __riscv_32e */
+load_x t0,  1  * portWORD_SIZE( sp )
+addi sp, sp, portVOLUNTARY_CONTEXT_SIZE
+
+csrw mstatus, t0                        /* Restores the task's interrupt enable as well. */
+ret
    .endm
 /*-----------------------------------------------------------*/
 
@@ -408,16 +599,24 @@ load_x sp, xISRStackTop /* Switch to ISR stack. */
 // load_x t1, pxCurrentTCBs /* Load pxCurrentTCB. */
 // load_x sp, 0 ( t1 )     /* Read sp from first TCB member. */
 /* SMP */
-csrr  t1, mhartid
-slli  t1, t1, 2
-la        t2, pxCurrentTCBs
-add   t2, t2, t1
-load_x t1, 0 ( t2 )
+csrr t0, mscratch                               /* t0 = CPU-local block of this hart. */
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    csrr t1, mcycle
+    store_x t1, portCPU_LOCAL_TRAP_START( t0 )
+#endif
+load_x t1, portCPU_LOCAL_CURRENT_TCB( t0 )
+load_x t1, 0 ( t1 )
 load_x sp, 0 ( t1 )
 
 /* Load mepc with the address of the instruction in the task to run next. */
-load_x t0, 0 ( sp )
-csrw mepc, t0
+load_x t1, 0 ( sp )
+#if( portasmFAST_TRAP_RETURN == 1 )
+    li t2, portVOLUNTARY_FRAME_MARKER
+    beq t1, t2, 6f                      /* The task gave up the hart in vPortYield(). */
+#endif
+csrw mepc, t1
+
+portcontextRESTORE_FPU_STATE portFPU_CONTEXT_SLOT
 
 /* Restore mstatus register. */
 load_x t0, 1 * portWORD_SIZE( sp )
@@ -437,28 +636,17 @@ portasmRESTORE_ADDITIONAL_REGISTERS
 5:
 #endif /* ifdef portasmSTORE_VPU_CONTEXT */
 
-#if( configENABLE_FPU == 1 )
-    csrr t0, mstatus
-    srl t1, t0, MSTATUS_FS_OFFSET
-    andi t1, t1, 3
-    addi t2, x0, 3
-    bne t1, t2, 6f /* If FPU status is not dirty, do not restore FPU registers. */
-
-    portcontextRESTORE_FPU_CONTEXT
-6:
-#endif /* ifdef portasmSTORE_FPU_CONTEXT */
-
-// load_x t0, portCRITICAL_NESTING_OFFSET * portWORD_SIZE( sp ) /* Obtain xCriticalNesting value for this task from task's stack. */
-// load_x t1, pxCriticalNesting                                 /* Load the address of xCriticalNesting into t1. */
-// store_x t0, 0 ( t1 )                                         /* Restore the critical nesting value for this task. */
-
-/* SMP */
-// load_x t0, portCRITICAL_NESTING_OFFSET * portWORD_SIZE(sp)
-// csrr  t1, mhartid
-// slli  t1, t1, 2
-// la t2, pxCriticalNesting
-// add   t2, t2, t1
-// store_x t0, 0(t2)
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    /* The trap exit is timed up to the reload of the general purpose
+     * registers, which takes the same time for every trap. */
+    csrr t0, mscratch
+    csrr t1, mcycle
+    load_x t2, portCPU_LOCAL_TRAP_START( t0 )
+    sub t1, t1, t2
+    load_x t2, portCPU_LOCAL_TRAP_EXIT_CYCLES( t0 )
+    add t2, t2, t1
+    store_x t2, portCPU_LOCAL_TRAP_EXIT_CYCLES( t0 )
+#endif
 
 load_x x1,  2  * portWORD_SIZE( sp )
 load_x x5,  3  * portWORD_SIZE( sp )
@@ -492,6 +680,61 @@ load_x x15, 13 * portWORD_SIZE( sp )
 #endif /* ifndef __riscv_32e */
 addi sp, sp, portCONTEXT_SIZE
 
+mret
+
+#if( portasmFAST_TRAP_RETURN == 1 )
+6:
+    portcontextRESTORE_VOLUNTARY_CONTEXT
+#endif
+   .endm
+/*-----------------------------------------------------------*/
+
+   .macro portcontextRESTORE_CALLER_SAVED_CONTEXT
+/* Returns to the task whose frame is at sp when s0-s11, the FPU registers and
+ * the chip specific registers still hold its values. */
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    csrr t0, mscratch
+    csrr t1, mcycle
+    store_x t1, portCPU_LOCAL_TRAP_START( t0 )
+#endif
+
+load_x t1, 0 ( sp )
+csrw mepc, t1
+load_x t1, 1 * portWORD_SIZE( sp )
+csrw mstatus, t1
+
+#if( configPORT_TRAP_CYCLE_STATS == 1 )
+    csrr t1, mcycle
+    load_x t2, portCPU_LOCAL_TRAP_START( t0 )
+    sub t1, t1, t2
+    load_x t2, portCPU_LOCAL_TRAP_EXIT_CYCLES( t0 )
+    add t2, t2, t1
+    store_x t2, portCPU_LOCAL_TRAP_EXIT_CYCLES( t0 )
+    load_x t2, portCPU_LOCAL_TRAP_FAST_RETURNS( t0 )
+    addi t2, t2, 1
+    store_x t2, portCPU_LOCAL_TRAP_FAST_RETURNS( t0 )
+#endif
+
+load_x x1,  2  * portWORD_SIZE( sp )
+load_x x5,  3  * portWORD_SIZE( sp )
+load_x x6,  4  * portWORD_SIZE( sp )
+load_x x7,  5  * portWORD_SIZE( sp )
+load_x x10, 8  * portWORD_SIZE( sp )
+load_x x11, 9  * portWORD_SIZE( sp )
+load_x x12, 10 * portWORD_SIZE( sp )
+load_x x13, 11 * portWORD_SIZE( sp )
+load_x x14, 12 * portWORD_SIZE( sp )
+load_x x15, 13 * portWORD_SIZE( sp )
+#ifndef __riscv_32e
+    load_x x16, 14 * portWORD_SIZE( sp )
+    load_x x17, 15 * portWORD_SIZE( sp )
+    load_x x28, 26 * portWORD_SIZE( sp )
+    load_x x29, 27 * portWORD_SIZE( sp )
+    load_x x30, 28 * portWORD_SIZE( sp )
+    load_x x31, 29 * portWORD_SIZE( sp )
+#endif /* ifndef __riscv_32e */
+addi sp, sp, portCONTEXT_SIZE
+
 mret
    .endm
 /*-----------------------------------------------------------*/
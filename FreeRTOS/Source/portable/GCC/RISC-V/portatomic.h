@@ -0,0 +1,300 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * The atomic.h interface on top of the RISC-V A extension, included by
+ * atomic.h when the port sets portHAS_NATIVE_ATOMICS.  None of these functions
+ * masks interrupts or takes a kernel lock, so they can be used from tasks,
+ * ISRs and inside the port's own spinlocks alike.
+ *
+ * The functions without a suffix are fully ordered, like the critical section
+ * based versions they replace.  The _Acquire variants keep later memory
+ * accesses after the operation, the _Release variants keep earlier ones before
+ * it.  AMOs carry that ordering in their own .aqrl, .aq or .rl bits.  The lr/sc
+ * loops put acquire on the lr and release on the sc, following the RISC-V
+ * mappings: lr.aq/sc for acquire, lr/sc.rl for release and lr.aqrl/sc.rl when
+ * fully ordered.  See atomic.h for the description of every operation.
+ */
+
+#ifndef PORTATOMIC_H
+#define PORTATOMIC_H
+
+#ifndef ATOMIC_H
+    #error "include atomic.h instead of portatomic.h"
+#endif
+
+#if __riscv_xlen == 64
+    #define portatomicPTR_SUFFIX    "d"
+#else
+    #define portatomicPTR_SUFFIX    "w"
+#endif
+
+/* Body of a function that applies the AMO instruction xInstruction to
+ * *pulDestination and returns the previous value. */
+#define portatomicAMO( xInstruction, pulDestination, ulValue )  \
+    uint32_t ulPrevious;                                          \
+    __asm volatile ( xInstruction " %0, %2, %1"                   \
+                     : "=r" ( ulPrevious ), "+A" ( *( pulDestination ) ) \
+                     : "r" ( ulValue )                            \
+                     : "memory" );                                \
+    return ulPrevious
+
+/* Body of a compare-and-swap with lr/sc for words of xSize ("w" or
+ * portatomicPTR_SUFFIX).  xLrOrder and xScOrder are the ordering suffixes of
+ * the lr and the sc ("", ".aq", ".rl" or ".aqrl"). */
+#define portatomicCAS( xType, xSize, xLrOrder, xScOrder, pxDestination, xExchange, xComparand ) \
+    xType xPrevious;                                                        \
+    uint32_t ulFailed;                                                      \
+    __asm volatile ( "1: lr." xSize xLrOrder " %0, %2\n"                   \
+                     "   bne %0, %3, 2f\n"                                  \
+                     "   sc." xSize xScOrder " %1, %4, %2\n"               \
+                     "   bnez %1, 1b\n"                                     \
+                     "2:"                                                   \
+                     : "=&r" ( xPrevious ), "=&r" ( ulFailed ), "+A" ( *( pxDestination ) ) \
+                     : "r" ( xComparand ), "r" ( xExchange )                \
+                     : "memory" );                                          \
+    return ( xPrevious == ( xComparand ) ) ? ATOMIC_COMPARE_AND_SWAP_SUCCESS : ATOMIC_COMPARE_AND_SWAP_FAILURE
+
+/*----------------------------- Swap && CAS ------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32( uint32_t volatile * pulDestination,
+                                                            uint32_t ulExchange,
+                                                            uint32_t ulComparand )
+{
+    portatomicCAS( uint32_t, "w", ".aqrl", ".rl", pulDestination, ulExchange, ulComparand );
+}
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32_Acquire( uint32_t volatile * pulDestination,
+                                                                    uint32_t ulExchange,
+                                                                    uint32_t ulComparand )
+{
+    portatomicCAS( uint32_t, "w", ".aq", "", pulDestination, ulExchange, ulComparand );
+}
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32_Release( uint32_t volatile * pulDestination,
+                                                                    uint32_t ulExchange,
+                                                                    uint32_t ulComparand )
+{
+    portatomicCAS( uint32_t, "w", "", ".rl", pulDestination, ulExchange, ulComparand );
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_Swap_u32( uint32_t volatile * pulDestination,
+                                                  uint32_t ulExchange )
+{
+    portatomicAMO( "amoswap.w.aqrl", pulDestination, ulExchange );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Swap_u32_Acquire( uint32_t volatile * pulDestination,
+                                                          uint32_t ulExchange )
+{
+    portatomicAMO( "amoswap.w.aq", pulDestination, ulExchange );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Swap_u32_Release( uint32_t volatile * pulDestination,
+                                                          uint32_t ulExchange )
+{
+    portatomicAMO( "amoswap.w.rl", pulDestination, ulExchange );
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE void * Atomic_SwapPointers_p32( void * volatile * ppvDestination,
+                                                        void * pvExchange )
+{
+    void * pvPrevious;
+
+    __asm volatile ( "amoswap." portatomicPTR_SUFFIX ".aqrl %0, %2, %1"
+                     : "=r" ( pvPrevious ), "+A" ( *ppvDestination )
+                     : "r" ( pvExchange )
+                     : "memory" );
+
+    return pvPrevious;
+}
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32( void * volatile * ppvDestination,
+                                                                    void * pvExchange,
+                                                                    void * pvComparand )
+{
+    portatomicCAS( void *, portatomicPTR_SUFFIX, ".aqrl", ".rl", ppvDestination, pvExchange, pvComparand );
+}
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32_Acquire( void * volatile * ppvDestination,
+                                                                            void * pvExchange,
+                                                                            void * pvComparand )
+{
+    portatomicCAS( void *, portatomicPTR_SUFFIX, ".aq", "", ppvDestination, pvExchange, pvComparand );
+}
+
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32_Release( void * volatile * ppvDestination,
+                                                                            void * pvExchange,
+                                                                            void * pvComparand )
+{
+    portatomicCAS( void *, portatomicPTR_SUFFIX, "", ".rl", ppvDestination, pvExchange, pvComparand );
+}
+
+/*----------------------------- Arithmetic ------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_Add_u32( uint32_t volatile * pulAddend,
+                                                 uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.aqrl", pulAddend, ulCount );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Add_u32_Acquire( uint32_t volatile * pulAddend,
+                                                         uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.aq", pulAddend, ulCount );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Add_u32_Release( uint32_t volatile * pulAddend,
+                                                         uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.rl", pulAddend, ulCount );
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_Subtract_u32( uint32_t volatile * pulAddend,
+                                                      uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.aqrl", pulAddend, -ulCount );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Subtract_u32_Acquire( uint32_t volatile * pulAddend,
+                                                              uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.aq", pulAddend, -ulCount );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Subtract_u32_Release( uint32_t volatile * pulAddend,
+                                                              uint32_t ulCount )
+{
+    portatomicAMO( "amoadd.w.rl", pulAddend, -ulCount );
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_Increment_u32( uint32_t volatile * pulAddend )
+{
+    portatomicAMO( "amoadd.w.aqrl", pulAddend, 1U );
+}
+
+static portFORCE_INLINE uint32_t Atomic_Decrement_u32( uint32_t volatile * pulAddend )
+{
+    portatomicAMO( "amoadd.w.aqrl", pulAddend, ( uint32_t ) -1 );
+}
+
+/*----------------------------- Bitwise Logical ------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_OR_u32( uint32_t volatile * pulDestination,
+                                                uint32_t ulValue )
+{
+    portatomicAMO( "amoor.w.aqrl", pulDestination, ulValue );
+}
+
+static portFORCE_INLINE uint32_t Atomic_OR_u32_Acquire( uint32_t volatile * pulDestination,
+                                                        uint32_t ulValue )
+{
+    portatomicAMO( "amoor.w.aq", pulDestination, ulValue );
+}
+
+static portFORCE_INLINE uint32_t Atomic_OR_u32_Release( uint32_t volatile * pulDestination,
+                                                        uint32_t ulValue )
+{
+    portatomicAMO( "amoor.w.rl", pulDestination, ulValue );
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_AND_u32( uint32_t volatile * pulDestination,
+                                                 uint32_t ulValue )
+{
+    portatomicAMO( "amoand.w.aqrl", pulDestination, ulValue );
+}
+
+static portFORCE_INLINE uint32_t Atomic_AND_u32_Acquire( uint32_t volatile * pulDestination,
+                                                         uint32_t ulValue )
+{
+    portatomicAMO( "amoand.w.aq", pulDestination, ulValue );
+}
+
+static portFORCE_INLINE uint32_t Atomic_AND_u32_Release( uint32_t volatile * pulDestination,
+                                                         uint32_t ulValue )
+{
+    portatomicAMO( "amoand.w.rl", pulDestination, ulValue );
+}
+/*-----------------------------------------------------------*/
+
+/* There is no NAND AMO, so this one is an lr/sc loop. */
+static portFORCE_INLINE uint32_t Atomic_NAND_u32( uint32_t volatile * pulDestination,
+                                                  uint32_t ulValue )
+{
+    uint32_t ulPrevious;
+    uint32_t ulNew;
+    uint32_t ulFailed;
+
+    __asm volatile ( "1: lr.w.aqrl %0, %3\n"
+                     "   and %1, %0, %4\n"
+                     "   not %1, %1\n"
+                     "   sc.w.rl %2, %1, %3\n"
+                     "   bnez %2, 1b"
+                     : "=&r" ( ulPrevious ), "=&r" ( ulNew ), "=&r" ( ulFailed ), "+A" ( *pulDestination )
+                     : "r" ( ulValue )
+                     : "memory" );
+
+    return ulPrevious;
+}
+/*-----------------------------------------------------------*/
+
+static portFORCE_INLINE uint32_t Atomic_XOR_u32( uint32_t volatile * pulDestination,
+                                                 uint32_t ulValue )
+{
+    portatomicAMO( "amoxor.w.aqrl", pulDestination, ulValue );
+}
+
+/*----------------------------- Load && Store ------------------------------*/
+
+/* Aligned word loads and stores are single-copy atomic, they only need the
+ * fences that give them their ordering. */
+static portFORCE_INLINE uint32_t Atomic_Load_u32_Acquire( uint32_t const volatile * pulSource )
+{
+    uint32_t ulValue = *pulSource;
+
+    __asm volatile ( "fence r, rw" ::: "memory" );
+
+    return ulValue;
+}
+
+static portFORCE_INLINE void Atomic_Store_u32_Release( uint32_t volatile * pulDestination,
+                                                       uint32_t ulValue )
+{
+    __asm volatile ( "fence rw, w" ::: "memory" );
+    *pulDestination = ulValue;
+}
+
+#undef portatomicAMO
+#undef portatomicCAS
+
+#endif /* PORTATOMIC_H */
@@ -90,6 +90,11 @@ extern "C"
 #define portBYTE_ALIGNMENT 16
 #endif
 
+/* In the FPU builds (configENABLE_FPU) the trap handlers, the tick hook and
+ * the functions run by xPortRemoteCall() must not use the FPU.  A trap that
+ * does not switch tasks does not save the FPU registers, so the trap entry
+ * turns the FPU off until the trap returns (see portContext.h). */
+
 /* SMP utilities*/
 #ifndef configNUMBER_OF_CORES
 #define configNUMBER_OF_CORES 4
@@ -104,10 +109,10 @@ extern "C"
 extern void vTaskSwitchContext(void); // SMP utilities
 #endif
 
-#define portYIELD() __asm volatile("ecall");
-
-
-extern volatile size_t pxCriticalNesting[configNUMBER_OF_CORES];
+/* A voluntary switch is a call into the port, which saves only the registers
+ * a function call preserves; an ecall is handled as a full trap. */
+extern void vPortYield(void);
+#define portYIELD() vPortYield()
 
 
 #define portDISABLE_INTERRUPTS_BEFORE_SCHED() \
@@ -140,11 +145,101 @@ extern void vTaskExitCritical( void );
 
     /* SMP utilities*/
 BaseType_t rtos_core_id_get(void);
-#define portGET_CORE_ID() rtos_core_id_get()
+
+/* The kernel asks for the core ID all the time, so it reads mhartid inline
+ * rather than calling rtos_core_id_get(). */
+static inline BaseType_t xPortGetCoreID(void)
+{
+    UBaseType_t uxCoreID;
+
+    __asm volatile("csrr %0, mhartid" : "=r"(uxCoreID));
+
+    return (BaseType_t)uxCoreID;
+}
+#define portGET_CORE_ID() xPortGetCoreID()
 
 void vPortYieldOtherCore(UBaseType_t xCoreID);
 #define portYIELD_CORE(x) vPortYieldOtherCore((x))
 
+/* Inter-processor interrupts.  The sender ORs the reasons into a per-hart
+ * word before it raises the target's MSIP bit, and the target handles every
+ * reason collected by the time it takes the interrupt. */
+#define portIPI_REASON_YIELD        (1UL << 0)  /* Reschedule. */
+#define portIPI_REASON_CALL         (1UL << 1)  /* Run the calls queued in the mailbox. */
+
+void vPortSendIPI(UBaseType_t xCoreID, uint32_t ulReasons);
+
+/* A hart raises at most one software interrupt per target until the target
+ * has collected the reasons; later requests are only merged into the reason
+ * word.  While the sender holds a kernel lock the interrupt is deferred until
+ * the lock is released.  The counters below are kept per hart. */
+typedef struct xPORT_IPI_STATS
+{
+    uint32_t ulSent;            /* Software interrupts raised by the hart. */
+    uint32_t ulSuppressed;      /* Requests merged into an interrupt that was already pending. */
+    uint32_t ulReceived;        /* Software interrupts taken by the hart. */
+} PortIPIStats_t;
+
+void vPortGetIPIStats(UBaseType_t xCoreID, PortIPIStats_t *pxStats);
+
+/* Remote function calls.  Every hart has a mailbox of
+ * configPORT_REMOTE_CALL_QUEUE_LENGTH calls, which it runs from its software
+ * interrupt - with interrupts disabled, so the functions must be short and
+ * may only use the FromISR API.  Like the interrupt handlers they must not use
+ * the FPU (see portContext.h).  A function returns pdTRUE if it made a task
+ * ready that should preempt the task running on its hart.
+ *
+ * xPortRemoteCall() runs pxFunction on every hart in uxCoreMask (which may
+ * include the calling hart) and returns once all of them have finished.  It
+ * may be called from tasks and interrupts, but not from inside a critical
+ * section, and it waits for room in a full mailbox.  A task waits with
+ * interrupts enabled and may be moved to another hart meanwhile.
+ *
+ * xPortRemoteCallAsync() returns once the calls are queued.  If pxCompletion
+ * is not NULL, portREMOTE_CALL_IS_COMPLETE() tells when they have all run.
+ * Harts whose mailbox is full are skipped, in which case pdFAIL is
+ * returned. */
+#ifndef configUSE_PORT_REMOTE_CALLS
+#define configUSE_PORT_REMOTE_CALLS 0
+#endif
+
+#ifndef configPORT_REMOTE_CALL_QUEUE_LENGTH
+#define configPORT_REMOTE_CALL_QUEUE_LENGTH 8
+#endif
+
+#if (configUSE_PORT_REMOTE_CALLS == 1)
+typedef BaseType_t (*PortRemoteFunction_t)(void *pvParameter);
+
+typedef struct xPORT_REMOTE_CALL_COMPLETION
+{
+    volatile uint32_t ulPending;    /* Number of harts that have not run the call yet. */
+} PortRemoteCallCompletion_t;
+
+BaseType_t xPortRemoteCall(UBaseType_t uxCoreMask, PortRemoteFunction_t pxFunction, void *pvParameter);
+BaseType_t xPortRemoteCallAsync(UBaseType_t uxCoreMask,
+                                PortRemoteFunction_t pxFunction,
+                                void *pvParameter,
+                                PortRemoteCallCompletion_t *pxCompletion);
+#define portREMOTE_CALL_IS_COMPLETE(pxCompletion) ((pxCompletion)->ulPending == 0U)
+#endif
+
+/* Tickless idle.  Idle harts sleep in wfi, and the tick hart stops the tick
+ * while every hart is asleep.  A sleeping hart is woken with a software
+ * interrupt when a task it can run is made ready. */
+#if (configUSE_TICKLESS_IDLE != 0)
+extern volatile uint32_t ulPortSleepingHarts;
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+void vPortWakeSleepingCores(UBaseType_t uxCoreMask);
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) vPortSuppressTicksAndSleep((xExpectedIdleTime))
+#define portWAKE_SLEEPING_CORES(uxCoreMask)                           \
+    do {                                                              \
+        if ((ulPortSleepingHarts & (uint32_t)(uxCoreMask)) != 0U)     \
+        {                                                             \
+            vPortWakeSleepingCores((uxCoreMask));                     \
+        }                                                             \
+    } while (0)
+#endif
+
 extern UBaseType_t vTaskEnterCriticalFromISR(void);
 extern void vTaskExitCriticalFromISR(UBaseType_t);
 
@@ -152,9 +247,117 @@ extern void vTaskExitCriticalFromISR(UBaseType_t);
 #define portEXIT_CRITICAL_FROM_ISR vTaskExitCriticalFromISR   
 
 
-extern bool RvSpinTryLock( volatile uint32_t *lock );
-extern void RvSpinLock( volatile uint32_t *lock );
-extern void RvSpinUnlock( volatile uint32_t *lock );
+/* Spinlock implementations, selected with configPORT_SPINLOCK_TYPE. */
+#define portSPINLOCK_TYPE_TAS       0   /* Test-and-test-and-set on a single word. */
+#define portSPINLOCK_TYPE_TICKET    1   /* FIFO ticket lock. */
+#define portSPINLOCK_TYPE_MCS       2   /* MCS queue lock, every hart spins on its own node. */
+
+#ifndef configPORT_SPINLOCK_TYPE
+#define configPORT_SPINLOCK_TYPE portSPINLOCK_TYPE_TAS
+#endif
+
+/* Used to keep per-hart data that is written often in separate cache lines. */
+#ifndef configPORT_CACHE_LINE_SIZE
+#define configPORT_CACHE_LINE_SIZE 64
+#endif
+#define portCACHE_LINE_ALIGNED __attribute__((aligned(configPORT_CACHE_LINE_SIZE)))
+#define portCACHE_LINE_SIZE configPORT_CACHE_LINE_SIZE
+
+/* Number of MCS queue nodes each hart owns, which bounds how many MCS locks
+ * one hart can hold (or wait for) at the same time. */
+#ifndef configPORT_MCS_NODES_PER_CORE
+#define configPORT_MCS_NODES_PER_CORE 4
+#endif
+
+#ifndef RTOS_LOCK_COUNT
+#define RTOS_LOCK_COUNT 2
+#endif
+
+/* Wait for contended kernel locks with interrupts enabled, masking them only
+ * for the attempt that takes the locks (see xPortTakeKernelLocks()).  Such a
+ * wait gives up the FIFO order of the ticket and MCS locks. */
+#ifndef configPORT_INTERRUPTIBLE_LOCK_WAIT
+#define configPORT_INTERRUPTIBLE_LOCK_WAIT 0
+#endif
+
+/* Track the longest interrupt-off section of the kernel critical sections on
+ * every hart (see vPortGetIrqOffStats()). */
+#ifndef configPORT_IRQ_OFF_STATS
+#define configPORT_IRQ_OFF_STATS 0
+#endif
+
+/* Trap entry/exit cycle counters in the CPU-local block, selected with
+ * "make TRAP_STATS=1" so the assembler sees the same setting. */
+#ifndef configPORT_TRAP_CYCLE_STATS
+#define configPORT_TRAP_CYCLE_STATS 0
+#endif
+
+/* Per-hart CPU-local block.  Each hart keeps the address of its own block in
+ * mscratch, so the trap entry and exit reach it with a single CSR read.  The
+ * fields up to uxTrapFastReturns are also accessed from assembly, through the
+ * portCPU_LOCAL_* offsets in portContext.h. */
+typedef struct xPORT_CPU_LOCAL
+{
+    StackType_t *pxISRStackTop;                 /* Top of the hart's ISR stack. */
+    UBaseType_t uxCoreID;
+    void *volatile *ppxCurrentTCB;              /* &pxCurrentTCBs[ uxCoreID ]. */
+    volatile UBaseType_t uxCriticalNesting;     /* taskENTER_CRITICAL() nesting of the task running on the hart. */
+    void *pvFPUContext;                         /* FPU context area of the task running on the hart (configENABLE_FPU). */
+    void *pvFPUOwner;                           /* FPU context area last loaded into or saved from the hart's FPU (configENABLE_FPU). */
+    UBaseType_t uxTrapStart;                    /* mcycle at the start of the current trap entry or exit. */
+    UBaseType_t uxTraps;                        /* Traps taken (configPORT_TRAP_CYCLE_STATS). */
+    UBaseType_t uxTrapEntryCycles;              /* Cycles from the trap to its handler, summed over uxTraps. */
+    UBaseType_t uxTrapExitCycles;               /* Cycles from the handler back to the task, summed over uxTraps. */
+    UBaseType_t uxTrapFastReturns;              /* Traps of uxTraps that returned without saving s0-s11. */
+    uint8_t ucOwnedByCore[RTOS_LOCK_COUNT];     /* Kernel locks held by the hart. */
+    uint8_t ucRecursionCount[RTOS_LOCK_COUNT];
+} portCACHE_LINE_ALIGNED PortCpuLocal_t;
+
+extern PortCpuLocal_t xPortCpuLocal[configNUMBER_OF_CORES];
+
+/* The CPU-local block of the calling hart, valid once the hart has started
+ * its scheduler. */
+static inline PortCpuLocal_t *pxPortGetCpuLocal(void)
+{
+    PortCpuLocal_t *pxCpuLocal;
+
+    __asm volatile("csrr %0, mscratch" : "=r"(pxCpuLocal));
+
+    return pxCpuLocal;
+}
+
+struct xPORT_MCS_NODE;
+
+typedef struct xPORT_SPINLOCK
+{
+#if (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_TAS)
+    volatile uint32_t ulLock;                   /* 0 when free, owner hart ID + 1 when taken. */
+#elif (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_TICKET)
+    volatile uint32_t ulNextTicket;             /* Ticket handed to the next hart that arrives. */
+    volatile uint32_t ulNowServing;             /* Ticket of the hart that owns the lock. */
+#elif (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_MCS)
+    struct xPORT_MCS_NODE *volatile pxTail;     /* Last hart in the wait queue, NULL when free. */
+    struct xPORT_MCS_NODE *pxOwnerNode;         /* Node of the owning hart, needed on release. */
+#else
+#error "Unknown configPORT_SPINLOCK_TYPE"
+#endif
+} PortSpinlock_t;
+
+/* All spinlock types are free when zeroed. */
+#define portSPINLOCK_STATIC_INIT { 0 }
+
+/* Plain (non-recursive) spinlocks.  These must be called with interrupts
+ * disabled, and xCoreID must be the ID of the calling hart. */
+void vPortSpinlockInit(PortSpinlock_t *pxLock);
+void vPortSpinlockTake(PortSpinlock_t *pxLock, BaseType_t xCoreID);
+BaseType_t xPortSpinlockTryTake(PortSpinlock_t *pxLock, BaseType_t xCoreID);
+void vPortSpinlockGive(PortSpinlock_t *pxLock, BaseType_t xCoreID);
+
+/* Spinlocks embedded in kernel objects (configUSE_PER_OBJECT_LOCKS). */
+#define portSPINLOCK_TYPE                           PortSpinlock_t
+#define portINIT_SPINLOCK( pxLock )                 vPortSpinlockInit( ( pxLock ) )
+#define portGET_SPINLOCK( xCoreID, pxLock )         vPortSpinlockTake( ( pxLock ), ( xCoreID ) )
+#define portRELEASE_SPINLOCK( xCoreID, pxLock )     vPortSpinlockGive( ( pxLock ), ( xCoreID ) )
 
 extern void vPortRecursiveLock( BaseType_t xCoreID,
                                 uint32_t ulLockNum,
@@ -165,6 +368,32 @@ extern void vPortRecursiveLock( BaseType_t xCoreID,
 #define portGET_TASK_LOCK( xCore )         vPortRecursiveLock( ( xCore ), 1, pdTRUE )
 #define portRELEASE_TASK_LOCK( xCore )     vPortRecursiveLock( ( xCore ), 1, pdFALSE )
 
+/* Takes the task lock, and the ISR lock too if xIncludeIsrLock is pdTRUE, for
+ * the outermost vTaskEnterCritical() or vTaskSuspendAll().  Called with
+ * interrupts masked; uxInterruptStatus is the portSET_INTERRUPT_MASK() value
+ * of the caller.  With configPORT_INTERRUPTIBLE_LOCK_WAIT, a hart that holds
+ * neither kernel lock waits for contended locks with that state restored, so
+ * the calling task may be switched out and resumed on another hart meanwhile.
+ * Returns the ID of the hart the locks were taken on. */
+extern BaseType_t xPortTakeKernelLocks( UBaseType_t uxInterruptStatus,
+                                        BaseType_t xIncludeIsrLock );
+
+#define portGET_KERNEL_LOCKS( uxInterruptStatus, xIncludeIsrLock )    xPortTakeKernelLocks( ( uxInterruptStatus ), ( xIncludeIsrLock ) )
+
+#if (configPORT_IRQ_OFF_STATS == 1)
+typedef struct xPORT_IRQ_OFF_STATS
+{
+    uint32_t ulMaxCycles;       /* Longest kernel critical section with interrupts masked. */
+    uint32_t ulTotalCycles;     /* Summed over ulSections. */
+    uint32_t ulSections;        /* Critical sections measured. */
+} PortIrqOffStats_t;
+
+void vPortGetIrqOffStats(UBaseType_t xCoreID, PortIrqOffStats_t *pxStats);
+
+/* Clears the counters of the calling hart. */
+void vPortResetIrqOffStats(void);
+#endif
+
 // extern void vPortTakeTaskLock(void);
 // extern void vPortReleaseTaskLock(void);
 // extern void vPortTakeIsrLock(void);
@@ -199,10 +428,14 @@ static inline void vPortCLEAR_INTERRUPT_MASK( UBaseType_t uxSaved )
     }
 }
 
-// #define portGET_CRITICAL_NESTING_COUNT(core)   ( pxCriticalNesting[(core)] )
-// #define portSET_CRITICAL_NESTING_COUNT(core, x) ( pxCriticalNesting[(core)] = (x) )
-// #define portINCREMENT_CRITICAL_NESTING_COUNT(core) ( pxCriticalNesting[(core)]++ )
-// #define portDECREMENT_CRITICAL_NESTING_COUNT(core) ( pxCriticalNesting[(core)]-- )
+/* A task is never switched out inside a critical section, so the nesting
+ * count can live with the hart rather than in the TCB. */
+#if (portCRITICAL_NESTING_IN_TCB == 0)
+#define portGET_CRITICAL_NESTING_COUNT(xCoreID)        (xPortCpuLocal[(xCoreID)].uxCriticalNesting)
+#define portSET_CRITICAL_NESTING_COUNT(xCoreID, x)     (xPortCpuLocal[(xCoreID)].uxCriticalNesting = (x))
+#define portINCREMENT_CRITICAL_NESTING_COUNT(xCoreID)  (xPortCpuLocal[(xCoreID)].uxCriticalNesting++)
+#define portDECREMENT_CRITICAL_NESTING_COUNT(xCoreID)  (xPortCpuLocal[(xCoreID)].uxCriticalNesting--)
+#endif
 
 
 
@@ -231,6 +464,24 @@ static inline void vPortCLEAR_INTERRUPT_MASK( UBaseType_t uxSaved )
 
 /*-----------------------------------------------------------*/
 
+/* Run time stats are counted in cycles of the hart that reads the counter.
+ * All harts leave reset together, so their mcycle values stay close enough
+ * for run times measured on one hart to be compared with those of another. */
+#if (configGENERATE_RUN_TIME_STATS == 1) && !defined(portGET_RUN_TIME_COUNTER_VALUE)
+static inline UBaseType_t uxPortGetRunTimeCounter(void)
+{
+    UBaseType_t uxCycles;
+
+    __asm volatile("csrr %0, mcycle" : "=r"(uxCycles));
+
+    return uxCycles;
+}
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() uxPortGetRunTimeCounter()
+#endif
+
+/*-----------------------------------------------------------*/
+
 /* Task function macros as described on the FreeRTOS.org WEB site. These are
  * not necessary for to use this port.  They are defined so the common demo
  * files (which build with all the ports) will build. */
@@ -247,6 +498,12 @@ static inline void vPortCLEAR_INTERRUPT_MASK( UBaseType_t uxSaved )
 #endif
 
 #define portMEMORY_BARRIER()    __asm volatile ( "fence iorw, iorw" ::: "memory" )
+
+/* atomic.h is implemented with the A extension (portatomic.h) rather than with
+ * critical sections, which on SMP would take both kernel locks. */
+#ifdef __riscv_atomic
+#define portHAS_NATIVE_ATOMICS 1
+#endif
 /*-----------------------------------------------------------*/
 
 /* configCLINT_BASE_ADDRESS is a legacy definition that was replaced by the
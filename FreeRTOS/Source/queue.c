@@ -77,6 +77,15 @@ typedef struct SemaphoreData
     UBaseType_t uxRecursiveCallCount; /**< Maintains a count of the number of times a recursive mutex has been recursively 'taken' when the structure is used as a mutex. */
 } SemaphoreData_t;
 
+/* Each item in a priority queue is preceded by this header, which orders the
+ * items in the heap held in the storage area.  queuePRIORITY_QUEUE_ENTRY_SIZE()
+ * in queue.h *must* match it. */
+typedef struct QueuePriorityHeader
+{
+    UBaseType_t uxPriority; /**< The priority the item was sent with. */
+    UBaseType_t uxSequence; /**< The queue's uxNextSequence when the item was sent, so items of equal priority are received in the order they were sent. */
+} QueuePriorityHeader_t;
+
 /* Semaphores do not actually store or copy data, so have an item size of
  * zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH    ( ( UBaseType_t ) 0 )
@@ -133,6 +142,28 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        portSPINLOCK_TYPE xObjectLock; /**< Protects the storage area, the counters and the cRxLock/cTxLock members.  Always taken after the kernel locks. */
+    #endif
+
+    #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        int8_t * pcClaimedSlot;  /**< The slot at pcWriteTo handed out by xQueueClaim() and not yet committed, or NULL. */
+        int8_t * pcBorrowedItem; /**< The item at the front of the queue handed out by xQueueBorrow() and not yet released, or NULL. */
+    #endif
+
+    #if ( configUSE_QUEUE_WORD_COPY == 1 )
+        uint8_t ucItemWords; /**< 1 or 2 if an item is that many 32-bit words long and the storage area is word aligned, so items can be copied with word loads and stores, otherwise 0. */
+    #endif
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+        UBaseType_t uxEntrySize;    /**< For a priority queue, the size of a QueuePriorityHeader_t and the item that follows it in the storage area.  0 for every other queue. */
+        UBaseType_t uxNextSequence; /**< Stamped on the next item sent to a priority queue. */
+    #endif
+
+    #if ( configUSE_QUEUE_STATS == 1 )
+        QueueStats_t xStats; /**< Returned by vQueueGetStats() and uxQueueGetRegistryStats(). */
+    #endif
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -190,11 +221,13 @@ static void prvUnlockQueue( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue ) PRIVILEGED_FUNCTION;
 
 /*
- * Uses a critical section to determine if there is any space in a queue.
+ * Uses a critical section to determine if there is any space in a queue for
+ * an item sent to xCopyPosition.
  *
  * @return pdTRUE if there is no space, otherwise pdFALSE;
  */
-static BaseType_t prvIsQueueFull( const Queue_t * pxQueue ) PRIVILEGED_FUNCTION;
+static BaseType_t prvIsQueueFull( const Queue_t * pxQueue,
+                                  const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 
 /*
  * Copies an item into the queue, either at the front of the queue or the
@@ -219,6 +252,140 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
     static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_PER_OBJECT_LOCKS == 1 )
+
+/*
+ * Attempt to send or receive an item while holding only the queue's own
+ * spinlock.  These succeed only if the operation can complete without moving
+ * a task out of an event list (no task is waiting on the other side, or the
+ * queue is locked and the unblocking is left to prvUnlockQueue()).  Mutexes
+ * and queue set members always use the kernel critical section.
+ *
+ * @return pdTRUE if the item was sent/received, otherwise pdFALSE, in which
+ * case the caller must fall back to the normal path.
+ */
+    static BaseType_t prvTrySendWithObjectLock( Queue_t * const pxQueue,
+                                                const void * const pvItemToQueue,
+                                                const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvTryReceiveWithObjectLock( Queue_t * const pxQueue,
+                                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+/*
+ * Add the claimed slot to the back of the queue, or remove the borrowed item
+ * from the front of the queue, then unblock the tasks that may now be able to
+ * send or receive.  Called from a critical section.  When xFromISR is pdTRUE
+ * and the queue is locked the event lists are left alone and the lock counts
+ * are incremented instead, as for the other FromISR functions.
+ *
+ * @return pdTRUE if a task that should preempt the calling task was unblocked,
+ * otherwise pdFALSE.
+ */
+    static BaseType_t prvCommitClaimedSlot( Queue_t * const pxQueue,
+                                            const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvReleaseBorrowedItem( Queue_t * const pxQueue,
+                                              const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+/*
+ * Copy uxItems items to the back of the queue, or from the front of the queue
+ * into pvBuffer, then unblock one waiting task for each item moved.  The caller
+ * has checked the items fit, or are in the queue.  Called from a critical
+ * section.  When xFromISR is pdTRUE and the queue is locked the event lists
+ * are left alone and the lock counts are incremented instead, as for the other
+ * FromISR functions.
+ *
+ * @return pdTRUE if a task that should preempt the calling task was unblocked,
+ * otherwise pdFALSE.
+ */
+    static BaseType_t prvSendMultipleToQueue( Queue_t * const pxQueue,
+                                              const void * pvItems,
+                                              const UBaseType_t uxItems,
+                                              const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvReceiveMultipleFromQueue( Queue_t * const pxQueue,
+                                                   void * const pvBuffer,
+                                                   const UBaseType_t uxItems,
+                                                   const BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( ( configUSE_QUEUE_ZERO_COPY == 1 ) || ( configUSE_QUEUE_BATCHING == 1 ) )
+
+/*
+ * Unblock up to uxTasksToUnblock of the tasks waiting in pxEventList, highest
+ * priority first.  Used when more than one waiting task may now be able to
+ * proceed: after a batch of items was sent or received, or when tasks held off
+ * by a claimed slot or a borrowed item, which block on the same lists as tasks
+ * held off by a full or empty queue, have to retry.  pxEventList is one of the
+ * event lists of pxQueue.  Called from a critical section.
+ *
+ * @return pdTRUE if a task that should preempt the calling task was unblocked,
+ * otherwise pdFALSE.
+ */
+    static BaseType_t prvUnblockWaitingTasks( Queue_t * const pxQueue,
+                                              List_t * const pxEventList,
+                                              UBaseType_t uxTasksToUnblock ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_STATS == 1 )
+
+/*
+ * Count a task that blocked on the queue, at ulBlockStartTime, in the
+ * statistics counter pulBlocks, and add the time until it ran again to the
+ * blocked time.  Called by the task once it has run again, outside a critical
+ * section.
+ */
+    static void prvRecordBlockedTime( Queue_t * const pxQueue,
+                                      uint32_t * const pulBlocks,
+                                      const configRUN_TIME_COUNTER_TYPE ulBlockStartTime ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+/*
+ * xTaskRemoveFromEventList() that also counts, in the statistics of pxQueue,
+ * the tasks it unblocked that another core has been asked to run.  Called
+ * from a critical section.
+ */
+    static BaseType_t prvRemoveFromEventList( Queue_t * const pxQueue,
+                                              const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+/*
+ * The storage area of a priority queue holds a binary heap of
+ * uxMessagesWaiting entries, each a QueuePriorityHeader_t followed by the item,
+ * with the next item to receive in the first entry.  prvAddToHeap() inserts an
+ * item sent with priority uxPriority into a heap of uxEntries entries.
+ * prvRemoveFromHeap() drops the first entry once it has been copied out and
+ * uxMessagesWaiting has been decremented, and does nothing for other queues.
+ * Both are called from a critical section.
+ */
+    static void prvAddToHeap( Queue_t * const pxQueue,
+                              const void * pvItemToQueue,
+                              const UBaseType_t uxPriority,
+                              const UBaseType_t uxEntries ) PRIVILEGED_FUNCTION;
+    static void prvRemoveFromHeap( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * @return pdTRUE if the item with header pxEntry is to be received before the
+ * item with header pxOther, otherwise pdFALSE.
+ */
+    static BaseType_t prvIsReceivedBefore( const QueuePriorityHeader_t * const pxEntry,
+                                           const QueuePriorityHeader_t * const pxOther ) PRIVILEGED_FUNCTION;
+
+/*
+ * Turn a queue just created with room for its heap entries into a priority
+ * queue of uxItemSize byte items.
+ */
+    static void prvInitialisePriorityQueue( Queue_t * pxNewQueue,
+                                            const UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -251,12 +418,86 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
 #endif
 /*-----------------------------------------------------------*/
 
+/*
+ * When configUSE_PER_OBJECT_LOCKS is 1 each queue has its own spinlock that
+ * guards the queue data.  The kernel critical section is still needed whenever
+ * a task is moved between an event list and a ready list, so the critical
+ * section macros below take the kernel locks first and the queue lock second.
+ * Sends and receives that do not need to unblock a task only take the queue
+ * lock - see prvTrySendWithObjectLock() and prvTryReceiveWithObjectLock().
+ */
+#if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    #define queueGET_OBJECT_LOCK( pxQueue )        portGET_SPINLOCK( portGET_CORE_ID(), ( portSPINLOCK_TYPE * ) &( ( pxQueue )->xObjectLock ) )
+    #define queueRELEASE_OBJECT_LOCK( pxQueue )    portRELEASE_SPINLOCK( portGET_CORE_ID(), ( portSPINLOCK_TYPE * ) &( ( pxQueue )->xObjectLock ) )
+
+    #define queueENTER_CRITICAL( pxQueue )       \
+    do {                                         \
+        taskENTER_CRITICAL();                    \
+        queueGET_OBJECT_LOCK( pxQueue );         \
+    } while( 0 )
+
+    #define queueEXIT_CRITICAL( pxQueue )        \
+    do {                                         \
+        queueRELEASE_OBJECT_LOCK( pxQueue );     \
+        taskEXIT_CRITICAL();                     \
+    } while( 0 )
+
+    #define queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus )            \
+    do {                                                                               \
+        ( uxSavedInterruptStatus ) = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();    \
+        queueGET_OBJECT_LOCK( pxQueue );                                               \
+    } while( 0 )
+
+    #define queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus ) \
+    do {                                                                   \
+        queueRELEASE_OBJECT_LOCK( pxQueue );                               \
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );              \
+    } while( 0 )
+#else
+    #define queueENTER_CRITICAL( pxQueue )    taskENTER_CRITICAL()
+    #define queueEXIT_CRITICAL( pxQueue )     taskEXIT_CRITICAL()
+    #define queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus ) \
+    ( uxSavedInterruptStatus ) = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR()
+    #define queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus )  taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus )
+#endif /* configUSE_PER_OBJECT_LOCKS */
+
+/*
+ * Copy one item between the queue storage area and a task's buffer.  Items of
+ * one or two words are copied with word loads and stores, as long as the
+ * task's buffer is word aligned too, instead of through memcpy(), which is a
+ * function call and a loop for even the smallest item.
+ */
+#if ( configUSE_QUEUE_WORD_COPY == 1 )
+    #define queueIS_WORD_ALIGNED( pv )    ( ( ( portPOINTER_SIZE_TYPE ) ( pv ) & ( portPOINTER_SIZE_TYPE ) ( sizeof( uint32_t ) - 1U ) ) == 0U )
+
+    #define queueCOPY_ITEM( pxQueue, pvDestination, pvSource )                                                \
+    do {                                                                                                      \
+        if( ( ( pxQueue )->ucItemWords != ( uint8_t ) 0U ) &&                                                 \
+            queueIS_WORD_ALIGNED( ( portPOINTER_SIZE_TYPE ) ( pvDestination ) | ( portPOINTER_SIZE_TYPE ) ( pvSource ) ) ) \
+        {                                                                                                     \
+            ( ( uint32_t * ) ( pvDestination ) )[ 0 ] = ( ( const uint32_t * ) ( pvSource ) )[ 0 ];           \
+                                                                                                              \
+            if( ( pxQueue )->ucItemWords == ( uint8_t ) 2U )                                                  \
+            {                                                                                                 \
+                ( ( uint32_t * ) ( pvDestination ) )[ 1 ] = ( ( const uint32_t * ) ( pvSource ) )[ 1 ];       \
+            }                                                                                                 \
+        }                                                                                                     \
+        else                                                                                                  \
+        {                                                                                                     \
+            ( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), ( size_t ) ( pxQueue )->uxItemSize ); \
+        }                                                                                                     \
+    } while( 0 )
+#else
+    #define queueCOPY_ITEM( pxQueue, pvDestination, pvSource ) \
+    ( void ) memcpy( ( void * ) ( pvDestination ), ( const void * ) ( pvSource ), ( size_t ) ( pxQueue )->uxItemSize )
+#endif /* configUSE_QUEUE_WORD_COPY */
+
 /*
  * Macro to mark a queue as locked.  Locking a queue prevents an ISR from
  * accessing the queue event lists.
  */
 #define prvLockQueue( pxQueue )                            \
-    taskENTER_CRITICAL();                                  \
+    queueENTER_CRITICAL( pxQueue );                        \
     {                                                      \
         if( ( pxQueue )->cRxLock == queueUNLOCKED )        \
         {                                                  \
@@ -267,7 +508,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             ( pxQueue )->cTxLock = queueLOCKED_UNMODIFIED; \
         }                                                  \
     }                                                      \
-    taskEXIT_CRITICAL()
+    queueEXIT_CRITICAL( pxQueue )
 
 /*
  * Macro to increment cTxLock member of the queue data structure. It is
@@ -298,6 +539,82 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             ( pxQueue )->cRxLock = ( int8_t ) ( ( cRxLock ) + ( int8_t ) 1 ); \
         }                                                                     \
     } while( 0 )
+
+/*
+ * Macros to test whether an item can be written to the queue at xCopyPosition,
+ * and whether the item at the front of the queue can be read.  A slot claimed
+ * with xQueueClaim() sits at the back of the queue until it is committed, so
+ * nothing else can be written meanwhile.  An item borrowed with xQueueBorrow()
+ * stays at the front of the queue until it is released, so nothing else can be
+ * read, or written in front of it, meanwhile.
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    #define queueCAN_SEND( pxQueue, xCopyPosition )                                                                        \
+    ( ( ( ( pxQueue )->uxMessagesWaiting < ( pxQueue )->uxLength ) || ( ( xCopyPosition ) == queueOVERWRITE ) ) &&     \
+      ( ( pxQueue )->pcClaimedSlot == NULL ) &&                                                                        \
+      ( ( ( pxQueue )->pcBorrowedItem == NULL ) || ( ( xCopyPosition ) == queueSEND_TO_BACK ) ) )
+
+    #define queueCAN_RECEIVE( pxQueue, uxMessagesWaiting ) \
+    ( ( ( uxMessagesWaiting ) > ( UBaseType_t ) 0 ) && ( ( pxQueue )->pcBorrowedItem == NULL ) )
+#else
+    #define queueCAN_SEND( pxQueue, xCopyPosition ) \
+    ( ( ( pxQueue )->uxMessagesWaiting < ( pxQueue )->uxLength ) || ( ( xCopyPosition ) == queueOVERWRITE ) )
+
+    #define queueCAN_RECEIVE( pxQueue, uxMessagesWaiting )    ( ( uxMessagesWaiting ) > ( UBaseType_t ) 0 )
+#endif /* configUSE_QUEUE_ZERO_COPY */
+
+/*
+ * Priority queues keep their items in a heap, not a ring, so the functions
+ * that hand out or copy runs of slots in the ring cannot be used on them.
+ */
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+    #define queueIS_PRIORITY_QUEUE( pxQueue )         ( ( pxQueue )->uxEntrySize != ( UBaseType_t ) 0U )
+    #define queueHEAP_ENTRY( pxQueue, uxIndex )       ( ( pxQueue )->pcHead + ( ( uxIndex ) * ( pxQueue )->uxEntrySize ) )
+    #define queueHEAP_HEADER( pxQueue, uxIndex )      ( ( QueuePriorityHeader_t * ) queueHEAP_ENTRY( ( pxQueue ), ( uxIndex ) ) )
+#else
+    #define queueIS_PRIORITY_QUEUE( pxQueue )    ( pdFALSE )
+#endif /* configUSE_PRIORITY_QUEUES */
+
+/*
+ * Macros to update the statistics of a queue.  All but
+ * queueSTATS_RECORD_BLOCKED() are used from a critical section, where the
+ * number of items in the queue has just been updated.
+ */
+#if ( configUSE_QUEUE_STATS == 1 )
+    #define queueSTATS_RECORD_HIGH_WATER_MARK( pxQueue )                                            \
+    do {                                                                                            \
+        if( ( pxQueue )->uxMessagesWaiting > ( pxQueue )->xStats.uxMessagesWaitingHighWaterMark )   \
+        {                                                                                           \
+            ( pxQueue )->xStats.uxMessagesWaitingHighWaterMark = ( pxQueue )->uxMessagesWaiting;    \
+        }                                                                                           \
+    } while( 0 )
+
+    #define queueSTATS_RECORD_SENT( pxQueue, uxItems )                 \
+    do {                                                               \
+        ( pxQueue )->xStats.ulSends += ( uint32_t ) ( uxItems );       \
+        queueSTATS_RECORD_HIGH_WATER_MARK( pxQueue );                  \
+    } while( 0 )
+
+    #define queueSTATS_RECORD_RECEIVED( pxQueue, uxItems )    ( ( pxQueue )->xStats.ulReceives += ( uint32_t ) ( uxItems ) )
+
+    #define queueSTATS_RECORD_BLOCKED( pxQueue, xCounter, ulBlockStartTime ) \
+    prvRecordBlockedTime( ( pxQueue ), &( ( pxQueue )->xStats.xCounter ), ( ulBlockStartTime ) )
+#else
+    #define queueSTATS_RECORD_HIGH_WATER_MARK( pxQueue )
+    #define queueSTATS_RECORD_SENT( pxQueue, uxItems )
+    #define queueSTATS_RECORD_RECEIVED( pxQueue, uxItems )
+    #define queueSTATS_RECORD_BLOCKED( pxQueue, xCounter, ulBlockStartTime )
+#endif /* configUSE_QUEUE_STATS */
+
+/*
+ * Used in place of xTaskRemoveFromEventList() for the event lists of a queue,
+ * so the cross-core wakeups can be counted.
+ */
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #define queueREMOVE_FROM_EVENT_LIST( pxQueue, pxEventList )    prvRemoveFromEventList( ( pxQueue ), ( pxEventList ) )
+#else
+    #define queueREMOVE_FROM_EVENT_LIST( pxQueue, pxEventList )    xTaskRemoveFromEventList( pxEventList )
+#endif
 /*-----------------------------------------------------------*/
 
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
@@ -315,7 +632,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
         /* Check for multiplication overflow. */
         ( ( SIZE_MAX / pxQueue->uxLength ) >= pxQueue->uxItemSize ) )
     {
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxQueue );
         {
             pxQueue->u.xQueue.pcTail = pxQueue->pcHead + ( pxQueue->uxLength * pxQueue->uxItemSize );
             pxQueue->uxMessagesWaiting = ( UBaseType_t ) 0U;
@@ -324,6 +641,13 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             pxQueue->cRxLock = queueUNLOCKED;
             pxQueue->cTxLock = queueUNLOCKED;
 
+            #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+            {
+                pxQueue->pcClaimedSlot = NULL;
+                pxQueue->pcBorrowedItem = NULL;
+            }
+            #endif
+
             if( xNewQueue == pdFALSE )
             {
                 /* If there are tasks blocked waiting to read from the queue, then
@@ -333,7 +657,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
                  * it will be possible to write to it. */
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
                     {
                         queueYIELD_IF_USING_PREEMPTION();
                     }
@@ -354,7 +678,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
                 vListInitialise( &( pxQueue->xTasksWaitingToReceive ) );
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxQueue );
     }
     else
     {
@@ -594,6 +918,43 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
      * defined. */
     pxNewQueue->uxLength = uxQueueLength;
     pxNewQueue->uxItemSize = uxItemSize;
+
+    #if ( configUSE_QUEUE_WORD_COPY == 1 )
+    {
+        /* Every item is word aligned if the storage area is, as the item size
+         * is a whole number of words. */
+        if( ( ( uxItemSize == ( UBaseType_t ) sizeof( uint32_t ) ) || ( uxItemSize == ( UBaseType_t ) ( 2U * sizeof( uint32_t ) ) ) ) &&
+            ( queueIS_WORD_ALIGNED( pucQueueStorage ) ) )
+        {
+            pxNewQueue->ucItemWords = ( uint8_t ) ( uxItemSize / ( UBaseType_t ) sizeof( uint32_t ) );
+        }
+        else
+        {
+            pxNewQueue->ucItemWords = ( uint8_t ) 0U;
+        }
+    }
+    #endif
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+    {
+        /* Set by prvInitialisePriorityQueue() if this is a priority queue. */
+        pxNewQueue->uxEntrySize = ( UBaseType_t ) 0U;
+    }
+    #endif
+
+    #if ( configUSE_QUEUE_STATS == 1 )
+    {
+        ( void ) memset( ( void * ) &( pxNewQueue->xStats ), 0x00, sizeof( QueueStats_t ) );
+    }
+    #endif
+
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    {
+        /* Must be ready before xQueueGenericReset() enters the critical section. */
+        portINIT_SPINLOCK( &( pxNewQueue->xObjectLock ) );
+    }
+    #endif
+
     ( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -703,7 +1064,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
          * calling task is the mutex holder, but not a good way of determining the
          * identity of the mutex holder, as the holder may change between the
          * following critical section exiting and the function returning. */
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxSemaphore );
         {
             if( pxSemaphore->uxQueueType == queueQUEUE_IS_MUTEX )
             {
@@ -714,7 +1075,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
                 pxReturn = NULL;
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxSemaphore );
 
         traceRETURN_xQueueGetMutexHolder( pxReturn );
 
@@ -885,6 +1246,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             if( xHandle != NULL )
             {
                 ( ( Queue_t * ) xHandle )->uxMessagesWaiting = uxInitialCount;
+                queueSTATS_RECORD_HIGH_WATER_MARK( ( Queue_t * ) xHandle );
 
                 traceCREATE_COUNTING_SEMAPHORE();
             }
@@ -924,6 +1286,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             if( xHandle != NULL )
             {
                 ( ( Queue_t * ) xHandle )->uxMessagesWaiting = uxInitialCount;
+                queueSTATS_RECORD_HIGH_WATER_MARK( ( Queue_t * ) xHandle );
 
                 traceCREATE_COUNTING_SEMAPHORE();
             }
@@ -960,21 +1323,33 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
     configASSERT( pxQueue );
     configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
     configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+    configASSERT( ( xCopyPosition < queueSEND_BY_PRIORITY ) || ( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE ) );
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
     {
         configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
     }
     #endif
 
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    {
+        if( prvTrySendWithObjectLock( pxQueue, pvItemToQueue, xCopyPosition ) != pdFALSE )
+        {
+            traceRETURN_xQueueGenericSend( pdPASS );
+
+            return pdPASS;
+        }
+    }
+    #endif
+
     for( ; ; )
     {
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxQueue );
         {
             /* Is there room on the queue now?  The running task must be the
              * highest priority task wanting to access the queue.  If the head item
              * in the queue is to be overwritten then it does not matter if the
              * queue is full. */
-            if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+            if( queueCAN_SEND( pxQueue, xCopyPosition ) != pdFALSE )
             {
                 traceQUEUE_SEND( pxQueue );
 
@@ -1011,7 +1386,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                          * queue then unblock it now. */
                         if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                         {
-                            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                            if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                             {
                                 /* The unblocked task has a priority higher than
                                  * our own so yield immediately.  Yes it is ok to
@@ -1046,7 +1421,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                      * queue then unblock it now. */
                     if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                     {
-                        if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                        if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                         {
                             /* The unblocked task has a priority higher than
                              * our own so yield immediately.  Yes it is ok to do
@@ -1074,7 +1449,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                 }
                 #endif /* configUSE_QUEUE_SETS */
 
-                taskEXIT_CRITICAL();
+                queueEXIT_CRITICAL( pxQueue );
 
                 traceRETURN_xQueueGenericSend( pdPASS );
 
@@ -1086,7 +1461,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                 {
                     /* The queue was full and no block time is specified (or
                      * the block time has expired) so leave now. */
-                    taskEXIT_CRITICAL();
+                    queueEXIT_CRITICAL( pxQueue );
 
                     /* Return to the original privilege level before exiting
                      * the function. */
@@ -1109,7 +1484,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                 }
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxQueue );
 
         /* Interrupts and other tasks can send to and receive from the queue
          * now the critical section has been exited. */
@@ -1120,8 +1495,12 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
         /* Update the timeout state to see if it has expired yet. */
         if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
         {
-            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            if( prvIsQueueFull( pxQueue, xCopyPosition ) != pdFALSE )
             {
+                #if ( configUSE_QUEUE_STATS == 1 )
+                    const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                #endif
+
                 traceBLOCKING_ON_QUEUE_SEND( pxQueue );
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
 
@@ -1141,6 +1520,8 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                 {
                     taskYIELD_WITHIN_API();
                 }
+
+                queueSTATS_RECORD_BLOCKED( pxQueue, ulFullBlocks, ulBlockStartTime );
             }
             else
             {
@@ -1178,6 +1559,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
     configASSERT( pxQueue );
     configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
     configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+    configASSERT( ( xCopyPosition < queueSEND_BY_PRIORITY ) || ( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE ) );
 
     /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -1203,9 +1585,9 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
     /* MISRA Ref 4.7.1 [Return value shall be checked] */
     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
     /* coverity[misra_c_2012_directive_4_7_violation] */
-    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
     {
-        if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+        if( queueCAN_SEND( pxQueue, xCopyPosition ) != pdFALSE )
         {
             const int8_t cTxLock = pxQueue->cTxLock;
             const UBaseType_t uxPreviousMessagesWaiting = pxQueue->uxMessagesWaiting;
@@ -1257,7 +1639,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
                     {
                         if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                         {
-                            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                            if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                             {
                                 /* The task waiting has a higher priority so
                                  *  record that a context switch is required. */
@@ -1285,7 +1667,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
                 {
                     if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                     {
-                        if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                        if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                         {
                             /* The task waiting has a higher priority so record that a
                              * context switch is required. */
@@ -1328,7 +1710,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
             xReturn = errQUEUE_FULL;
         }
     }
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
 
     traceRETURN_xQueueGenericSendFromISR( xReturn );
 
@@ -1381,7 +1763,7 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
     /* MISRA Ref 4.7.1 [Return value shall be checked] */
     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
     /* coverity[misra_c_2012_directive_4_7_violation] */
-    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
     {
         const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
@@ -1401,6 +1783,7 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
              * priority disinheritance is needed.  Simply increase the count of
              * messages (semaphores) available. */
             pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting + ( UBaseType_t ) 1 );
+            queueSTATS_RECORD_SENT( pxQueue, 1U );
 
             /* The event list is not altered if the queue is locked.  This will
              * be done when the queue is unlocked later. */
@@ -1433,7 +1816,7 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
                     {
                         if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                         {
-                            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                            if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                             {
                                 /* The task waiting has a higher priority so
                                  *  record that a context switch is required. */
@@ -1461,7 +1844,7 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
                 {
                     if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                     {
-                        if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                        if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                         {
                             /* The task waiting has a higher priority so record that a
                              * context switch is required. */
@@ -1501,7 +1884,7 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
             xReturn = errQUEUE_FULL;
         }
     }
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
 
     traceRETURN_xQueueGiveFromISR( xReturn );
 
@@ -1533,27 +1916,45 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
     }
     #endif
 
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    {
+        if( prvTryReceiveWithObjectLock( pxQueue, pvBuffer ) != pdFALSE )
+        {
+            traceRETURN_xQueueReceive( pdPASS );
+
+            return pdPASS;
+        }
+    }
+    #endif
+
     for( ; ; )
     {
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxQueue );
         {
             const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
             /* Is there data in the queue now?  To be running the calling task
              * must be the highest priority task wanting to access the queue. */
-            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            if( queueCAN_RECEIVE( pxQueue, uxMessagesWaiting ) != pdFALSE )
             {
                 /* Data available, remove one item. */
                 prvCopyDataFromQueue( pxQueue, pvBuffer );
                 traceQUEUE_RECEIVE( pxQueue );
                 pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting - ( UBaseType_t ) 1 );
+                queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
+
+                #if ( configUSE_PRIORITY_QUEUES == 1 )
+                {
+                    prvRemoveFromHeap( pxQueue );
+                }
+                #endif
 
                 /* There is now space in the queue, were any tasks waiting to
                  * post to the queue?  If so, unblock the highest priority waiting
                  * task. */
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
                     {
                         queueYIELD_IF_USING_PREEMPTION();
                     }
@@ -1567,7 +1968,7 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                taskEXIT_CRITICAL();
+                queueEXIT_CRITICAL( pxQueue );
 
                 traceRETURN_xQueueReceive( pdPASS );
 
@@ -1579,7 +1980,7 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                 {
                     /* The queue was empty and no block time is specified (or
                      * the block time has expired) so leave now. */
-                    taskEXIT_CRITICAL();
+                    queueEXIT_CRITICAL( pxQueue );
 
                     traceQUEUE_RECEIVE_FAILED( pxQueue );
                     traceRETURN_xQueueReceive( errQUEUE_EMPTY );
@@ -1600,7 +2001,7 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                 }
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxQueue );
 
         /* Interrupts and other tasks can send to and receive from the queue
          * now the critical section has been exited. */
@@ -1615,6 +2016,10 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
              * the task on the list of tasks waiting to receive from the queue. */
             if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
             {
+                #if ( configUSE_QUEUE_STATS == 1 )
+                    const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                #endif
+
                 traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
                 prvUnlockQueue( pxQueue );
@@ -1627,6 +2032,8 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
+
+                queueSTATS_RECORD_BLOCKED( pxQueue, ulEmptyBlocks, ulBlockStartTime );
             }
             else
             {
@@ -1686,9 +2093,20 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
     }
     #endif
 
+    #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+    {
+        if( prvTryReceiveWithObjectLock( pxQueue, NULL ) != pdFALSE )
+        {
+            traceRETURN_xQueueSemaphoreTake( pdPASS );
+
+            return pdPASS;
+        }
+    }
+    #endif
+
     for( ; ; )
     {
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxQueue );
         {
             /* Semaphores are queues with an item size of 0, and where the
              * number of messages in the queue is the semaphore's count value. */
@@ -1703,6 +2121,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 /* Semaphores are queues with a data size of zero and where the
                  * messages waiting is the semaphore's count.  Reduce the count. */
                 pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxSemaphoreCount - ( UBaseType_t ) 1 );
+                queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
 
                 #if ( configUSE_MUTEXES == 1 )
                 {
@@ -1723,7 +2142,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                  * semaphore, and if so, unblock the highest priority such task. */
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
                     {
                         queueYIELD_IF_USING_PREEMPTION();
                     }
@@ -1737,7 +2156,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                taskEXIT_CRITICAL();
+                queueEXIT_CRITICAL( pxQueue );
 
                 traceRETURN_xQueueSemaphoreTake( pdPASS );
 
@@ -1749,7 +2168,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 {
                     /* The semaphore count was 0 and no block time is specified
                      * (or the block time has expired) so exit now. */
-                    taskEXIT_CRITICAL();
+                    queueEXIT_CRITICAL( pxQueue );
 
                     traceQUEUE_RECEIVE_FAILED( pxQueue );
                     traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
@@ -1770,7 +2189,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 }
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxQueue );
 
         /* Interrupts and other tasks can give to and take from the semaphore
          * now the critical section has been exited. */
@@ -1787,17 +2206,21 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
              * queue being empty is equivalent to the semaphore count being 0. */
             if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
             {
+                #if ( configUSE_QUEUE_STATS == 1 )
+                    const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                #endif
+
                 traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
 
                 #if ( configUSE_MUTEXES == 1 )
                 {
                     if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
                     {
-                        taskENTER_CRITICAL();
+                        queueENTER_CRITICAL( pxQueue );
                         {
                             xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
                         }
-                        taskEXIT_CRITICAL();
+                        queueEXIT_CRITICAL( pxQueue );
                     }
                     else
                     {
@@ -1817,6 +2240,8 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
+
+                queueSTATS_RECORD_BLOCKED( pxQueue, ulEmptyBlocks, ulBlockStartTime );
             }
             else
             {
@@ -1845,7 +2270,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                      * test the mutex type again to check it is actually a mutex. */
                     if( xInheritanceOccurred != pdFALSE )
                     {
-                        taskENTER_CRITICAL();
+                        queueENTER_CRITICAL( pxQueue );
                         {
                             UBaseType_t uxHighestWaitingPriority;
 
@@ -1865,7 +2290,7 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                             /* coverity[overrun] */
                             vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
                         }
-                        taskEXIT_CRITICAL();
+                        queueEXIT_CRITICAL( pxQueue );
                     }
                 }
                 #endif /* configUSE_MUTEXES */
@@ -1911,7 +2336,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
 
     for( ; ; )
     {
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( pxQueue );
         {
             const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
@@ -1934,7 +2359,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
                  * any other tasks waiting for the data. */
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
                     {
                         /* The task waiting has a higher priority than this task. */
                         queueYIELD_IF_USING_PREEMPTION();
@@ -1949,7 +2374,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                taskEXIT_CRITICAL();
+                queueEXIT_CRITICAL( pxQueue );
 
                 traceRETURN_xQueuePeek( pdPASS );
 
@@ -1961,7 +2386,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
                 {
                     /* The queue was empty and no block time is specified (or
                      * the block time has expired) so leave now. */
-                    taskEXIT_CRITICAL();
+                    queueEXIT_CRITICAL( pxQueue );
 
                     traceQUEUE_PEEK_FAILED( pxQueue );
                     traceRETURN_xQueuePeek( errQUEUE_EMPTY );
@@ -1983,7 +2408,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
                 }
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( pxQueue );
 
         /* Interrupts and other tasks can send to and receive from the queue
          * now that the critical section has been exited. */
@@ -1998,6 +2423,10 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
             * queue now, and if not enter the Blocked state to wait for data. */
             if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
             {
+                #if ( configUSE_QUEUE_STATS == 1 )
+                    const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                #endif
+
                 traceBLOCKING_ON_QUEUE_PEEK( pxQueue );
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
                 prvUnlockQueue( pxQueue );
@@ -2010,6 +2439,8 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
+
+                queueSTATS_RECORD_BLOCKED( pxQueue, ulEmptyBlocks, ulBlockStartTime );
             }
             else
             {
@@ -2074,12 +2505,12 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
     /* MISRA Ref 4.7.1 [Return value shall be checked] */
     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
     /* coverity[misra_c_2012_directive_4_7_violation] */
-    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
     {
         const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
         /* Cannot block in an ISR, so check there is data available. */
-        if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+        if( queueCAN_RECEIVE( pxQueue, uxMessagesWaiting ) != pdFALSE )
         {
             const int8_t cRxLock = pxQueue->cRxLock;
 
@@ -2087,6 +2518,13 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 
             prvCopyDataFromQueue( pxQueue, pvBuffer );
             pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting - ( UBaseType_t ) 1 );
+            queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
+
+            #if ( configUSE_PRIORITY_QUEUES == 1 )
+            {
+                prvRemoveFromHeap( pxQueue );
+            }
+            #endif
 
             /* If the queue is locked the event list will not be modified.
              * Instead update the lock count so the task that unlocks the queue
@@ -2096,7 +2534,7 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
             {
                 if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
                     {
                         /* The task waiting has a higher priority than us so
                          * force a context switch. */
@@ -2134,7 +2572,7 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
             traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
         }
     }
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
 
     traceRETURN_xQueueReceiveFromISR( xReturn );
 
@@ -2175,7 +2613,7 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
     /* MISRA Ref 4.7.1 [Return value shall be checked] */
     /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
     /* coverity[misra_c_2012_directive_4_7_violation] */
-    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
     {
         /* Cannot block in an ISR, so check there is data available. */
         if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
@@ -2196,7 +2634,7 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
             traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue );
         }
     }
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
 
     traceRETURN_xQueuePeekFromISR( xReturn );
 
@@ -2204,264 +2642,1992 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
-{
-    UBaseType_t uxReturn;
-
-    traceENTER_uxQueueMessagesWaiting( xQueue );
-
-    configASSERT( xQueue );
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
 
-    portBASE_TYPE_ENTER_CRITICAL();
+    BaseType_t xQueueClaim( QueueHandle_t xQueue,
+                            void ** const ppvSlot,
+                            TickType_t xTicksToWait )
     {
-        uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
-    }
-    portBASE_TYPE_EXIT_CRITICAL();
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
 
-    traceRETURN_uxQueueMessagesWaiting( uxReturn );
+        traceENTER_xQueueClaim( xQueue, ppvSlot, xTicksToWait );
 
-    return uxReturn;
-}
-/*-----------------------------------------------------------*/
+        configASSERT( pxQueue );
+        configASSERT( ppvSlot );
 
-UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
-{
-    UBaseType_t uxReturn;
-    Queue_t * const pxQueue = xQueue;
+        /* There is no slot to claim in a semaphore, and the items of a priority
+         * queue move whenever one is sent or received. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
-    traceENTER_uxQueueSpacesAvailable( xQueue );
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
 
-    configASSERT( pxQueue );
+        for( ; ; )
+        {
+            queueENTER_CRITICAL( pxQueue );
+            {
+                /* Is there room on the queue, and no other slot claimed? */
+                if( queueCAN_SEND( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+                {
+                    /* The slot is handed out where the next item would be
+                     * copied to, and nothing else can be written to the queue
+                     * until it is committed, so it cannot be overwritten and
+                     * items stay in the order they were sent. */
+                    pxQueue->pcClaimedSlot = pxQueue->pcWriteTo;
+                    *ppvSlot = ( void * ) pxQueue->pcClaimedSlot;
 
-    portBASE_TYPE_ENTER_CRITICAL();
-    {
-        uxReturn = ( UBaseType_t ) ( pxQueue->uxLength - pxQueue->uxMessagesWaiting );
-    }
-    portBASE_TYPE_EXIT_CRITICAL();
+                    queueEXIT_CRITICAL( pxQueue );
 
-    traceRETURN_uxQueueSpacesAvailable( uxReturn );
+                    traceRETURN_xQueueClaim( pdPASS );
 
-    return uxReturn;
-}
-/*-----------------------------------------------------------*/
+                    return pdPASS;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was full and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        queueEXIT_CRITICAL( pxQueue );
 
-UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
-{
-    UBaseType_t uxReturn;
-    Queue_t * const pxQueue = xQueue;
+                        traceQUEUE_SEND_FAILED( pxQueue );
+                        traceRETURN_xQueueClaim( errQUEUE_FULL );
 
-    traceENTER_uxQueueMessagesWaitingFromISR( xQueue );
+                        return errQUEUE_FULL;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was full and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            queueEXIT_CRITICAL( pxQueue );
 
-    configASSERT( pxQueue );
-    uxReturn = pxQueue->uxMessagesWaiting;
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
 
-    traceRETURN_uxQueueMessagesWaitingFromISR( uxReturn );
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
 
-    return uxReturn;
-}
-/*-----------------------------------------------------------*/
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+                {
+                    #if ( configUSE_QUEUE_STATS == 1 )
+                        const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                    #endif
 
-void vQueueDelete( QueueHandle_t xQueue )
-{
-    Queue_t * const pxQueue = xQueue;
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
 
-    traceENTER_vQueueDelete( xQueue );
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
 
-    configASSERT( pxQueue );
-    traceQUEUE_DELETE( pxQueue );
+                    queueSTATS_RECORD_BLOCKED( pxQueue, ulFullBlocks, ulBlockStartTime );
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
 
-    #if ( configQUEUE_REGISTRY_SIZE > 0 )
-    {
-        vQueueUnregisterQueue( pxQueue );
-    }
-    #endif
+                traceQUEUE_SEND_FAILED( pxQueue );
+                traceRETURN_xQueueClaim( errQUEUE_FULL );
 
-    #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
-    {
-        /* The queue can only have been allocated dynamically - free it
-         * again. */
-        vPortFree( pxQueue );
+                return errQUEUE_FULL;
+            }
+        }
     }
-    #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    BaseType_t xQueueClaimFromISR( QueueHandle_t xQueue,
+                                   void ** const ppvSlot )
     {
-        /* The queue could have been allocated statically or dynamically, so
-         * check before attempting to free the memory. */
+        BaseType_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueClaimFromISR( xQueue, ppvSlot );
+
+        configASSERT( pxQueue );
+        configASSERT( ppvSlot );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        /* See the comment in xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            if( queueCAN_SEND( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+            {
+                pxQueue->pcClaimedSlot = pxQueue->pcWriteTo;
+                *ppvSlot = ( void * ) pxQueue->pcClaimedSlot;
+                xReturn = pdPASS;
+            }
+            else
+            {
+                traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+                xReturn = errQUEUE_FULL;
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_xQueueClaimFromISR( xReturn );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueCommit( QueueHandle_t xQueue,
+                       void * const pvSlot )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueCommit( xQueue, pvSlot );
+
+        configASSERT( pxQueue );
+
+        queueENTER_CRITICAL( pxQueue );
+        {
+            /* Only the slot returned by the last xQueueClaim() can be
+             * committed, and only once. */
+            configASSERT( ( pxQueue->pcClaimedSlot != NULL ) && ( ( int8_t * ) pvSlot == pxQueue->pcClaimedSlot ) );
+
+            traceQUEUE_SEND( pxQueue );
+
+            if( prvCommitClaimedSlot( pxQueue, pdFALSE ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueEXIT_CRITICAL( pxQueue );
+
+        traceRETURN_vQueueCommit();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueCommitFromISR( QueueHandle_t xQueue,
+                              void * const pvSlot,
+                              BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueCommitFromISR( xQueue, pvSlot, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+
+        /* See the comment in xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            configASSERT( ( pxQueue->pcClaimedSlot != NULL ) && ( ( int8_t * ) pvSlot == pxQueue->pcClaimedSlot ) );
+
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            if( prvCommitClaimedSlot( pxQueue, pdTRUE ) != pdFALSE )
+            {
+                if( pxHigherPriorityTaskWoken != NULL )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_vQueueCommitFromISR();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    BaseType_t xQueueBorrow( QueueHandle_t xQueue,
+                             void ** const ppvItem,
+                             TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueBorrow( xQueue, ppvItem, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( ppvItem );
+
+        /* There is no item to borrow from a semaphore, and the items of a
+         * priority queue move whenever one is sent or received. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            queueENTER_CRITICAL( pxQueue );
+            {
+                /* Is there data in the queue, and no other item borrowed? */
+                if( queueCAN_RECEIVE( pxQueue, pxQueue->uxMessagesWaiting ) != pdFALSE )
+                {
+                    /* The item stays in the queue, and keeps its slot, until it
+                     * is released.  pcReadFrom points to the last item read, so
+                     * the front item is the one after it. */
+                    pxQueue->pcBorrowedItem = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+                    if( pxQueue->pcBorrowedItem >= pxQueue->u.xQueue.pcTail )
+                    {
+                        pxQueue->pcBorrowedItem = pxQueue->pcHead;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    *ppvItem = ( void * ) pxQueue->pcBorrowedItem;
+                    traceQUEUE_RECEIVE( pxQueue );
+
+                    queueEXIT_CRITICAL( pxQueue );
+
+                    traceRETURN_xQueueBorrow( pdPASS );
+
+                    return pdPASS;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was empty and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        queueEXIT_CRITICAL( pxQueue );
+
+                        traceQUEUE_RECEIVE_FAILED( pxQueue );
+                        traceRETURN_xQueueBorrow( errQUEUE_EMPTY );
+
+                        return errQUEUE_EMPTY;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was empty and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            queueEXIT_CRITICAL( pxQueue );
+
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    #if ( configUSE_QUEUE_STATS == 1 )
+                        const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                    #endif
+
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    queueSTATS_RECORD_BLOCKED( pxQueue, ulEmptyBlocks, ulBlockStartTime );
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and
+                     * borrow it. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no data in the queue exit, otherwise
+                 * loop back and attempt to borrow the data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    traceRETURN_xQueueBorrow( errQUEUE_EMPTY );
+
+                    return errQUEUE_EMPTY;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    BaseType_t xQueueBorrowFromISR( QueueHandle_t xQueue,
+                                    void ** const ppvItem )
+    {
+        BaseType_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueBorrowFromISR( xQueue, ppvItem );
+
+        configASSERT( pxQueue );
+        configASSERT( ppvItem );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        /* See the comment in xQueueReceiveFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            if( queueCAN_RECEIVE( pxQueue, pxQueue->uxMessagesWaiting ) != pdFALSE )
+            {
+                pxQueue->pcBorrowedItem = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+                if( pxQueue->pcBorrowedItem >= pxQueue->u.xQueue.pcTail )
+                {
+                    pxQueue->pcBorrowedItem = pxQueue->pcHead;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                *ppvItem = ( void * ) pxQueue->pcBorrowedItem;
+                traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+                xReturn = pdPASS;
+            }
+            else
+            {
+                traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+                xReturn = pdFAIL;
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_xQueueBorrowFromISR( xReturn );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueRelease( QueueHandle_t xQueue,
+                        void * const pvItem )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueRelease( xQueue, pvItem );
+
+        configASSERT( pxQueue );
+
+        queueENTER_CRITICAL( pxQueue );
+        {
+            /* Only the item returned by the last xQueueBorrow() can be
+             * released, and only once. */
+            configASSERT( ( pxQueue->pcBorrowedItem != NULL ) && ( ( int8_t * ) pvItem == pxQueue->pcBorrowedItem ) );
+
+            if( prvReleaseBorrowedItem( pxQueue, pdFALSE ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueEXIT_CRITICAL( pxQueue );
+
+        traceRETURN_vQueueRelease();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueReleaseFromISR( QueueHandle_t xQueue,
+                               void * const pvItem,
+                               BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueReleaseFromISR( xQueue, pvItem, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+
+        /* See the comment in xQueueReceiveFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            configASSERT( ( pxQueue->pcBorrowedItem != NULL ) && ( ( int8_t * ) pvItem == pxQueue->pcBorrowedItem ) );
+
+            if( prvReleaseBorrowedItem( pxQueue, pdTRUE ) != pdFALSE )
+            {
+                if( pxHigherPriorityTaskWoken != NULL )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_vQueueReleaseFromISR();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                    const void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        UBaseType_t uxItemsSent;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueSendMultiple( xQueue, pvItems, uxItems, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pvItems );
+        configASSERT( uxItems > ( UBaseType_t ) 0U );
+
+        /* Semaphores and mutexes have no items to copy, and priority queues
+         * are not kept in a ring the items could be copied to or from in one
+         * go. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            queueENTER_CRITICAL( pxQueue );
+            {
+                /* Is there room for at least one item?  As many items as fit
+                 * are sent, and the task only blocks if none do. */
+                if( queueCAN_SEND( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+                {
+                    uxItemsSent = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+                    if( uxItemsSent > uxItems )
+                    {
+                        uxItemsSent = uxItems;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    traceQUEUE_SEND( pxQueue );
+
+                    if( prvSendMultipleToQueue( pxQueue, pvItems, uxItemsSent, pdFALSE ) != pdFALSE )
+                    {
+                        /* Yes it is ok to do this from within the critical
+                         * section - the kernel takes care of that. */
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    queueEXIT_CRITICAL( pxQueue );
+
+                    traceRETURN_xQueueSendMultiple( uxItemsSent );
+
+                    return uxItemsSent;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was full and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        queueEXIT_CRITICAL( pxQueue );
+
+                        traceQUEUE_SEND_FAILED( pxQueue );
+                        traceRETURN_xQueueSendMultiple( 0 );
+
+                        return ( UBaseType_t ) 0U;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was full and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            queueEXIT_CRITICAL( pxQueue );
+
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+                {
+                    #if ( configUSE_QUEUE_STATS == 1 )
+                        const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                    #endif
+
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+
+                    queueSTATS_RECORD_BLOCKED( pxQueue, ulFullBlocks, ulBlockStartTime );
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                traceRETURN_xQueueSendMultiple( 0 );
+
+                return ( UBaseType_t ) 0U;
+            }
+        }
+    }
+
+#endif /* configUSE_QUEUE_BATCHING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                           const void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxItemsSent;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueSendMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+        configASSERT( pvItems );
+        configASSERT( uxItems > ( UBaseType_t ) 0U );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        /* See the comment in xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            if( queueCAN_SEND( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+            {
+                uxItemsSent = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+                if( uxItemsSent > uxItems )
+                {
+                    uxItemsSent = uxItems;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+                if( prvSendMultipleToQueue( pxQueue, pvItems, uxItemsSent, pdTRUE ) != pdFALSE )
+                {
+                    if( pxHigherPriorityTaskWoken != NULL )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+                uxItemsSent = ( UBaseType_t ) 0U;
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_xQueueSendMultipleFromISR( uxItemsSent );
+
+        return uxItemsSent;
+    }
+
+#endif /* configUSE_QUEUE_BATCHING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                       void * const pvBuffer,
+                                       const UBaseType_t uxMaxItems,
+                                       TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        UBaseType_t uxItemsReceived;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueReceiveMultiple( xQueue, pvBuffer, uxMaxItems, xTicksToWait );
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( uxMaxItems > ( UBaseType_t ) 0U );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            queueENTER_CRITICAL( pxQueue );
+            {
+                const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+                /* Is there at least one item in the queue?  As many items as
+                 * are there, up to uxMaxItems, are received, and the task only
+                 * blocks if there are none. */
+                if( queueCAN_RECEIVE( pxQueue, uxMessagesWaiting ) != pdFALSE )
+                {
+                    uxItemsReceived = ( uxMessagesWaiting < uxMaxItems ) ? uxMessagesWaiting : uxMaxItems;
+
+                    if( prvReceiveMultipleFromQueue( pxQueue, pvBuffer, uxItemsReceived, pdFALSE ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    traceQUEUE_RECEIVE( pxQueue );
+
+                    queueEXIT_CRITICAL( pxQueue );
+
+                    traceRETURN_xQueueReceiveMultiple( uxItemsReceived );
+
+                    return uxItemsReceived;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was empty and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        queueEXIT_CRITICAL( pxQueue );
+
+                        traceQUEUE_RECEIVE_FAILED( pxQueue );
+                        traceRETURN_xQueueReceiveMultiple( 0 );
+
+                        return ( UBaseType_t ) 0U;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was empty and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            queueEXIT_CRITICAL( pxQueue );
+
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    #if ( configUSE_QUEUE_STATS == 1 )
+                        const configRUN_TIME_COUNTER_TYPE ulBlockStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                    #endif
+
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        taskYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    queueSTATS_RECORD_BLOCKED( pxQueue, ulEmptyBlocks, ulBlockStartTime );
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and read
+                     * the data. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no data in the queue exit, otherwise
+                 * loop back and attempt to read the data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    traceRETURN_xQueueReceiveMultiple( 0 );
+
+                    return ( UBaseType_t ) 0U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+
+#endif /* configUSE_QUEUE_BATCHING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                              void * const pvBuffer,
+                                              const UBaseType_t uxMaxItems,
+                                              BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxItemsReceived;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_xQueueReceiveMultipleFromISR( xQueue, pvBuffer, uxMaxItems, pxHigherPriorityTaskWoken );
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( uxMaxItems > ( UBaseType_t ) 0U );
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+        /* See the comment in xQueueReceiveFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        /* MISRA Ref 4.7.1 [Return value shall be checked] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#dir-47 */
+        /* coverity[misra_c_2012_directive_4_7_violation] */
+        queueENTER_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+        {
+            const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+            if( queueCAN_RECEIVE( pxQueue, uxMessagesWaiting ) != pdFALSE )
+            {
+                uxItemsReceived = ( uxMessagesWaiting < uxMaxItems ) ? uxMessagesWaiting : uxMaxItems;
+
+                traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+                if( prvReceiveMultipleFromQueue( pxQueue, pvBuffer, uxItemsReceived, pdTRUE ) != pdFALSE )
+                {
+                    if( pxHigherPriorityTaskWoken != NULL )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+                uxItemsReceived = ( UBaseType_t ) 0U;
+            }
+        }
+        queueEXIT_CRITICAL_FROM_ISR( pxQueue, uxSavedInterruptStatus );
+
+        traceRETURN_xQueueReceiveMultipleFromISR( uxItemsReceived );
+
+        return uxItemsReceived;
+    }
+
+#endif /* configUSE_QUEUE_BATCHING */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    QueueHandle_t xQueueCreatePriority( const UBaseType_t uxQueueLength,
+                                        const UBaseType_t uxItemSize )
+    {
+        QueueHandle_t xNewQueue;
+
+        traceENTER_xQueueCreatePriority( uxQueueLength, uxItemSize );
+
+        /* A queue without items has nothing to order. */
+        configASSERT( uxItemSize != ( UBaseType_t ) 0U );
+
+        xNewQueue = xQueueGenericCreate( uxQueueLength, ( UBaseType_t ) queuePRIORITY_QUEUE_ENTRY_SIZE( uxItemSize ), queueQUEUE_TYPE_PRIORITY );
+        prvInitialisePriorityQueue( ( Queue_t * ) xNewQueue, uxItemSize );
+
+        traceRETURN_xQueueCreatePriority( xNewQueue );
+
+        return xNewQueue;
+    }
+
+#endif /* ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+    QueueHandle_t xQueueCreatePriorityStatic( const UBaseType_t uxQueueLength,
+                                              const UBaseType_t uxItemSize,
+                                              uint8_t * pucQueueStorage,
+                                              StaticQueue_t * pxStaticQueue )
+    {
+        QueueHandle_t xNewQueue;
+
+        traceENTER_xQueueCreatePriorityStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxStaticQueue );
+
+        /* A queue without items has nothing to order, and the headers in the
+         * storage area are read and written as UBaseType_t. */
+        configASSERT( uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( ( ( portPOINTER_SIZE_TYPE ) pucQueueStorage & ( portPOINTER_SIZE_TYPE ) ( sizeof( UBaseType_t ) - 1U ) ) == 0U );
+
+        xNewQueue = xQueueGenericCreateStatic( uxQueueLength, ( UBaseType_t ) queuePRIORITY_QUEUE_ENTRY_SIZE( uxItemSize ), pucQueueStorage, pxStaticQueue, queueQUEUE_TYPE_PRIORITY );
+        prvInitialisePriorityQueue( ( Queue_t * ) xNewQueue, uxItemSize );
+
+        traceRETURN_xQueueCreatePriorityStatic( xNewQueue );
+
+        return xNewQueue;
+    }
+
+#endif /* ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    static void prvInitialisePriorityQueue( Queue_t * pxNewQueue,
+                                            const UBaseType_t uxItemSize )
+    {
+        if( pxNewQueue != NULL )
+        {
+            /* The queue create function sized the storage area for uxLength
+             * heap entries, each a header and an item, but this function is
+             * creating a priority queue.  Keep the entry size for indexing the
+             * heap and copy only the item to and from the tasks' buffers. */
+            pxNewQueue->uxEntrySize = pxNewQueue->uxItemSize;
+            pxNewQueue->uxItemSize = uxItemSize;
+            pxNewQueue->uxNextSequence = ( UBaseType_t ) 0U;
+
+            #if ( configUSE_QUEUE_WORD_COPY == 1 )
+            {
+                /* Entries are a whole number of UBaseType_t long and the header
+                 * is two of them, so every item is word aligned if the storage
+                 * area is. */
+                if( ( ( uxItemSize == ( UBaseType_t ) sizeof( uint32_t ) ) || ( uxItemSize == ( UBaseType_t ) ( 2U * sizeof( uint32_t ) ) ) ) &&
+                    ( queueIS_WORD_ALIGNED( pxNewQueue->pcHead ) ) )
+                {
+                    pxNewQueue->ucItemWords = ( uint8_t ) ( uxItemSize / ( UBaseType_t ) sizeof( uint32_t ) );
+                }
+                else
+                {
+                    pxNewQueue->ucItemWords = ( uint8_t ) 0U;
+                }
+            }
+            #endif
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+    UBaseType_t uxReturn;
+
+    traceENTER_uxQueueMessagesWaiting( xQueue );
+
+    configASSERT( xQueue );
+
+    portBASE_TYPE_ENTER_CRITICAL();
+    {
+        uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+    }
+    portBASE_TYPE_EXIT_CRITICAL();
+
+    traceRETURN_uxQueueMessagesWaiting( uxReturn );
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
+{
+    UBaseType_t uxReturn;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_uxQueueSpacesAvailable( xQueue );
+
+    configASSERT( pxQueue );
+
+    portBASE_TYPE_ENTER_CRITICAL();
+    {
+        uxReturn = ( UBaseType_t ) ( pxQueue->uxLength - pxQueue->uxMessagesWaiting );
+    }
+    portBASE_TYPE_EXIT_CRITICAL();
+
+    traceRETURN_uxQueueSpacesAvailable( uxReturn );
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
+{
+    UBaseType_t uxReturn;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_uxQueueMessagesWaitingFromISR( xQueue );
+
+    configASSERT( pxQueue );
+    uxReturn = pxQueue->uxMessagesWaiting;
+
+    traceRETURN_uxQueueMessagesWaitingFromISR( uxReturn );
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_vQueueDelete( xQueue );
+
+    configASSERT( pxQueue );
+    traceQUEUE_DELETE( pxQueue );
+
+    #if ( configQUEUE_REGISTRY_SIZE > 0 )
+    {
+        vQueueUnregisterQueue( pxQueue );
+    }
+    #endif
+
+    #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+    {
+        /* The queue can only have been allocated dynamically - free it
+         * again. */
+        vPortFree( pxQueue );
+    }
+    #elif ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    {
+        /* The queue could have been allocated statically or dynamically, so
+         * check before attempting to free the memory. */
         if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
         {
-            vPortFree( pxQueue );
+            vPortFree( pxQueue );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else /* if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) ) */
+    {
+        /* The queue must have been statically allocated, so is not going to be
+         * deleted.  Avoid compiler warnings about the unused parameter. */
+        ( void ) pxQueue;
+    }
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
+    traceRETURN_vQueueDelete();
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
+    {
+        traceENTER_uxQueueGetQueueNumber( xQueue );
+
+        traceRETURN_uxQueueGetQueueNumber( ( ( Queue_t * ) xQueue )->uxQueueNumber );
+
+        return ( ( Queue_t * ) xQueue )->uxQueueNumber;
+    }
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    void vQueueSetQueueNumber( QueueHandle_t xQueue,
+                               UBaseType_t uxQueueNumber )
+    {
+        traceENTER_vQueueSetQueueNumber( xQueue, uxQueueNumber );
+
+        ( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
+
+        traceRETURN_vQueueSetQueueNumber();
+    }
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
+    {
+        traceENTER_ucQueueGetQueueType( xQueue );
+
+        traceRETURN_ucQueueGetQueueType( ( ( Queue_t * ) xQueue )->ucQueueType );
+
+        return ( ( Queue_t * ) xQueue )->ucQueueType;
+    }
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueGetQueueItemSize( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
+{
+    traceENTER_uxQueueGetQueueItemSize( xQueue );
+
+    traceRETURN_uxQueueGetQueueItemSize( ( ( Queue_t * ) xQueue )->uxItemSize );
+
+    return ( ( Queue_t * ) xQueue )->uxItemSize;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueGetQueueLength( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
+{
+    traceENTER_uxQueueGetQueueLength( xQueue );
+
+    traceRETURN_uxQueueGetQueueLength( ( ( Queue_t * ) xQueue )->uxLength );
+
+    return ( ( Queue_t * ) xQueue )->uxLength;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MUTEXES == 1 )
+
+    static UBaseType_t prvGetHighestPriorityOfWaitToReceiveList( const Queue_t * const pxQueue )
+    {
+        UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+        /* If a task waiting for a mutex causes the mutex holder to inherit a
+         * priority, but the waiting task times out, then the holder should
+         * disinherit the priority - but only down to the highest priority of any
+         * other tasks that are waiting for the same mutex.  For this purpose,
+         * return the priority of the highest priority task that is waiting for the
+         * mutex. */
+        if( listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) > 0U )
+        {
+            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) ( ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxQueue->xTasksWaitingToReceive ) ) );
+        }
+        else
+        {
+            uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+        }
+
+        return uxHighestPriorityOfWaitingTasks;
+    }
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
+                                      const void * pvItemToQueue,
+                                      const BaseType_t xPosition )
+{
+    BaseType_t xReturn = pdFALSE;
+    UBaseType_t uxMessagesWaiting;
+
+    /* This function is called from a critical section. */
+
+    uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+    if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
+    {
+        #if ( configUSE_MUTEXES == 1 )
+        {
+            if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+            {
+                /* The mutex is no longer being held. */
+                xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+                pxQueue->u.xSemaphore.xMutexHolder = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_MUTEXES */
+    }
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+        else if( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE )
+        {
+            UBaseType_t uxPriority;
+
+            if( xPosition >= queueSEND_BY_PRIORITY )
+            {
+                uxPriority = ( UBaseType_t ) ( xPosition - queueSEND_BY_PRIORITY );
+                configASSERT( uxPriority <= queueMAX_ITEM_PRIORITY );
+            }
+            else if( xPosition == queueSEND_TO_FRONT )
+            {
+                uxPriority = queueMAX_ITEM_PRIORITY;
+            }
+            else
+            {
+                uxPriority = ( UBaseType_t ) 0U;
+
+                if( ( xPosition == queueOVERWRITE ) && ( uxMessagesWaiting > ( UBaseType_t ) 0 ) )
+                {
+                    /* The queue holds one item, which is replaced. */
+                    --uxMessagesWaiting;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            prvAddToHeap( pxQueue, pvItemToQueue, uxPriority, uxMessagesWaiting );
+        }
+    #endif /* configUSE_PRIORITY_QUEUES */
+    else if( xPosition == queueSEND_TO_BACK )
+    {
+        queueCOPY_ITEM( pxQueue, pxQueue->pcWriteTo, pvItemToQueue );
+        pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        queueCOPY_ITEM( pxQueue, pxQueue->u.xQueue.pcReadFrom, pvItemToQueue );
+        pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
+
+        if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead )
+        {
+            pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xPosition == queueOVERWRITE )
+        {
+            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                /* An item is not being added but overwritten, so subtract
+                 * one from the recorded number of items in the queue so when
+                 * one is added again below the number of recorded items remains
+                 * correct. */
+                --uxMessagesWaiting;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting + ( UBaseType_t ) 1 );
+    queueSTATS_RECORD_SENT( pxQueue, 1U );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyDataFromQueue( Queue_t * const pxQueue,
+                                  void * const pvBuffer )
+{
+    if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+    {
+        #if ( configUSE_PRIORITY_QUEUES == 1 )
+            if( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE )
+            {
+                /* The item stays in the heap, so peeking needs nothing more.
+                 * Receiving removes it with prvRemoveFromHeap(). */
+                queueCOPY_ITEM( pxQueue, pvBuffer, queueHEAP_ENTRY( pxQueue, 0U ) + sizeof( QueuePriorityHeader_t ) );
+            }
+            else
+        #endif
+        {
+            pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
+
+            if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail )
+            {
+                pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            queueCOPY_ITEM( pxQueue, pvBuffer, pxQueue->u.xQueue.pcReadFrom );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    static BaseType_t prvIsReceivedBefore( const QueuePriorityHeader_t * const pxEntry,
+                                           const QueuePriorityHeader_t * const pxOther )
+    {
+        BaseType_t xReturn;
+
+        if( pxEntry->uxPriority != pxOther->uxPriority )
+        {
+            xReturn = ( pxEntry->uxPriority > pxOther->uxPriority ) ? pdTRUE : pdFALSE;
+        }
+        else
+        {
+            /* The sequence numbers of the items in the queue are less than
+             * uxLength apart, so the difference tells the older one even after
+             * uxNextSequence has wrapped. */
+            xReturn = ( ( BaseType_t ) ( pxEntry->uxSequence - pxOther->uxSequence ) < ( BaseType_t ) 0 ) ? pdTRUE : pdFALSE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    static void prvAddToHeap( Queue_t * const pxQueue,
+                              const void * pvItemToQueue,
+                              const UBaseType_t uxPriority,
+                              const UBaseType_t uxEntries )
+    {
+        QueuePriorityHeader_t xHeader;
+        UBaseType_t uxHole = uxEntries;
+        UBaseType_t uxParent;
+
+        xHeader.uxPriority = uxPriority;
+        xHeader.uxSequence = pxQueue->uxNextSequence;
+        pxQueue->uxNextSequence++;
+
+        /* Sift up: move each parent that is received after the new item down
+         * into the hole, so every entry is only copied once, then write the
+         * new item into the hole that is left. */
+        while( uxHole > ( UBaseType_t ) 0U )
+        {
+            uxParent = ( uxHole - ( UBaseType_t ) 1U ) / ( UBaseType_t ) 2U;
+
+            if( prvIsReceivedBefore( &xHeader, queueHEAP_HEADER( pxQueue, uxParent ) ) == pdFALSE )
+            {
+                break;
+            }
+
+            ( void ) memcpy( ( void * ) queueHEAP_ENTRY( pxQueue, uxHole ), ( void * ) queueHEAP_ENTRY( pxQueue, uxParent ), ( size_t ) pxQueue->uxEntrySize );
+            uxHole = uxParent;
+        }
+
+        *queueHEAP_HEADER( pxQueue, uxHole ) = xHeader;
+        queueCOPY_ITEM( pxQueue, queueHEAP_ENTRY( pxQueue, uxHole ) + sizeof( QueuePriorityHeader_t ), pvItemToQueue );
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    static void prvRemoveFromHeap( Queue_t * const pxQueue )
+    {
+        const UBaseType_t uxEntries = pxQueue->uxMessagesWaiting;
+        const QueuePriorityHeader_t * pxLast;
+        UBaseType_t uxHole = 0U;
+        UBaseType_t uxChild;
+
+        if( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE )
+        {
+            /* The last entry sits just past the entries that are left. */
+            pxLast = queueHEAP_HEADER( pxQueue, uxEntries );
+
+            /* Sift down from the first entry, which has been received: move
+             * the child received first up into the hole for as long as it is
+             * received before the last entry, then move the last entry into
+             * the hole that is left.  Only entries below uxEntries are written,
+             * so the last entry stays intact until it is moved. */
+            for( ; ; )
+            {
+                uxChild = ( uxHole * ( UBaseType_t ) 2U ) + ( UBaseType_t ) 1U;
+
+                if( uxChild >= uxEntries )
+                {
+                    break;
+                }
+
+                if( ( ( uxChild + ( UBaseType_t ) 1U ) < uxEntries ) &&
+                    ( prvIsReceivedBefore( queueHEAP_HEADER( pxQueue, uxChild + ( UBaseType_t ) 1U ), queueHEAP_HEADER( pxQueue, uxChild ) ) != pdFALSE ) )
+                {
+                    uxChild++;
+                }
+
+                if( prvIsReceivedBefore( queueHEAP_HEADER( pxQueue, uxChild ), pxLast ) == pdFALSE )
+                {
+                    break;
+                }
+
+                ( void ) memcpy( ( void * ) queueHEAP_ENTRY( pxQueue, uxHole ), ( void * ) queueHEAP_ENTRY( pxQueue, uxChild ), ( size_t ) pxQueue->uxEntrySize );
+                uxHole = uxChild;
+            }
+
+            if( uxHole != uxEntries )
+            {
+                ( void ) memcpy( ( void * ) queueHEAP_ENTRY( pxQueue, uxHole ), ( const void * ) pxLast, ( size_t ) pxQueue->uxEntrySize );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+static void prvUnlockQueue( Queue_t * const pxQueue )
+{
+    /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+
+    /* The lock counts contains the number of extra data items placed or
+     * removed from the queue while the queue was locked.  When a queue is
+     * locked items can be added or removed, but the event lists cannot be
+     * updated. */
+    queueENTER_CRITICAL( pxQueue );
+    {
+        int8_t cTxLock = pxQueue->cTxLock;
+
+        /* See if data was added to the queue while it was locked. */
+        while( cTxLock > queueLOCKED_UNMODIFIED )
+        {
+            /* Data was posted while the queue was locked.  Are any tasks
+             * blocked waiting for data to become available? */
+            #if ( configUSE_QUEUE_SETS == 1 )
+            {
+                if( pxQueue->pxQueueSetContainer != NULL )
+                {
+                    if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                    {
+                        /* The queue is a member of a queue set, and posting to
+                         * the queue set caused a higher priority task to unblock.
+                         * A context switch is required. */
+                        vTaskMissedYield();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* Tasks that are removed from the event list will get
+                     * added to the pending ready list as the scheduler is still
+                     * suspended. */
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                    {
+                        if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                        {
+                            /* The task waiting has a higher priority so record that a
+                             * context switch is required. */
+                            vTaskMissedYield();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+            #else /* configUSE_QUEUE_SETS */
+            {
+                /* Tasks that are removed from the event list will get added to
+                 * the pending ready list as the scheduler is still suspended. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        /* The task waiting has a higher priority so record that
+                         * a context switch is required. */
+                        vTaskMissedYield();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    break;
+                }
+            }
+            #endif /* configUSE_QUEUE_SETS */
+
+            --cTxLock;
+        }
+
+        pxQueue->cTxLock = queueUNLOCKED;
+    }
+    queueEXIT_CRITICAL( pxQueue );
+
+    /* Do the same for the Rx lock. */
+    queueENTER_CRITICAL( pxQueue );
+    {
+        int8_t cRxLock = pxQueue->cRxLock;
+
+        while( cRxLock > queueLOCKED_UNMODIFIED )
+        {
+            if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+            {
+                if( queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                {
+                    vTaskMissedYield();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                --cRxLock;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        pxQueue->cRxLock = queueUNLOCKED;
+    }
+    queueEXIT_CRITICAL( pxQueue );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue )
+{
+    BaseType_t xReturn;
+
+    queueENTER_CRITICAL( pxQueue );
+    {
+        if( queueCAN_RECEIVE( pxQueue, pxQueue->uxMessagesWaiting ) == pdFALSE )
+        {
+            xReturn = pdTRUE;
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            xReturn = pdFALSE;
         }
     }
-    #else /* if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) ) */
-    {
-        /* The queue must have been statically allocated, so is not going to be
-         * deleted.  Avoid compiler warnings about the unused parameter. */
-        ( void ) pxQueue;
-    }
-    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+    queueEXIT_CRITICAL( pxQueue );
 
-    traceRETURN_vQueueDelete();
+    return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue )
+{
+    BaseType_t xReturn;
+    Queue_t * const pxQueue = xQueue;
 
-    UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
-    {
-        traceENTER_uxQueueGetQueueNumber( xQueue );
+    traceENTER_xQueueIsQueueEmptyFromISR( xQueue );
 
-        traceRETURN_uxQueueGetQueueNumber( ( ( Queue_t * ) xQueue )->uxQueueNumber );
+    configASSERT( pxQueue );
 
-        return ( ( Queue_t * ) xQueue )->uxQueueNumber;
+    if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+    {
+        xReturn = pdTRUE;
+    }
+    else
+    {
+        xReturn = pdFALSE;
     }
 
-#endif /* configUSE_TRACE_FACILITY */
+    traceRETURN_xQueueIsQueueEmptyFromISR( xReturn );
+
+    return xReturn;
+}
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+static BaseType_t prvIsQueueFull( const Queue_t * pxQueue,
+                                  const BaseType_t xCopyPosition )
+{
+    BaseType_t xReturn;
 
-    void vQueueSetQueueNumber( QueueHandle_t xQueue,
-                               UBaseType_t uxQueueNumber )
+    queueENTER_CRITICAL( pxQueue );
     {
-        traceENTER_vQueueSetQueueNumber( xQueue, uxQueueNumber );
-
-        ( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
-
-        traceRETURN_vQueueSetQueueNumber();
+        if( queueCAN_SEND( pxQueue, xCopyPosition ) == pdFALSE )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
     }
+    queueEXIT_CRITICAL( pxQueue );
 
-#endif /* configUSE_TRACE_FACILITY */
+    return xReturn;
+}
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( configUSE_PER_OBJECT_LOCKS == 1 )
 
-    uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
+    static BaseType_t prvTrySendWithObjectLock( Queue_t * const pxQueue,
+                                                const void * const pvItemToQueue,
+                                                const BaseType_t xCopyPosition )
     {
-        traceENTER_ucQueueGetQueueType( xQueue );
+        BaseType_t xReturn = pdFALSE;
+        UBaseType_t uxSavedInterruptStatus;
 
-        traceRETURN_ucQueueGetQueueType( ( ( Queue_t * ) xQueue )->ucQueueType );
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+        queueGET_OBJECT_LOCK( pxQueue );
+        {
+            if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) &&
+                ( pxQueue->uxQueueType != queueQUEUE_IS_MUTEX )
+                #if ( configUSE_QUEUE_SETS == 1 )
+                    && ( pxQueue->pxQueueSetContainer == NULL )
+                #endif
+                #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+                    && ( pxQueue->pcClaimedSlot == NULL ) && ( pxQueue->pcBorrowedItem == NULL )
+                #endif
+                )
+            {
+                const int8_t cTxLock = pxQueue->cTxLock;
 
-        return ( ( Queue_t * ) xQueue )->ucQueueType;
+                if( cTxLock == queueUNLOCKED )
+                {
+                    /* A waiting receiver has to be moved to a ready list, which
+                     * needs the kernel lock. */
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        traceQUEUE_SEND( pxQueue );
+                        ( void ) prvCopyDataToQueue( pxQueue, pvItemToQueue, xCopyPosition );
+                        xReturn = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The task that locked the queue unblocks any receiver when
+                     * it unlocks the queue, exactly as for sends from an ISR. */
+                    traceQUEUE_SEND( pxQueue );
+                    ( void ) prvCopyDataToQueue( pxQueue, pvItemToQueue, xCopyPosition );
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                    xReturn = pdTRUE;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueRELEASE_OBJECT_LOCK( pxQueue );
+        portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+
+        return xReturn;
     }
 
-#endif /* configUSE_TRACE_FACILITY */
+#endif /* configUSE_PER_OBJECT_LOCKS */
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxQueueGetQueueItemSize( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
-{
-    traceENTER_uxQueueGetQueueItemSize( xQueue );
+#if ( configUSE_PER_OBJECT_LOCKS == 1 )
 
-    traceRETURN_uxQueueGetQueueItemSize( ( ( Queue_t * ) xQueue )->uxItemSize );
+    static BaseType_t prvTryReceiveWithObjectLock( Queue_t * const pxQueue,
+                                                   void * const pvBuffer )
+    {
+        BaseType_t xReturn = pdFALSE;
+        UBaseType_t uxSavedInterruptStatus;
 
-    return ( ( Queue_t * ) xQueue )->uxItemSize;
-}
-/*-----------------------------------------------------------*/
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+        queueGET_OBJECT_LOCK( pxQueue );
+        {
+            const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
-UBaseType_t uxQueueGetQueueLength( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
-{
-    traceENTER_uxQueueGetQueueLength( xQueue );
+            if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) &&
+                ( pxQueue->uxQueueType != queueQUEUE_IS_MUTEX )
+                #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+                    && ( pxQueue->pcBorrowedItem == NULL )
+                #endif
+                )
+            {
+                const int8_t cRxLock = pxQueue->cRxLock;
 
-    traceRETURN_uxQueueGetQueueLength( ( ( Queue_t * ) xQueue )->uxLength );
+                /* A waiting sender has to be moved to a ready list, which needs
+                 * the kernel lock - unless the queue is locked, in which case the
+                 * task that locked it does that when it unlocks the queue. */
+                if( ( cRxLock != queueUNLOCKED ) ||
+                    ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE ) )
+                {
+                    prvCopyDataFromQueue( pxQueue, pvBuffer );
+                    traceQUEUE_RECEIVE( pxQueue );
+                    pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting - ( UBaseType_t ) 1 );
+                    queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
 
-    return ( ( Queue_t * ) xQueue )->uxLength;
-}
+                    #if ( configUSE_PRIORITY_QUEUES == 1 )
+                    {
+                        prvRemoveFromHeap( pxQueue );
+                    }
+                    #endif
+
+                    if( cRxLock != queueUNLOCKED )
+                    {
+                        prvIncrementQueueRxLock( pxQueue, cRxLock );
+                    }
+
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueRELEASE_OBJECT_LOCK( pxQueue );
+        portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_PER_OBJECT_LOCKS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_MUTEXES == 1 )
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
 
-    static UBaseType_t prvGetHighestPriorityOfWaitToReceiveList( const Queue_t * const pxQueue )
+    static BaseType_t prvCommitClaimedSlot( Queue_t * const pxQueue,
+                                            const BaseType_t xFromISR )
     {
-        UBaseType_t uxHighestPriorityOfWaitingTasks;
+        BaseType_t xReturn = pdFALSE;
+        UBaseType_t uxWaitingTasks;
 
-        /* If a task waiting for a mutex causes the mutex holder to inherit a
-         * priority, but the waiting task times out, then the holder should
-         * disinherit the priority - but only down to the highest priority of any
-         * other tasks that are waiting for the same mutex.  For this purpose,
-         * return the priority of the highest priority task that is waiting for the
-         * mutex. */
-        if( listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) > 0U )
+        /* The claimed slot is at pcWriteTo, so committing it is a send to the
+         * back of the queue without the copy. */
+        pxQueue->pcClaimedSlot = NULL;
+        pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
         {
-            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) ( ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxQueue->xTasksWaitingToReceive ) ) );
+            pxQueue->pcWriteTo = pxQueue->pcHead;
         }
         else
         {
-            uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+            mtCOVERAGE_TEST_MARKER();
         }
 
-        return uxHighestPriorityOfWaitingTasks;
-    }
-
-#endif /* configUSE_MUTEXES */
-/*-----------------------------------------------------------*/
-
-static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
-                                      const void * pvItemToQueue,
-                                      const BaseType_t xPosition )
-{
-    BaseType_t xReturn = pdFALSE;
-    UBaseType_t uxMessagesWaiting;
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting + ( UBaseType_t ) 1 );
+        queueSTATS_RECORD_SENT( pxQueue, 1U );
 
-    /* This function is called from a critical section. */
+        if( ( xFromISR == pdFALSE ) || ( pxQueue->cTxLock == queueUNLOCKED ) )
+        {
+            #if ( configUSE_QUEUE_SETS == 1 )
+            {
+                if( pxQueue->pxQueueSetContainer != NULL )
+                {
+                    xReturn = prvNotifyQueueSetContainer( pxQueue );
+                }
+                else if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    xReturn = queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #else /* configUSE_QUEUE_SETS */
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    xReturn = queueREMOVE_FROM_EVENT_LIST( pxQueue, &( pxQueue->xTasksWaitingToReceive ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_QUEUE_SETS */
+        }
+        else
+        {
+            const int8_t cTxLock = pxQueue->cTxLock;
 
-    uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+            prvIncrementQueueTxLock( pxQueue, cTxLock );
+        }
 
-    if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
-    {
-        #if ( configUSE_MUTEXES == 1 )
+        /* Senders were held off by the claim whether or not the queue had room
+         * for them. */
+        if( ( xFromISR == pdFALSE ) || ( pxQueue->cRxLock == queueUNLOCKED ) )
         {
-            if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+            if( prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToSend ), listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToSend ) ) ) != pdFALSE )
             {
-                /* The mutex is no longer being held. */
-                xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
-                pxQueue->u.xSemaphore.xMutexHolder = NULL;
+                xReturn = pdTRUE;
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
         }
-        #endif /* configUSE_MUTEXES */
-    }
-    else if( xPosition == queueSEND_TO_BACK )
-    {
-        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
-        pxQueue->pcWriteTo += pxQueue->uxItemSize;
-
-        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
-        {
-            pxQueue->pcWriteTo = pxQueue->pcHead;
-        }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            for( uxWaitingTasks = listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToSend ) ); uxWaitingTasks > ( UBaseType_t ) 0U; uxWaitingTasks-- )
+            {
+                const int8_t cRxLock = pxQueue->cRxLock;
+
+                prvIncrementQueueRxLock( pxQueue, cRxLock );
+            }
         }
+
+        return xReturn;
     }
-    else
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    static BaseType_t prvReleaseBorrowedItem( Queue_t * const pxQueue,
+                                              const BaseType_t xFromISR )
     {
-        ( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
-        pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
+        BaseType_t xReturn = pdFALSE;
+        UBaseType_t uxWaitingTasks;
 
-        if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead )
+        /* The borrowed item is the front item, so releasing it is a receive
+         * without the copy. */
+        pxQueue->u.xQueue.pcReadFrom = pxQueue->pcBorrowedItem;
+        pxQueue->pcBorrowedItem = NULL;
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1 );
+        queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
+
+        /* Receivers were held off by the borrow, but those waiting on a queue
+         * that is now empty have to carry on waiting. */
+        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
         {
-            pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
+            if( ( xFromISR == pdFALSE ) || ( pxQueue->cTxLock == queueUNLOCKED ) )
+            {
+                xReturn = prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToReceive ), listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) );
+            }
+            else
+            {
+                for( uxWaitingTasks = listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ); uxWaitingTasks > ( UBaseType_t ) 0U; uxWaitingTasks-- )
+                {
+                    const int8_t cTxLock = pxQueue->cTxLock;
+
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                }
+            }
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
 
-        if( xPosition == queueOVERWRITE )
+        /* The slot is free now, and senders to the front of the queue were held
+         * off by the borrow whether or not the queue had room for them. */
+        if( ( xFromISR == pdFALSE ) || ( pxQueue->cRxLock == queueUNLOCKED ) )
         {
-            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            if( prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToSend ), listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToSend ) ) ) != pdFALSE )
             {
-                /* An item is not being added but overwritten, so subtract
-                 * one from the recorded number of items in the queue so when
-                 * one is added again below the number of recorded items remains
-                 * correct. */
-                --uxMessagesWaiting;
+                xReturn = pdTRUE;
             }
             else
             {
@@ -2470,221 +4636,254 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            for( uxWaitingTasks = listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToSend ) ); uxWaitingTasks > ( UBaseType_t ) 0U; uxWaitingTasks-- )
+            {
+                const int8_t cRxLock = pxQueue->cRxLock;
+
+                prvIncrementQueueRxLock( pxQueue, cRxLock );
+            }
         }
-    }
 
-    pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxMessagesWaiting + ( UBaseType_t ) 1 );
+        return xReturn;
+    }
 
-    return xReturn;
-}
+#endif /* configUSE_QUEUE_ZERO_COPY */
 /*-----------------------------------------------------------*/
 
-static void prvCopyDataFromQueue( Queue_t * const pxQueue,
-                                  void * const pvBuffer )
-{
-    if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    static BaseType_t prvSendMultipleToQueue( Queue_t * const pxQueue,
+                                              const void * pvItems,
+                                              const UBaseType_t uxItems,
+                                              const BaseType_t xFromISR )
     {
-        pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
+        BaseType_t xReturn = pdFALSE;
+        const size_t xBytes = ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize;
+        size_t xBytesToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+        UBaseType_t uxItem;
 
-        if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail )
+        /* The items go to the back of the queue in one block, or two if they
+         * wrap around the end of the storage area. */
+        if( xBytes <= xBytesToTail )
         {
-            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytes );
+            pxQueue->pcWriteTo += xBytes;
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytesToTail );
+            ( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) ( ( const uint8_t * ) pvItems + xBytesToTail ), xBytes - xBytesToTail );
+            pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xBytesToTail );
         }
 
-        ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize );
-    }
-}
-/*-----------------------------------------------------------*/
-
-static void prvUnlockQueue( Queue_t * const pxQueue )
-{
-    /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-    /* The lock counts contains the number of extra data items placed or
-     * removed from the queue while the queue was locked.  When a queue is
-     * locked items can be added or removed, but the event lists cannot be
-     * updated. */
-    taskENTER_CRITICAL();
-    {
-        int8_t cTxLock = pxQueue->cTxLock;
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting + uxItems );
+        queueSTATS_RECORD_SENT( pxQueue, uxItems );
 
-        /* See if data was added to the queue while it was locked. */
-        while( cTxLock > queueLOCKED_UNMODIFIED )
+        /* Each item can unblock one receiver, or must be posted to the queue
+         * set the queue is a member of. */
+        if( ( xFromISR == pdFALSE ) || ( pxQueue->cTxLock == queueUNLOCKED ) )
         {
-            /* Data was posted while the queue was locked.  Are any tasks
-             * blocked waiting for data to become available? */
             #if ( configUSE_QUEUE_SETS == 1 )
             {
                 if( pxQueue->pxQueueSetContainer != NULL )
                 {
-                    if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
-                    {
-                        /* The queue is a member of a queue set, and posting to
-                         * the queue set caused a higher priority task to unblock.
-                         * A context switch is required. */
-                        vTaskMissedYield();
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                else
-                {
-                    /* Tasks that are removed from the event list will get
-                     * added to the pending ready list as the scheduler is still
-                     * suspended. */
-                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                    for( uxItem = ( UBaseType_t ) 0U; uxItem < uxItems; uxItem++ )
                     {
-                        if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                        if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
                         {
-                            /* The task waiting has a higher priority so record that a
-                             * context switch is required. */
-                            vTaskMissedYield();
+                            xReturn = pdTRUE;
                         }
                         else
                         {
                             mtCOVERAGE_TEST_MARKER();
                         }
                     }
-                    else
-                    {
-                        break;
-                    }
-                }
-            }
-            #else /* configUSE_QUEUE_SETS */
-            {
-                /* Tasks that are removed from the event list will get added to
-                 * the pending ready list as the scheduler is still suspended. */
-                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
-                {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
-                    {
-                        /* The task waiting has a higher priority so record that
-                         * a context switch is required. */
-                        vTaskMissedYield();
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
                 }
                 else
                 {
-                    break;
+                    xReturn = prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToReceive ), uxItems );
                 }
             }
+            #else /* configUSE_QUEUE_SETS */
+            {
+                xReturn = prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToReceive ), uxItems );
+            }
             #endif /* configUSE_QUEUE_SETS */
+        }
+        else
+        {
+            /* The task that unlocks the queue does the unblocking, one task
+             * for each item. */
+            for( uxItem = ( UBaseType_t ) 0U; uxItem < uxItems; uxItem++ )
+            {
+                const int8_t cTxLock = pxQueue->cTxLock;
 
-            --cTxLock;
+                prvIncrementQueueTxLock( pxQueue, cTxLock );
+            }
         }
 
-        pxQueue->cTxLock = queueUNLOCKED;
+        return xReturn;
     }
-    taskEXIT_CRITICAL();
 
-    /* Do the same for the Rx lock. */
-    taskENTER_CRITICAL();
+#endif /* configUSE_QUEUE_BATCHING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHING == 1 )
+
+    static BaseType_t prvReceiveMultipleFromQueue( Queue_t * const pxQueue,
+                                                   void * const pvBuffer,
+                                                   const UBaseType_t uxItems,
+                                                   const BaseType_t xFromISR )
     {
-        int8_t cRxLock = pxQueue->cRxLock;
+        BaseType_t xReturn = pdFALSE;
+        const size_t xBytes = ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize;
+        int8_t * pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+        size_t xBytesToTail;
+        UBaseType_t uxItem;
+
+        /* pcReadFrom points to the last item read, so the front item is the
+         * one after it. */
+        if( pcReadFrom >= pxQueue->u.xQueue.pcTail )
+        {
+            pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-        while( cRxLock > queueLOCKED_UNMODIFIED )
+        /* The items come from the front of the queue in one block, or two if
+         * they wrap around the end of the storage area.  pcReadFrom is left
+         * pointing to the last of them. */
+        xBytesToTail = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom );
+
+        if( xBytes <= xBytesToTail )
         {
-            if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
-            {
-                if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
-                {
-                    vTaskMissedYield();
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+            ( void ) memcpy( pvBuffer, ( void * ) pcReadFrom, xBytes );
+            pxQueue->u.xQueue.pcReadFrom = pcReadFrom + ( xBytes - pxQueue->uxItemSize );
+        }
+        else
+        {
+            ( void ) memcpy( pvBuffer, ( void * ) pcReadFrom, xBytesToTail );
+            ( void ) memcpy( ( void * ) ( ( uint8_t * ) pvBuffer + xBytesToTail ), ( void * ) pxQueue->pcHead, xBytes - xBytesToTail );
+            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( xBytes - xBytesToTail ) - pxQueue->uxItemSize );
+        }
 
-                --cRxLock;
-            }
-            else
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - uxItems );
+        queueSTATS_RECORD_RECEIVED( pxQueue, uxItems );
+
+        /* Each free slot can unblock one sender. */
+        if( ( xFromISR == pdFALSE ) || ( pxQueue->cRxLock == queueUNLOCKED ) )
+        {
+            xReturn = prvUnblockWaitingTasks( pxQueue, &( pxQueue->xTasksWaitingToSend ), uxItems );
+        }
+        else
+        {
+            for( uxItem = ( UBaseType_t ) 0U; uxItem < uxItems; uxItem++ )
             {
-                break;
+                const int8_t cRxLock = pxQueue->cRxLock;
+
+                prvIncrementQueueRxLock( pxQueue, cRxLock );
             }
         }
 
-        pxQueue->cRxLock = queueUNLOCKED;
+        return xReturn;
     }
-    taskEXIT_CRITICAL();
-}
+
+#endif /* configUSE_QUEUE_BATCHING */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue )
-{
-    BaseType_t xReturn;
+#if ( ( configUSE_QUEUE_ZERO_COPY == 1 ) || ( configUSE_QUEUE_BATCHING == 1 ) )
 
-    taskENTER_CRITICAL();
+    static BaseType_t prvUnblockWaitingTasks( Queue_t * const pxQueue,
+                                              List_t * const pxEventList,
+                                              UBaseType_t uxTasksToUnblock )
     {
-        if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
-        {
-            xReturn = pdTRUE;
-        }
-        else
+        BaseType_t xReturn = pdFALSE;
+
+        /* Only used when the cross-core wakeups are counted. */
+        ( void ) pxQueue;
+
+        while( ( uxTasksToUnblock > ( UBaseType_t ) 0U ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
         {
-            xReturn = pdFALSE;
+            if( queueREMOVE_FROM_EVENT_LIST( pxQueue, pxEventList ) != pdFALSE )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxTasksToUnblock--;
         }
+
+        return xReturn;
     }
-    taskEXIT_CRITICAL();
 
-    return xReturn;
-}
+#endif /* ( ( configUSE_QUEUE_ZERO_COPY == 1 ) || ( configUSE_QUEUE_BATCHING == 1 ) ) */
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue )
-{
-    BaseType_t xReturn;
-    Queue_t * const pxQueue = xQueue;
+#if ( configUSE_QUEUE_STATS == 1 )
 
-    traceENTER_xQueueIsQueueEmptyFromISR( xQueue );
+    static void prvRecordBlockedTime( Queue_t * const pxQueue,
+                                      uint32_t * const pulBlocks,
+                                      const configRUN_TIME_COUNTER_TYPE ulBlockStartTime )
+    {
+        const configRUN_TIME_COUNTER_TYPE ulBlockedTime = portGET_RUN_TIME_COUNTER_VALUE() - ulBlockStartTime;
 
-    configASSERT( pxQueue );
+        queueENTER_CRITICAL( pxQueue );
+        {
+            ( *pulBlocks )++;
+            pxQueue->xStats.ulBlockedTime += ulBlockedTime;
 
-    if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
-    {
-        xReturn = pdTRUE;
-    }
-    else
-    {
-        xReturn = pdFALSE;
+            if( ulBlockedTime > pxQueue->xStats.ulPeakBlockedTime )
+            {
+                pxQueue->xStats.ulPeakBlockedTime = ulBlockedTime;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        queueEXIT_CRITICAL( pxQueue );
     }
 
-    traceRETURN_xQueueIsQueueEmptyFromISR( xReturn );
-
-    return xReturn;
-}
+#endif /* configUSE_QUEUE_STATS */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvIsQueueFull( const Queue_t * pxQueue )
-{
-    BaseType_t xReturn;
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
 
-    taskENTER_CRITICAL();
+    static BaseType_t prvRemoveFromEventList( Queue_t * const pxQueue,
+                                              const List_t * const pxEventList )
     {
-        if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+        /* Unblocking a task asks another core to yield if the task is going to
+         * run there in place of a lower priority task. */
+        const UBaseType_t uxRemoteYields = uxTaskGetRemoteYieldCount();
+        const BaseType_t xReturn = xTaskRemoveFromEventList( pxEventList );
+
+        if( uxTaskGetRemoteYieldCount() != uxRemoteYields )
         {
-            xReturn = pdTRUE;
+            pxQueue->xStats.ulCrossCoreWakeups++;
         }
         else
         {
-            xReturn = pdFALSE;
+            mtCOVERAGE_TEST_MARKER();
         }
+
+        return xReturn;
     }
-    taskEXIT_CRITICAL();
 
-    return xReturn;
-}
+#endif /* ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) ) */
 /*-----------------------------------------------------------*/
 
 BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
@@ -2727,7 +4926,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
          * between the check to see if the queue is full and blocking on the queue. */
         portDISABLE_INTERRUPTS();
         {
-            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
             {
                 /* The queue is full - do we want to block or just leave without
                  * posting? */
@@ -2805,6 +5004,10 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         traceENTER_xQueueCRReceive( xQueue, pvBuffer, xTicksToWait );
 
+        /* Co-routines read the items in the ring directly, which a priority
+         * queue does not keep them in. */
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* If the queue is already empty we may have to block.  A critical section
          * is required to prevent an interrupt adding something to the queue
          * between the check to see if the queue is empty and blocking on the queue. */
@@ -2852,6 +5055,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                 }
 
                 --( pxQueue->uxMessagesWaiting );
+                queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
                 ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( unsigned ) pxQueue->uxItemSize );
 
                 xReturn = pdPASS;
@@ -2957,6 +5161,10 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         traceENTER_xQueueCRReceiveFromISR( xQueue, pvBuffer, pxCoRoutineWoken );
 
+        /* Co-routines read the items in the ring directly, which a priority
+         * queue does not keep them in. */
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* We cannot block from an ISR, so check there is data available. If
          * not then just leave without doing anything. */
         if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
@@ -2974,6 +5182,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
             }
 
             --( pxQueue->uxMessagesWaiting );
+            queueSTATS_RECORD_RECEIVED( pxQueue, 1U );
             ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( unsigned ) pxQueue->uxItemSize );
 
             if( ( *pxCoRoutineWoken ) == pdFALSE )
@@ -3137,6 +5346,92 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 #endif /* configQUEUE_REGISTRY_SIZE */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATS == 1 )
+
+    void vQueueGetStats( QueueHandle_t xQueue,
+                         QueueStats_t * pxStats )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueGetStats( xQueue, pxStats );
+
+        configASSERT( pxQueue );
+        configASSERT( pxStats );
+
+        queueENTER_CRITICAL( pxQueue );
+        {
+            *pxStats = pxQueue->xStats;
+        }
+        queueEXIT_CRITICAL( pxQueue );
+
+        traceRETURN_vQueueGetStats();
+    }
+
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATS == 1 )
+
+    void vQueueResetStats( QueueHandle_t xQueue )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        traceENTER_vQueueResetStats( xQueue );
+
+        configASSERT( pxQueue );
+
+        queueENTER_CRITICAL( pxQueue );
+        {
+            ( void ) memset( ( void * ) &( pxQueue->xStats ), 0x00, sizeof( QueueStats_t ) );
+            pxQueue->xStats.uxMessagesWaitingHighWaterMark = pxQueue->uxMessagesWaiting;
+        }
+        queueEXIT_CRITICAL( pxQueue );
+
+        traceRETURN_vQueueResetStats();
+    }
+
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
+
+    UBaseType_t uxQueueGetRegistryStats( QueueRegistryStats_t * const pxStatsArray,
+                                         const UBaseType_t uxArraySize )
+    {
+        UBaseType_t ux;
+        UBaseType_t uxCount = ( UBaseType_t ) 0U;
+
+        traceENTER_uxQueueGetRegistryStats( pxStatsArray, uxArraySize );
+
+        configASSERT( ( pxStatsArray != NULL ) || ( uxArraySize == ( UBaseType_t ) 0U ) );
+
+        /* As for pcQueueGetName(), there is nothing here to protect against
+         * another task adding or removing entries from the registry while it is
+         * being read, so a queue must be removed from the registry before it is
+         * deleted, as vQueueDelete() does. */
+        for( ux = ( UBaseType_t ) 0U; ( ux < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE ) && ( uxCount < uxArraySize ); ux++ )
+        {
+            if( xQueueRegistry[ ux ].pcQueueName != NULL )
+            {
+                pxStatsArray[ uxCount ].pcQueueName = xQueueRegistry[ ux ].pcQueueName;
+                pxStatsArray[ uxCount ].xHandle = xQueueRegistry[ ux ].xHandle;
+                vQueueGetStats( pxStatsArray[ uxCount ].xHandle, &( pxStatsArray[ uxCount ].xStats ) );
+                uxCount++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        traceRETURN_uxQueueGetRegistryStats( uxCount );
+
+        return uxCount;
+    }
+
+#endif /* ( ( configUSE_QUEUE_STATS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TIMERS == 1 )
 
     void vQueueWaitForMessageRestricted( QueueHandle_t xQueue,
@@ -3228,7 +5523,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         traceENTER_xQueueAddToSet( xQueueOrSemaphore, xQueueSet );
 
-        taskENTER_CRITICAL();
+        queueENTER_CRITICAL( ( Queue_t * ) xQueueOrSemaphore );
         {
             if( ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer != NULL )
             {
@@ -3247,7 +5542,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                 xReturn = pdPASS;
             }
         }
-        taskEXIT_CRITICAL();
+        queueEXIT_CRITICAL( ( Queue_t * ) xQueueOrSemaphore );
 
         traceRETURN_xQueueAddToSet( xReturn );
 
@@ -3281,12 +5576,12 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         }
         else
         {
-            taskENTER_CRITICAL();
+            queueENTER_CRITICAL( pxQueueOrSemaphore );
             {
                 /* The queue is no longer contained in the set. */
                 pxQueueOrSemaphore->pxQueueSetContainer = NULL;
             }
-            taskEXIT_CRITICAL();
+            queueEXIT_CRITICAL( pxQueueOrSemaphore );
             xReturn = pdPASS;
         }
 
@@ -3348,6 +5643,14 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
          * to prvNotifyQueueSetContainer is preceded by a check that
          * pxQueueSetContainer != NULL */
         configASSERT( pxQueueSetContainer ); /* LCOV_EXCL_BR_LINE */
+
+        /* The member's lock is already held, the set's lock nests inside it. */
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        {
+            queueGET_OBJECT_LOCK( pxQueueSetContainer );
+        }
+        #endif
+
         configASSERT( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength );
 
         if( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength )
@@ -3363,7 +5666,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
             {
                 if( listLIST_IS_EMPTY( &( pxQueueSetContainer->xTasksWaitingToReceive ) ) == pdFALSE )
                 {
-                    if( xTaskRemoveFromEventList( &( pxQueueSetContainer->xTasksWaitingToReceive ) ) != pdFALSE )
+                    if( queueREMOVE_FROM_EVENT_LIST( pxQueueSetContainer, &( pxQueueSetContainer->xTasksWaitingToReceive ) ) != pdFALSE )
                     {
                         /* The task waiting has a higher priority. */
                         xReturn = pdTRUE;
@@ -3388,6 +5691,12 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        #if ( configUSE_PER_OBJECT_LOCKS == 1 )
+        {
+            queueRELEASE_OBJECT_LOCK( pxQueueSetContainer );
+        }
+        #endif
+
         return xReturn;
     }
 
@@ -215,11 +215,16 @@
 
 /*-----------------------------------------------------------*/
 
-/* Define away taskRESET_READY_PRIORITY() and portRESET_READY_PRIORITY() as
- * they are only required when a port optimised method of task selection is
- * being used. */
-    #define taskRESET_READY_PRIORITY( uxPriority )
-    #define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
+/* Define away taskRESET_READY_PRIORITY(), taskCLEAR_READY_PRIORITY() and
+ * taskRECORD_READY_LIST_PRIORITY() as they are only required when a port
+ * optimised method of task selection is being used. */
+    #define taskRESET_READY_PRIORITY( pxTCB, uxPriority )
+    #define taskCLEAR_READY_PRIORITY( pxTCB, uxPriority )
+    #define taskRECORD_READY_LIST_PRIORITY( pxTCB )
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        #define taskGET_TOP_READY_PRIORITY()    ( uxTopReadyPriority )
+    #endif
 
 #else /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
 
@@ -227,32 +232,51 @@
  * performed in a way that is tailored to the particular microcontroller
  * architecture being used. */
 
-/* A port optimised version is provided.  Call the port defined macros. */
+/* A port optimised version is provided.  Call the port defined macros.
+ * uxTopReadyPriority is then a bit map with a bit set for every priority that
+ * has a task in any of the ready lists. */
     #define taskRECORD_READY_PRIORITY( uxPriority )    portRECORD_READY_PRIORITY( ( uxPriority ), uxTopReadyPriority )
 
 /*-----------------------------------------------------------*/
 
-    #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                  \
-    do {                                                                                        \
-        UBaseType_t uxTopPriority;                                                              \
-                                                                                                \
-        /* Find the highest priority list that contains ready tasks. */                         \
-        portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                          \
-        configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 ); \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );   \
+    #if ( configNUMBER_OF_CORES == 1 )
+        #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                  \
+    do {                                                                                            \
+        UBaseType_t uxTopPriority;                                                                  \
+                                                                                                    \
+        /* Find the highest priority list that contains ready tasks. */                             \
+        portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                              \
+        configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );     \
+        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );       \
     } while( 0 )
+    #else /* if ( configNUMBER_OF_CORES == 1 ) */
+
+        #define taskSELECT_HIGHEST_PRIORITY_TASK( xCoreID )    prvSelectHighestPriorityTask( xCoreID )
+
+/* The priority of the highest priority ready task on any core, read from the
+ * bit map so it is always current. */
+        #define taskGET_TOP_READY_PRIORITY()                   prvGetTopReadyPriority()
+
+    #endif /* if ( configNUMBER_OF_CORES == 1 ) */
 
 /*-----------------------------------------------------------*/
 
+/* Called once the ready list of pxTCB at uxPriority is known to be empty. */
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        #define taskCLEAR_READY_PRIORITY( pxTCB, uxPriority )    prvClearReadyPriority( ( pxTCB ), ( uxPriority ) )
+    #else
+        #define taskCLEAR_READY_PRIORITY( pxTCB, uxPriority )    portRESET_READY_PRIORITY( ( uxPriority ), ( uxTopReadyPriority ) )
+    #endif
+
 /* A port optimised version is provided, call it only if the TCB being reset
  * is being referenced from a ready list.  If it is referenced from a delayed
  * or suspended list then it won't be in a ready list. */
-    #define taskRESET_READY_PRIORITY( uxPriority )                                                     \
-    do {                                                                                               \
-        if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) == ( UBaseType_t ) 0 ) \
-        {                                                                                              \
-            portRESET_READY_PRIORITY( ( uxPriority ), ( uxTopReadyPriority ) );                        \
-        }                                                                                              \
+    #define taskRESET_READY_PRIORITY( pxTCB, uxPriority )                                                \
+    do {                                                                                                 \
+        if( listCURRENT_LIST_LENGTH( taskREADY_LIST( ( pxTCB ), ( uxPriority ) ) ) == ( UBaseType_t ) 0 ) \
+        {                                                                                                \
+            taskCLEAR_READY_PRIORITY( ( pxTCB ), ( uxPriority ) );                                       \
+        }                                                                                                \
     } while( 0 )
 
 #endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
@@ -275,18 +299,184 @@
         prvResetNextTaskUnblockTime();                                            \
     } while( 0 )
 
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+/* The equivalent of taskSWITCH_DELAYED_LISTS() for the delayed lists of a
+ * single core, used when the core's own view of the tick count overflows. */
+    #define taskSWITCH_CORE_DELAYED_LISTS( xCoreID )                                         \
+    do {                                                                                     \
+        List_t * pxTemp;                                                                     \
+                                                                                             \
+        configASSERT( ( listLIST_IS_EMPTY( pxCoreDelayedTaskList[ ( xCoreID ) ] ) ) );       \
+                                                                                             \
+        pxTemp = pxCoreDelayedTaskList[ ( xCoreID ) ];                                       \
+        pxCoreDelayedTaskList[ ( xCoreID ) ] = pxCoreOverflowDelayedTaskList[ ( xCoreID ) ]; \
+        pxCoreOverflowDelayedTaskList[ ( xCoreID ) ] = pxTemp;                               \
+        prvResetCoreNextTaskUnblockTime( ( xCoreID ) );                                      \
+    } while( 0 )
+
+    #define taskIS_CORE_DELAYED_LIST( pxList )    prvIsCoreDelayedList( pxList )
+
+#else /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+    #define taskIS_CORE_DELAYED_LIST( pxList )    ( pdFALSE )
+
+#endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+#if ( configUSE_DELAY_WHEEL == 1 )
+
+/* Every level of a delay wheel has 1 << taskDELAY_WHEEL_SLOT_BITS slots, so
+ * the slots in use at one level fit in a UBaseType_t bit map. */
+    #define taskDELAY_WHEEL_SLOT_BITS    ( 5U )
+    #define taskDELAY_WHEEL_SLOTS        ( ( UBaseType_t ) 1U << taskDELAY_WHEEL_SLOT_BITS )
+    #define taskDELAY_WHEEL_SLOT_MASK    ( taskDELAY_WHEEL_SLOTS - 1U )
+
+/* The first wheel fronts the shared delayed lists and, with per core ticks,
+ * wheel x + 1 fronts the delayed lists of core x. */
+    #if ( configUSE_PER_CORE_TICKS == 1 )
+        #define taskDELAY_WHEEL_COUNT    ( configNUMBER_OF_CORES + 1 )
+    #else
+        #define taskDELAY_WHEEL_COUNT    ( 1 )
+    #endif
+
+    #define taskGLOBAL_DELAY_WHEEL                ( &( xDelayWheels[ 0 ] ) )
+    #define taskCORE_DELAY_WHEEL( xCoreID )       ( &( xDelayWheels[ ( xCoreID ) + 1 ] ) )
+    #define taskIS_DELAY_WHEEL_LIST( pxList )     prvIsDelayWheelList( pxList )
+
+#else /* #if ( configUSE_DELAY_WHEEL == 1 ) */
+
+    #define taskIS_DELAY_WHEEL_LIST( pxList )     ( pdFALSE )
+
+#endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PER_CORE_READY_LISTS == 1 )
+
+/* A task whose affinity mask names exactly one core is held in that core's
+ * private ready lists, all other tasks are held in the shared ready lists.
+ * The choice is made each time the task is added to a ready list so it
+ * always reflects the current affinity mask. */
+    #define taskREADY_LIST( pxTCB, uxPriority )                                   \
+    ( ( ( pxTCB )->xReadyListCore >= 0 ) ?                                        \
+      &( pxCoreReadyTasksLists[ ( pxTCB )->xReadyListCore ][ ( uxPriority ) ] ) : \
+      &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+
+    #define taskUPDATE_READY_LIST_CORE( pxTCB )    ( ( pxTCB )->xReadyListCore = prvGetReadyListCore( ( pxTCB )->uxCoreAffinityMask ) )
+
+/* The number of ready lists a core searches at each priority. */
+    #define taskREADY_LISTS_PER_CORE    2
+
+/* Fill pxLists with the ready lists xCoreID searches at uxPriority, in search
+ * order.  Tasks pinned to the core are considered first.  Tasks in the shared
+ * lists can run on any core in their affinity mask, so a core takes work from
+ * them once its own list at that priority has nothing runnable.  The private
+ * lists of other cores are never searched. */
+    #define taskGET_CORE_READY_LISTS( pxLists, xCoreID, uxPriority )                    \
+    do {                                                                                \
+        ( pxLists )[ 0 ] = &( pxCoreReadyTasksLists[ ( xCoreID ) ][ ( uxPriority ) ] ); \
+        ( pxLists )[ 1 ] = &( pxReadyTasksLists[ ( uxPriority ) ] );                    \
+    } while( 0 )
+
+/* The number of ready tasks at uxPriority that xCoreID can consider. */
+    #define taskREADY_TASKS_AT_PRIORITY( xCoreID, uxPriority )              \
+    ( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) + \
+      listCURRENT_LIST_LENGTH( &( pxCoreReadyTasksLists[ ( xCoreID ) ][ ( uxPriority ) ] ) ) )
+
+    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+/* Each ready list set has its own priority bit map as well, so a core only
+ * looks at the priorities of the tasks it is allowed to take - those in the
+ * shared lists and those pinned to it. */
+        #define taskREADY_PRIORITIES( pxTCB ) \
+    ( ( ( pxTCB )->xReadyListCore >= 0 ) ? &( uxCoreReadyPriorities[ ( pxTCB )->xReadyListCore ] ) : &( uxSharedReadyPriorities ) )
+
+        #define taskRECORD_READY_LIST_PRIORITY( pxTCB )    portRECORD_READY_PRIORITY( ( pxTCB )->uxPriority, *taskREADY_PRIORITIES( pxTCB ) )
+
+        #define taskCORE_READY_PRIORITIES( xCoreID )       ( uxSharedReadyPriorities | uxCoreReadyPriorities[ ( xCoreID ) ] )
+
+    #endif /* #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) */
+
+#else /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+
+    #define taskREADY_LIST( pxTCB, uxPriority )                   ( &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+    #define taskUPDATE_READY_LIST_CORE( pxTCB )
+    #define taskREADY_LISTS_PER_CORE                              1
+    #define taskGET_CORE_READY_LISTS( pxLists, xCoreID, uxPriority ) \
+    do {                                                             \
+        ( void ) ( xCoreID );                                        \
+        ( pxLists )[ 0 ] = &( pxReadyTasksLists[ ( uxPriority ) ] ); \
+    } while( 0 )
+    #define taskREADY_TASKS_AT_PRIORITY( xCoreID, uxPriority )    listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+
+    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+        #define taskRECORD_READY_LIST_PRIORITY( pxTCB )
+        #define taskCORE_READY_PRIORITIES( xCoreID )    ( uxTopReadyPriority )
+    #endif
+
+#endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+/*-----------------------------------------------------------*/
+
+/* Let the port wake a core that is sleeping in its idle task and is allowed
+ * to run pxTCB. */
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
+    #define taskWAKE_SLEEPING_CORES( pxTCB )    portWAKE_SLEEPING_CORES( ( pxTCB )->uxCoreAffinityMask )
+#elif ( configNUMBER_OF_CORES > 1 )
+    #define taskWAKE_SLEEPING_CORES( pxTCB )    portWAKE_SLEEPING_CORES( tskNO_AFFINITY )
+#else
+    #define taskWAKE_SLEEPING_CORES( pxTCB )
+#endif
+
+/* Tell prvReadyTaskWaitingForCore() that a task may be waiting for a core. */
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #define taskREADY_TASKS_CHANGED()    ( uxReadyTasksChanges++ )
+#else
+    #define taskREADY_TASKS_CHANGED()
+#endif
+/*-----------------------------------------------------------*/
+
+/* Keep the idle and running core masks in step with the task each core runs
+ * and with the priority of running tasks. */
+#if ( configUSE_RUNNING_CORE_MASKS == 1 )
+    #define taskRECORD_RUNNING_TASK( xCoreID, pxTCB )    prvRecordRunningTask( ( xCoreID ), ( pxTCB ) )
+    #define taskUPDATE_RUNNING_PRIORITY( pxTCB )          prvUpdateRunningPriority( pxTCB )
+#else
+    #define taskRECORD_RUNNING_TASK( xCoreID, pxTCB )
+    #define taskUPDATE_RUNNING_PRIORITY( pxTCB )
+#endif
+
+/* Remember the core a task is switched in on, counting a migration if it last
+ * ran on another core. */
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+    #define taskRECORD_LAST_RUN_CORE( pxTCB, xCoreID )                                       \
+    do {                                                                                     \
+        if( ( ( pxTCB )->xLastRunCore >= 0 ) && ( ( pxTCB )->xLastRunCore != ( xCoreID ) ) ) \
+        {                                                                                    \
+            xMigrationStats.ulMigrations++;                                                  \
+        }                                                                                    \
+        ( pxTCB )->xLastRunCore = ( xCoreID );                                               \
+    } while( 0 )
+#elif ( configUSE_LOAD_BALANCER == 1 )
+    #define taskRECORD_LAST_RUN_CORE( pxTCB, xCoreID )    ( ( pxTCB )->xLastRunCore = ( xCoreID ) )
+#else
+    #define taskRECORD_LAST_RUN_CORE( pxTCB, xCoreID )
+#endif
 /*-----------------------------------------------------------*/
 
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
  */
-#define prvAddTaskToReadyList( pxTCB )                                                                     \
-    do {                                                                                                   \
-        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-        listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
-        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                      \
+#define prvAddTaskToReadyList( pxTCB )                                                                         \
+    do {                                                                                                       \
+        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                               \
+        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                    \
+        taskUPDATE_READY_LIST_CORE( pxTCB );                                                                   \
+        taskRECORD_READY_LIST_PRIORITY( pxTCB );                                                               \
+        listINSERT_END( taskREADY_LIST( ( pxTCB ), ( pxTCB )->uxPriority ), &( ( pxTCB )->xStateListItem ) ); \
+        taskREADY_TASKS_CHANGED();                                                                             \
+        taskWAKE_SLEEPING_CORES( pxTCB );                                                                      \
+        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                          \
     } while( 0 )
 /*-----------------------------------------------------------*/
 
@@ -330,7 +520,14 @@
 #endif
 
 /* Indicates that the task is an Idle task. */
-#define taskATTRIBUTE_IS_IDLE    ( UBaseType_t ) ( 1U << 0U )
+#define taskATTRIBUTE_IS_IDLE          ( UBaseType_t ) ( 1U << 0U )
+
+/* Indicates that the task was created with an affinity mask, which the load
+ * balancer must not change. */
+#define taskATTRIBUTE_HARD_AFFINITY    ( UBaseType_t ) ( 1U << 1U )
+
+/* Indicates that the load balancer may move the task between cores. */
+#define taskATTRIBUTE_MIGRATABLE       ( UBaseType_t ) ( 1U << 2U )
 
 #if ( ( configNUMBER_OF_CORES > 1 ) && ( portCRITICAL_NESTING_IN_TCB == 1 ) )
     #define portGET_CRITICAL_NESTING_COUNT( xCoreID )          ( pxCurrentTCBs[ ( xCoreID ) ]->uxCriticalNesting )
@@ -356,6 +553,7 @@
         else                                                                                 \
         {                                                                                    \
             /* Request other core to yield if it is not requested before. */                 \
+            taskRECORD_REMOTE_YIELD();                                                       \
             if( pxCurrentTCBs[ ( xCoreID ) ]->xTaskRunState != taskTASK_SCHEDULED_TO_YIELD ) \
             {                                                                                \
                 portYIELD_CORE( xCoreID );                                                   \
@@ -364,6 +562,15 @@
         }                                                                                    \
     } while( 0 )
 #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
+
+/* Counts, for the core making the request, the yields requested of other
+ * cores.  The queue statistics use the count to tell whether unblocking a task
+ * woke another core. */
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    #define taskRECORD_REMOTE_YIELD()    ( uxRemoteYieldRequests[ portGET_CORE_ID() ]++ )
+#else
+    #define taskRECORD_REMOTE_YIELD()
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -382,6 +589,15 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_CORE_AFFINITY == 1 ) && ( configNUMBER_OF_CORES > 1 )
         UBaseType_t uxCoreAffinityMask; /**< Used to link the task to certain cores.  UBaseType_t must have greater than or equal to the number of bits as configNUMBER_OF_CORES. */
     #endif
+    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        BaseType_t xReadyListCore; /**< The core whose private ready lists hold the task, or -1 if the task is held in the shared ready lists. */
+    #endif
+    #if ( ( configUSE_CACHE_AFFINITY_WAKEUP == 1 ) || ( configUSE_LOAD_BALANCER == 1 ) )
+        BaseType_t xLastRunCore; /**< The core the task last ran on, or -1 if it has not run yet. */
+    #endif
+    #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+        BaseType_t xCacheAffinityHint; /**< Set to pdTRUE if the task should be placed back on xLastRunCore when it becomes ready. */
+    #endif
 
     ListItem_t xStateListItem;                  /**< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
     ListItem_t xEventListItem;                  /**< Used to reference a task from an event list. */
@@ -473,10 +689,43 @@ typedef tskTCB TCB_t;
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
+#if ( configUSE_PER_CORE_READY_LISTS == 1 )
+    PRIVILEGED_DATA static List_t pxCoreReadyTasksLists[ configNUMBER_OF_CORES ][ configMAX_PRIORITIES ]; /**< Prioritised ready tasks that are pinned to a single core. */
+
+    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+        PRIVILEGED_DATA static volatile UBaseType_t uxSharedReadyPriorities = 0U;                               /**< Priorities that have a task in the shared ready lists. */
+        PRIVILEGED_DATA static volatile UBaseType_t uxCoreReadyPriorities[ configNUMBER_OF_CORES ] = { 0U };    /**< Priorities that have a task in the private ready lists of each core. */
+    #endif
+#endif
 PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
 PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if ( configUSE_PER_CORE_TICKS == 1 )
+    PRIVILEGED_DATA static List_t xCoreDelayedTaskLists[ configNUMBER_OF_CORES ][ 2 ];             /**< Delayed tasks that are pinned to a single core, two lists per core as above. */
+    PRIVILEGED_DATA static List_t * volatile pxCoreDelayedTaskList[ configNUMBER_OF_CORES ];         /**< Points to the delayed task list each core is currently using. */
+    PRIVILEGED_DATA static List_t * volatile pxCoreOverflowDelayedTaskList[ configNUMBER_OF_CORES ]; /**< Points to the delayed task list each core is using for wake times that have overflowed its tick count. */
+#endif
+#if ( configUSE_DELAY_WHEEL == 1 )
+
+/* A hierarchical timing wheel.  xTime is the tick count the wheel has been
+ * brought up to.  A task whose wake time is in the same 32 tick block as xTime
+ * is held in the level 0 slot of its wake time.  Otherwise, if its wake time is
+ * in the same 1024 tick block, it is held in the level 1 slot of the 32 tick
+ * block it falls in, and so on.  When xTime reaches the start of a level 1 or
+ * higher slot the tasks in that slot are spread over the lower levels.  The
+ * bit of a slot in uxOccupied[] is set when a task is placed in the slot, but
+ * only cleared once the wheel reaches the slot, as a task that leaves the
+ * Blocked state early is removed with uxListRemove() alone. */
+    typedef struct xDELAY_WHEEL
+    {
+        List_t xSlots[ configDELAY_WHEEL_LEVELS ][ taskDELAY_WHEEL_SLOTS ];
+        UBaseType_t uxOccupied[ configDELAY_WHEEL_LEVELS ];
+        TickType_t xTime;
+    } DelayWheel_t;
+
+    PRIVILEGED_DATA static DelayWheel_t xDelayWheels[ taskDELAY_WHEEL_COUNT ]; /**< Delayed tasks whose wake time is near enough to be held in a timing wheel rather than a sorted delayed list. */
+#endif
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -510,6 +759,66 @@ PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
 PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUMBER_OF_CORES ];       /**< Holds the handles of the idle tasks.  The idle tasks are created automatically when the scheduler is started. */
 
+#if ( configUSE_RUNNING_CORE_MASKS == 1 )
+
+/* Bit x of these masks refers to core x.  They are only written with the
+ * kernel locks held, so each update is atomic with respect to the scheduling
+ * decisions that read them. */
+    PRIVILEGED_DATA static volatile UBaseType_t uxIdleCoreMask = 0U;                                  /**< Cores running their idle task. */
+    PRIVILEGED_DATA static volatile UBaseType_t uxRunningCoreMasks[ configMAX_PRIORITIES ] = { 0U }; /**< Cores running a task other than idle, by priority. */
+    PRIVILEGED_DATA static volatile UBaseType_t uxRunningPriorities = 0U;                             /**< Priorities that have a core in uxRunningCoreMasks. */
+    PRIVILEGED_DATA static BaseType_t xCoreRunningPriorities[ configNUMBER_OF_CORES ] = { 0 };         /**< The priority each core is held under in the masks, -1 for idle. */
+#endif
+
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+    PRIVILEGED_DATA static TaskMigrationStats_t xMigrationStats = { 0U }; /**< Only updated with the kernel locks held. */
+#endif
+
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+    PRIVILEGED_DATA static UBaseType_t uxRemoteYieldRequests[ configNUMBER_OF_CORES ] = { 0U }; /**< Only updated with the kernel locks held, and only by the core it belongs to. */
+#endif
+
+#if ( configUSE_LOAD_BALANCER == 1 )
+
+/* A task the load balancer may move, with the cores it may be moved to and its
+ * run time at the end of the previous balancing period. */
+    typedef struct xMIGRATABLE_TASK
+    {
+        TCB_t * pxTCB;
+        UBaseType_t uxAllowedCores;
+        configRUN_TIME_COUNTER_TYPE ulLastRunTime;
+    } MigratableTask_t;
+
+    PRIVILEGED_DATA static MigratableTask_t xMigratableTasks[ configLOAD_BALANCER_MAX_TASKS ];
+    PRIVILEGED_DATA static UBaseType_t uxMigratableTasks = 0U;
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCoreBusyTime[ configNUMBER_OF_CORES ] = { 0U };     /**< Time each core spent running tasks other than an idle task. */
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulLastCoreBusyTime[ configNUMBER_OF_CORES ] = { 0U }; /**< ulCoreBusyTime at the end of the previous balancing period. */
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulLastBalanceTime = 0U;
+    PRIVILEGED_DATA static BaseType_t xLoadBalancerStarted = pdFALSE;
+#endif
+
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+/* Each core processes its own delayed lists from its own tick interrupt, so
+ * it can lag the global tick count by the time between its tick and the tick
+ * of the core that increments xTickCount.  xCoreTickCounts[] holds the tick
+ * count each core has processed its delayed lists up to. */
+    PRIVILEGED_DATA static volatile TickType_t xCoreTickCounts[ configNUMBER_OF_CORES ];
+    PRIVILEGED_DATA static volatile TickType_t xCoreNextTaskUnblockTimes[ configNUMBER_OF_CORES ];
+#endif
+
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+/* Counts the changes that can give an idle core a ready task to run: a task
+ * added to a ready list, a task switched out while still ready and a new
+ * affinity mask.  prvReadyTaskWaitingForCore() remembers the count at which it
+ * last found nothing for a core to run, and only walks the ready lists again
+ * once the count has moved on.  Both are only updated with the kernel locks
+ * held. */
+    PRIVILEGED_DATA static UBaseType_t uxReadyTasksChanges = 1U;
+    PRIVILEGED_DATA static UBaseType_t uxNothingWaitingAt[ configNUMBER_OF_CORES ] = { 0U };
+#endif
+
 /* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
  * For tracking the state of remote threads, OpenOCD uses uxTopUsedPriority
  * to determine the number of priority lists to read back from the remote target. */
@@ -573,6 +882,115 @@ static BaseType_t prvCreateIdleTasks( void );
     static void prvSelectHighestPriorityTask( BaseType_t xCoreID );
 #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
 
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) )
+
+/*
+ * Returns the priority of the highest priority ready task.
+ */
+    static UBaseType_t prvGetTopReadyPriority( void );
+#endif
+
+#if ( configUSE_RUNNING_CORE_MASKS == 1 )
+
+/*
+ * Moves xCoreID to the idle or running core mask that matches pxTCB, the task
+ * it now runs.
+ */
+    static void prvRecordRunningTask( BaseType_t xCoreID,
+                                      const TCB_t * pxTCB );
+
+/*
+ * Moves the core running pxTCB, if any, to the running core mask of the
+ * task's new priority.
+ */
+    static void prvUpdateRunningPriority( const TCB_t * pxTCB );
+
+/*
+ * Returns the core in uxCores that can be preempted, or -1 if there is none.
+ */
+    static BaseType_t prvGetPreemptibleCore( UBaseType_t uxCores );
+
+/*
+ * Returns the core running the lowest priority work that pxTCB can preempt,
+ * or -1 if there is none.
+ */
+    static BaseType_t prvFindCoreToPreempt( const TCB_t * pxTCB );
+#endif /* #if ( configUSE_RUNNING_CORE_MASKS == 1 ) */
+
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+
+/*
+ * Returns the core pxTCB last ran on if it is a better place for the task than
+ * xCoreID, the core running the lowest priority work the task can preempt,
+ * which runs work of priority xCorePriority.  Otherwise returns xCoreID.
+ */
+    static BaseType_t prvPreferLastRunCore( const TCB_t * pxTCB,
+                                            UBaseType_t uxCandidateCores,
+                                            BaseType_t xCoreID,
+                                            BaseType_t xCorePriority );
+#endif
+
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
+
+/*
+ * Sets the affinity mask of pxTCB and moves or yields the task as needed.  Must
+ * be called from a critical section.
+ */
+    static void prvSetCoreAffinity( TCB_t * pxTCB,
+                                    UBaseType_t uxCoreAffinityMask );
+#endif
+
+#if ( configUSE_LOAD_BALANCER == 1 )
+
+/*
+ * Stops the load balancer from moving pxTCB.  Must be called from a critical
+ * section.
+ */
+    static void prvForgetMigratableTask( TCB_t * pxTCB );
+
+/*
+ * Returns the run time of pxTCB up to ulNow, including the time it has been
+ * running on a core since it was last switched in.
+ */
+    static configRUN_TIME_COUNTER_TYPE prvGetTaskRunTime( const TCB_t * pxTCB,
+                                                          configRUN_TIME_COUNTER_TYPE ulNow );
+
+/*
+ * Returns the time xCoreID has spent running tasks other than an idle task up
+ * to ulNow.
+ */
+    static configRUN_TIME_COUNTER_TYPE prvGetCoreBusyTime( BaseType_t xCoreID,
+                                                           configRUN_TIME_COUNTER_TYPE ulNow );
+#endif
+
+#if ( configUSE_PER_CORE_READY_LISTS == 1 )
+
+/*
+ * Returns the core whose private ready lists should hold a task with the
+ * affinity mask uxCoreAffinityMask, or -1 if the task can run on more than
+ * one core and so belongs in the shared ready lists.
+ */
+    static BaseType_t prvGetReadyListCore( UBaseType_t uxCoreAffinityMask );
+
+    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+
+/*
+ * Returns pdTRUE if the private ready list of any core holds a task of
+ * priority uxPriority.
+ */
+        static BaseType_t prvCoreReadyListsHavePriority( UBaseType_t uxPriority );
+    #else
+
+/*
+ * Clears uxPriority from the bit map of the ready lists that hold pxTCB, which
+ * must have just been emptied, and from uxTopReadyPriority if no other ready
+ * list holds a task of that priority.
+ */
+        static void prvClearReadyPriority( const TCB_t * pxTCB,
+                                           UBaseType_t uxPriority );
+    #endif
+#endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+
 /**
  * Utility task that simply returns pdTRUE if the task referenced by xTask is
  * currently in the Suspended state, or pdFALSE if the task referenced by xTask
@@ -692,12 +1110,112 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 
 #endif
 
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+/*
+ * Returns pdTRUE if a ready task other than an idle task is waiting for a core
+ * and could be run by core xCoreID.  Must be called from a critical section.
+ */
+    static BaseType_t prvReadyTaskWaitingForCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called from the idle tasks of an SMP system to let the port put the core to
+ * sleep while it has nothing to run.
+ */
+    static void prvSleepWhileIdle( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Set xNextTaskUnblockTime to the time at which the next Blocked state task
  * will exit the Blocked state.
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+/*
+ * Set xCoreNextTaskUnblockTimes[ xCoreID ] to the time at which the next task
+ * in the delayed lists of core xCoreID will exit the Blocked state.
+ */
+    static void prvResetCoreNextTaskUnblockTime( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if pxList is one of the delayed lists of any core.
+ */
+    static BaseType_t prvIsCoreDelayedList( const List_t * pxList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves every task in the current delayed list of core xCoreID whose wake time
+ * is not after xConstTickCount to the ready lists.
+ */
+    static void prvUnblockCoreDelayedTasks( BaseType_t xCoreID,
+                                            TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the number of ticks after xConstTickCount at which a task in the
+ * delayed lists of core xCoreID times out, or 0 if the core has a timeout that
+ * is already due but has not yet processed it.
+ */
+    static TickType_t prvGetCoreTicksToUnblock( BaseType_t xCoreID,
+                                                TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+#if ( configUSE_DELAY_WHEEL == 1 )
+
+/*
+ * Brings the delay wheel pxWheel up to xTickCount, placing pxListItem in it if
+ * its wake time is near enough, and lowers *pxNextUnblockTime to the time the
+ * wheel next has to be looked at if that is earlier.  Returns pdFALSE if the
+ * wake time is too far ahead, in which case the item must be placed in the
+ * sorted delayed list pxDelayedList instead.
+ */
+    static BaseType_t prvDelayWheelInsert( DelayWheel_t * pxWheel,
+                                           List_t * pxDelayedList,
+                                           TickType_t xTickCount,
+                                           ListItem_t * pxListItem,
+                                           volatile TickType_t * pxNextUnblockTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Brings the delay wheel pxWheel up to xTickCount.  Every task in the wheel
+ * whose wake time is not after xTickCount is moved to the head of the delayed
+ * list pxDelayedList, where it is unblocked like any other timed out task.
+ */
+    static void prvAdvanceDelayWheel( DelayWheel_t * pxWheel,
+                                      TickType_t xTickCount,
+                                      List_t * pxDelayedList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Places pxListItem in the slot of the delay wheel pxWheel that its wake time
+ * falls in.  Returns the level used, or configDELAY_WHEEL_LEVELS without
+ * placing the item if its wake time is beyond the wheel.
+ */
+    static UBaseType_t prvPlaceInDelayWheel( DelayWheel_t * pxWheel,
+                                             ListItem_t * pxListItem ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets *pxTime to the time the delay wheel pxWheel next has to be advanced
+ * to, and returns the level of the slot the time comes from, or
+ * configDELAY_WHEEL_LEVELS if no slot is marked as holding a task.
+ */
+    static UBaseType_t prvGetNextDelayWheelEvent( const DelayWheel_t * pxWheel,
+                                                  TickType_t * pxTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Lowers *pxNextUnblockTime to the time the delay wheel pxWheel next has to be
+ * advanced to, if that is earlier.
+ */
+    static void prvUpdateUnblockTimeFromDelayWheel( const DelayWheel_t * pxWheel,
+                                                    volatile TickType_t * pxNextUnblockTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if pxList is a slot of any delay wheel.
+ */
+    static BaseType_t prvIsDelayWheelList( const List_t * pxList ) PRIVILEGED_FUNCTION;
+
+#endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -868,11 +1386,21 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
              * other cores may have requested this task to yield, potentially altering
              * its run state. */
 
-            portDISABLE_INTERRUPTS();
+            #ifdef portGET_KERNEL_LOCKS
+            {
+                UBaseType_t uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
 
-            xCoreID = ( BaseType_t ) portGET_CORE_ID();
-            portGET_TASK_LOCK( xCoreID );
-            portGET_ISR_LOCK( xCoreID );
+                xCoreID = portGET_KERNEL_LOCKS( uxSavedInterruptStatus, pdTRUE );
+            }
+            #else
+            {
+                portDISABLE_INTERRUPTS();
+
+                xCoreID = ( BaseType_t ) portGET_CORE_ID();
+                portGET_TASK_LOCK( xCoreID );
+                portGET_ISR_LOCK( xCoreID );
+            }
+            #endif /* portGET_KERNEL_LOCKS */
 
             portSET_CRITICAL_NESTING_COUNT( xCoreID, uxPrevCriticalNesting );
 
@@ -886,13 +1414,221 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_RUNNING_CORE_MASKS == 1 )
+    static void prvRecordRunningTask( BaseType_t xCoreID,
+                                      const TCB_t * pxTCB )
+    {
+        const UBaseType_t uxCoreBit = ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID;
+        const BaseType_t xPreviousPriority = xCoreRunningPriorities[ xCoreID ];
+        BaseType_t xPriority = ( BaseType_t ) pxTCB->uxPriority;
+
+        /* Idle tasks are given a priority of tskIDLE_PRIORITY - 1, as in
+         * prvYieldForTask(), and are kept in their own mask. */
+        if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U )
+        {
+            xPriority = ( BaseType_t ) -1;
+        }
+
+        if( xPriority != xPreviousPriority )
+        {
+            if( xPreviousPriority < 0 )
+            {
+                uxIdleCoreMask &= ~uxCoreBit;
+            }
+            else
+            {
+                uxRunningCoreMasks[ xPreviousPriority ] &= ~uxCoreBit;
+
+                if( uxRunningCoreMasks[ xPreviousPriority ] == 0U )
+                {
+                    portRESET_READY_PRIORITY( ( UBaseType_t ) xPreviousPriority, uxRunningPriorities );
+                }
+            }
+
+            if( xPriority < 0 )
+            {
+                uxIdleCoreMask |= uxCoreBit;
+            }
+            else
+            {
+                uxRunningCoreMasks[ xPriority ] |= uxCoreBit;
+                portRECORD_READY_PRIORITY( ( UBaseType_t ) xPriority, uxRunningPriorities );
+            }
+
+            xCoreRunningPriorities[ xCoreID ] = xPriority;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUpdateRunningPriority( const TCB_t * pxTCB )
+    {
+        BaseType_t xCoreID;
+
+        if( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE )
+        {
+            prvRecordRunningTask( pxTCB->xTaskRunState, pxTCB );
+        }
+        else if( pxTCB->xTaskRunState == taskTASK_SCHEDULED_TO_YIELD )
+        {
+            /* The task is still the current task of a core that has been asked
+             * to yield, but the run state no longer says which one. */
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                if( pxCurrentTCBs[ xCoreID ] == pxTCB )
+                {
+                    prvRecordRunningTask( xCoreID, pxTCB );
+                    break;
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvGetPreemptibleCore( UBaseType_t uxCores )
+    {
+        BaseType_t xReturn = ( BaseType_t ) -1;
+        UBaseType_t uxCore;
+
+        /* The highest numbered core is tried first, which is the core the
+         * search over all cores in prvYieldForTask() settles on when several
+         * run work of the same priority. */
+        while( uxCores != 0U )
+        {
+            portGET_HIGHEST_PRIORITY( uxCore, uxCores );
+
+            if( ( taskTASK_IS_RUNNING( pxCurrentTCBs[ uxCore ] ) != pdFALSE ) && ( xYieldPendings[ uxCore ] == pdFALSE ) )
+            {
+                #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
+                    if( pxCurrentTCBs[ uxCore ]->xPreemptionDisable == pdFALSE )
+                #endif
+                {
+                    xReturn = ( BaseType_t ) uxCore;
+                    break;
+                }
+            }
+
+            uxCores &= ~( ( UBaseType_t ) 1U << uxCore );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvFindCoreToPreempt( const TCB_t * pxTCB )
+    {
+        UBaseType_t uxCandidateCores = ( ( UBaseType_t ) 1U << configNUMBER_OF_CORES ) - 1U;
+        UBaseType_t uxLowerPriorities;
+        UBaseType_t uxPriority;
+        BaseType_t xCoreID;
+        BaseType_t xCorePriority = ( BaseType_t ) -1;
+
+        #if ( configUSE_CORE_AFFINITY == 1 )
+        {
+            uxCandidateCores &= pxTCB->uxCoreAffinityMask;
+        }
+        #endif
+
+        /* Idle cores run the lowest priority work of all. */
+        xCoreID = prvGetPreemptibleCore( uxIdleCoreMask & uxCandidateCores );
+
+        /* Then the cores running the lowest priority below that of pxTCB. */
+        uxLowerPriorities = uxRunningPriorities & ( ( ( UBaseType_t ) 1U << pxTCB->uxPriority ) - 1U );
+
+        while( ( xCoreID < 0 ) && ( uxLowerPriorities != 0U ) )
+        {
+            /* Isolate the lowest set bit so the port's search for the highest
+             * set bit finds it. */
+            portGET_HIGHEST_PRIORITY( uxPriority, ( uxLowerPriorities & ( ~uxLowerPriorities + 1U ) ) );
+            xCoreID = prvGetPreemptibleCore( uxRunningCoreMasks[ uxPriority ] & uxCandidateCores );
+            xCorePriority = ( BaseType_t ) uxPriority;
+            portRESET_READY_PRIORITY( uxPriority, uxLowerPriorities );
+        }
+
+        #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+        {
+            if( xCoreID >= 0 )
+            {
+                xCoreID = prvPreferLastRunCore( pxTCB, uxCandidateCores, xCoreID, xCorePriority );
+            }
+        }
+        #else
+        {
+            ( void ) xCorePriority;
+        }
+        #endif
+
+        return xCoreID;
+    }
+#endif /* #if ( configUSE_RUNNING_CORE_MASKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+    static BaseType_t prvPreferLastRunCore( const TCB_t * pxTCB,
+                                            UBaseType_t uxCandidateCores,
+                                            BaseType_t xCoreID,
+                                            BaseType_t xCorePriority )
+    {
+        const BaseType_t xLastRunCore = pxTCB->xLastRunCore;
+        BaseType_t xLastCorePriority;
+        BaseType_t xReturn = xCoreID;
+
+        if( xLastRunCore >= 0 )
+        {
+            if( ( pxTCB->xCacheAffinityHint != pdFALSE ) && ( xLastRunCore != xCoreID ) &&
+                ( ( uxCandidateCores & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xLastRunCore ) ) != 0U ) )
+            {
+                xLastCorePriority = xCoreRunningPriorities[ xLastRunCore ];
+
+                /* The last core must run work the task can preempt, not too far
+                 * above the work on xCoreID, and be free to be preempted now. */
+                if( ( xLastCorePriority < ( BaseType_t ) pxTCB->uxPriority ) &&
+                    ( ( xLastCorePriority - xCorePriority ) <= ( BaseType_t ) configCACHE_AFFINITY_TOLERANCE ) &&
+                    ( prvGetPreemptibleCore( ( UBaseType_t ) 1U << ( UBaseType_t ) xLastRunCore ) == xLastRunCore ) )
+                {
+                    xReturn = xLastRunCore;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xReturn == xLastRunCore )
+            {
+                xMigrationStats.ulLastCoreWakeups++;
+            }
+            else
+            {
+                xMigrationStats.ulOtherCoreWakeups++;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+#endif /* #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( configNUMBER_OF_CORES > 1 )
     static void prvYieldForTask( const TCB_t * pxTCB )
     {
-        BaseType_t xLowestPriorityToPreempt;
-        BaseType_t xCurrentCoreTaskPriority;
+        #if ( configUSE_RUNNING_CORE_MASKS == 0 )
+            BaseType_t xLowestPriorityToPreempt;
+            BaseType_t xCurrentCoreTaskPriority;
+            BaseType_t xCoreID;
+        #endif
         BaseType_t xLowestPriorityCore = ( BaseType_t ) -1;
-        BaseType_t xCoreID;
         const BaseType_t xCurrentCoreID = ( BaseType_t ) portGET_CORE_ID();
 
         #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
@@ -906,77 +1642,85 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
             /* No task should yield for this one if it is a lower priority
              * than priority level of currently ready tasks. */
-            if( pxTCB->uxPriority >= uxTopReadyPriority )
+            if( pxTCB->uxPriority >= taskGET_TOP_READY_PRIORITY() )
         #else
             /* Yield is not required for a task which is already running. */
             if( taskTASK_IS_RUNNING( pxTCB ) == pdFALSE )
         #endif
         {
-            xLowestPriorityToPreempt = ( BaseType_t ) pxTCB->uxPriority;
-
-            /* xLowestPriorityToPreempt will be decremented to -1 if the priority of pxTCB
-             * is 0. This is ok as we will give system idle tasks a priority of -1 below. */
-            --xLowestPriorityToPreempt;
-
-            for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            #if ( configUSE_RUNNING_CORE_MASKS == 1 )
+            {
+                xLowestPriorityCore = prvFindCoreToPreempt( pxTCB );
+            }
+            #else /* #if ( configUSE_RUNNING_CORE_MASKS == 1 ) */
             {
-                xCurrentCoreTaskPriority = ( BaseType_t ) pxCurrentTCBs[ xCoreID ]->uxPriority;
+                xLowestPriorityToPreempt = ( BaseType_t ) pxTCB->uxPriority;
 
-                /* System idle tasks are being assigned a priority of tskIDLE_PRIORITY - 1 here. */
-                if( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U )
-                {
-                    xCurrentCoreTaskPriority = ( BaseType_t ) ( xCurrentCoreTaskPriority - 1 );
-                }
+                /* xLowestPriorityToPreempt will be decremented to -1 if the priority of pxTCB
+                 * is 0. This is ok as we will give system idle tasks a priority of -1 below. */
+                --xLowestPriorityToPreempt;
 
-                if( ( taskTASK_IS_RUNNING( pxCurrentTCBs[ xCoreID ] ) != pdFALSE ) && ( xYieldPendings[ xCoreID ] == pdFALSE ) )
+                for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
                 {
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
-                        if( taskTASK_IS_RUNNING( pxTCB ) == pdFALSE )
-                    #endif
+                    xCurrentCoreTaskPriority = ( BaseType_t ) pxCurrentTCBs[ xCoreID ]->uxPriority;
+
+                    /* System idle tasks are being assigned a priority of tskIDLE_PRIORITY - 1 here. */
+                    if( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U )
+                    {
+                        xCurrentCoreTaskPriority = ( BaseType_t ) ( xCurrentCoreTaskPriority - 1 );
+                    }
+
+                    if( ( taskTASK_IS_RUNNING( pxCurrentTCBs[ xCoreID ] ) != pdFALSE ) && ( xYieldPendings[ xCoreID ] == pdFALSE ) )
                     {
-                        if( xCurrentCoreTaskPriority <= xLowestPriorityToPreempt )
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                            if( taskTASK_IS_RUNNING( pxTCB ) == pdFALSE )
+                        #endif
                         {
-                            #if ( configUSE_CORE_AFFINITY == 1 )
-                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
-                            #endif
+                            if( xCurrentCoreTaskPriority <= xLowestPriorityToPreempt )
                             {
-                                #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
-                                    if( pxCurrentTCBs[ xCoreID ]->xPreemptionDisable == pdFALSE )
+                                #if ( configUSE_CORE_AFFINITY == 1 )
+                                    if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
                                 #endif
                                 {
-                                    xLowestPriorityToPreempt = xCurrentCoreTaskPriority;
-                                    xLowestPriorityCore = xCoreID;
+                                    #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
+                                        if( pxCurrentTCBs[ xCoreID ]->xPreemptionDisable == pdFALSE )
+                                    #endif
+                                    {
+                                        xLowestPriorityToPreempt = xCurrentCoreTaskPriority;
+                                        xLowestPriorityCore = xCoreID;
+                                    }
                                 }
                             }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
                         }
-                        else
+
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
                         {
-                            mtCOVERAGE_TEST_MARKER();
+                            /* Yield all currently running non-idle tasks with a priority lower than
+                             * the task that needs to run. */
+                            if( ( xCurrentCoreTaskPriority > ( ( BaseType_t ) tskIDLE_PRIORITY - 1 ) ) &&
+                                ( xCurrentCoreTaskPriority < ( BaseType_t ) pxTCB->uxPriority ) )
+                            {
+                                prvYieldCore( xCoreID );
+                                xYieldCount++;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
                         }
+                        #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
                     }
-
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                    else
                     {
-                        /* Yield all currently running non-idle tasks with a priority lower than
-                         * the task that needs to run. */
-                        if( ( xCurrentCoreTaskPriority > ( ( BaseType_t ) tskIDLE_PRIORITY - 1 ) ) &&
-                            ( xCurrentCoreTaskPriority < ( BaseType_t ) pxTCB->uxPriority ) )
-                        {
-                            prvYieldCore( xCoreID );
-                            xYieldCount++;
-                        }
-                        else
-                        {
-                            mtCOVERAGE_TEST_MARKER();
-                        }
+                        mtCOVERAGE_TEST_MARKER();
                     }
-                    #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
                 }
             }
+            #endif /* #if ( configUSE_RUNNING_CORE_MASKS == 1 ) */
 
             #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
                 if( ( xYieldCount == 0 ) && ( xLowestPriorityCore >= 0 ) )
@@ -1001,13 +1745,103 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_PER_CORE_READY_LISTS == 1 )
+    static BaseType_t prvGetReadyListCore( UBaseType_t uxCoreAffinityMask )
+    {
+        BaseType_t xReadyListCore = -1;
+        BaseType_t xCoreID;
+
+        uxCoreAffinityMask &= ( ( ( UBaseType_t ) 1U << configNUMBER_OF_CORES ) - 1U );
+
+        /* Only a mask with exactly one bit set pins the task to a core. */
+        if( ( uxCoreAffinityMask != 0U ) && ( ( uxCoreAffinityMask & ( uxCoreAffinityMask - 1U ) ) == 0U ) )
+        {
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                if( uxCoreAffinityMask == ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) )
+                {
+                    xReadyListCore = xCoreID;
+                    break;
+                }
+            }
+        }
+
+        return xReadyListCore;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+        static BaseType_t prvCoreReadyListsHavePriority( UBaseType_t uxPriority )
+        {
+            BaseType_t xReturn = pdFALSE;
+            BaseType_t xCoreID;
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                if( listLIST_IS_EMPTY( &( pxCoreReadyTasksLists[ xCoreID ][ uxPriority ] ) ) == pdFALSE )
+                {
+                    xReturn = pdTRUE;
+                    break;
+                }
+            }
+
+            return xReturn;
+        }
+    #else /* #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
+        static void prvClearReadyPriority( const TCB_t * pxTCB,
+                                           UBaseType_t uxPriority )
+        {
+            UBaseType_t uxReadyPriorities;
+            BaseType_t xCoreID;
+
+            portRESET_READY_PRIORITY( uxPriority, *taskREADY_PRIORITIES( pxTCB ) );
+
+            /* Rebuild the union rather than test the bit alone, the cost is the
+             * same and uxTopReadyPriority can then never hold a stale bit. */
+            uxReadyPriorities = uxSharedReadyPriorities;
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                uxReadyPriorities |= uxCoreReadyPriorities[ xCoreID ];
+            }
+
+            uxTopReadyPriority = uxReadyPriorities;
+        }
+    #endif /* #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
+#endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) )
+    static UBaseType_t prvGetTopReadyPriority( void )
+    {
+        UBaseType_t uxTopPriority = tskIDLE_PRIORITY;
+
+        /* The idle tasks keep the idle priority bit set once the scheduler has
+         * started, but the bit map is empty before the first task is created. */
+        if( uxTopReadyPriority != 0U )
+        {
+            portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );
+        }
+
+        return uxTopPriority;
+    }
+#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( configNUMBER_OF_CORES > 1 )
     static void prvSelectHighestPriorityTask( BaseType_t xCoreID )
     {
-        UBaseType_t uxCurrentPriority = uxTopReadyPriority;
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+            UBaseType_t uxCurrentPriority = uxTopReadyPriority;
+            BaseType_t xDecrementTopPriority = pdTRUE;
+        #else
+            UBaseType_t uxCurrentPriority = tskIDLE_PRIORITY;
+            UBaseType_t uxReadyPriorities = taskCORE_READY_PRIORITIES( xCoreID );
+        #endif
         BaseType_t xTaskScheduled = pdFALSE;
-        BaseType_t xDecrementTopPriority = pdTRUE;
         TCB_t * pxTCB = NULL;
+        const List_t * pxReadyLists[ taskREADY_LISTS_PER_CORE ];
+        BaseType_t xReadyListIndex;
 
         #if ( configUSE_CORE_AFFINITY == 1 )
             const TCB_t * pxPreviousTCB = NULL;
@@ -1019,6 +1853,17 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         /* This function should be called when scheduler is running. */
         configASSERT( xSchedulerRunning == pdTRUE );
 
+        #if ( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) && ( configRUN_MULTIPLE_PRIORITIES == 0 ) )
+        {
+            /* The bit map is cleared as soon as a ready list empties, so the top
+             * priority has dropped if the task leaving this core was above it. */
+            if( pxCurrentTCBs[ xCoreID ]->uxPriority > taskGET_TOP_READY_PRIORITY() )
+            {
+                xPriorityDropped = pdTRUE;
+            }
+        }
+        #endif
+
         /* A new task is created and a running task with the same priority yields
          * itself to run the new task. When a running task yields itself, it is still
          * in the ready list. This running task will be selected before the new task
@@ -1029,129 +1874,179 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
          *
          * To fix these problems, the running task should be put to the end of the
          * ready list before searching for the ready task in the ready list. */
-        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
+        if( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxCurrentTCBs[ xCoreID ], pxCurrentTCBs[ xCoreID ]->uxPriority ),
                                      &pxCurrentTCBs[ xCoreID ]->xStateListItem ) == pdTRUE )
         {
             ( void ) uxListRemove( &pxCurrentTCBs[ xCoreID ]->xStateListItem );
-            vListInsertEnd( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ),
+            vListInsertEnd( taskREADY_LIST( pxCurrentTCBs[ xCoreID ], pxCurrentTCBs[ xCoreID ]->uxPriority ),
                             &pxCurrentTCBs[ xCoreID ]->xStateListItem );
         }
 
         while( xTaskScheduled == pdFALSE )
         {
+            #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+            {
+                /* Only the priorities of the ready lists this core searches are
+                 * in uxReadyPriorities, so each step goes straight to the next
+                 * priority that has a task this core may be able to run. */
+                if( uxReadyPriorities == 0U )
+                {
+                    break;
+                }
+
+                portGET_HIGHEST_PRIORITY( uxCurrentPriority, uxReadyPriorities );
+            }
+            #endif
+
             #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
             {
-                if( uxCurrentPriority < uxTopReadyPriority )
+                if( uxCurrentPriority < taskGET_TOP_READY_PRIORITY() )
                 {
                     /* We can't schedule any tasks, other than idle, that have a
                      * priority lower than the priority of a task currently running
                      * on another core. */
                     uxCurrentPriority = tskIDLE_PRIORITY;
+
+                    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+                    {
+                        /* The idle priority is the last one searched. */
+                        uxReadyPriorities = 0U;
+                    }
+                    #endif
                 }
             }
             #endif
 
-            if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxCurrentPriority ] ) ) == pdFALSE )
-            {
-                const List_t * const pxReadyList = &( pxReadyTasksLists[ uxCurrentPriority ] );
-                const ListItem_t * pxEndMarker = listGET_END_MARKER( pxReadyList );
-                ListItem_t * pxIterator;
-
-                /* The ready task list for uxCurrentPriority is not empty, so uxTopReadyPriority
-                 * must not be decremented any further. */
-                xDecrementTopPriority = pdFALSE;
+            taskGET_CORE_READY_LISTS( pxReadyLists, xCoreID, uxCurrentPriority );
 
-                for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+            for( xReadyListIndex = 0; ( xReadyListIndex < taskREADY_LISTS_PER_CORE ) && ( xTaskScheduled == pdFALSE ); xReadyListIndex++ )
+            {
+                if( listLIST_IS_EMPTY( pxReadyLists[ xReadyListIndex ] ) == pdFALSE )
                 {
-                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
-                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-                    /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+                    const List_t * const pxReadyList = pxReadyLists[ xReadyListIndex ];
+                    const ListItem_t * pxEndMarker = listGET_END_MARKER( pxReadyList );
+                    ListItem_t * pxIterator;
+
+                    #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+                    {
+                        /* The ready task list for uxCurrentPriority is not empty, so uxTopReadyPriority
+                         * must not be decremented any further. */
+                        xDecrementTopPriority = pdFALSE;
+                    }
+                    #endif
 
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                    for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
                     {
-                        /* When falling back to the idle priority because only one priority
-                         * level is allowed to run at a time, we should ONLY schedule the true
-                         * idle tasks, not user tasks at the idle priority. */
-                        if( uxCurrentPriority < uxTopReadyPriority )
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
                         {
-                            if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                            /* When falling back to the idle priority because only one priority
+                             * level is allowed to run at a time, we should ONLY schedule the true
+                             * idle tasks, not user tasks at the idle priority. */
+                            if( uxCurrentPriority < taskGET_TOP_READY_PRIORITY() )
                             {
-                                continue;
+                                if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                                {
+                                    continue;
+                                }
                             }
                         }
-                    }
-                    #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
+                        #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
 
-                    if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
-                    {
-                        #if ( configUSE_CORE_AFFINITY == 1 )
-                            if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
-                        #endif
+                        if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
                         {
-                            /* If the task is not being executed by any core swap it in. */
-                            pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
                             #if ( configUSE_CORE_AFFINITY == 1 )
-                                pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
+                            #endif
+                            {
+                                /* If the task is not being executed by any core swap it in. */
+                                pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
+                                taskREADY_TASKS_CHANGED();
+                                #if ( configUSE_CORE_AFFINITY == 1 )
+                                    pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                                #endif
+                                pxTCB->xTaskRunState = xCoreID;
+                                pxCurrentTCBs[ xCoreID ] = pxTCB;
+                                taskRECORD_RUNNING_TASK( xCoreID, pxTCB );
+                                taskRECORD_LAST_RUN_CORE( pxTCB, xCoreID );
+                                xTaskScheduled = pdTRUE;
+                            }
+                        }
+                        else if( pxTCB == pxCurrentTCBs[ xCoreID ] )
+                        {
+                            configASSERT( ( pxTCB->xTaskRunState == xCoreID ) || ( pxTCB->xTaskRunState == taskTASK_SCHEDULED_TO_YIELD ) );
+
+                            #if ( configUSE_CORE_AFFINITY == 1 )
+                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
                             #endif
-                            pxTCB->xTaskRunState = xCoreID;
-                            pxCurrentTCBs[ xCoreID ] = pxTCB;
-                            xTaskScheduled = pdTRUE;
+                            {
+                                /* The task is already running on this core, mark it as scheduled. */
+                                pxTCB->xTaskRunState = xCoreID;
+                                xTaskScheduled = pdTRUE;
+                            }
+                        }
+                        else
+                        {
+                            /* This task is running on the core other than xCoreID. */
+                            mtCOVERAGE_TEST_MARKER();
                         }
-                    }
-                    else if( pxTCB == pxCurrentTCBs[ xCoreID ] )
-                    {
-                        configASSERT( ( pxTCB->xTaskRunState == xCoreID ) || ( pxTCB->xTaskRunState == taskTASK_SCHEDULED_TO_YIELD ) );
 
-                        #if ( configUSE_CORE_AFFINITY == 1 )
-                            if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
-                        #endif
+                        if( xTaskScheduled != pdFALSE )
                         {
-                            /* The task is already running on this core, mark it as scheduled. */
-                            pxTCB->xTaskRunState = xCoreID;
-                            xTaskScheduled = pdTRUE;
+                            /* A task has been selected to run on this core. */
+                            break;
                         }
                     }
-                    else
-                    {
-                        /* This task is running on the core other than xCoreID. */
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    if( xTaskScheduled != pdFALSE )
-                    {
-                        /* A task has been selected to run on this core. */
-                        break;
-                    }
                 }
             }
-            else
+
+            #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
             {
                 if( xDecrementTopPriority != pdFALSE )
                 {
-                    uxTopReadyPriority--;
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                    #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                        if( prvCoreReadyListsHavePriority( uxCurrentPriority ) != pdFALSE )
+                        {
+                            /* A task pinned to another core is ready at this priority, so
+                             * uxTopReadyPriority must not be decremented any further. */
+                            xDecrementTopPriority = pdFALSE;
+                        }
+                        else
+                    #endif
                     {
-                        xPriorityDropped = pdTRUE;
+                        uxTopReadyPriority--;
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                        {
+                            xPriorityDropped = pdTRUE;
+                        }
+                        #endif
                     }
-                    #endif
                 }
-            }
 
-            /* There are configNUMBER_OF_CORES Idle tasks created when scheduler started.
-             * The scheduler should be able to select a task to run when uxCurrentPriority
-             * is tskIDLE_PRIORITY. uxCurrentPriority is never decreased to value blow
-             * tskIDLE_PRIORITY. */
-            if( uxCurrentPriority > tskIDLE_PRIORITY )
-            {
-                uxCurrentPriority--;
+                /* There are configNUMBER_OF_CORES Idle tasks created when scheduler started.
+                 * The scheduler should be able to select a task to run when uxCurrentPriority
+                 * is tskIDLE_PRIORITY. uxCurrentPriority is never decreased to value blow
+                 * tskIDLE_PRIORITY. */
+                if( uxCurrentPriority > tskIDLE_PRIORITY )
+                {
+                    uxCurrentPriority--;
+                }
+                else
+                {
+                    /* This function is called when idle task is not created. Break the
+                     * loop to prevent uxCurrentPriority overrun. */
+                    break;
+                }
             }
-            else
+            #else /* #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
             {
-                /* This function is called when idle task is not created. Break the
-                 * loop to prevent uxCurrentPriority overrun. */
-                break;
+                portRESET_READY_PRIORITY( uxCurrentPriority, uxReadyPriorities );
             }
+            #endif /* #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
         }
 
         #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
@@ -1181,7 +2076,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         {
             if( xTaskScheduled == pdTRUE )
             {
-                if( ( pxPreviousTCB != NULL ) && ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxPreviousTCB->uxPriority ] ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE ) )
+                if( ( pxPreviousTCB != NULL ) && ( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxPreviousTCB, pxPreviousTCB->uxPriority ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE ) )
                 {
                     /* A ready task was just evicted from this core. See if it can be
                      * scheduled on any other core. */
@@ -1384,8 +2279,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
             if( pxNewTCB != NULL )
             {
-                /* Set the task's affinity before scheduling it. */
+                /* Set the task's affinity before scheduling it.  The load
+                 * balancer never changes an affinity set at creation. */
                 pxNewTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+                pxNewTCB->uxTaskAttributes |= taskATTRIBUTE_HARD_AFFINITY;
 
                 prvAddNewTaskToReadyList( pxNewTCB );
             }
@@ -1499,8 +2396,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
             if( pxNewTCB != NULL )
             {
-                /* Set the task's affinity before scheduling it. */
+                /* Set the task's affinity before scheduling it.  The load
+                 * balancer never changes an affinity set at creation. */
                 pxNewTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+                pxNewTCB->uxTaskAttributes |= taskATTRIBUTE_HARD_AFFINITY;
 
                 prvAddNewTaskToReadyList( pxNewTCB );
                 xReturn = pdPASS;
@@ -1616,8 +2515,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
             if( pxNewTCB != NULL )
             {
-                /* Set the task's affinity before scheduling it. */
+                /* Set the task's affinity before scheduling it.  The load
+                 * balancer never changes an affinity set at creation. */
                 pxNewTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+                pxNewTCB->uxTaskAttributes |= taskATTRIBUTE_HARD_AFFINITY;
 
                 prvAddNewTaskToReadyList( pxNewTCB );
 
@@ -1792,8 +2693,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
             if( pxNewTCB != NULL )
             {
-                /* Set the task's affinity before scheduling it. */
+                /* Set the task's affinity before scheduling it.  The load
+                 * balancer never changes an affinity set at creation. */
                 pxNewTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+                pxNewTCB->uxTaskAttributes |= taskATTRIBUTE_HARD_AFFINITY;
 
                 prvAddNewTaskToReadyList( pxNewTCB );
                 xReturn = pdPASS;
@@ -2015,6 +2918,18 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     {
         pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
 
+        #if ( ( configUSE_CACHE_AFFINITY_WAKEUP == 1 ) || ( configUSE_LOAD_BALANCER == 1 ) )
+        {
+            pxNewTCB->xLastRunCore = ( BaseType_t ) -1;
+        }
+        #endif
+
+        #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+        {
+            pxNewTCB->xCacheAffinityHint = pdTRUE;
+        }
+        #endif
+
         /* Is this an idle task? */
         if( ( ( TaskFunction_t ) pxTaskCode == ( TaskFunction_t ) ( &prvIdleTask ) ) || ( ( TaskFunction_t ) pxTaskCode == ( TaskFunction_t ) ( &prvPassiveIdleTask ) ) )
         {
@@ -2228,7 +3143,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             /* Remove task from the ready/delayed list. */
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
             {
-                taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+                taskRESET_READY_PRIORITY( pxTCB, pxTCB->uxPriority );
             }
             else
             {
@@ -2245,6 +3160,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            /* The load balancer must not look at the TCB once it is freed. */
+            #if ( configUSE_LOAD_BALANCER == 1 )
+            {
+                prvForgetMigratableTask( pxTCB );
+            }
+            #endif
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -2543,7 +3465,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * item is currently placed on. */
                 eReturn = eReady;
             }
-            else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+            else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) ||
+                     ( taskIS_CORE_DELAYED_LIST( pxStateList ) != pdFALSE ) || ( taskIS_DELAY_WHEEL_LIST( pxStateList ) != pdFALSE ) )
             {
                 /* The task being queried is referenced from one of the Blocked
                  * lists. */
@@ -2921,6 +3844,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                 }
                 #endif /* if ( configUSE_MUTEXES == 1 ) */
 
+                taskUPDATE_RUNNING_PRIORITY( pxTCB );
+
                 /* Only reset the event list item value if the value is not
                  * being used for anything else. */
                 if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == ( ( TickType_t ) 0U ) )
@@ -2936,7 +3861,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * nothing more than change its priority variable. However, if
                  * the task is in a ready list it needs to be removed and placed
                  * in the list appropriate to its new priority. */
-                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                if( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxTCB, uxPriorityUsedOnEntry ), &( pxTCB->xStateListItem ) ) != pdFALSE )
                 {
                     /* The task is currently in its ready list - remove before
                      * adding it to its new ready list.  As we are in a critical
@@ -2944,9 +3869,9 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                     if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                     {
                         /* It is known that the task is in its ready list so
-                         * there is no need to check again and the port level
-                         * reset macro can be called directly. */
-                        portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
+                         * there is no need to check again and the ready
+                         * priority can be cleared directly. */
+                        taskCLEAR_READY_PRIORITY( pxTCB, uxPriorityUsedOnEntry );
                     }
                     else
                     {
@@ -3006,142 +3931,485 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
+    static void prvSetCoreAffinity( TCB_t * pxTCB,
+                                    UBaseType_t uxCoreAffinityMask )
+    {
+        BaseType_t xCoreID;
+
+        pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+        taskREADY_TASKS_CHANGED();
+
+        #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        {
+            /* A ready task may have to move between the shared ready lists
+             * and the private ready lists of a core. */
+            if( ( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxTCB, pxTCB->uxPriority ), &( pxTCB->xStateListItem ) ) != pdFALSE ) &&
+                ( pxTCB->xReadyListCore != prvGetReadyListCore( uxCoreAffinityMask ) ) )
+            {
+                if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    taskCLEAR_READY_PRIORITY( pxTCB, pxTCB->uxPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvAddTaskToReadyList( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+
+        if( xSchedulerRunning != pdFALSE )
+        {
+            if( taskTASK_IS_RUNNING( pxTCB ) == pdTRUE )
+            {
+                xCoreID = ( BaseType_t ) pxTCB->xTaskRunState;
+
+                /* If the task can no longer run on the core it was running,
+                 * request the core to yield. */
+                if( ( uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) == 0U )
+                {
+                    prvYieldCore( xCoreID );
+                }
+            }
+            else
+            {
+                #if ( configUSE_PREEMPTION == 1 )
+                {
+                    /* The SMP scheduler requests a core to yield when a ready
+                     * task is able to run. It is possible that the core affinity
+                     * of the ready task is changed before the requested core
+                     * can select it to run. In that case, the task may not be
+                     * selected by the previously requested core due to core affinity
+                     * constraint and the SMP scheduler must select a new core to
+                     * yield for the task. */
+                    prvYieldForTask( pxTCB );
+                }
+                #else /* #if( configUSE_PREEMPTION == 1 ) */
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+                #endif /* #if( configUSE_PREEMPTION == 1 ) */
+            }
+        }
+    }
+#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
     void vTaskCoreAffinitySet( const TaskHandle_t xTask,
                                UBaseType_t uxCoreAffinityMask )
     {
-        TCB_t * pxTCB;
+        TCB_t * pxTCB;
+
+        traceENTER_vTaskCoreAffinitySet( xTask, uxCoreAffinityMask );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            configASSERT( pxTCB != NULL );
+
+            #if ( configUSE_LOAD_BALANCER == 1 )
+            {
+                /* The application takes the placement of the task back from
+                 * the load balancer. */
+                prvForgetMigratableTask( pxTCB );
+            }
+            #endif
+
+            prvSetCoreAffinity( pxTCB, uxCoreAffinityMask );
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskCoreAffinitySet();
+    }
+#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
+    UBaseType_t vTaskCoreAffinityGet( ConstTaskHandle_t xTask )
+    {
+        const TCB_t * pxTCB;
+        UBaseType_t uxCoreAffinityMask;
+
+        traceENTER_vTaskCoreAffinityGet( xTask );
+
+        portBASE_TYPE_ENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            configASSERT( pxTCB != NULL );
+
+            uxCoreAffinityMask = pxTCB->uxCoreAffinityMask;
+        }
+        portBASE_TYPE_EXIT_CRITICAL();
+
+        traceRETURN_vTaskCoreAffinityGet( uxCoreAffinityMask );
+
+        return uxCoreAffinityMask;
+    }
+#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
+
+    void vTaskPreemptionDisable( const TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+
+        traceENTER_vTaskPreemptionDisable( xTask );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            configASSERT( pxTCB != NULL );
+
+            pxTCB->xPreemptionDisable = pdTRUE;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskPreemptionDisable();
+    }
+
+#endif /* #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
+
+    void vTaskPreemptionEnable( const TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xCoreID;
+
+        traceENTER_vTaskPreemptionEnable( xTask );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            configASSERT( pxTCB != NULL );
+
+            pxTCB->xPreemptionDisable = pdFALSE;
+
+            if( xSchedulerRunning != pdFALSE )
+            {
+                if( taskTASK_IS_RUNNING( pxTCB ) == pdTRUE )
+                {
+                    xCoreID = ( BaseType_t ) pxTCB->xTaskRunState;
+                    prvYieldCore( xCoreID );
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskPreemptionEnable();
+    }
+
+#endif /* #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+
+    void vTaskSetCacheAffinityHint( TaskHandle_t xTask,
+                                    BaseType_t xPreferLastCore )
+    {
+        TCB_t * pxTCB;
+
+        traceENTER_vTaskSetCacheAffinityHint( xTask, xPreferLastCore );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            configASSERT( pxTCB != NULL );
+
+            pxTCB->xCacheAffinityHint = xPreferLastCore;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskSetCacheAffinityHint();
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskGetMigrationStats( TaskMigrationStats_t * pxStats )
+    {
+        traceENTER_vTaskGetMigrationStats( pxStats );
+
+        configASSERT( pxStats != NULL );
+
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xMigrationStats;
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskGetMigrationStats();
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskResetMigrationStats( void )
+    {
+        traceENTER_vTaskResetMigrationStats();
+
+        taskENTER_CRITICAL();
+        {
+            ( void ) memset( ( void * ) &xMigrationStats, 0x00, sizeof( xMigrationStats ) );
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskResetMigrationStats();
+    }
+
+#endif /* #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_LOAD_BALANCER == 1 )
+
+    static void prvForgetMigratableTask( TCB_t * pxTCB )
+    {
+        UBaseType_t x;
+
+        if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_MIGRATABLE ) != 0U )
+        {
+            pxTCB->uxTaskAttributes &= ~taskATTRIBUTE_MIGRATABLE;
+
+            for( x = 0U; x < uxMigratableTasks; x++ )
+            {
+                if( xMigratableTasks[ x ].pxTCB == pxTCB )
+                {
+                    /* Keep the table packed by moving its last entry into the
+                     * hole. */
+                    uxMigratableTasks--;
+                    xMigratableTasks[ x ] = xMigratableTasks[ uxMigratableTasks ];
+                    break;
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static configRUN_TIME_COUNTER_TYPE prvGetTaskRunTime( const TCB_t * pxTCB,
+                                                          configRUN_TIME_COUNTER_TYPE ulNow )
+    {
+        configRUN_TIME_COUNTER_TYPE ulRunTime = pxTCB->ulRunTimeCounter;
         BaseType_t xCoreID;
 
-        traceENTER_vTaskCoreAffinitySet( xTask, uxCoreAffinityMask );
-
-        taskENTER_CRITICAL();
+        if( taskTASK_IS_RUNNING( pxTCB ) == pdTRUE )
         {
-            pxTCB = prvGetTCBFromHandle( xTask );
-            configASSERT( pxTCB != NULL );
-
-            pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+            xCoreID = pxTCB->xTaskRunState;
 
-            if( xSchedulerRunning != pdFALSE )
+            /* The guard is against the counter of this core being a little
+             * behind that of the core the task runs on. */
+            if( ulNow > ulTaskSwitchedInTime[ xCoreID ] )
             {
-                if( taskTASK_IS_RUNNING( pxTCB ) == pdTRUE )
-                {
-                    xCoreID = ( BaseType_t ) pxTCB->xTaskRunState;
-
-                    /* If the task can no longer run on the core it was running,
-                     * request the core to yield. */
-                    if( ( uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) == 0U )
-                    {
-                        prvYieldCore( xCoreID );
-                    }
-                }
-                else
-                {
-                    #if ( configUSE_PREEMPTION == 1 )
-                    {
-                        /* The SMP scheduler requests a core to yield when a ready
-                         * task is able to run. It is possible that the core affinity
-                         * of the ready task is changed before the requested core
-                         * can select it to run. In that case, the task may not be
-                         * selected by the previously requested core due to core affinity
-                         * constraint and the SMP scheduler must select a new core to
-                         * yield for the task. */
-                        prvYieldForTask( xTask );
-                    }
-                    #else /* #if( configUSE_PREEMPTION == 1 ) */
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                    #endif /* #if( configUSE_PREEMPTION == 1 ) */
-                }
+                ulRunTime += ulNow - ulTaskSwitchedInTime[ xCoreID ];
             }
         }
-        taskEXIT_CRITICAL();
 
-        traceRETURN_vTaskCoreAffinitySet();
+        return ulRunTime;
     }
-#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
 /*-----------------------------------------------------------*/
 
-#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
-    UBaseType_t vTaskCoreAffinityGet( ConstTaskHandle_t xTask )
+    static configRUN_TIME_COUNTER_TYPE prvGetCoreBusyTime( BaseType_t xCoreID,
+                                                           configRUN_TIME_COUNTER_TYPE ulNow )
     {
-        const TCB_t * pxTCB;
-        UBaseType_t uxCoreAffinityMask;
+        configRUN_TIME_COUNTER_TYPE ulBusyTime = ulCoreBusyTime[ xCoreID ];
 
-        traceENTER_vTaskCoreAffinityGet( xTask );
-
-        portBASE_TYPE_ENTER_CRITICAL();
+        if( ( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U ) &&
+            ( ulNow > ulTaskSwitchedInTime[ xCoreID ] ) )
         {
-            pxTCB = prvGetTCBFromHandle( xTask );
-            configASSERT( pxTCB != NULL );
-
-            uxCoreAffinityMask = pxTCB->uxCoreAffinityMask;
+            ulBusyTime += ulNow - ulTaskSwitchedInTime[ xCoreID ];
         }
-        portBASE_TYPE_EXIT_CRITICAL();
 
-        traceRETURN_vTaskCoreAffinityGet( uxCoreAffinityMask );
-
-        return uxCoreAffinityMask;
+        return ulBusyTime;
     }
-#endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
-
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
-
-    void vTaskPreemptionDisable( const TaskHandle_t xTask )
+    BaseType_t xTaskSetMigratable( TaskHandle_t xTask,
+                                   BaseType_t xMigratable )
     {
         TCB_t * pxTCB;
+        configRUN_TIME_COUNTER_TYPE ulNow;
+        BaseType_t xReturn = pdPASS;
 
-        traceENTER_vTaskPreemptionDisable( xTask );
+        traceENTER_xTaskSetMigratable( xTask, xMigratable );
 
         taskENTER_CRITICAL();
         {
             pxTCB = prvGetTCBFromHandle( xTask );
             configASSERT( pxTCB != NULL );
 
-            pxTCB->xPreemptionDisable = pdTRUE;
+            if( xMigratable == pdFALSE )
+            {
+                prvForgetMigratableTask( pxTCB );
+            }
+            else if( ( pxTCB->uxTaskAttributes & ( taskATTRIBUTE_HARD_AFFINITY | taskATTRIBUTE_IS_IDLE ) ) != 0U )
+            {
+                /* Tasks created with an affinity mask, and the idle tasks,
+                 * stay where they are. */
+                xReturn = pdFAIL;
+            }
+            else if( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_MIGRATABLE ) != 0U )
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+            else if( uxMigratableTasks >= ( UBaseType_t ) configLOAD_BALANCER_MAX_TASKS )
+            {
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+                    portALT_GET_RUN_TIME_COUNTER_VALUE( ulNow );
+                #else
+                    ulNow = ( configRUN_TIME_COUNTER_TYPE ) portGET_RUN_TIME_COUNTER_VALUE();
+                #endif
+
+                /* The balancer may later pin the task to any core it may run
+                 * on now. */
+                xMigratableTasks[ uxMigratableTasks ].pxTCB = pxTCB;
+                xMigratableTasks[ uxMigratableTasks ].uxAllowedCores = pxTCB->uxCoreAffinityMask;
+                xMigratableTasks[ uxMigratableTasks ].ulLastRunTime = prvGetTaskRunTime( pxTCB, ulNow );
+                uxMigratableTasks++;
+                pxTCB->uxTaskAttributes |= taskATTRIBUTE_MIGRATABLE;
+            }
         }
         taskEXIT_CRITICAL();
 
-        traceRETURN_vTaskPreemptionDisable();
-    }
+        traceRETURN_xTaskSetMigratable( xReturn );
 
-#endif /* #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 ) */
+        return xReturn;
+    }
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
-
-    void vTaskPreemptionEnable( const TaskHandle_t xTask )
+    UBaseType_t uxTaskBalanceLoad( void )
     {
+        configRUN_TIME_COUNTER_TYPE ulCoreLoads[ configNUMBER_OF_CORES ];
+        configRUN_TIME_COUNTER_TYPE ulTaskLoads[ configLOAD_BALANCER_MAX_TASKS ];
+        configRUN_TIME_COUNTER_TYPE ulNow, ulPeriod = 0U, ulThreshold, ulTime;
+        BaseType_t xCoreID, xBusiestCore, xTargetCore, xBestTargetCore = 0;
+        UBaseType_t x, uxBestTask, uxMoved = 0U;
         TCB_t * pxTCB;
-        BaseType_t xCoreID;
 
-        traceENTER_vTaskPreemptionEnable( xTask );
+        traceENTER_uxTaskBalanceLoad();
 
         taskENTER_CRITICAL();
         {
-            pxTCB = prvGetTCBFromHandle( xTask );
-            configASSERT( pxTCB != NULL );
+            #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+                portALT_GET_RUN_TIME_COUNTER_VALUE( ulNow );
+            #else
+                ulNow = ( configRUN_TIME_COUNTER_TYPE ) portGET_RUN_TIME_COUNTER_VALUE();
+            #endif
 
-            pxTCB->xPreemptionDisable = pdFALSE;
+            /* The first call only starts the first period. */
+            if( xLoadBalancerStarted != pdFALSE )
+            {
+                ulPeriod = ulNow - ulLastBalanceTime;
+            }
+            else
+            {
+                xLoadBalancerStarted = pdTRUE;
+            }
 
-            if( xSchedulerRunning != pdFALSE )
+            ulLastBalanceTime = ulNow;
+
+            /* The load of every core and every migratable task over the
+             * period. */
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
             {
-                if( taskTASK_IS_RUNNING( pxTCB ) == pdTRUE )
+                ulTime = prvGetCoreBusyTime( xCoreID, ulNow );
+                ulCoreLoads[ xCoreID ] = ulTime - ulLastCoreBusyTime[ xCoreID ];
+                ulLastCoreBusyTime[ xCoreID ] = ulTime;
+            }
+
+            for( x = 0U; x < uxMigratableTasks; x++ )
+            {
+                pxTCB = xMigratableTasks[ x ].pxTCB;
+                ulTime = prvGetTaskRunTime( pxTCB, ulNow );
+                ulTaskLoads[ x ] = ulTime - xMigratableTasks[ x ].ulLastRunTime;
+                xMigratableTasks[ x ].ulLastRunTime = ulTime;
+            }
+
+            ulThreshold = ( ulPeriod / 100U ) * ( configRUN_TIME_COUNTER_TYPE ) configLOAD_BALANCER_IMBALANCE_PERCENT;
+
+            /* Every pass moves one task off the busiest core.  A task that
+             * was moved has its load cleared so it is not moved again. */
+            while( ( ulPeriod > 0U ) && ( uxMoved < uxMigratableTasks ) )
+            {
+                xBusiestCore = 0;
+
+                for( xCoreID = 1; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
                 {
-                    xCoreID = ( BaseType_t ) pxTCB->xTaskRunState;
-                    prvYieldCore( xCoreID );
+                    if( ulCoreLoads[ xCoreID ] > ulCoreLoads[ xBusiestCore ] )
+                    {
+                        xBusiestCore = xCoreID;
+                    }
+                }
+
+                uxBestTask = uxMigratableTasks;
+
+                for( x = 0U; x < uxMigratableTasks; x++ )
+                {
+                    if( ( xMigratableTasks[ x ].pxTCB->xLastRunCore == xBusiestCore ) && ( ulTaskLoads[ x ] > 0U ) )
+                    {
+                        /* The least busy core the task may be moved to. */
+                        xTargetCore = -1;
+
+                        for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                        {
+                            if( ( xCoreID != xBusiestCore ) &&
+                                ( ( xMigratableTasks[ x ].uxAllowedCores & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U ) &&
+                                ( ( xTargetCore < 0 ) || ( ulCoreLoads[ xCoreID ] < ulCoreLoads[ xTargetCore ] ) ) )
+                            {
+                                xTargetCore = xCoreID;
+                            }
+                        }
+
+                        if( xTargetCore >= 0 )
+                        {
+                            ulTime = ulCoreLoads[ xBusiestCore ] - ulCoreLoads[ xTargetCore ];
+
+                            /* Moving the task only narrows the gap between the
+                             * two cores if it ran for less time than the gap. */
+                            if( ( ulTime > ulThreshold ) && ( ulTaskLoads[ x ] < ulTime ) &&
+                                ( ( uxBestTask == uxMigratableTasks ) || ( ulTaskLoads[ x ] > ulTaskLoads[ uxBestTask ] ) ) )
+                            {
+                                uxBestTask = x;
+                                xBestTargetCore = xTargetCore;
+                            }
+                        }
+                    }
+                }
+
+                if( uxBestTask == uxMigratableTasks )
+                {
+                    break;
                 }
+
+                prvSetCoreAffinity( xMigratableTasks[ uxBestTask ].pxTCB, ( UBaseType_t ) 1U << ( UBaseType_t ) xBestTargetCore );
+
+                ulCoreLoads[ xBusiestCore ] -= ulTaskLoads[ uxBestTask ];
+                ulCoreLoads[ xBestTargetCore ] += ulTaskLoads[ uxBestTask ];
+                ulTaskLoads[ uxBestTask ] = 0U;
+                uxMoved++;
             }
         }
         taskEXIT_CRITICAL();
 
-        traceRETURN_vTaskPreemptionEnable();
+        traceRETURN_uxTaskBalanceLoad( uxMoved );
+
+        return uxMoved;
     }
 
-#endif /* #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 ) */
+#endif /* #if ( configUSE_LOAD_BALANCER == 1 ) */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_vTaskSuspend == 1 )
@@ -3165,7 +4433,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
              * suspended list. */
             if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
             {
-                taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+                taskRESET_READY_PRIORITY( pxTCB, pxTCB->uxPriority );
             }
             else
             {
@@ -3676,6 +4944,7 @@ static BaseType_t prvCreateIdleTasks( void )
                 /* Assign idle task to each core before SMP scheduler is running. */
                 xIdleTaskHandles[ xCoreID ]->xTaskRunState = xCoreID;
                 pxCurrentTCBs[ xCoreID ] = xIdleTaskHandles[ xCoreID ];
+                taskRECORD_RUNNING_TASK( xCoreID, pxCurrentTCBs[ xCoreID ] );
             }
             #endif
         }
@@ -3745,6 +5014,18 @@ void vTaskStartScheduler( void )
         xSchedulerRunning = pdTRUE;
         xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
 
+        #if ( configUSE_PER_CORE_TICKS == 1 )
+        {
+            BaseType_t xCoreID;
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                xCoreTickCounts[ xCoreID ] = ( TickType_t ) configINITIAL_TICK_COUNT;
+                xCoreNextTaskUnblockTimes[ xCoreID ] = portMAX_DELAY;
+            }
+        }
+        #endif
+
         /* If configGENERATE_RUN_TIME_STATS is defined then the following
          * macro must be defined to configure the timer/counter used to generate
          * the run time counter time base.   NOTE:  If configGENERATE_RUN_TIME_STATS
@@ -3904,7 +5185,13 @@ void vTaskSuspendAll( void )
              * do not otherwise exhibit real time behaviour. */
             portSOFTWARE_BARRIER();
 
-            portGET_TASK_LOCK( xCoreID );
+            #ifdef portGET_KERNEL_LOCKS
+                /* The task may be moved to another core while the port waits
+                 * for the lock. */
+                xCoreID = portGET_KERNEL_LOCKS( ulState, pdFALSE );
+            #else
+                portGET_TASK_LOCK( xCoreID );
+            #endif
 
             /* uxSchedulerSuspended is increased after prvCheckForRunStateChange. The
              * purpose is to prevent altering the variable when fromISR APIs are readying
@@ -3944,7 +5231,7 @@ void vTaskSuspendAll( void )
 
 /*----------------------------------------------------------*/
 
-#if ( configUSE_TICKLESS_IDLE != 0 )
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES == 1 ) )
 
     static TickType_t prvGetExpectedIdleTime( void )
     {
@@ -3978,31 +5265,209 @@ void vTaskSuspendAll( void )
         }
         #endif /* if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 ) */
 
-        if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
-        {
-            xReturn = 0;
-        }
-        else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1U )
+        if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
+        {
+            xReturn = 0;
+        }
+        else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1U )
+        {
+            /* There are other idle priority tasks in the ready state.  If
+             * time slicing is used then the very next tick interrupt must be
+             * processed. */
+            xReturn = 0;
+        }
+        else if( xHigherPriorityReadyTasks != pdFALSE )
+        {
+            /* There are tasks in the Ready state that have a priority above the
+             * idle priority.  This path can only be reached if
+             * configUSE_PREEMPTION is 0. */
+            xReturn = 0;
+        }
+        else
+        {
+            xReturn = xNextTaskUnblockTime;
+            xReturn -= xTickCount;
+        }
+
+        return xReturn;
+    }
+
+#elif ( configUSE_TICKLESS_IDLE != 0 ) /* && ( configNUMBER_OF_CORES > 1 ) */
+
+    static BaseType_t prvReadyTaskWaitingForCore( BaseType_t xCoreID )
+    {
+        BaseType_t xReturn = pdFALSE;
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+            UBaseType_t uxPriority = uxTopReadyPriority;
+        #else
+            UBaseType_t uxPriority = tskIDLE_PRIORITY;
+            UBaseType_t uxReadyPriorities = taskCORE_READY_PRIORITIES( xCoreID );
+        #endif
+        const List_t * pxReadyLists[ taskREADY_LISTS_PER_CORE ];
+        BaseType_t xReadyListIndex;
+        const ListItem_t * pxIterator;
+        const ListItem_t * pxEndMarker;
+        const TCB_t * pxTCB;
+
+        /* Only walk the ready lists if something has been made ready, switched
+         * out or given a new affinity since the last walk found no task for
+         * this core. */
+        if( uxNothingWaitingAt[ xCoreID ] != uxReadyTasksChanges )
+        {
+            for( ; ; )
+            {
+                #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+                {
+                    if( uxReadyPriorities == 0U )
+                    {
+                        break;
+                    }
+
+                    portGET_HIGHEST_PRIORITY( uxPriority, uxReadyPriorities );
+                }
+                #endif
+
+                taskGET_CORE_READY_LISTS( pxReadyLists, xCoreID, uxPriority );
+
+                for( xReadyListIndex = 0; ( xReadyListIndex < taskREADY_LISTS_PER_CORE ) && ( xReturn == pdFALSE ); xReadyListIndex++ )
+                {
+                    pxEndMarker = listGET_END_MARKER( pxReadyLists[ xReadyListIndex ] );
+
+                    for( pxIterator = listGET_HEAD_ENTRY( pxReadyLists[ xReadyListIndex ] ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+                    {
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTCB = ( const TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+                        /* Running tasks are in the ready lists too, and the idle
+                         * tasks of busy cores are always ready but not running. */
+                        if( ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) &&
+                            ( ( pxTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U ) )
+                        {
+                            #if ( configUSE_CORE_AFFINITY == 1 )
+                                if( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U )
+                            #endif
+                            {
+                                xReturn = pdTRUE;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if( ( xReturn != pdFALSE ) || ( uxPriority == tskIDLE_PRIORITY ) )
+                {
+                    break;
+                }
+
+                #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+                    uxPriority--;
+                #else
+                    portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities );
+                #endif
+            }
+
+            if( xReturn == pdFALSE )
+            {
+                uxNothingWaitingAt[ xCoreID ] = uxReadyTasksChanges;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvGetExpectedIdleTime( void )
+    {
+        TickType_t xReturn;
+        const BaseType_t xCoreID = ( BaseType_t ) portGET_CORE_ID();
+
+        /* Tasks keep running on the other cores while this core is idle, so
+         * only ready tasks that this core could pick up prevent it sleeping. */
+        if( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+        {
+            xReturn = 0;
+        }
+        else if( prvReadyTaskWaitingForCore( xCoreID ) != pdFALSE )
+        {
+            xReturn = 0;
+        }
+        else
+        {
+            xReturn = xNextTaskUnblockTime;
+            xReturn -= xTickCount;
+
+            #if ( configUSE_PER_CORE_TICKS == 1 )
+            {
+                BaseType_t xOtherCoreID;
+                TickType_t xCoreTicksToUnblock;
+
+                /* The tick must keep running until the earliest timeout of
+                 * the tasks pinned to any core as well. */
+                for( xOtherCoreID = 0; xOtherCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xOtherCoreID++ )
+                {
+                    xCoreTicksToUnblock = prvGetCoreTicksToUnblock( xOtherCoreID, xTickCount );
+
+                    if( xCoreTicksToUnblock < xReturn )
+                    {
+                        xReturn = xCoreTicksToUnblock;
+                    }
+                }
+            }
+            #endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    TickType_t xTaskGetExpectedIdleTime( void )
+    {
+        TickType_t xReturn;
+
+        traceENTER_xTaskGetExpectedIdleTime();
+
+        xReturn = prvGetExpectedIdleTime();
+
+        traceRETURN_xTaskGetExpectedIdleTime( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSleepWhileIdle( void )
+    {
+        TickType_t xExpectedIdleTime;
+
+        /* The scheduler is not suspended here as in the single core case,
+         * because that would stop every other core from scheduling as well.
+         * The ready lists are walked from a critical section instead, and the
+         * port repeats the check with interrupts masked before it sleeps. */
+        taskENTER_CRITICAL();
         {
-            /* There are other idle priority tasks in the ready state.  If
-             * time slicing is used then the very next tick interrupt must be
-             * processed. */
-            xReturn = 0;
+            xExpectedIdleTime = prvGetExpectedIdleTime();
         }
-        else if( xHigherPriorityReadyTasks != pdFALSE )
+        taskEXIT_CRITICAL();
+
+        /* Define the following macro to set xExpectedIdleTime to 0 if the
+         * application does not want portSUPPRESS_TICKS_AND_SLEEP() to be
+         * called. */
+        configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( xExpectedIdleTime );
+
+        /* Any idle period is worth sleeping through on an SMP core, the port
+         * applies configEXPECTED_IDLE_TIME_BEFORE_SLEEP when it decides
+         * whether the tick itself can be stopped. */
+        if( xExpectedIdleTime > ( TickType_t ) 0 )
         {
-            /* There are tasks in the Ready state that have a priority above the
-             * idle priority.  This path can only be reached if
-             * configUSE_PREEMPTION is 0. */
-            xReturn = 0;
+            traceLOW_POWER_IDLE_BEGIN();
+            portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime );
+            traceLOW_POWER_IDLE_END();
         }
         else
         {
-            xReturn = xNextTaskUnblockTime;
-            xReturn -= xTickCount;
+            mtCOVERAGE_TEST_MARKER();
         }
-
-        return xReturn;
     }
 
 #endif /* configUSE_TICKLESS_IDLE */
@@ -4339,6 +5804,21 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                 }
             } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
 
+            #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+            {
+                BaseType_t xCoreID;
+
+                /* Search the ready lists private to each core. */
+                for( xCoreID = 0; ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( pxTCB == NULL ); xCoreID++ )
+                {
+                    for( uxQueue = 0; ( uxQueue < ( UBaseType_t ) configMAX_PRIORITIES ) && ( pxTCB == NULL ); uxQueue++ )
+                    {
+                        pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxCoreReadyTasksLists[ xCoreID ][ uxQueue ] ), pcNameToQuery );
+                    }
+                }
+            }
+            #endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+
             /* Search the delayed lists. */
             if( pxTCB == NULL )
             {
@@ -4350,6 +5830,43 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                 pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
             }
 
+            #if ( configUSE_PER_CORE_TICKS == 1 )
+            {
+                BaseType_t xCoreID;
+
+                /* Search the delayed lists private to each core. */
+                for( xCoreID = 0; ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( pxTCB == NULL ); xCoreID++ )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( &( xCoreDelayedTaskLists[ xCoreID ][ 0 ] ), pcNameToQuery );
+
+                    if( pxTCB == NULL )
+                    {
+                        pxTCB = prvSearchForNameWithinSingleList( &( xCoreDelayedTaskLists[ xCoreID ][ 1 ] ), pcNameToQuery );
+                    }
+                }
+            }
+            #endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+            #if ( configUSE_DELAY_WHEEL == 1 )
+            {
+                UBaseType_t uxWheel;
+                UBaseType_t uxLevel;
+                UBaseType_t uxSlot;
+
+                /* Search every slot of the delay wheels. */
+                for( uxWheel = 0U; ( uxWheel < ( UBaseType_t ) taskDELAY_WHEEL_COUNT ) && ( pxTCB == NULL ); uxWheel++ )
+                {
+                    for( uxLevel = 0U; ( uxLevel < ( UBaseType_t ) configDELAY_WHEEL_LEVELS ) && ( pxTCB == NULL ); uxLevel++ )
+                    {
+                        for( uxSlot = 0U; ( uxSlot < taskDELAY_WHEEL_SLOTS ) && ( pxTCB == NULL ); uxSlot++ )
+                        {
+                            pxTCB = prvSearchForNameWithinSingleList( &( xDelayWheels[ uxWheel ].xSlots[ uxLevel ][ uxSlot ] ), pcNameToQuery );
+                        }
+                    }
+                }
+            }
+            #endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
+
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
                 if( pxTCB == NULL )
@@ -4458,11 +5975,56 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
                     uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), eReady ) );
                 } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
 
+                #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+                {
+                    BaseType_t xCoreID;
+
+                    for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                    {
+                        for( uxQueue = 0; uxQueue < ( UBaseType_t ) configMAX_PRIORITIES; uxQueue++ )
+                        {
+                            uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxCoreReadyTasksLists[ xCoreID ][ uxQueue ] ), eReady ) );
+                        }
+                    }
+                }
+                #endif /* #if ( configUSE_PER_CORE_READY_LISTS == 1 ) */
+
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Blocked state. */
                 uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
                 uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
 
+                #if ( configUSE_PER_CORE_TICKS == 1 )
+                {
+                    BaseType_t xCoreID;
+
+                    for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                    {
+                        uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xCoreDelayedTaskLists[ xCoreID ][ 0 ] ), eBlocked ) );
+                        uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xCoreDelayedTaskLists[ xCoreID ][ 1 ] ), eBlocked ) );
+                    }
+                }
+                #endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+                #if ( configUSE_DELAY_WHEEL == 1 )
+                {
+                    UBaseType_t uxWheel;
+                    UBaseType_t uxLevel;
+                    UBaseType_t uxSlot;
+
+                    for( uxWheel = 0U; uxWheel < ( UBaseType_t ) taskDELAY_WHEEL_COUNT; uxWheel++ )
+                    {
+                        for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configDELAY_WHEEL_LEVELS; uxLevel++ )
+                        {
+                            for( uxSlot = 0U; uxSlot < taskDELAY_WHEEL_SLOTS; uxSlot++ )
+                            {
+                                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayWheels[ uxWheel ].xSlots[ uxLevel ][ uxSlot ] ), eBlocked ) );
+                            }
+                        }
+                    }
+                }
+                #endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
+
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
                     /* Fill in an TaskStatus_t structure with information on
@@ -4554,7 +6116,7 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
  * This is to ensure vTaskStepTick() is available when user defined low power mode
  * implementations require configUSE_TICKLESS_IDLE to be set to a value other than
  * 1. */
-#if ( configUSE_TICKLESS_IDLE != 0 )
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES == 1 ) )
 
     void vTaskStepTick( TickType_t xTicksToJump )
     {
@@ -4595,6 +6157,48 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
         traceRETURN_vTaskStepTick();
     }
 
+#elif ( configUSE_TICKLESS_IDLE != 0 ) /* && ( configNUMBER_OF_CORES > 1 ) */
+
+    void vTaskStepTick( TickType_t xTicksToJump )
+    {
+        TickType_t xTicksBeforeUnblock;
+        TickType_t xTicksToSkip;
+
+        traceENTER_vTaskStepTick( xTicksToJump );
+
+        /* The scheduler is not suspended while an SMP core sleeps, so the
+         * sleep can overrun xNextTaskUnblockTime if the wakeup was late.  Ticks
+         * on which nothing unblocks are skipped, the rest are processed by
+         * xTaskIncrementTick() so delayed tasks are moved to the ready lists
+         * and the delayed lists are switched on overflow.  The port calls this
+         * from within taskENTER_CRITICAL_FROM_ISR() on the tick core. */
+        while( xTicksToJump > ( TickType_t ) 0 )
+        {
+            xTicksBeforeUnblock = xNextTaskUnblockTime - xTickCount;
+
+            if( xTicksBeforeUnblock > ( TickType_t ) 1 )
+            {
+                xTicksToSkip = xTicksBeforeUnblock - ( TickType_t ) 1;
+
+                if( xTicksToSkip > xTicksToJump )
+                {
+                    xTicksToSkip = xTicksToJump;
+                }
+
+                xTickCount += xTicksToSkip;
+                xTicksToJump -= xTicksToSkip;
+                traceINCREASE_TICK_COUNT( xTicksToSkip );
+            }
+            else
+            {
+                ( void ) xTaskIncrementTick();
+                xTicksToJump--;
+            }
+        }
+
+        traceRETURN_vTaskStepTick();
+    }
+
 #endif /* configUSE_TICKLESS_IDLE */
 /*----------------------------------------------------------*/
 
@@ -4764,6 +6368,14 @@ BaseType_t xTaskIncrementTick( void )
          * look any further down the list. */
         if( xConstTickCount >= xNextTaskUnblockTime )
         {
+            #if ( configUSE_DELAY_WHEEL == 1 )
+            {
+                /* Tasks in the delay wheel that have timed out are moved to
+                 * the head of the delayed list, and unblocked from there. */
+                prvAdvanceDelayWheel( taskGLOBAL_DELAY_WHEEL, xConstTickCount, pxDelayedTaskList );
+            }
+            #endif
+
             for( ; ; )
             {
                 if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
@@ -4853,6 +6465,12 @@ BaseType_t xTaskIncrementTick( void )
                     #endif /* #if ( configUSE_PREEMPTION == 1 ) */
                 }
             }
+
+            #if ( configUSE_DELAY_WHEEL == 1 )
+            {
+                prvUpdateUnblockTimeFromDelayWheel( taskGLOBAL_DELAY_WHEEL, &xNextTaskUnblockTime );
+            }
+            #endif
         }
 
         /* Tasks of equal priority to the currently running task will share
@@ -4871,13 +6489,13 @@ BaseType_t xTaskIncrementTick( void )
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
-            #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+            #elif ( configUSE_PER_CORE_TICKS == 0 )
             {
                 BaseType_t xCoreID;
 
                 for( xCoreID = 0; xCoreID < ( ( BaseType_t ) configNUMBER_OF_CORES ); xCoreID++ )
                 {
-                    if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ) ) > 1U )
+                    if( taskREADY_TASKS_AT_PRIORITY( xCoreID, pxCurrentTCBs[ xCoreID ]->uxPriority ) > 1U )
                     {
                         xYieldPendings[ xCoreID ] = pdTRUE;
                     }
@@ -4888,6 +6506,9 @@ BaseType_t xTaskIncrementTick( void )
                 }
             }
             #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+
+            /* With configUSE_PER_CORE_TICKS each core time slices itself from
+             * xTaskIncrementCoreTick(). */
         }
         #endif /* #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
@@ -4920,7 +6541,7 @@ BaseType_t xTaskIncrementTick( void )
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
-            #else /* #if ( configNUMBER_OF_CORES == 1 ) */
+            #elif ( configUSE_PER_CORE_TICKS == 0 )
             {
                 BaseType_t xCoreID, xCurrentCoreID;
                 xCurrentCoreID = ( BaseType_t ) portGET_CORE_ID();
@@ -4949,27 +6570,219 @@ BaseType_t xTaskIncrementTick( void )
                     }
                 }
             }
-            #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+            #endif /* #if ( configNUMBER_OF_CORES == 1 ) */
+
+            /* With configUSE_PER_CORE_TICKS every core acts on its own pending
+             * yield from xTaskIncrementCoreTick(), and prvYieldForTask() has
+             * already interrupted any other core that a task unblocked above
+             * should preempt, so there is nothing to fan out here. */
+        }
+        #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+
+        #if ( ( configUSE_PER_CORE_TICKS == 1 ) && ( configUSE_TICKLESS_IDLE != 0 ) )
+        {
+            BaseType_t xCoreID;
+
+            /* A core stops its own tick while it sleeps in its idle task, so
+             * wake it when a task pinned to it times out. */
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                if( prvGetCoreTicksToUnblock( xCoreID, xConstTickCount ) == ( TickType_t ) 0U )
+                {
+                    portWAKE_SLEEPING_CORES( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        #endif /* #if ( ( configUSE_PER_CORE_TICKS == 1 ) && ( configUSE_TICKLESS_IDLE != 0 ) ) */
+    }
+    else
+    {
+        xPendedTicks += 1U;
+
+        /* The tick hook gets called at regular intervals, even if the
+         * scheduler is locked. */
+        #if ( configUSE_TICK_HOOK == 1 )
+        {
+            vApplicationTickHook();
+        }
+        #endif
+    }
+
+    traceRETURN_xTaskIncrementTick( xSwitchRequired );
+
+    return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+    BaseType_t xTaskIncrementCoreTick( void )
+    {
+        BaseType_t xSwitchRequired = pdFALSE;
+        const BaseType_t xCoreID = ( BaseType_t ) portGET_CORE_ID();
+
+        traceENTER_xTaskIncrementCoreTick();
+
+        /* The delayed lists of a core are only walked while the scheduler is
+         * running, exactly like the shared delayed lists.  If the scheduler is
+         * suspended the core simply catches up on a later tick. */
+        if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
+        {
+            const TickType_t xConstTickCount = xTickCount;
+
+            if( xConstTickCount != xCoreTickCounts[ xCoreID ] )
+            {
+                /* The core may have missed several ticks, for example if it
+                 * was sleeping.  If the tick count wrapped in that time then
+                 * every task left in the current delayed list has timed out,
+                 * so empty it before switching to the overflow list. */
+                if( xConstTickCount < xCoreTickCounts[ xCoreID ] )
+                {
+                    prvUnblockCoreDelayedTasks( xCoreID, portMAX_DELAY );
+                    taskSWITCH_CORE_DELAYED_LISTS( xCoreID );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xCoreTickCounts[ xCoreID ] = xConstTickCount;
+
+                if( xConstTickCount >= xCoreNextTaskUnblockTimes[ xCoreID ] )
+                {
+                    prvUnblockCoreDelayedTasks( xCoreID, xConstTickCount );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+            {
+                if( taskREADY_TASKS_AT_PRIORITY( xCoreID, pxCurrentTCBs[ xCoreID ]->uxPriority ) > 1U )
+                {
+                    xYieldPendings[ xCoreID ] = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+
+            #if ( configUSE_PREEMPTION == 1 )
+            {
+                #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
+                    if( pxCurrentTCBs[ xCoreID ]->xPreemptionDisable == pdFALSE )
+                #endif
+                {
+                    if( xYieldPendings[ xCoreID ] != pdFALSE )
+                    {
+                        xSwitchRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_xTaskIncrementCoreTick( xSwitchRequired );
+
+        return xSwitchRequired;
+    }
+
+#endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+    static void prvUnblockCoreDelayedTasks( BaseType_t xCoreID,
+                                            TickType_t xConstTickCount )
+    {
+        TCB_t * pxTCB;
+        TickType_t xItemValue;
+        List_t * const pxDelayedList = pxCoreDelayedTaskList[ xCoreID ];
+
+        #if ( configUSE_DELAY_WHEEL == 1 )
+        {
+            prvAdvanceDelayWheel( taskCORE_DELAY_WHEEL( xCoreID ), xConstTickCount, pxDelayedList );
+        }
+        #endif
+
+        for( ; ; )
+        {
+            if( listLIST_IS_EMPTY( pxDelayedList ) != pdFALSE )
+            {
+                xCoreNextTaskUnblockTimes[ xCoreID ] = portMAX_DELAY;
+                break;
+            }
+            else
+            {
+                /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                /* coverity[misra_c_2012_rule_11_5_violation] */
+                pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedList );
+                xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+                if( xConstTickCount < xItemValue )
+                {
+                    xCoreNextTaskUnblockTimes[ xCoreID ] = xItemValue;
+                    break;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+
+                if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+                {
+                    listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvAddTaskToReadyList( pxTCB );
+
+                /* The task is normally pinned to this core, in which case
+                 * prvYieldForTask() only ever marks this core as needing to
+                 * yield.  It only interrupts another core if the task's
+                 * affinity was changed while it was blocked. */
+                #if ( configUSE_PREEMPTION == 1 )
+                {
+                    prvYieldForTask( pxTCB );
+                }
+                #endif
+            }
         }
-        #endif /* #if ( configUSE_PREEMPTION == 1 ) */
-    }
-    else
-    {
-        xPendedTicks += 1U;
 
-        /* The tick hook gets called at regular intervals, even if the
-         * scheduler is locked. */
-        #if ( configUSE_TICK_HOOK == 1 )
+        #if ( configUSE_DELAY_WHEEL == 1 )
         {
-            vApplicationTickHook();
+            prvUpdateUnblockTimeFromDelayWheel( taskCORE_DELAY_WHEEL( xCoreID ), &( xCoreNextTaskUnblockTimes[ xCoreID ] ) );
         }
         #endif
     }
 
-    traceRETURN_xTaskIncrementTick( xSwitchRequired );
-
-    return xSwitchRequired;
-}
+#endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_APPLICATION_TASK_TAG == 1 )
@@ -5240,6 +7053,15 @@ BaseType_t xTaskIncrementTick( void )
                     if( ulTotalRunTime[ xCoreID ] > ulTaskSwitchedInTime[ xCoreID ] )
                     {
                         pxCurrentTCBs[ xCoreID ]->ulRunTimeCounter += ( ulTotalRunTime[ xCoreID ] - ulTaskSwitchedInTime[ xCoreID ] );
+
+                        #if ( configUSE_LOAD_BALANCER == 1 )
+                        {
+                            if( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) == 0U )
+                            {
+                                ulCoreBusyTime[ xCoreID ] += ( ulTotalRunTime[ xCoreID ] - ulTaskSwitchedInTime[ xCoreID ] );
+                            }
+                        }
+                        #endif
                     }
                     else
                     {
@@ -5758,7 +7580,7 @@ void vTaskMissedYield( void )
                  * the ready list at the idle priority contains one more task than the
                  * number of idle tasks, which is equal to the configured numbers of cores
                  * then a task other than the idle task is ready to execute. */
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
+                if( taskREADY_TASKS_AT_PRIORITY( portGET_CORE_ID(), tskIDLE_PRIORITY ) > ( UBaseType_t ) configNUMBER_OF_CORES )
                 {
                     taskYIELD();
                 }
@@ -5769,6 +7591,12 @@ void vTaskMissedYield( void )
             }
             #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) ) */
 
+            #if ( configUSE_TICKLESS_IDLE != 0 )
+            {
+                prvSleepWhileIdle();
+            }
+            #endif /* configUSE_TICKLESS_IDLE */
+
             #if ( configUSE_PASSIVE_IDLE_HOOK == 1 )
             {
                 /* Call the user defined function from within the idle task.  This
@@ -5847,7 +7675,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
              * the ready list at the idle priority contains one more task than the
              * number of idle tasks, which is equal to the configured numbers of cores
              * then a task other than the idle task is ready to execute. */
-            if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
+            if( taskREADY_TASKS_AT_PRIORITY( portGET_CORE_ID(), tskIDLE_PRIORITY ) > ( UBaseType_t ) configNUMBER_OF_CORES )
             {
                 taskYIELD();
             }
@@ -5869,7 +7697,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
          * to 1.  This is to ensure portSUPPRESS_TICKS_AND_SLEEP() is called when
          * user defined low power mode  implementations require
          * configUSE_TICKLESS_IDLE to be set to a value other than 1. */
-        #if ( configUSE_TICKLESS_IDLE != 0 )
+        #if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configNUMBER_OF_CORES == 1 ) )
         {
             TickType_t xExpectedIdleTime;
 
@@ -5913,6 +7741,10 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
                 mtCOVERAGE_TEST_MARKER();
             }
         }
+        #elif ( configUSE_TICKLESS_IDLE != 0 )
+        {
+            prvSleepWhileIdle();
+        }
         #endif /* configUSE_TICKLESS_IDLE */
 
         #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PASSIVE_IDLE_HOOK == 1 ) )
@@ -5964,6 +7796,14 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
             eReturn = eAbortSleep;
         }
 
+        #if ( configNUMBER_OF_CORES > 1 )
+            else if( prvReadyTaskWaitingForCore( ( BaseType_t ) portGET_CORE_ID() ) != pdFALSE )
+            {
+                /* Another core made a task ready that this core could run. */
+                eReturn = eAbortSleep;
+            }
+        #endif /* #if ( configNUMBER_OF_CORES > 1 ) */
+
         #if ( INCLUDE_vTaskSuspend == 1 )
             else if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == ( uxCurrentNumberOfTasks - uxNonApplicationTasks ) )
             {
@@ -6071,6 +7911,17 @@ static void prvInitialiseTaskLists( void )
     for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
     {
         vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+
+        #if ( configUSE_PER_CORE_READY_LISTS == 1 )
+        {
+            BaseType_t xCoreID;
+
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            {
+                vListInitialise( &( pxCoreReadyTasksLists[ xCoreID ][ uxPriority ] ) );
+            }
+        }
+        #endif
     }
 
     vListInitialise( &xDelayedTaskList1 );
@@ -6093,6 +7944,45 @@ static void prvInitialiseTaskLists( void )
      * using list2. */
     pxDelayedTaskList = &xDelayedTaskList1;
     pxOverflowDelayedTaskList = &xDelayedTaskList2;
+
+    #if ( configUSE_PER_CORE_TICKS == 1 )
+    {
+        BaseType_t xCoreID;
+
+        for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+        {
+            vListInitialise( &( xCoreDelayedTaskLists[ xCoreID ][ 0 ] ) );
+            vListInitialise( &( xCoreDelayedTaskLists[ xCoreID ][ 1 ] ) );
+            pxCoreDelayedTaskList[ xCoreID ] = &( xCoreDelayedTaskLists[ xCoreID ][ 0 ] );
+            pxCoreOverflowDelayedTaskList[ xCoreID ] = &( xCoreDelayedTaskLists[ xCoreID ][ 1 ] );
+            xCoreTickCounts[ xCoreID ] = xTickCount;
+            xCoreNextTaskUnblockTimes[ xCoreID ] = portMAX_DELAY;
+        }
+    }
+    #endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+
+    #if ( configUSE_DELAY_WHEEL == 1 )
+    {
+        UBaseType_t uxWheel;
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+
+        for( uxWheel = 0U; uxWheel < ( UBaseType_t ) taskDELAY_WHEEL_COUNT; uxWheel++ )
+        {
+            for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configDELAY_WHEEL_LEVELS; uxLevel++ )
+            {
+                for( uxSlot = 0U; uxSlot < taskDELAY_WHEEL_SLOTS; uxSlot++ )
+                {
+                    vListInitialise( &( xDelayWheels[ uxWheel ].xSlots[ uxLevel ][ uxSlot ] ) );
+                }
+
+                xDelayWheels[ uxWheel ].uxOccupied[ uxLevel ] = 0U;
+            }
+
+            xDelayWheels[ uxWheel ].xTime = xTickCount;
+        }
+    }
+    #endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
 }
 /*-----------------------------------------------------------*/
 
@@ -6414,123 +8304,427 @@ static void prvCheckTasksWaitingTermination( void )
         }
         #endif
 
-        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+        traceRETURN_uxTaskGetStackHighWaterMark2( uxReturn );
+
+        return uxReturn;
+    }
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+
+    UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        uint8_t * pucEndOfStack;
+        UBaseType_t uxReturn;
+
+        traceENTER_uxTaskGetStackHighWaterMark( xTask );
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+        configASSERT( pxTCB != NULL );
+
+        #if portSTACK_GROWTH < 0
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+        }
+        #else
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+        }
+        #endif
+
+        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+        traceRETURN_uxTaskGetStackHighWaterMark( uxReturn );
+
+        return uxReturn;
+    }
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelete == 1 )
+
+    static void prvDeleteTCB( TCB_t * pxTCB )
+    {
+        /* This call is required specifically for the TriCore port.  It must be
+         * above the vPortFree() calls.  The call is also used by ports/demos that
+         * want to allocate and clean RAM statically. */
+        portCLEAN_UP_TCB( pxTCB );
+
+        #if ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 )
+        {
+            /* Free up the memory allocated for the task's TLS Block. */
+            configDEINIT_TLS_BLOCK( pxTCB->xTLSBlock );
+        }
+        #endif
+
+        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+        {
+            /* The task can only have been allocated dynamically - free both
+             * the stack and TCB. */
+            vPortFreeStack( pxTCB->pxStack );
+            vPortFree( pxTCB );
+        }
+        #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
+        {
+            /* The task could have been allocated statically or dynamically, so
+             * check what was statically allocated before trying to free the
+             * memory. */
+            if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+            {
+                /* Both the stack and TCB were allocated dynamically, so both
+                 * must be freed. */
+                vPortFreeStack( pxTCB->pxStack );
+                vPortFree( pxTCB );
+            }
+            else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+            {
+                /* Only the stack was statically allocated, so the TCB is the
+                 * only memory that must be freed. */
+                vPortFree( pxTCB );
+            }
+            else
+            {
+                /* Neither the stack nor the TCB were allocated dynamically, so
+                 * nothing needs to be freed. */
+                configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB );
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+    }
+
+#endif /* INCLUDE_vTaskDelete */
+/*-----------------------------------------------------------*/
+
+static void prvResetNextTaskUnblockTime( void )
+{
+    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+    {
+        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+         * the maximum possible value so it is  extremely unlikely that the
+         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+         * there is an item in the delayed list. */
+        xNextTaskUnblockTime = portMAX_DELAY;
+    }
+    else
+    {
+        /* The new current delayed list is not empty, get the value of
+         * the item at the head of the delayed list.  This is the time at
+         * which the task at the head of the delayed list should be removed
+         * from the Blocked state. */
+        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+    }
+
+    #if ( configUSE_DELAY_WHEEL == 1 )
+    {
+        prvUpdateUnblockTimeFromDelayWheel( taskGLOBAL_DELAY_WHEEL, &xNextTaskUnblockTime );
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PER_CORE_TICKS == 1 )
+
+    static void prvResetCoreNextTaskUnblockTime( BaseType_t xCoreID )
+    {
+        if( listLIST_IS_EMPTY( pxCoreDelayedTaskList[ xCoreID ] ) != pdFALSE )
+        {
+            xCoreNextTaskUnblockTimes[ xCoreID ] = portMAX_DELAY;
+        }
+        else
+        {
+            xCoreNextTaskUnblockTimes[ xCoreID ] = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCoreDelayedTaskList[ xCoreID ] );
+        }
+
+        #if ( configUSE_DELAY_WHEEL == 1 )
+        {
+            prvUpdateUnblockTimeFromDelayWheel( taskCORE_DELAY_WHEEL( xCoreID ), &( xCoreNextTaskUnblockTimes[ xCoreID ] ) );
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsCoreDelayedList( const List_t * pxList )
+    {
+        BaseType_t xCoreID;
+        BaseType_t xReturn = pdFALSE;
+
+        for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+        {
+            if( ( pxList == &( xCoreDelayedTaskLists[ xCoreID ][ 0 ] ) ) ||
+                ( pxList == &( xCoreDelayedTaskLists[ xCoreID ][ 1 ] ) ) )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvGetCoreTicksToUnblock( BaseType_t xCoreID,
+                                                TickType_t xConstTickCount )
+    {
+        const TickType_t xCoreTickCount = xCoreTickCounts[ xCoreID ];
+        const TickType_t xLag = xConstTickCount - xCoreTickCount;
+        TickType_t xTicksToUnblock;
+        TickType_t xReturn;
+
+        if( xConstTickCount < xCoreTickCount )
+        {
+            /* The tick count wrapped since the core last ran, so its delayed
+             * lists must be switched before its next unblock time means
+             * anything. */
+            xReturn = 0;
+        }
+        else
+        {
+            xTicksToUnblock = xCoreNextTaskUnblockTimes[ xCoreID ] - xCoreTickCount;
+            xReturn = ( xTicksToUnblock > xLag ) ? ( xTicksToUnblock - xLag ) : ( TickType_t ) 0U;
+        }
+
+        return xReturn;
+    }
+
+#endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_DELAY_WHEEL == 1 )
+
+    static BaseType_t prvDelayWheelInsert( DelayWheel_t * pxWheel,
+                                           List_t * pxDelayedList,
+                                           TickType_t xTickCount,
+                                           ListItem_t * pxListItem,
+                                           volatile TickType_t * pxNextUnblockTime )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        /* The slot a task goes in is chosen relative to the time the wheel is
+         * at, so bring the wheel up to the tick count first.  No task in the
+         * wheel can be due yet, so this normally only passes slots that were
+         * left empty by tasks leaving the Blocked state early. */
+        prvAdvanceDelayWheel( pxWheel, xTickCount, pxDelayedList );
+
+        if( prvPlaceInDelayWheel( pxWheel, pxListItem ) < ( UBaseType_t ) configDELAY_WHEEL_LEVELS )
+        {
+            prvUpdateUnblockTimeFromDelayWheel( pxWheel, pxNextUnblockTime );
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAdvanceDelayWheel( DelayWheel_t * pxWheel,
+                                      TickType_t xTickCount,
+                                      List_t * pxDelayedList )
+    {
+        List_t * pxSlot;
+        ListItem_t * pxListItem;
+        TickType_t xEventTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+        UBaseType_t uxNewLevel;
+
+        for( ; ; )
+        {
+            /* Every task in the level 0 slot of the time the wheel is at has
+             * timed out.  Moving them to the head of the sorted delayed list
+             * is quick as no task in that list times out before them. */
+            uxSlot = ( UBaseType_t ) pxWheel->xTime & taskDELAY_WHEEL_SLOT_MASK;
+            pxSlot = &( pxWheel->xSlots[ 0 ][ uxSlot ] );
+
+            while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+            {
+                pxListItem = listGET_HEAD_ENTRY( pxSlot );
+                listREMOVE_ITEM( pxListItem );
+                vListInsert( pxDelayedList, pxListItem );
+            }
+
+            pxWheel->uxOccupied[ 0 ] &= ~( ( UBaseType_t ) 1U << uxSlot );
+
+            /* Times are compared relative to the time the wheel is at, so the
+             * wheel keeps working across a tick count overflow. */
+            uxLevel = prvGetNextDelayWheelEvent( pxWheel, &xEventTime );
+
+            if( ( uxLevel == ( UBaseType_t ) configDELAY_WHEEL_LEVELS ) ||
+                ( ( TickType_t ) ( xEventTime - pxWheel->xTime ) > ( TickType_t ) ( xTickCount - pxWheel->xTime ) ) )
+            {
+                pxWheel->xTime = xTickCount;
+                break;
+            }
+
+            pxWheel->xTime = xEventTime;
 
-        traceRETURN_uxTaskGetStackHighWaterMark2( uxReturn );
+            if( uxLevel > 0U )
+            {
+                /* The wheel has reached the start of a higher level slot, so
+                 * every task in it now falls in a lower level.  A task whose
+                 * wake time is the start of the slot lands in the level 0 slot
+                 * checked at the top of the loop. */
+                uxSlot = ( UBaseType_t ) ( xEventTime >> ( taskDELAY_WHEEL_SLOT_BITS * uxLevel ) ) & taskDELAY_WHEEL_SLOT_MASK;
+                pxSlot = &( pxWheel->xSlots[ uxLevel ][ uxSlot ] );
+                pxWheel->uxOccupied[ uxLevel ] &= ~( ( UBaseType_t ) 1U << uxSlot );
 
-        return uxReturn;
+                while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                {
+                    pxListItem = listGET_HEAD_ENTRY( pxSlot );
+                    listREMOVE_ITEM( pxListItem );
+                    uxNewLevel = prvPlaceInDelayWheel( pxWheel, pxListItem );
+                    configASSERT( uxNewLevel < uxLevel );
+                    ( void ) uxNewLevel;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
     }
-
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
-
-    UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+    static UBaseType_t prvPlaceInDelayWheel( DelayWheel_t * pxWheel,
+                                             ListItem_t * pxListItem )
     {
-        TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
-        UBaseType_t uxReturn;
-
-        traceENTER_uxTaskGetStackHighWaterMark( xTask );
+        const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxListItem );
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+        UBaseType_t uxShift;
 
-        pxTCB = prvGetTCBFromHandle( xTask );
-        configASSERT( pxTCB != NULL );
-
-        #if portSTACK_GROWTH < 0
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
-        }
-        #else
+        for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configDELAY_WHEEL_LEVELS; uxLevel++ )
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
-        }
-        #endif
-
-        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+            uxShift = taskDELAY_WHEEL_SLOT_BITS * uxLevel;
 
-        traceRETURN_uxTaskGetStackHighWaterMark( uxReturn );
+            /* Use the lowest level whose slots, from the one the wheel is at
+             * onwards, still reach the wake time. */
+            if( ( xTimeToWake >> ( uxShift + taskDELAY_WHEEL_SLOT_BITS ) ) == ( pxWheel->xTime >> ( uxShift + taskDELAY_WHEEL_SLOT_BITS ) ) )
+            {
+                uxSlot = ( UBaseType_t ) ( xTimeToWake >> uxShift ) & taskDELAY_WHEEL_SLOT_MASK;
+                listINSERT_END( &( pxWheel->xSlots[ uxLevel ][ uxSlot ] ), pxListItem );
+                pxWheel->uxOccupied[ uxLevel ] |= ( UBaseType_t ) 1U << uxSlot;
+                break;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
 
-        return uxReturn;
+        return uxLevel;
     }
-
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskDelete == 1 )
-
-    static void prvDeleteTCB( TCB_t * pxTCB )
+    static UBaseType_t prvGetNextDelayWheelEvent( const DelayWheel_t * pxWheel,
+                                                  TickType_t * pxTime )
     {
-        /* This call is required specifically for the TriCore port.  It must be
-         * above the vPortFree() calls.  The call is also used by ports/demos that
-         * want to allocate and clean RAM statically. */
-        portCLEAN_UP_TCB( pxTCB );
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+        UBaseType_t uxLaterSlots;
+        UBaseType_t uxShift;
 
-        #if ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 )
+        for( uxLevel = 0U; uxLevel < ( UBaseType_t ) configDELAY_WHEEL_LEVELS; uxLevel++ )
         {
-            /* Free up the memory allocated for the task's TLS Block. */
-            configDEINIT_TLS_BLOCK( pxTCB->xTLSBlock );
-        }
-        #endif
+            uxShift = taskDELAY_WHEEL_SLOT_BITS * uxLevel;
+            uxSlot = ( UBaseType_t ) ( pxWheel->xTime >> uxShift ) & taskDELAY_WHEEL_SLOT_MASK;
 
-        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
-        {
-            /* The task can only have been allocated dynamically - free both
-             * the stack and TCB. */
-            vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
-        }
-        #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
-        {
-            /* The task could have been allocated statically or dynamically, so
-             * check what was statically allocated before trying to free the
-             * memory. */
-            if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+            /* A level 0 slot may hold tasks due at the time the wheel is at,
+             * but a higher level slot only ever holds tasks in a later slot
+             * than the wheel's own.  Every slot that can hold tasks at a
+             * level is before the first slot that can at the next level. */
+            if( uxLevel == 0U )
             {
-                /* Both the stack and TCB were allocated dynamically, so both
-                 * must be freed. */
-                vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                uxLaterSlots = pxWheel->uxOccupied[ uxLevel ] & ( ~( UBaseType_t ) 0U << uxSlot );
             }
-            else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+            else
             {
-                /* Only the stack was statically allocated, so the TCB is the
-                 * only memory that must be freed. */
-                vPortFree( pxTCB );
+                uxLaterSlots = pxWheel->uxOccupied[ uxLevel ] & ( ( ~( UBaseType_t ) 0U << uxSlot ) << 1U );
+            }
+
+            if( uxLaterSlots != 0U )
+            {
+                #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+                {
+                    portGET_HIGHEST_PRIORITY( uxSlot, ( uxLaterSlots & ( ~uxLaterSlots + 1U ) ) );
+                }
+                #else
+                {
+                    uxSlot = 0U;
+
+                    while( ( uxLaterSlots & ( ( UBaseType_t ) 1U << uxSlot ) ) == 0U )
+                    {
+                        uxSlot++;
+                    }
+                }
+                #endif
+
+                /* The start of the slot, in the block the wheel is at. */
+                *pxTime = ( ( pxWheel->xTime >> ( uxShift + taskDELAY_WHEEL_SLOT_BITS ) ) << ( uxShift + taskDELAY_WHEEL_SLOT_BITS ) ) |
+                          ( ( TickType_t ) uxSlot << uxShift );
+                break;
             }
             else
             {
-                /* Neither the stack nor the TCB were allocated dynamically, so
-                 * nothing needs to be freed. */
-                configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB );
                 mtCOVERAGE_TEST_MARKER();
             }
         }
-        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-    }
 
-#endif /* INCLUDE_vTaskDelete */
+        return uxLevel;
+    }
 /*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+    static void prvUpdateUnblockTimeFromDelayWheel( const DelayWheel_t * pxWheel,
+                                                    volatile TickType_t * pxNextUnblockTime )
     {
-        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-         * the maximum possible value so it is  extremely unlikely that the
-         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-         * there is an item in the delayed list. */
-        xNextTaskUnblockTime = portMAX_DELAY;
+        TickType_t xEventTime;
+
+        if( prvGetNextDelayWheelEvent( pxWheel, &xEventTime ) < ( UBaseType_t ) configDELAY_WHEEL_LEVELS )
+        {
+            if( xEventTime < *pxNextUnblockTime )
+            {
+                *pxNextUnblockTime = xEventTime;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
-    else
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsDelayWheelList( const List_t * pxList )
     {
-        /* The new current delayed list is not empty, get the value of
-         * the item at the head of the delayed list.  This is the time at
-         * which the task at the head of the delayed list should be removed
-         * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        UBaseType_t uxWheel;
+        BaseType_t xReturn = pdFALSE;
+
+        for( uxWheel = 0U; uxWheel < ( UBaseType_t ) taskDELAY_WHEEL_COUNT; uxWheel++ )
+        {
+            if( ( pxList >= &( xDelayWheels[ uxWheel ].xSlots[ 0 ][ 0 ] ) ) &&
+                ( pxList <= &( xDelayWheels[ uxWheel ].xSlots[ configDELAY_WHEEL_LEVELS - 1 ][ taskDELAY_WHEEL_SLOTS - 1U ] ) ) )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
     }
-}
+
+#endif /* #if ( configUSE_DELAY_WHEEL == 1 ) */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_RECURSIVE_MUTEXES == 1 ) ) || ( configNUMBER_OF_CORES > 1 )
@@ -6666,14 +8860,14 @@ static void prvResetNextTaskUnblockTime( void )
 
                 /* If the task being modified is in the ready state it will need
                  * to be moved into a new list. */
-                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxMutexHolderTCB->uxPriority ] ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE )
+                if( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxMutexHolderTCB, pxMutexHolderTCB->uxPriority ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE )
                 {
                     if( uxListRemove( &( pxMutexHolderTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                     {
                         /* It is known that the task is in its ready list so
-                         * there is no need to check again and the port level
-                         * reset macro can be called directly. */
-                        portRESET_READY_PRIORITY( pxMutexHolderTCB->uxPriority, uxTopReadyPriority );
+                         * there is no need to check again and the ready
+                         * priority can be cleared directly. */
+                        taskCLEAR_READY_PRIORITY( pxMutexHolderTCB, pxMutexHolderTCB->uxPriority );
                     }
                     else
                     {
@@ -6682,6 +8876,7 @@ static void prvResetNextTaskUnblockTime( void )
 
                     /* Inherit the priority before being moved into the new list. */
                     pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
+                    taskUPDATE_RUNNING_PRIORITY( pxMutexHolderTCB );
                     prvAddTaskToReadyList( pxMutexHolderTCB );
                     #if ( configNUMBER_OF_CORES > 1 )
                     {
@@ -6698,6 +8893,7 @@ static void prvResetNextTaskUnblockTime( void )
                 {
                     /* Just inherit the priority. */
                     pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
+                    taskUPDATE_RUNNING_PRIORITY( pxMutexHolderTCB );
                 }
 
                 traceTASK_PRIORITY_INHERIT( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
@@ -6770,7 +8966,7 @@ static void prvResetNextTaskUnblockTime( void )
                      * the holding task from the ready list. */
                     if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                     {
-                        portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+                        taskCLEAR_READY_PRIORITY( pxTCB, pxTCB->uxPriority );
                     }
                     else
                     {
@@ -6781,6 +8977,7 @@ static void prvResetNextTaskUnblockTime( void )
                      * new  ready list. */
                     traceTASK_PRIORITY_DISINHERIT( pxTCB, pxTCB->uxBasePriority );
                     pxTCB->uxPriority = pxTCB->uxBasePriority;
+                    taskUPDATE_RUNNING_PRIORITY( pxTCB );
 
                     /* Reset the event list item value.  It cannot be in use for
                      * any other purpose if this task is running, and it must be
@@ -6881,6 +9078,7 @@ static void prvResetNextTaskUnblockTime( void )
                     traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPriorityToUse );
                     uxPriorityUsedOnEntry = pxTCB->uxPriority;
                     pxTCB->uxPriority = uxPriorityToUse;
+                    taskUPDATE_RUNNING_PRIORITY( pxTCB );
 
                     /* Only reset the event list item value if the value is not
                      * being used for anything else. */
@@ -6899,14 +9097,15 @@ static void prvResetNextTaskUnblockTime( void )
                      * from its current state list if it is in the Ready state as
                      * the task's priority is going to change and there is one
                      * Ready list per priority. */
-                    if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                    if( listIS_CONTAINED_WITHIN( taskREADY_LIST( pxTCB, uxPriorityUsedOnEntry ), &( pxTCB->xStateListItem ) ) != pdFALSE )
                     {
                         if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
                         {
                             /* It is known that the task is in its ready list so
-                             * there is no need to check again and the port level
-                             * reset macro can be called directly. */
-                            portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+                             * there is no need to check again and the ready
+                             * priority can be cleared directly.  The list emptied
+                             * is the one of the priority being disinherited. */
+                            taskCLEAR_READY_PRIORITY( pxTCB, uxPriorityUsedOnEntry );
                         }
                         else
                         {
@@ -7022,18 +9221,32 @@ static void prvResetNextTaskUnblockTime( void )
 
     void vTaskEnterCritical( void )
     {
+        #ifdef portGET_KERNEL_LOCKS
+            UBaseType_t uxSavedInterruptStatus;
+        #endif
+
         traceENTER_vTaskEnterCritical();
 
-        portDISABLE_INTERRUPTS();
+        #ifdef portGET_KERNEL_LOCKS
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+        #else
+            portDISABLE_INTERRUPTS();
+        #endif
         {
-            const BaseType_t xCoreID = ( BaseType_t ) portGET_CORE_ID();
+            BaseType_t xCoreID = ( BaseType_t ) portGET_CORE_ID();
 
             if( xSchedulerRunning != pdFALSE )
             {
                 if( portGET_CRITICAL_NESTING_COUNT( xCoreID ) == 0U )
                 {
-                    portGET_TASK_LOCK( xCoreID );
-                    portGET_ISR_LOCK( xCoreID );
+                    #ifdef portGET_KERNEL_LOCKS
+                        /* The task may be moved to another core while the
+                         * port waits for the locks. */
+                        xCoreID = portGET_KERNEL_LOCKS( uxSavedInterruptStatus, pdTRUE );
+                    #else
+                        portGET_TASK_LOCK( xCoreID );
+                        portGET_ISR_LOCK( xCoreID );
+                    #endif
                 }
 
                 portINCREMENT_CRITICAL_NESTING_COUNT( xCoreID );
@@ -7661,6 +9874,24 @@ TickType_t uxTaskResetEventItemValue( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+    UBaseType_t uxTaskGetRemoteYieldCount( void )
+    {
+        UBaseType_t uxReturn;
+
+        traceENTER_uxTaskGetRemoteYieldCount();
+
+        uxReturn = uxRemoteYieldRequests[ portGET_CORE_ID() ];
+
+        traceRETURN_uxTaskGetRemoteYieldCount( uxReturn );
+
+        return uxReturn;
+    }
+
+#endif /* #if ( ( configUSE_QUEUE_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     TaskHandle_t pvTaskIncrementMutexHeldCount( void )
@@ -8581,8 +10812,45 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 {
     TickType_t xTimeToWake;
     const TickType_t xConstTickCount = xTickCount;
-    List_t * const pxDelayedList = pxDelayedTaskList;
-    List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    List_t * pxDelayedList = pxDelayedTaskList;
+    List_t * pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    volatile TickType_t * pxNextUnblockTime = &xNextTaskUnblockTime;
+    TickType_t xListTickCount = xConstTickCount;
+
+    #if ( configUSE_DELAY_WHEEL == 1 )
+        DelayWheel_t * pxDelayWheel = taskGLOBAL_DELAY_WHEEL;
+    #endif
+
+    #if ( configUSE_PER_CORE_TICKS == 1 )
+    {
+        const BaseType_t xCoreID = pxCurrentTCB->xReadyListCore;
+
+        /* A task pinned to a single core is timed out by that core's own
+         * tick.  The wake time is still calculated from the global tick
+         * count, but the core may not have processed the latest tick yet, so
+         * the overflow test must also be made against the tick count the
+         * core's delayed lists are at - otherwise a wake time just after the
+         * tick count wraps could be placed in the list the core is about to
+         * switch away from. */
+        if( xCoreID >= 0 )
+        {
+            pxDelayedList = pxCoreDelayedTaskList[ xCoreID ];
+            pxOverflowDelayedList = pxCoreOverflowDelayedTaskList[ xCoreID ];
+            pxNextUnblockTime = &( xCoreNextTaskUnblockTimes[ xCoreID ] );
+            xListTickCount = xCoreTickCounts[ xCoreID ];
+
+            #if ( configUSE_DELAY_WHEEL == 1 )
+            {
+                pxDelayWheel = taskCORE_DELAY_WHEEL( xCoreID );
+            }
+            #endif
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* #if ( configUSE_PER_CORE_TICKS == 1 ) */
 
     #if ( INCLUDE_xTaskAbortDelay == 1 )
     {
@@ -8598,8 +10866,8 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
     if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
     {
         /* The current task must be in a ready list, so there is no need to
-         * check, and the port reset macro can be called directly. */
-        portRESET_READY_PRIORITY( pxCurrentTCB->uxPriority, uxTopReadyPriority );
+         * check, and the ready priority can be cleared directly. */
+        taskCLEAR_READY_PRIORITY( pxCurrentTCB, pxCurrentTCB->uxPriority );
     }
     else
     {
@@ -8625,7 +10893,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
             /* The list item will be inserted in wake time order. */
             listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-            if( xTimeToWake < xConstTickCount )
+            if( ( xTimeToWake < xConstTickCount ) || ( xTimeToWake < xListTickCount ) )
             {
                 /* Wake time has overflowed.  Place this item in the overflow
                  * list. */
@@ -8635,20 +10903,27 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
             else
             {
                 /* The wake time has not overflowed, so the current block list
-                 * is used. */
+                 * is used - or the delay wheel in front of it, if the wake
+                 * time is near enough. */
                 traceMOVED_TASK_TO_DELAYED_LIST();
-                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
 
-                /* If the task entering the blocked state was placed at the
-                 * head of the list of blocked tasks then xNextTaskUnblockTime
-                 * needs to be updated too. */
-                if( xTimeToWake < xNextTaskUnblockTime )
-                {
-                    xNextTaskUnblockTime = xTimeToWake;
-                }
-                else
+                #if ( configUSE_DELAY_WHEEL == 1 )
+                    if( prvDelayWheelInsert( pxDelayWheel, pxDelayedList, xListTickCount, &( pxCurrentTCB->xStateListItem ), pxNextUnblockTime ) == pdFALSE )
+                #endif
                 {
-                    mtCOVERAGE_TEST_MARKER();
+                    vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                    /* If the task entering the blocked state was placed at the
+                     * head of the list of blocked tasks then xNextTaskUnblockTime
+                     * needs to be updated too. */
+                    if( xTimeToWake < *pxNextUnblockTime )
+                    {
+                        *pxNextUnblockTime = xTimeToWake;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
                 }
             }
         }
@@ -8663,7 +10938,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         /* The list item will be inserted in wake time order. */
         listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-        if( xTimeToWake < xConstTickCount )
+        if( ( xTimeToWake < xConstTickCount ) || ( xTimeToWake < xListTickCount ) )
         {
             traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
             /* Wake time has overflowed.  Place this item in the overflow list. */
@@ -8672,19 +10947,27 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         else
         {
             traceMOVED_TASK_TO_DELAYED_LIST();
-            /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
 
-            /* If the task entering the blocked state was placed at the head of the
-             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
-             * too. */
-            if( xTimeToWake < xNextTaskUnblockTime )
-            {
-                xNextTaskUnblockTime = xTimeToWake;
-            }
-            else
+            /* The wake time has not overflowed, so the current block list is
+             * used - or the delay wheel in front of it, if the wake time is near
+             * enough. */
+            #if ( configUSE_DELAY_WHEEL == 1 )
+                if( prvDelayWheelInsert( pxDelayWheel, pxDelayedList, xListTickCount, &( pxCurrentTCB->xStateListItem ), pxNextUnblockTime ) == pdFALSE )
+            #endif
             {
-                mtCOVERAGE_TEST_MARKER();
+                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                /* If the task entering the blocked state was placed at the head
+                 * of the list of blocked tasks then xNextTaskUnblockTime needs to
+                 * be updated too. */
+                if( xTimeToWake < *pxNextUnblockTime )
+                {
+                    *pxNextUnblockTime = xTimeToWake;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
         }
 
@@ -8799,6 +11082,23 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
         *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
     }
 
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+
+        void vApplicationGetCoreTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                                 StackType_t ** ppxTimerTaskStackBuffer,
+                                                 configSTACK_DEPTH_TYPE * puxTimerTaskStackSize,
+                                                 BaseType_t xCoreID )
+        {
+            static StaticTask_t xTimerTaskTCBs[ configNUMBER_OF_CORES - 1 ];
+            static StackType_t uxTimerTaskStacks[ configNUMBER_OF_CORES - 1 ][ configTIMER_TASK_STACK_DEPTH ];
+
+            *ppxTimerTaskTCBBuffer = &( xTimerTaskTCBs[ xCoreID - 1 ] );
+            *ppxTimerTaskStackBuffer = &( uxTimerTaskStacks[ xCoreID - 1 ][ 0 ] );
+            *puxTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+        }
+
+    #endif /* #if ( configUSE_PER_CORE_TIMER_TASKS == 1 ) */
+
 #endif /* #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configKERNEL_PROVIDED_STATIC_MEMORY == 1 ) && ( portUSING_MPU_WRAPPERS == 0 ) && ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
@@ -8846,6 +11146,52 @@ void vTaskResetState( void )
     uxTaskNumber = ( UBaseType_t ) 0U;
     xNextTaskUnblockTime = ( TickType_t ) 0U;
 
+    #if ( configUSE_PER_CORE_TICKS == 1 )
+    {
+        for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+        {
+            xCoreTickCounts[ xCoreID ] = ( TickType_t ) configINITIAL_TICK_COUNT;
+            xCoreNextTaskUnblockTimes[ xCoreID ] = ( TickType_t ) 0U;
+        }
+    }
+    #endif
+
+    #if ( configUSE_CACHE_AFFINITY_WAKEUP == 1 )
+    {
+        ( void ) memset( ( void * ) &xMigrationStats, 0x00, sizeof( xMigrationStats ) );
+    }
+    #endif
+
+    #if ( configUSE_RUNNING_CORE_MASKS == 1 )
+    {
+        UBaseType_t uxPriority;
+
+        uxIdleCoreMask = 0U;
+        uxRunningPriorities = 0U;
+
+        for( uxPriority = 0; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+        {
+            uxRunningCoreMasks[ uxPriority ] = 0U;
+        }
+
+        for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+        {
+            xCoreRunningPriorities[ xCoreID ] = 0;
+        }
+    }
+    #endif
+
+    #if ( ( configUSE_PER_CORE_READY_LISTS == 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) )
+    {
+        uxSharedReadyPriorities = 0U;
+
+        for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+        {
+            uxCoreReadyPriorities[ xCoreID ] = 0U;
+        }
+    }
+    #endif
+
     uxSchedulerSuspended = ( UBaseType_t ) 0U;
 
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
@@ -8857,5 +11203,19 @@ void vTaskResetState( void )
         }
     }
     #endif /* #if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+    #if ( configUSE_LOAD_BALANCER == 1 )
+    {
+        uxMigratableTasks = 0U;
+        ulLastBalanceTime = 0U;
+        xLoadBalancerStarted = pdFALSE;
+
+        for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+        {
+            ulCoreBusyTime[ xCoreID ] = 0U;
+            ulLastCoreBusyTime[ xCoreID ] = 0U;
+        }
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
\ No newline at end of file
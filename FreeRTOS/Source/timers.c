@@ -74,6 +74,18 @@
         #endif
     #endif /* #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) ) */
 
+/* The number of timer service tasks, and the service a timer's commands are
+ * sent to.  With per core timer tasks, service x runs on core x. */
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+        #define tmrSERVICE_COUNT                  ( configNUMBER_OF_CORES )
+        #define tmrGET_TIMER_SERVICE( pxTimer )    ( &( xTimerServices[ ( pxTimer )->ucCoreID ] ) )
+        #define tmrGET_CURRENT_SERVICE()           ( &( xTimerServices[ portGET_CORE_ID() ] ) )
+    #else
+        #define tmrSERVICE_COUNT                  ( 1 )
+        #define tmrGET_TIMER_SERVICE( pxTimer )    ( &( xTimerServices[ 0 ] ) )
+        #define tmrGET_CURRENT_SERVICE()           ( &( xTimerServices[ 0 ] ) )
+    #endif
+
 /* Bit definitions used in the ucStatus member of a timer structure. */
     #define tmrSTATUS_IS_ACTIVE                  ( 0x01U )
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( 0x02U )
@@ -91,6 +103,9 @@
             UBaseType_t uxTimerNumber;                                           /**< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
         uint8_t ucStatus;                                                        /**< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
+        #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+            uint8_t ucCoreID;                                                    /**< The core whose timer service task runs the timer. */
+        #endif
     } xTIMER;
 
 /* The old xTIMER name is maintained above then typedefed to the new Timer_t
@@ -134,20 +149,24 @@
         } u;
     } DaemonTaskMessage_t;
 
-/* The list in which active timers are stored.  Timers are referenced in expire
+/* The state of one timer service task.  Active timers are stored in expire
  * time order, with the nearest expiry time at the front of the list.  Only the
- * timer service task is allowed to access these lists.
- * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
- * breaks some kernel aware debuggers, and debuggers that reply on removing the
- * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
-
-/* A queue that is used to send commands to the timer service task. */
-    PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
-    PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
+ * timer service task is allowed to access its lists.  Other tasks communicate
+ * with the timer service task using the xTimerQueue queue. */
+    typedef struct tmrTimerService
+    {
+        List_t xActiveTimerList1;
+        List_t xActiveTimerList2;
+        List_t * pxCurrentTimerList;
+        List_t * pxOverflowTimerList;
+        QueueHandle_t xTimerQueue;
+        TaskHandle_t xTimerTaskHandle;
+        TickType_t xLastTime; /**< The tick count the last time prvSampleTimeNow() was called, to detect tick count overflows. */
+    } TimerService_t;
+
+/* The timer services could be at function scope but that breaks some kernel
+ * aware debuggers, and debuggers that reply on removing the static qualifier. */
+    PRIVILEGED_DATA static TimerService_t xTimerServices[ tmrSERVICE_COUNT ];
 
 /*-----------------------------------------------------------*/
 
@@ -160,21 +179,29 @@
 /*
  * The timer service task (daemon).  Timer functionality is controlled by this
  * task.  Other tasks communicate with the timer service task using the
- * xTimerQueue queue.
+ * xTimerQueue queue of the TimerService_t passed in pvParameters.
  */
     static portTASK_FUNCTION_PROTO( prvTimerTask, pvParameters ) PRIVILEGED_FUNCTION;
 
+/*
+ * Create the timer service task of pxService, pinned to core xCoreID if
+ * xCoreID is not tskNO_AFFINITY.
+ */
+    static BaseType_t prvCreateTimerTask( TimerService_t * const pxService,
+                                          const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
 /*
  * Called by the timer service task to interpret and process a command it
  * received on the timer queue.
  */
-    static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
+    static void prvProcessReceivedCommands( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
 
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
  * depending on if the expire time causes a timer counter overflow.
  */
-    static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+    static BaseType_t prvInsertTimerInActiveList( TimerService_t * const pxService,
+                                                  Timer_t * const pxTimer,
                                                   const TickType_t xNextExpiryTime,
                                                   const TickType_t xTimeNow,
                                                   const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
@@ -184,7 +211,8 @@
  * clear the backlog, calling the callback for each additional reload.  When
  * this function returns, the next expiry time is after xTimeNow.
  */
-    static void prvReloadTimer( Timer_t * const pxTimer,
+    static void prvReloadTimer( TimerService_t * const pxService,
+                                Timer_t * const pxTimer,
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
@@ -192,20 +220,22 @@
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+    static void prvSwitchTimerLists( TimerService_t * const pxService ) PRIVILEGED_FUNCTION;
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
  * if a tick count overflow occurred since prvSampleTimeNow() was last called.
  */
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
 
 /*
  * If the timer list contains any active timers then return the expire time of
@@ -213,13 +243,15 @@
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
  * to pdTRUE.
  */
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
+    static TickType_t prvGetNextExpireTime( const TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
 /*
  * If a timer has expired, process it.  Otherwise, block the timer service task
  * until either a timer does expire or a command is received.
  */
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
 
 /*
@@ -246,27 +278,73 @@
          * been created then the initialisation will already have been performed. */
         prvCheckForValidListAndQueue();
 
-        if( xTimerQueue != NULL )
+        #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+        {
+            BaseType_t xCoreID;
+
+            xReturn = pdPASS;
+
+            for( xCoreID = 0; ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( xReturn == pdPASS ); xCoreID++ )
+            {
+                xReturn = prvCreateTimerTask( &( xTimerServices[ xCoreID ] ), xCoreID );
+            }
+        }
+        #else /* #if ( configUSE_PER_CORE_TIMER_TASKS == 1 ) */
+        {
+            xReturn = prvCreateTimerTask( &( xTimerServices[ 0 ] ), 0 );
+        }
+        #endif /* #if ( configUSE_PER_CORE_TIMER_TASKS == 1 ) */
+
+        configASSERT( xReturn );
+
+        traceRETURN_xTimerCreateTimerTask( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCreateTimerTask( TimerService_t * const pxService,
+                                          const BaseType_t xCoreID )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        if( pxService->xTimerQueue != NULL )
         {
             #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
             {
+                #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+                    const UBaseType_t uxCoreAffinityMask = ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID;
+                #else
+                    const UBaseType_t uxCoreAffinityMask = configTIMER_SERVICE_TASK_CORE_AFFINITY;
+                #endif
+
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
                     StaticTask_t * pxTimerTaskTCBBuffer = NULL;
                     StackType_t * pxTimerTaskStackBuffer = NULL;
                     configSTACK_DEPTH_TYPE uxTimerTaskStackSize;
 
-                    vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
-                    xTimerTaskHandle = xTaskCreateStaticAffinitySet( &prvTimerTask,
-                                                                     configTIMER_SERVICE_TASK_NAME,
-                                                                     uxTimerTaskStackSize,
-                                                                     NULL,
-                                                                     ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                                     pxTimerTaskStackBuffer,
-                                                                     pxTimerTaskTCBBuffer,
-                                                                     configTIMER_SERVICE_TASK_CORE_AFFINITY );
+                    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+                        if( xCoreID > 0 )
+                        {
+                            vApplicationGetCoreTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize, xCoreID );
+                        }
+                        else
+                    #endif
+                    {
+                        vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
+                    }
+
+                    pxService->xTimerTaskHandle = xTaskCreateStaticAffinitySet( &prvTimerTask,
+                                                                                configTIMER_SERVICE_TASK_NAME,
+                                                                                uxTimerTaskStackSize,
+                                                                                ( void * ) pxService,
+                                                                                ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                                                pxTimerTaskStackBuffer,
+                                                                                pxTimerTaskTCBBuffer,
+                                                                                uxCoreAffinityMask );
 
-                    if( xTimerTaskHandle != NULL )
+                    if( pxService->xTimerTaskHandle != NULL )
                     {
                         xReturn = pdPASS;
                     }
@@ -276,10 +354,10 @@
                     xReturn = xTaskCreateAffinitySet( &prvTimerTask,
                                                       configTIMER_SERVICE_TASK_NAME,
                                                       configTIMER_TASK_STACK_DEPTH,
-                                                      NULL,
+                                                      ( void * ) pxService,
                                                       ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                      configTIMER_SERVICE_TASK_CORE_AFFINITY,
-                                                      &xTimerTaskHandle );
+                                                      uxCoreAffinityMask,
+                                                      &( pxService->xTimerTaskHandle ) );
                 }
                 #endif /* configSUPPORT_STATIC_ALLOCATION */
             }
@@ -292,15 +370,15 @@
                     configSTACK_DEPTH_TYPE uxTimerTaskStackSize;
 
                     vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
-                    xTimerTaskHandle = xTaskCreateStatic( &prvTimerTask,
-                                                          configTIMER_SERVICE_TASK_NAME,
-                                                          uxTimerTaskStackSize,
-                                                          NULL,
-                                                          ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                                          pxTimerTaskStackBuffer,
-                                                          pxTimerTaskTCBBuffer );
-
-                    if( xTimerTaskHandle != NULL )
+                    pxService->xTimerTaskHandle = xTaskCreateStatic( &prvTimerTask,
+                                                                     configTIMER_SERVICE_TASK_NAME,
+                                                                     uxTimerTaskStackSize,
+                                                                     ( void * ) pxService,
+                                                                     ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
+                                                                     pxTimerTaskStackBuffer,
+                                                                     pxTimerTaskTCBBuffer );
+
+                    if( pxService->xTimerTaskHandle != NULL )
                     {
                         xReturn = pdPASS;
                     }
@@ -310,9 +388,9 @@
                     xReturn = xTaskCreate( &prvTimerTask,
                                            configTIMER_SERVICE_TASK_NAME,
                                            configTIMER_TASK_STACK_DEPTH,
-                                           NULL,
+                                           ( void * ) pxService,
                                            ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
-                                           &xTimerTaskHandle );
+                                           &( pxService->xTimerTaskHandle ) );
                 }
                 #endif /* configSUPPORT_STATIC_ALLOCATION */
             }
@@ -323,9 +401,8 @@
             mtCOVERAGE_TEST_MARKER();
         }
 
-        configASSERT( xReturn );
-
-        traceRETURN_xTimerCreateTimerTask( xReturn );
+        /* Only used to pin the task when there is a timer task per core. */
+        ( void ) xCoreID;
 
         return xReturn;
     }
@@ -436,6 +513,14 @@
         pxNewTimer->pxCallbackFunction = pxCallbackFunction;
         vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
 
+        #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+        {
+            /* The timer is run by the timer service task of the core that
+             * created it until vTimerSetCore() is called. */
+            pxNewTimer->ucCoreID = ( uint8_t ) portGET_CORE_ID();
+        }
+        #endif
+
         if( xAutoReload != pdFALSE )
         {
             pxNewTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_AUTORELOAD;
@@ -453,11 +538,17 @@
     {
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
+        QueueHandle_t xTimerQueue = NULL;
 
         ( void ) pxHigherPriorityTaskWoken;
 
         traceENTER_xTimerGenericCommandFromTask( xTimer, xCommandID, xOptionalValue, pxHigherPriorityTaskWoken, xTicksToWait );
 
+        if( xTimer != NULL )
+        {
+            xTimerQueue = tmrGET_TIMER_SERVICE( xTimer )->xTimerQueue;
+        }
+
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
         if( ( xTimerQueue != NULL ) && ( xTimer != NULL ) )
@@ -502,11 +593,17 @@
     {
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
+        QueueHandle_t xTimerQueue = NULL;
 
         ( void ) xTicksToWait;
 
         traceENTER_xTimerGenericCommandFromISR( xTimer, xCommandID, xOptionalValue, pxHigherPriorityTaskWoken, xTicksToWait );
 
+        if( xTimer != NULL )
+        {
+            xTimerQueue = tmrGET_TIMER_SERVICE( xTimer )->xTimerQueue;
+        }
+
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
         if( ( xTimerQueue != NULL ) && ( xTimer != NULL ) )
@@ -538,8 +635,14 @@
 
     TaskHandle_t xTimerGetTimerDaemonTaskHandle( void )
     {
+        TaskHandle_t xTimerTaskHandle;
+
         traceENTER_xTimerGetTimerDaemonTaskHandle();
 
+        /* With a timer service task per core, the one of the calling core is
+         * returned. */
+        xTimerTaskHandle = tmrGET_CURRENT_SERVICE()->xTimerTaskHandle;
+
         /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
          * started, then xTimerTaskHandle will be NULL. */
         configASSERT( ( xTimerTaskHandle != NULL ) );
@@ -692,14 +795,64 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvReloadTimer( Timer_t * const pxTimer,
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+
+        void vTimerSetCore( TimerHandle_t xTimer,
+                            BaseType_t xCoreID )
+        {
+            Timer_t * pxTimer = xTimer;
+
+            traceENTER_vTimerSetCore( xTimer, xCoreID );
+
+            configASSERT( xTimer );
+            configASSERT( taskVALID_CORE_ID( xCoreID ) == pdTRUE );
+
+            /* The active timer lists belong to the timer service task, so a
+             * timer can only change service while it is in none of them. */
+            configASSERT( xTimerIsTimerActive( xTimer ) == pdFALSE );
+
+            taskENTER_CRITICAL();
+            {
+                pxTimer->ucCoreID = ( uint8_t ) xCoreID;
+            }
+            taskEXIT_CRITICAL();
+
+            traceRETURN_vTimerSetCore();
+        }
+
+    #endif /* configUSE_PER_CORE_TIMER_TASKS */
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_PER_CORE_TIMER_TASKS == 1 )
+
+        BaseType_t xTimerGetCore( TimerHandle_t xTimer )
+        {
+            Timer_t * pxTimer = xTimer;
+            BaseType_t xCoreID;
+
+            traceENTER_xTimerGetCore( xTimer );
+
+            configASSERT( xTimer );
+
+            xCoreID = ( BaseType_t ) pxTimer->ucCoreID;
+
+            traceRETURN_xTimerGetCore( xCoreID );
+
+            return xCoreID;
+        }
+
+    #endif /* configUSE_PER_CORE_TIMER_TASKS */
+/*-----------------------------------------------------------*/
+
+    static void prvReloadTimer( TimerService_t * const pxService,
+                                Timer_t * const pxTimer,
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow )
     {
         /* Insert the timer into the appropriate list for the next expiry time.
          * If the next expiry time has already passed, advance the expiry time,
          * call the callback function, and try again. */
-        while( prvInsertTimerInActiveList( pxTimer, ( xExpiredTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xExpiredTime ) != pdFALSE )
+        while( prvInsertTimerInActiveList( pxService, pxTimer, ( xExpiredTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xExpiredTime ) != pdFALSE )
         {
             /* Advance the expiry time. */
             xExpiredTime += pxTimer->xTimerPeriodInTicks;
@@ -711,13 +864,14 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+    static void prvProcessExpiredTimer( TimerService_t * const pxService,
+                                        const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
         /* MISRA Ref 11.5.3 [Void pointer assignment] */
         /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
         /* coverity[misra_c_2012_rule_11_5_violation] */
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList );
+        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxService->pxCurrentTimerList );
 
         /* Remove the timer from the list of active timers.  A check has already
          * been performed to ensure the list is not empty. */
@@ -728,7 +882,7 @@
          * expiry time and re-insert the timer in the list of active timers. */
         if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            prvReloadTimer( pxService, pxTimer, xNextExpireTime, xTimeNow );
         }
         else
         {
@@ -746,16 +900,22 @@
         TickType_t xNextExpireTime;
         BaseType_t xListWasEmpty;
 
-        /* Just to avoid compiler warnings. */
-        ( void ) pvParameters;
+        /* MISRA Ref 11.5.5 [Void pointer assignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+        /* coverity[misra_c_2012_rule_11_5_violation] */
+        TimerService_t * const pxService = ( TimerService_t * ) pvParameters;
 
         #if ( configUSE_DAEMON_TASK_STARTUP_HOOK == 1 )
         {
             /* Allow the application writer to execute some code in the context of
              * this task at the point the task starts executing.  This is useful if the
              * application includes initialisation code that would benefit from
-             * executing after the scheduler has been started. */
-            vApplicationDaemonTaskStartupHook();
+             * executing after the scheduler has been started.  With a timer service
+             * task per core only the one of core 0 calls the hook. */
+            if( pxService == &( xTimerServices[ 0 ] ) )
+            {
+                vApplicationDaemonTaskStartupHook();
+            }
         }
         #endif /* configUSE_DAEMON_TASK_STARTUP_HOOK */
 
@@ -763,19 +923,20 @@
         {
             /* Query the timers list to see if it contains any timers, and if so,
              * obtain the time at which the next timer will expire. */
-            xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+            xNextExpireTime = prvGetNextExpireTime( pxService, &xListWasEmpty );
 
             /* If a timer has expired, process it.  Otherwise, block this task
              * until either a timer does expire, or a command is received. */
-            prvProcessTimerOrBlockTask( xNextExpireTime, xListWasEmpty );
+            prvProcessTimerOrBlockTask( pxService, xNextExpireTime, xListWasEmpty );
 
             /* Empty the command queue. */
-            prvProcessReceivedCommands();
+            prvProcessReceivedCommands( pxService );
         }
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+    static void prvProcessTimerOrBlockTask( TimerService_t * const pxService,
+                                            const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty )
     {
         TickType_t xTimeNow;
@@ -788,7 +949,7 @@
              * then don't process this timer as any timers that remained in the list
              * when the lists were switched will have been processed within the
              * prvSampleTimeNow() function. */
-            xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+            xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
 
             if( xTimerListsWereSwitched == pdFALSE )
             {
@@ -796,7 +957,7 @@
                 if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
                 {
                     ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                    prvProcessExpiredTimer( pxService, xNextExpireTime, xTimeNow );
                 }
                 else
                 {
@@ -810,10 +971,10 @@
                     {
                         /* The current timer list is empty - is the overflow list
                          * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        xListWasEmpty = listLIST_IS_EMPTY( pxService->pxOverflowTimerList );
                     }
 
-                    vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+                    vQueueWaitForMessageRestricted( pxService->xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
                     if( xTaskResumeAll() == pdFALSE )
                     {
@@ -837,7 +998,8 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
+    static TickType_t prvGetNextExpireTime( const TimerService_t * const pxService,
+                                            BaseType_t * const pxListWasEmpty )
     {
         TickType_t xNextExpireTime;
 
@@ -848,11 +1010,11 @@
          * this task to unblock when the tick count overflows, at which point the
          * timer lists will be switched and the next expiry time can be
          * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+        *pxListWasEmpty = listLIST_IS_EMPTY( pxService->pxCurrentTimerList );
 
         if( *pxListWasEmpty == pdFALSE )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentTimerList );
         }
         else
         {
@@ -864,16 +1026,16 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
+    static TickType_t prvSampleTimeNow( TimerService_t * const pxService,
+                                        BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
+        if( xTimeNow < pxService->xLastTime )
         {
-            prvSwitchTimerLists();
+            prvSwitchTimerLists( pxService );
             *pxTimerListsWereSwitched = pdTRUE;
         }
         else
@@ -881,13 +1043,14 @@
             *pxTimerListsWereSwitched = pdFALSE;
         }
 
-        xLastTime = xTimeNow;
+        pxService->xLastTime = xTimeNow;
 
         return xTimeNow;
     }
 /*-----------------------------------------------------------*/
 
-    static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+    static BaseType_t prvInsertTimerInActiveList( TimerService_t * const pxService,
+                                                  Timer_t * const pxTimer,
                                                   const TickType_t xNextExpiryTime,
                                                   const TickType_t xTimeNow,
                                                   const TickType_t xCommandTime )
@@ -909,7 +1072,7 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                vListInsert( pxService->pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
             }
         }
         else
@@ -923,7 +1086,7 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                vListInsert( pxService->pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
             }
         }
 
@@ -931,14 +1094,14 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessReceivedCommands( void )
+    static void prvProcessReceivedCommands( TimerService_t * const pxService )
     {
         DaemonTaskMessage_t xMessage = { 0 };
         Timer_t * pxTimer;
         BaseType_t xTimerListsWereSwitched;
         TickType_t xTimeNow;
 
-        while( xQueueReceive( xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL )
+        while( xQueueReceive( pxService->xTimerQueue, &xMessage, tmrNO_DELAY ) != pdFAIL )
         {
             #if ( INCLUDE_xTimerPendFunctionCall == 1 )
             {
@@ -990,7 +1153,7 @@
                      *  possibility of a higher priority task adding a message to the message
                      *  queue with a time that is ahead of the timer daemon task (because it
                      *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                    xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+                    xTimeNow = prvSampleTimeNow( pxService, &xTimerListsWereSwitched );
 
                     switch( xMessage.xMessageID )
                     {
@@ -1001,13 +1164,13 @@
                             /* Start or restart a timer. */
                             pxTimer->ucStatus |= ( uint8_t ) tmrSTATUS_IS_ACTIVE;
 
-                            if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
+                            if( prvInsertTimerInActiveList( pxService, pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
                             {
                                 /* The timer expired before it was added to the active
                                  * timer list.  Process it now. */
                                 if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0U )
                                 {
-                                    prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                                    prvReloadTimer( pxService, pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
                                 }
                                 else
                                 {
@@ -1043,7 +1206,7 @@
                              * be zero the next expiry time can only be in the future,
                              * meaning (unlike for the xTimerStart() case above) there is
                              * no fail case that needs to be handled here. */
-                            ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                            ( void ) prvInsertTimerInActiveList( pxService, pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
                             break;
 
                         case tmrCOMMAND_DELETE:
@@ -1086,7 +1249,7 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
+    static void prvSwitchTimerLists( TimerService_t * const pxService )
     {
         TickType_t xNextExpireTime;
         List_t * pxTemp;
@@ -1095,63 +1258,74 @@
          * If there are any timers still referenced from the current timer list
          * then they must have expired and should be processed before the lists
          * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+        while( listLIST_IS_EMPTY( pxService->pxCurrentTimerList ) == pdFALSE )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxService->pxCurrentTimerList );
 
             /* Process the expired timer.  For auto-reload timers, be careful to
              * process only expirations that occur on the current list.  Further
              * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            prvProcessExpiredTimer( pxService, xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
+        pxTemp = pxService->pxCurrentTimerList;
+        pxService->pxCurrentTimerList = pxService->pxOverflowTimerList;
+        pxService->pxOverflowTimerList = pxTemp;
     }
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
     {
+        TimerService_t * pxService;
+        UBaseType_t uxService;
+
         /* Check that the list from which active timers are referenced, and the
          * queue used to communicate with the timer service, have been
-         * initialised. */
+         * initialised.  The timer services are set up together, so the first
+         * one having a queue means they all have. */
         taskENTER_CRITICAL();
         {
-            if( xTimerQueue == NULL )
+            if( xTimerServices[ 0 ].xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
-
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
-                {
-                    /* The timer queue is allocated statically in case
+                    /* The timer queues are allocated statically in case
                      * configSUPPORT_DYNAMIC_ALLOCATION is 0. */
-                    PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue;
-                    PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ];
+                    PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueues[ tmrSERVICE_COUNT ];
+                    PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ tmrSERVICE_COUNT ][ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ];
+                #endif
 
-                    xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
-                }
-                #else
+                for( uxService = 0U; uxService < ( UBaseType_t ) tmrSERVICE_COUNT; uxService++ )
                 {
-                    xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ) );
-                }
-                #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+                    pxService = &( xTimerServices[ uxService ] );
 
-                #if ( configQUEUE_REGISTRY_SIZE > 0 )
-                {
-                    if( xTimerQueue != NULL )
+                    vListInitialise( &( pxService->xActiveTimerList1 ) );
+                    vListInitialise( &( pxService->xActiveTimerList2 ) );
+                    pxService->pxCurrentTimerList = &( pxService->xActiveTimerList1 );
+                    pxService->pxOverflowTimerList = &( pxService->xActiveTimerList2 );
+
+                    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                     {
-                        vQueueAddToRegistry( xTimerQueue, "TmrQ" );
+                        pxService->xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ uxService ][ 0 ] ), &( xStaticTimerQueues[ uxService ] ) );
                     }
-                    else
+                    #else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        pxService->xTimerQueue = xQueueCreate( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ) );
                     }
+                    #endif /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+
+                    #if ( configQUEUE_REGISTRY_SIZE > 0 )
+                    {
+                        if( pxService->xTimerQueue != NULL )
+                        {
+                            vQueueAddToRegistry( pxService->xTimerQueue, "TmrQ" );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif /* configQUEUE_REGISTRY_SIZE */
                 }
-                #endif /* configQUEUE_REGISTRY_SIZE */
             }
             else
             {
@@ -1244,13 +1418,14 @@
             traceENTER_xTimerPendFunctionCallFromISR( xFunctionToPend, pvParameter1, ulParameter2, pxHigherPriorityTaskWoken );
 
             /* Complete the message with the function parameters and post it to the
-             * daemon task. */
+             * daemon task - with a daemon task per core, the one of the core the
+             * interrupt is running on. */
             xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
             xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
             xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
             xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
 
-            xReturn = xQueueSendFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
+            xReturn = xQueueSendFromISR( tmrGET_CURRENT_SERVICE()->xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
 
             tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
             traceRETURN_xTimerPendFunctionCallFromISR( xReturn );
@@ -1271,6 +1446,10 @@
             DaemonTaskMessage_t xMessage;
             BaseType_t xReturn;
 
+            /* With a daemon task per core the function is pended to the one of
+             * the core the calling task is running on. */
+            const QueueHandle_t xTimerQueue = tmrGET_CURRENT_SERVICE()->xTimerQueue;
+
             traceENTER_xTimerPendFunctionCall( xFunctionToPend, pvParameter1, ulParameter2, xTicksToWait );
 
             /* This function can only be called after a timer has been created or
@@ -1332,8 +1511,13 @@
  */
     void vTimerResetState( void )
     {
-        xTimerQueue = NULL;
-        xTimerTaskHandle = NULL;
+        UBaseType_t uxService;
+
+        for( uxService = 0U; uxService < ( UBaseType_t ) tmrSERVICE_COUNT; uxService++ )
+        {
+            xTimerServices[ uxService ].xTimerQueue = NULL;
+            xTimerServices[ uxService ].xTimerTaskHandle = NULL;
+        }
     }
 /*-----------------------------------------------------------*/
 
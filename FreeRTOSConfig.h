@@ -17,10 +17,15 @@
 /* Scheduler and SMP related */
 #define configUSE_PREEMPTION             0 
 #define configUSE_TIME_SLICING           0
-#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0    /* ready priorities are kept in bit maps, found with clz ("make TASK_SELECTION=1") */
+#endif
 #define configUSE_IDLE_HOOK              0
 #define configUSE_PASSIVE_IDLE_HOOK      0
 #define configUSE_TICK_HOOK              1
+#ifndef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE          0    /* idle harts sleep in wfi, the tick stops when all are idle ("make TICKLESS=1") */
+#endif
 #define configCPU_CLOCK_HZ               ( ( uint32_t ) 50000000 )
 #define configTICK_RATE_HZ               ( ( TickType_t ) 100 )
 #define configMAX_PRIORITIES             ( 7 )
@@ -28,6 +33,9 @@
 #define configTOTAL_HEAP_SIZE            ( ( size_t ) ( 128 * 1024 ) )
 #define configMAX_TASK_NAME_LEN          ( 16 )
 #define configUSE_TRACE_FACILITY         0
+#ifndef configGENERATE_RUN_TIME_STATS
+#define configGENERATE_RUN_TIME_STATS    0    /* per-task and per-core run times, counted in mcycle ("make RUN_TIME_STATS=1") */
+#endif
 #define configUSE_16_BIT_TICKS           0
 #define configIDLE_SHOULD_YIELD          1    /* Enable yielding in idle task */
 
@@ -75,15 +83,85 @@
 /*-----------------------------------------------------------
  * SMP-specific configuration
  *----------------------------------------------------------*/
+#ifndef configNUMBER_OF_CORES
 #define configNUMBER_OF_CORES            4
+#endif
 #define configRUN_MULTIPLE_PRIORITIES    1    
 #define configUSE_CORE_AFFINITY          1
 #define configUSE_PASSIVE_IDLE_HOOK      0
 #define portSUPPORT_SMP                  1
 #define RTOS_LOCK_COUNT                  2
-#define portCRITICAL_NESTING_IN_TCB      1
+#define portCRITICAL_NESTING_IN_TCB      0    /* the nesting count lives in the per-hart CPU-local block */
+#ifndef configUSE_PER_OBJECT_LOCKS
+#define configUSE_PER_OBJECT_LOCKS       0    /* queues/semaphores/event groups get their own spinlock ("make PER_OBJECT_LOCKS=1") */
+#endif
+#ifndef configUSE_PER_CORE_READY_LISTS
+#define configUSE_PER_CORE_READY_LISTS   0    /* tasks pinned to one core use that core's own ready lists ("make PER_CORE_READY_LISTS=1") */
+#endif
+#ifndef configUSE_PER_CORE_TICKS
+#define configUSE_PER_CORE_TICKS         0    /* every hart has its own tick for the timeouts of its pinned tasks ("make PER_CORE_TICKS=1") */
+#endif
+#ifndef configUSE_RUNNING_CORE_MASKS
+#define configUSE_RUNNING_CORE_MASKS     0    /* idle and per-priority running core masks pick the core to preempt ("make RUNNING_CORE_MASKS=1") */
+#endif
+#ifndef configUSE_CACHE_AFFINITY_WAKEUP
+#define configUSE_CACHE_AFFINITY_WAKEUP  0    /* a woken task goes back to the core it last ran on if that core is free enough ("make CACHE_AFFINITY=1") */
+#endif
+#define configCACHE_AFFINITY_TOLERANCE   1    /* priority levels the last core may run above the best target and still be chosen */
+#ifndef configUSE_LOAD_BALANCER
+#define configUSE_LOAD_BALANCER          0    /* uxTaskBalanceLoad() pins migratable tasks to the least busy cores ("make LOAD_BALANCER=1") */
+#endif
+#ifndef configUSE_DELAY_WHEEL
+#define configUSE_DELAY_WHEEL            0    /* timeouts up to 1024 ticks ahead are kept in a timing wheel, not sorted lists ("make DELAY_WHEEL=1") */
+#endif
+#ifndef configUSE_PER_CORE_TIMER_TASKS
+#define configUSE_PER_CORE_TIMER_TASKS   0    /* every core runs its own timer service task and command queue ("make PER_CORE_TIMER_TASKS=1") */
+#endif
+#ifndef configUSE_QUEUE_ZERO_COPY
+#define configUSE_QUEUE_ZERO_COPY        0    /* xQueueClaim()/xQueueBorrow() let tasks fill in and read queue items in place ("make QUEUE_ZERO_COPY=1") */
+#endif
+#ifndef configUSE_QUEUE_BATCHING
+#define configUSE_QUEUE_BATCHING         0    /* xQueueSendMultiple()/xQueueReceiveMultiple() move many items per critical section ("make QUEUE_BATCHING=1") */
+#endif
+#ifndef configUSE_QUEUE_WORD_COPY
+#define configUSE_QUEUE_WORD_COPY        0    /* 4- and 8-byte queue items are copied with word loads/stores, not memcpy() ("make QUEUE_WORD_COPY=1") */
+#endif
+#ifndef configUSE_PRIORITY_QUEUES
+#define configUSE_PRIORITY_QUEUES        0    /* xQueueCreatePriority() queues are received from highest priority item first ("make PRIORITY_QUEUES=1") */
+#endif
+#ifndef configUSE_QUEUE_STATS
+#define configUSE_QUEUE_STATS            0    /* per-queue send/receive/block counts, blocked times and cross-core wakeups (vQueueGetStats()) ("make QUEUE_STATS=1") */
+#endif
+#ifndef configUSE_PORT_REMOTE_CALLS
+#define configUSE_PORT_REMOTE_CALLS      0    /* run short functions on other harts through their software interrupt ("make REMOTE_CALLS=1") */
+#endif
+#ifndef configUSE_MPMC_QUEUES
+#define configUSE_MPMC_QUEUES            0    /* lock-free multi-producer/multi-consumer queues (mpmc_queue.h) ("make MPMC_QUEUES=1") */
+#endif
 #define configISR_STACK_SIZE_WORDS       256
 
+/* Kernel spinlock implementation: portSPINLOCK_TYPE_TAS, _TICKET or _MCS
+ * (see portmacro.h).  Can also be selected with "make SPINLOCK=..." */
+#ifndef configPORT_SPINLOCK_TYPE
+#define configPORT_SPINLOCK_TYPE         0
+#endif
+
+/* Wait for contended kernel locks with interrupts enabled ("make LOCK_WAIT=1").
+ * A hart waiting that way leaves the ticket/MCS queue, so the locks are no
+ * longer handed over in FIFO order.  "make IRQ_OFF_STATS=1" records the
+ * longest interrupt-off section on every hart. */
+#ifndef configPORT_INTERRUPTIBLE_LOCK_WAIT
+#define configPORT_INTERRUPTIBLE_LOCK_WAIT 0
+#endif
+
+/* The FPU context is switched (lazily) only in the rv32imaf/rv32imafd builds,
+ * selected with "make FPU=f" or "make FPU=d". */
+#ifdef __riscv_flen
+#define configENABLE_FPU                 1
+#else
+#define configENABLE_FPU                 0
+#endif
+
 #define MALLOC_LOCK_ADDR  0x80000a00u
 #define PRINT_LOCK_ADDR  ( ( volatile uint32_t * ) 0x80000a04u )
 #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
@@ -158,6 +158,13 @@ void crt0(void)
     // asm volatile("lw  sp, %lo(stack_top)(t0)");
 #endif
 
+#ifdef __riscv_flen
+    // Turn the FPU on (mstatus.FS = Initial) for the code that runs before
+    // the scheduler starts.  Tasks carry their own FS state from then on.
+    asm volatile ("li t0, 0x2000");
+    asm volatile ("csrs mstatus, t0");
+#endif
+
     main();
 
 #if SET_STACK_POINTER
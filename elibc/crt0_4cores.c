@@ -34,6 +34,13 @@ void crt0(void)
     } else if (hart_id == 3) {
         asm volatile("la sp, __stack_top_3");
     }
+#ifdef __riscv_flen
+    // Turn the FPU on (mstatus.FS = Initial) for the code that runs before
+    // the scheduler starts.  Tasks carry their own FS state from then on.
+    asm volatile ("li t0, 0x2000");
+    asm volatile ("csrs mstatus, t0");
+#endif
+
     main();
 
     asm volatile ("la t0, sp_store");
@@ -1,5 +1,6 @@
 #include "FreeRTOS.h"
 #include "task.h"
+#include "atomic.h"
 #include "semphr.h"
 #include <stdint.h>
 #include <stdio.h>
@@ -38,10 +39,6 @@ static inline void unlock_print() {
 }
 
 
-static void atomic_or(volatile uint32_t *addr, int val) {
-    __asm__ volatile("amoor.w.aqrl zero, %1, %0" : "+A"(*addr) : "r"(val) : "memory");
-}
-
 
 void vWorkerTask() {
 
@@ -78,7 +75,7 @@ void vWorkerTask() {
         }
     }
 
-    atomic_or(&g_ulWorkersDoneMask, (1 << rtos_core_id_get()));
+    (void)Atomic_OR_u32(&g_ulWorkersDoneMask, 1U << rtos_core_id_get());
 
     while (g_ulStartRunFlag != 0) {
         __asm__ volatile("fence");
@@ -0,0 +1,415 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (configUSE_QUEUE_BATCHING != 1)
+#error rtos_run_batching needs configUSE_QUEUE_BATCHING
+#endif
+
+/*
+ * Functional test of batched queue sends and receives (configUSE_QUEUE_BATCHING).
+ *
+ * Items are numbered in the order they are sent, and every receive checks that
+ * it gets the next numbers in order.  The test task on core 0 runs these checks
+ * on a queue of QUEUE_LENGTH items:
+ * - FIFO order across the wrap: batches of a different size every round are
+ *   sent and received in batches of another size, mixed with single sends and
+ *   receives, so batches are split at every offset of the ring.  Each call
+ *   moves as many items as there are, or as there is room for.
+ * - Partial batches: a batch larger than the free space sends what fits and
+ *   returns the count, a full queue sends nothing and an empty one receives
+ *   nothing, and a receive larger than the queue returns what is there
+ *   without blocking.
+ * - Blocking: a batch send wakes one blocked receiver for every item, a
+ *   receiver blocked for a batch gets the items sent in one batch, and a
+ *   batch receive wakes a sender blocked on the full queue, which then sends
+ *   what fits.  The blocked tasks are helpers on the other cores.
+ * - The FromISR variants, called from the tick hook, including a batch sent
+ *   from the ISR that wakes a blocked receiver.
+ *
+ * Build with e.g. "make PROJ=rtos_run_batching NUM_CORES=4", 8 or 16, which
+ * switches batching on (QUEUE_BATCHING=1).
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TEST_PRIORITY           (tskIDLE_PRIORITY + 2)
+#define TEST_CORE               0
+#define NUM_HELPERS             2
+
+#define QUEUE_LENGTH            8u
+#define WRAP_ROUNDS             (4u * QUEUE_LENGTH)
+#define HELPER_TIMEOUT_TICKS    ((TickType_t)200)
+#define FULL_TIMEOUT_TICKS      ((TickType_t)5)
+#define WAIT_TICKS              ((TickType_t)300)
+
+enum { HELPER_RECEIVE = 1, HELPER_SEND };
+enum { ISR_NONE = 0, ISR_SEND, ISR_RECEIVE };
+
+typedef struct {
+    TaskHandle_t xTask;
+    volatile uint32_t ulCommand;
+    volatile uint32_t ulFirst;          /* First item to send. */
+    volatile uint32_t ulCount;          /* Items to send, or most items to receive. */
+    volatile uint32_t ulWaiting;
+    volatile uint32_t ulDone;
+    volatile UBaseType_t uxResult;      /* Items sent or received. */
+    uint32_t ulItems[QUEUE_LENGTH];
+} Helper_t;
+
+static QueueHandle_t xQueue;
+static Helper_t xHelpers[NUM_HELPERS];
+
+// Number of the next item to send, and of the next one expected out
+static uint32_t ulNextSend = 0;
+static uint32_t ulNextReceive = 0;
+
+static volatile uint32_t ulIsrCommand = ISR_NONE;
+static volatile uint32_t ulIsrCount;
+static volatile uint32_t ulIsrDone;
+static volatile UBaseType_t uxIsrResult;
+static uint32_t ulIsrItems[QUEUE_LENGTH];
+
+static volatile uint32_t ulChecks = 0;
+static volatile uint32_t ulErrors = 0;
+static volatile uint32_t ulFirstErrorLine = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+#define CHECK(x) check((x) ? 1 : 0, __LINE__)
+
+static void check(uint32_t ok, uint32_t line) {
+    ulChecks++;
+    if (!ok) {
+        if (ulErrors++ == 0) {
+            ulFirstErrorLine = line;
+        }
+    }
+}
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static void fill_items(uint32_t *pulItems, uint32_t first, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        pulItems[i] = first + i;
+    }
+}
+
+// Checks that count items received are the next ones expected
+static void check_received(const uint32_t *pulItems, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(pulItems[i] == ulNextReceive);
+        ulNextReceive++;
+    }
+}
+
+// Sends a batch of count items, which must all fit
+static void send_batch(uint32_t count) {
+    uint32_t ulItems[QUEUE_LENGTH];
+
+    fill_items(ulItems, ulNextSend, count);
+    CHECK(xQueueSendMultiple(xQueue, ulItems, count, 0) == count);
+    ulNextSend += count;
+}
+
+// Receives everything left in the queue
+static void drain(void) {
+    uint32_t ulItems[QUEUE_LENGTH];
+    UBaseType_t uxReceived = xQueueReceiveMultiple(xQueue, ulItems, QUEUE_LENGTH, 0);
+
+    check_received(ulItems, uxReceived);
+    CHECK(ulNextReceive == ulNextSend);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+// Runs a blocking call in a helper task and returns once it has blocked
+static void start_helper(Helper_t *pxHelper, uint32_t command, uint32_t first, uint32_t count) {
+    pxHelper->ulCommand = command;
+    pxHelper->ulFirst = first;
+    pxHelper->ulCount = count;
+    pxHelper->ulWaiting = 0;
+    pxHelper->ulDone = 0;
+    xTaskNotifyGive(pxHelper->xTask);
+
+    while ((pxHelper->ulWaiting == 0) || (eTaskGetState(pxHelper->xTask) != eBlocked)) {
+        vTaskDelay(1);
+    }
+    // Still blocked, so the queue really held the helper off
+    CHECK(Atomic_Load_u32_Acquire(&pxHelper->ulDone) == 0);
+}
+
+static UBaseType_t wait_helper(Helper_t *pxHelper) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    while ((Atomic_Load_u32_Acquire(&pxHelper->ulDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(pxHelper->ulDone != 0);
+    return pxHelper->uxResult;
+}
+
+// Has the tick hook run command on count items and returns its result
+static UBaseType_t run_isr(uint32_t command, uint32_t count) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    ulIsrCount = count;
+    ulIsrDone = 0;
+    Atomic_Store_u32_Release(&ulIsrCommand, command);
+
+    while ((Atomic_Load_u32_Acquire(&ulIsrDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(ulIsrDone != 0);
+    return uxIsrResult;
+}
+
+static void test_fifo_across_wrap(void) {
+    uint32_t ulItems[QUEUE_LENGTH];
+    uint32_t ulItem;
+    UBaseType_t uxWaiting, uxExpected, uxMoved;
+
+    for (uint32_t round = 0; round < WRAP_ROUNDS; round++) {
+        uint32_t send = 1u + ((round * 5u) % QUEUE_LENGTH);
+        uint32_t receive = 1u + ((round * 3u) % QUEUE_LENGTH);
+
+        // Sends what fits of the batch
+        uxWaiting = uxQueueMessagesWaiting(xQueue);
+        uxExpected = (send < QUEUE_LENGTH - uxWaiting) ? send : QUEUE_LENGTH - uxWaiting;
+        fill_items(ulItems, ulNextSend, send);
+        uxMoved = xQueueSendMultiple(xQueue, ulItems, send, 0);
+        CHECK(uxMoved == uxExpected);
+        ulNextSend += uxMoved;
+
+        // Receives what there is, up to the batch size
+        uxWaiting = uxQueueMessagesWaiting(xQueue);
+        uxExpected = (receive < uxWaiting) ? receive : uxWaiting;
+        uxMoved = xQueueReceiveMultiple(xQueue, ulItems, receive, 0);
+        CHECK(uxMoved == uxExpected);
+        check_received(ulItems, uxMoved);
+
+        // Single sends and receives keep their place among the batches
+        if ((round % 3u) == 0) {
+            ulItem = ulNextSend;
+            if (xQueueSend(xQueue, &ulItem, 0) == pdPASS) {
+                ulNextSend++;
+            }
+            if (xQueueReceive(xQueue, &ulItem, 0) == pdPASS) {
+                check_received(&ulItem, 1);
+            }
+        }
+    }
+
+    drain();
+}
+
+static void test_partial_batches(void) {
+    uint32_t ulItems[2 * QUEUE_LENGTH];
+    TickType_t xStart;
+
+    // A batch larger than the free space sends what fits
+    send_batch(QUEUE_LENGTH - 3);
+    fill_items(ulItems, ulNextSend, 5);
+    CHECK(xQueueSendMultiple(xQueue, ulItems, 5, 0) == 3);
+    ulNextSend += 3;
+    CHECK(uxQueueMessagesWaiting(xQueue) == QUEUE_LENGTH);
+
+    // A full queue sends nothing, after blocking for the timeout
+    CHECK(xQueueSendMultiple(xQueue, ulItems, 2, 0) == 0);
+    xStart = xTaskGetTickCount();
+    CHECK(xQueueSendMultiple(xQueue, ulItems, 2, FULL_TIMEOUT_TICKS) == 0);
+    CHECK((xTaskGetTickCount() - xStart) >= FULL_TIMEOUT_TICKS);
+
+    // A receive larger than the queue gets what is there, without blocking
+    xStart = xTaskGetTickCount();
+    CHECK(xQueueReceiveMultiple(xQueue, ulItems, 2 * QUEUE_LENGTH, HELPER_TIMEOUT_TICKS) == QUEUE_LENGTH);
+    CHECK((xTaskGetTickCount() - xStart) < HELPER_TIMEOUT_TICKS);
+    check_received(ulItems, QUEUE_LENGTH);
+
+    // An empty queue receives nothing
+    CHECK(xQueueReceiveMultiple(xQueue, ulItems, 2, 0) == 0);
+    xStart = xTaskGetTickCount();
+    CHECK(xQueueReceiveMultiple(xQueue, ulItems, 2, FULL_TIMEOUT_TICKS) == 0);
+    CHECK((xTaskGetTickCount() - xStart) >= FULL_TIMEOUT_TICKS);
+}
+
+static void test_blocking(void) {
+    Helper_t *pxA = &xHelpers[0];
+    Helper_t *pxB = &xHelpers[1];
+    uint32_t ulItems[2];
+    UBaseType_t uxMoved;
+    uint32_t first;
+
+    // One batch of two items wakes two receivers waiting for one item each
+    start_helper(pxA, HELPER_RECEIVE, 0, 1);
+    start_helper(pxB, HELPER_RECEIVE, 0, 1);
+    first = ulNextSend;
+    send_batch(2);
+    CHECK(wait_helper(pxA) == 1);
+    CHECK(wait_helper(pxB) == 1);
+    CHECK(((pxA->ulItems[0] == first) && (pxB->ulItems[0] == first + 1)) ||
+          ((pxA->ulItems[0] == first + 1) && (pxB->ulItems[0] == first)));
+    ulNextReceive += 2;
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+
+    // A receiver blocked for a batch gets the front of the batch sent
+    start_helper(pxA, HELPER_RECEIVE, 0, QUEUE_LENGTH);
+    send_batch(5);
+    uxMoved = wait_helper(pxA);
+    CHECK((uxMoved >= 1) && (uxMoved <= 5));
+    check_received(pxA->ulItems, uxMoved);
+    drain();
+
+    // A batch receive wakes a sender blocked on the full queue
+    send_batch(QUEUE_LENGTH);
+    start_helper(pxA, HELPER_SEND, ulNextSend, 3);
+    CHECK(xQueueReceiveMultiple(xQueue, ulItems, 2, 0) == 2);
+    check_received(ulItems, 2);
+    CHECK(wait_helper(pxA) == 2);
+    ulNextSend += 2;
+    drain();
+}
+
+static void test_from_isr(void) {
+    uint32_t ulItems[QUEUE_LENGTH];
+    UBaseType_t uxMoved;
+
+    // Batch send in the ISR: what fits goes in
+    send_batch(QUEUE_LENGTH - 2);
+    fill_items(ulIsrItems, ulNextSend, 5);
+    CHECK(run_isr(ISR_SEND, 5) == 2);
+    ulNextSend += 2;
+    CHECK(run_isr(ISR_SEND, 1) == 0);
+
+    // Batch receive in the ISR
+    CHECK(run_isr(ISR_RECEIVE, 3) == 3);
+    check_received(ulIsrItems, 3);
+    uxMoved = xQueueReceiveMultiple(xQueue, ulItems, QUEUE_LENGTH, 0);
+    CHECK(uxMoved == QUEUE_LENGTH - 3);
+    check_received(ulItems, uxMoved);
+    CHECK(run_isr(ISR_RECEIVE, 3) == 0);
+
+    // A batch sent from the ISR wakes a blocked receiver
+    start_helper(&xHelpers[0], HELPER_RECEIVE, 0, QUEUE_LENGTH);
+    fill_items(ulIsrItems, ulNextSend, 3);
+    CHECK(run_isr(ISR_SEND, 3) == 3);
+    ulNextSend += 3;
+    uxMoved = wait_helper(&xHelpers[0]);
+    CHECK(uxMoved >= 1);
+    check_received(xHelpers[0].ulItems, uxMoved);
+    drain();
+}
+
+void vHelperTask(void *pvParameters) {
+    Helper_t *pxHelper = (Helper_t *)pvParameters;
+    UBaseType_t uxResult;
+
+    for(;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        pxHelper->ulWaiting = 1;
+
+        if (pxHelper->ulCommand == HELPER_RECEIVE) {
+            uxResult = xQueueReceiveMultiple(xQueue, pxHelper->ulItems, pxHelper->ulCount, HELPER_TIMEOUT_TICKS);
+        } else {
+            fill_items(pxHelper->ulItems, pxHelper->ulFirst, pxHelper->ulCount);
+            uxResult = xQueueSendMultiple(xQueue, pxHelper->ulItems, pxHelper->ulCount, HELPER_TIMEOUT_TICKS);
+        }
+
+        pxHelper->uxResult = uxResult;
+        Atomic_Store_u32_Release(&pxHelper->ulDone, 1);
+    }
+}
+
+void vTestTask(void *pvParameters) {
+    (void)pvParameters;
+
+    test_fifo_across_wrap();
+    test_partial_batches();
+    test_blocking();
+    test_from_isr();
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[Batching] %lu items, %lu checks, %lu errors", ulNextSend, ulChecks, ulErrors);
+    if (ulErrors != 0) {
+        printf(" (first at line %lu)", ulFirstErrorLine);
+    }
+    printf(": %s\n", ulErrors == 0 ? "PASSED" : "FAILED");
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == TEST_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xQueue = xQueueCreate(QUEUE_LENGTH, sizeof(uint32_t));
+
+        xTaskCreateAffinitySet(vTestTask, "Test", TASK_STACK_SIZE, NULL, TEST_PRIORITY, (1 << TEST_CORE), NULL);
+        for (uint32_t i = 0; i < NUM_HELPERS; i++) {
+            xTaskCreateAffinitySet(vHelperTask, "Helper", TASK_STACK_SIZE, &xHelpers[i], TEST_PRIORITY,
+                                   (1 << ((i + 1) % configNUMBER_OF_CORES)), &xHelpers[i].xTask);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+
+// Runs the FromISR variants requested by run_isr() in interrupt context
+void vApplicationTickHook(void) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t command = Atomic_Swap_u32(&ulIsrCommand, ISR_NONE);
+
+    switch (command) {
+    case ISR_SEND:
+        uxIsrResult = xQueueSendMultipleFromISR(xQueue, ulIsrItems, ulIsrCount, &xHigherPriorityTaskWoken);
+        break;
+    case ISR_RECEIVE:
+        uxIsrResult = xQueueReceiveMultipleFromISR(xQueue, ulIsrItems, ulIsrCount, &xHigherPriorityTaskWoken);
+        break;
+    default:
+        return;
+    }
+
+    // Scheduling is cooperative, so a woken task runs when its core next yields
+    (void)xHigherPriorityTaskWoken;
+    Atomic_Store_u32_Release(&ulIsrDone, 1);
+}
@@ -0,0 +1,224 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Wakeup placement with and without cache affinity hints.
+ *
+ * PAIR_NUM producer/consumer pairs, one task per core in total, none of them
+ * pinned.  The two tasks of a pair hand a token back and forth with direct
+ * task notifications, so every round trip blocks and wakes both of them.  Each
+ * time a task runs it first walks its own WORKING_SET_WORDS word working set,
+ * which is only still in the cache if the task was woken on the core it last
+ * ran on.  The run is done twice for BENCH_WINDOW_CYCLES cycles, first with
+ * the hint off for every task (vTaskSetCacheAffinityHint(NULL, pdFALSE)), so
+ * a woken task goes wherever prvYieldForTask() finds the lowest priority
+ * work, and then with the hint on.
+ *
+ * Build with e.g. "make PROJ=rtos_run_cacheaffinity NUM_CORES=4", 8 or 16.
+ */
+
+#if (configUSE_CACHE_AFFINITY_WAKEUP != 1)
+#error rtos_run_cacheaffinity needs configUSE_CACHE_AFFINITY_WAKEUP
+#endif
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define PAIR_NUM                (CORE_NUM / 2)
+#define TASK_NUM                (PAIR_NUM * 2)
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_TASK        0
+
+#define BENCH_WINDOW_CYCLES     5000000u
+#define WORKING_SET_WORDS       1024
+
+enum { MODE_NO_HINT, MODE_HINT, MODE_NUM };
+
+static const char *const pcModeNames[] = { "no hint", "hint   " };
+
+typedef struct
+{
+    uint32_t ulWords[WORKING_SET_WORDS];
+} portCACHE_LINE_ALIGNED WorkingSet_t;
+
+typedef struct
+{
+    TaskHandle_t xTasks[2];
+    volatile uint32_t ulStop;
+    uint32_t ulRoundTrips[MODE_NUM];
+    uint32_t ulCycles[MODE_NUM];
+} portCACHE_LINE_ALIGNED PairStats_t;
+
+static WorkingSet_t xWorkingSets[TASK_NUM];
+static PairStats_t xPairs[PAIR_NUM];
+static TaskMigrationStats_t xModeStats[MODE_NUM];
+static volatile uint32_t ulSink;
+
+volatile uint32_t g_ulStartCount[MODE_NUM] = {0};
+volatile uint32_t g_ulDoneCount[MODE_NUM] = {0};
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+// Read-modify-write the whole working set, a stand-in for the task's real work
+static void touch_working_set(WorkingSet_t *pxSet) {
+    uint32_t ulSum = 0;
+
+    for (int i = 0; i < WORKING_SET_WORDS; i++) {
+        ulSum += pxSet->ulWords[i];
+        pxSet->ulWords[i] = ulSum;
+    }
+    ulSink = ulSum;
+}
+
+static void barrier(volatile uint32_t *pulCount) {
+    (void)Atomic_Increment_u32(pulCount);
+    while (*pulCount < TASK_NUM) {
+        taskYIELD();
+    }
+}
+
+void vPairTask(void *pvParameters) {
+    int task = (int)(uintptr_t)pvParameters;
+    int producer = (task % 2) == 0;
+    PairStats_t *pxPair = &xPairs[task / 2];
+    TaskHandle_t xPartner = pxPair->xTasks[producer ? 1 : 0];
+    WorkingSet_t *pxSet = &xWorkingSets[task];
+
+    for (int mode = 0; mode < MODE_NUM; mode++) {
+        uint32_t ulRoundTrips = 0;
+
+        vTaskSetCacheAffinityHint(NULL, (mode == MODE_HINT) ? pdTRUE : pdFALSE);
+        if (task == COORDINATOR_TASK) {
+            vTaskResetMigrationStats();
+        }
+        barrier(&g_ulStartCount[mode]);
+
+        uint32_t ulStart = read_mcycle();
+
+        if (producer) {
+            // The producer times the window and tells the consumer to stop with the last token
+            for (;;) {
+                touch_working_set(pxSet);
+                if (read_mcycle() - ulStart >= BENCH_WINDOW_CYCLES) {
+                    pxPair->ulStop = 1;
+                }
+                xTaskNotifyGive(xPartner);
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                ulRoundTrips++;
+                if (pxPair->ulStop) {
+                    break;
+                }
+            }
+            pxPair->ulRoundTrips[mode] = ulRoundTrips;
+            pxPair->ulCycles[mode] = read_mcycle() - ulStart;
+        } else {
+            for (;;) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                touch_working_set(pxSet);
+                int stop = pxPair->ulStop;
+                xTaskNotifyGive(xPartner);
+                if (stop) {
+                    break;
+                }
+            }
+        }
+
+        // All tasks are spinning in the barrier here, so no wakeup is left to count
+        barrier(&g_ulDoneCount[mode]);
+        if (task == COORDINATOR_TASK) {
+            vTaskGetMigrationStats(&xModeStats[mode]);
+        }
+        if (producer) {
+            pxPair->ulStop = 0;
+        }
+    }
+
+    if (task == COORDINATOR_TASK) {
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[CacheAffinity] %d pairs, %d word working set per task, tolerance %d\n", PAIR_NUM,
+               WORKING_SET_WORDS, configCACHE_AFFINITY_TOLERANCE);
+        for (int mode = 0; mode < MODE_NUM; mode++) {
+            uint32_t ulRoundTrips = 0, ulCycles = 0;
+
+            for (int i = 0; i < PAIR_NUM; i++) {
+                ulRoundTrips += xPairs[i].ulRoundTrips[mode];
+                if (xPairs[i].ulCycles[mode] > ulCycles) {
+                    ulCycles = xPairs[i].ulCycles[mode];
+                }
+            }
+            printf("  %s: %7u round trips, %6u per Mcycle, %7u migrations, wakeups %7u last core / %7u other\n",
+                   pcModeNames[mode], ulRoundTrips,
+                   ulCycles ? (uint32_t)(((uint64_t)ulRoundTrips * 1000000u) / ulCycles) : 0,
+                   xModeStats[mode].ulMigrations, xModeStats[mode].ulLastCoreWakeups,
+                   xModeStats[mode].ulOtherCoreWakeups);
+        }
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == 0) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        // No affinity, so the scheduler is free to move every task. Nothing runs before the
+        // scheduler starts, so both handles of a pair are known when its tasks first run.
+        for (int i = 0; i < TASK_NUM; i++) {
+            xTaskCreate(vPairTask, NULL, TASK_STACK_SIZE, (void *)(uintptr_t)i, TASK_PRIORITY,
+                        &xPairs[i / 2].xTasks[i % 2]);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
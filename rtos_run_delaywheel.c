@@ -0,0 +1,228 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Wake times of delays kept in the timing wheel (configUSE_DELAY_WHEEL).
+ *
+ * The wheel has configDELAY_WHEEL_LEVELS levels of 32 slots, so with the
+ * default two levels the first level turns over every 32 ticks and the whole
+ * wheel covers 1024 ticks.  Every worker task delays by one of the lengths
+ * below with vTaskDelayUntil() and checks that it wakes on the tick it asked
+ * for.  The lengths sit on both sides of the level 0 turn (32 ticks), span
+ * several turns of level 0 and end past the whole wheel, where the delay goes
+ * to the sorted delayed list instead.  The workers are spread over the cores
+ * and all wait at the same time, so the wheel holds tasks in many slots and
+ * on both levels at once.
+ *
+ * A canceller task then blocks with a timeout, is woken early by a
+ * notification, and blocks again for a different length.  The slot of the
+ * first timeout is left marked as occupied when the task leaves it early, so
+ * this checks that the stale slot neither wakes the task early nor loses it.
+ *
+ * A task may run up to LATE_TICKS after its wake tick, when its core is busy
+ * with the tick or another task; waking before it is always an error.
+ *
+ * Build with e.g. "make PROJ=rtos_run_delaywheel NUM_CORES=4", 8 or 16,
+ * which keeps near timeouts in the wheel (DELAY_WHEEL=1).
+ * "DELAY_WHEEL=0" runs the same checks against the sorted delayed lists.
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define WORKER_PRIORITY         (tskIDLE_PRIORITY + 2)
+#define COORDINATOR_PRIORITY    (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define ROUNDS                  2u
+#define LATE_TICKS              ((TickType_t)1)
+
+static const TickType_t xDelays[] = {
+    1, 2, 31, 32, 33, 63, 64, 65, 100, 500, 1023, 1024, 1025, 1100
+};
+#define NUM_DELAYS              (sizeof(xDelays) / sizeof(xDelays[0]))
+
+#define CANCEL_TIMEOUT          ((TickType_t)40)
+#define CANCEL_AFTER            ((TickType_t)10)
+#define CANCEL_REDELAY          ((TickType_t)50)
+
+#define DEADLINE_TICKS          ((TickType_t)(ROUNDS * 1100u + 500u))
+
+typedef struct {
+    volatile uint32_t ulRounds;
+    volatile uint32_t ulEarly;
+    volatile uint32_t ulLate;
+    volatile uint32_t ulMaxLate;
+} WorkerResult_t;
+
+static WorkerResult_t xResults[NUM_DELAYS];
+static TaskHandle_t xCancelTask;
+
+static volatile uint32_t ulCancelRounds = 0;
+static volatile uint32_t ulCancelErrors = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+// Records how far the wake-up at xNow was from xWake
+static void record_wake(WorkerResult_t *pxResult, TickType_t xWake, TickType_t xNow) {
+    TickType_t xLate = xNow - xWake;
+
+    if (xLate > (portMAX_DELAY / 2)) {
+        pxResult->ulEarly++;
+        return;
+    }
+    if (xLate > LATE_TICKS) {
+        pxResult->ulLate++;
+    }
+    if (xLate > pxResult->ulMaxLate) {
+        pxResult->ulMaxLate = xLate;
+    }
+}
+
+void vWorkerTask(void *pvParameters) {
+    uint32_t index = (uint32_t)(uintptr_t)pvParameters;
+    WorkerResult_t *pxResult = &xResults[index];
+    TickType_t xWake;
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        xWake = xTaskGetTickCount();
+        vTaskDelayUntil(&xWake, xDelays[index]);
+        record_wake(pxResult, xWake, xTaskGetTickCount());
+        pxResult->ulRounds = round + 1;
+    }
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+void vCancelTask(void *pvParameters) {
+    TickType_t xStart, xWake;
+    (void)pvParameters;
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        xStart = xTaskGetTickCount();
+
+        // The coordinator notifies us well before the timeout
+        if (ulTaskNotifyTake(pdTRUE, CANCEL_TIMEOUT) == 0) {
+            ulCancelErrors++;
+        }
+        if ((xTaskGetTickCount() - xStart) >= CANCEL_TIMEOUT) {
+            ulCancelErrors++;
+        }
+
+        // Block again across the tick the first timeout would have expired on
+        xWake = xTaskGetTickCount();
+        vTaskDelayUntil(&xWake, CANCEL_REDELAY);
+        if ((xTaskGetTickCount() - xWake) > LATE_TICKS) {
+            // Woken late, or early (which wraps around to a large difference)
+            ulCancelErrors++;
+        }
+
+        ulCancelRounds = round + 1;
+    }
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+static uint32_t all_done(void) {
+    for (uint32_t i = 0; i < NUM_DELAYS; i++) {
+        if (xResults[i].ulRounds < ROUNDS) {
+            return 0;
+        }
+    }
+    return ulCancelRounds == ROUNDS;
+}
+
+void vCoordinatorTask(void *pvParameters) {
+    TickType_t xStart = xTaskGetTickCount();
+    uint32_t errors = 0;
+    (void)pvParameters;
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        vTaskDelay(CANCEL_AFTER);
+        xTaskNotifyGive(xCancelTask);
+        while (ulCancelRounds <= round && (xTaskGetTickCount() - xStart) < DEADLINE_TICKS) {
+            vTaskDelay(1);
+        }
+    }
+
+    while (!all_done() && (xTaskGetTickCount() - xStart) < DEADLINE_TICKS) {
+        vTaskDelay(10);
+    }
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[DelayWheel] wheel %s, %u rounds\n", configUSE_DELAY_WHEEL ? "on" : "off", ROUNDS);
+    for (uint32_t i = 0; i < NUM_DELAYS; i++) {
+        printf("  delay %4lu ticks: %lu rounds, %lu early, %lu late, max %lu ticks late\n",
+               (uint32_t)xDelays[i], xResults[i].ulRounds, xResults[i].ulEarly,
+               xResults[i].ulLate, xResults[i].ulMaxLate);
+        errors += (xResults[i].ulRounds < ROUNDS) + xResults[i].ulEarly + xResults[i].ulLate;
+    }
+    printf("  cancelled timeout: %lu rounds, %lu errors\n", ulCancelRounds, ulCancelErrors);
+    errors += (ulCancelRounds < ROUNDS) + ulCancelErrors;
+    printf("[DelayWheel] %s\n", errors == 0 ? "PASSED" : (all_done() ? "FAILED" : "FAILED (stalled)"));
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (uint32_t i = 0; i < NUM_DELAYS; i++) {
+            xTaskCreateAffinitySet(vWorkerTask, "Worker", TASK_STACK_SIZE, (void *)(uintptr_t)i, WORKER_PRIORITY,
+                                   (1 << ((i + 1) % configNUMBER_OF_CORES)), NULL);
+        }
+        xTaskCreateAffinitySet(vCancelTask, "Cancel", TASK_STACK_SIZE, NULL, WORKER_PRIORITY,
+                               (1 << (1 % configNUMBER_OF_CORES)), &xCancelTask);
+        xTaskCreateAffinitySet(vCoordinatorTask, "Coordinator", TASK_STACK_SIZE, NULL, COORDINATOR_PRIORITY,
+                               (1 << COORDINATOR_CORE), NULL);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -0,0 +1,195 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Context switch cost for integer-only and FP task mixes.
+ *
+ * Two tasks of the same priority are pinned to every core and hand the core
+ * back and forth with taskYIELD() for BENCH_WINDOW_CYCLES cycles.  The mix on
+ * a core depends on core % 3:
+ *   0 - int/int : neither task touches the FPU
+ *   1 - fp/fp   : both tasks use the FPU between every yield
+ *   2 - int/fp  : only one of the tasks uses the FPU
+ * With the lazy FPU switching of the rv32imaf/rv32imafd port the int/int and
+ * int/fp cores should cost about the same per switch, since the FP registers
+ * are only saved/restored when ownership actually changes.  The FP tasks keep
+ * a running sum in the FPU across every yield and check it, so a corrupted FP context
+ * shows up as an error count.
+ *
+ * Build with e.g. "make PROJ=rtos_run_fpuswitch NUM_CORES=4 FPU=f".  Without
+ * FPU=... the FP tasks fall back to soft-float and the mixes are identical.
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define BENCH_WINDOW_CYCLES     5000000u
+
+enum { MIX_INT_INT, MIX_FP_FP, MIX_INT_FP };
+
+static const char *const pcMixNames[] = { "int/int", "fp/fp  ", "int/fp " };
+
+typedef struct
+{
+    uint32_t ulSwitches;
+    uint32_t ulCycles;
+    uint32_t ulFPErrors;
+    volatile uint32_t ulStopped;
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[CORE_NUM];
+
+volatile uint32_t g_ulStartCount = 0;
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static int core_mix(int core_id) {
+    return core_id % 3;
+}
+
+// The FP task of a pair (the second one on int/fp cores, both on fp/fp cores)
+static int uses_fpu(int core_id, int task) {
+    int mix = core_mix(core_id);
+    return (mix == MIX_FP_FP) || (mix == MIX_INT_FP && task == 1);
+}
+
+void vSwitchTask(void *pvParameters) {
+    int task = (int)(uintptr_t)pvParameters;
+    int core_id = rtos_core_id_get();
+    CoreStats_t *pxStats = &xStats[core_id];
+    int fp = uses_fpu(core_id, task);
+    float fStep = (float)(core_id + 1) * (task ? 0.5f : 1.0f);
+    float fAcc = 0.0f;
+    uint32_t ulSwitches = 0, ulErrors = 0, ulExpected = 0;
+
+    // Start barrier
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulStartCount < CORE_NUM * 2) {}
+
+    uint32_t ulStart = read_mcycle();
+    uint32_t ulElapsed = 0;
+
+    // Task 0 of every core times the window and stops its partner
+    while (!pxStats->ulStopped) {
+        if (fp) {
+            // Exact in single precision as long as the sum stays below 2^24
+            fAcc += fStep;
+            ulExpected++;
+            if (fAcc != fStep * (float)ulExpected) {
+                ulErrors++;
+                fAcc = fStep * (float)ulExpected;
+            }
+        }
+        taskYIELD();
+        ulSwitches++;
+
+        if (task == 0) {
+            ulElapsed = read_mcycle() - ulStart;
+            if (ulElapsed >= BENCH_WINDOW_CYCLES) {
+                pxStats->ulStopped = 1;
+            }
+        }
+    }
+
+    (void)Atomic_Add_u32(&pxStats->ulSwitches, ulSwitches);
+    (void)Atomic_Add_u32(&pxStats->ulFPErrors, ulErrors);
+    if (task == 0) {
+        pxStats->ulCycles = ulElapsed;
+    }
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE && task == 0) {
+        // Keep yielding so the partner on this core can publish its counts
+        while (g_ulDoneCount < CORE_NUM * 2) {
+            taskYIELD();
+        }
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[FPUSwitch] %d cores, FPU context %s\n", CORE_NUM, configENABLE_FPU ? "lazy" : "off (soft-float)");
+        for (int i = 0; i < CORE_NUM; i++) {
+            printf("  core %2d %s: %8u switches, %5u cycles each, %u FP errors\n", i, pcMixNames[core_mix(i)],
+                   xStats[i].ulSwitches, xStats[i].ulSwitches ? xStats[i].ulCycles / xStats[i].ulSwitches : 0,
+                   xStats[i].ulFPErrors);
+        }
+#if (configPORT_TRAP_CYCLE_STATS == 1)
+        // Built with TRAP_STATS=1: trap entry/exit cost from the CPU-local block
+        for (int i = 0; i < CORE_NUM; i++) {
+            uint32_t ulTraps = xPortCpuLocal[i].uxTraps;
+            printf("  core %2d traps: %8u (%u fast), entry %4u, exit %4u cycles each\n", i, ulTraps,
+                   xPortCpuLocal[i].uxTrapFastReturns,
+                   ulTraps ? xPortCpuLocal[i].uxTrapEntryCycles / ulTraps : 0,
+                   ulTraps ? xPortCpuLocal[i].uxTrapExitCycles / ulTraps : 0);
+        }
+#endif
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vSwitchTask, NULL, TASK_STACK_SIZE, (void *)0, TASK_PRIORITY, (1 << i), NULL);
+            xTaskCreateAffinitySet(vSwitchTask, NULL, TASK_STACK_SIZE, (void *)1, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -4,6 +4,7 @@
 #include <string.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "atomic.h"
 
 // Precision to use for calculations
 #define fptype float
@@ -45,10 +46,6 @@ static inline void unlock_print() {
     __asm__ volatile("amoswap.w.rl zero, zero, %0" : : "A"(*PRINT_LOCK_ADDR) : "memory");
 }
 
-static void atomic_or(volatile uint32_t *addr, int val) {
-    __asm__ volatile("amoor.w.aqrl zero, %1, %0" : "+A"(*addr) : "r"(val) : "memory");
-}
-
 /* --- HJM Core Calculation Functions (Unchanged) --- */
 fptype RanUnif(long* s) {
     long i = (long)(*s);
@@ -145,7 +142,7 @@ void vWorkerTask(void *pvParameters) {
     unlock_print();
     
     // Signal completion to coordinator
-    atomic_or(&g_ulWorkersDoneMask, (1 << uxCoreID));
+    (void)Atomic_OR_u32(&g_ulWorkersDoneMask, 1U << uxCoreID);
 
     vTaskDelete(NULL); // Task is done, delete self.
 }
@@ -0,0 +1,194 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Cost of an interrupt that does not switch tasks.
+ *
+ * A worker task on every core but the coordinator's counts spin loop
+ * iterations for BENCH_WINDOW_CYCLES cycles, twice: once undisturbed and once
+ * while the sender task on the coordinator core posts an asynchronous remote
+ * call to all of them every SEND_GAP_CYCLES cycles.  The call only counts
+ * itself and never asks for a switch, so every software interrupt takes the
+ * port's fast return path.  The iterations lost in the second window, divided
+ * by the interrupts taken, give the full cost of one such interrupt as seen
+ * by the interrupted task (trap entry, handler and exit).
+ *
+ * Build with e.g. "make PROJ=rtos_run_irqoverhead NUM_CORES=16", and add
+ * TRAP_STATS=1 to also get the entry/exit split from the port's counters.
+ */
+
+#if (configUSE_PORT_REMOTE_CALLS != 1)
+#error rtos_run_irqoverhead needs configUSE_PORT_REMOTE_CALLS
+#endif
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define WORKER_NUM              (CORE_NUM - 1)
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define BENCH_WINDOW_CYCLES     5000000u
+#define SEND_GAP_CYCLES         20000u
+
+typedef struct
+{
+    uint32_t ulQuietIterations;
+    uint32_t ulLoadedIterations;
+    volatile uint32_t ulCalls;      /* remote calls run on the core */
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[CORE_NUM];
+
+volatile uint32_t g_ulStartCount = 0;
+volatile uint32_t g_ulQuietDoneCount = 0;
+volatile uint32_t g_ulDoneCount = 0;
+volatile uint32_t g_ulLoaded = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static BaseType_t count_call(void *pvParameter) {
+    (void)pvParameter;
+    xStats[rtos_core_id_get()].ulCalls++;
+    return pdFALSE;
+}
+
+static uint32_t count_iterations(void) {
+    volatile uint32_t ulIterations = 0;
+    uint32_t ulStart = read_mcycle();
+
+    while ((read_mcycle() - ulStart) < BENCH_WINDOW_CYCLES) {
+        ulIterations++;
+    }
+    return ulIterations;
+}
+
+void vWorkerTask(void *pvParameters) {
+    CoreStats_t *pxStats = &xStats[rtos_core_id_get()];
+    (void)pvParameters;
+
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulStartCount < WORKER_NUM + 1) {}
+
+    pxStats->ulQuietIterations = count_iterations();
+    (void)Atomic_Increment_u32(&g_ulQuietDoneCount);
+
+    while (!g_ulLoaded) {}
+    pxStats->ulLoadedIterations = count_iterations();
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    for(;;){}
+}
+
+void vSenderTask(void *pvParameters) {
+    UBaseType_t uxWorkers = ((1U << CORE_NUM) - 1U) & ~(1U << COORDINATOR_CORE);
+    uint32_t ulSent = 0, ulDropped = 0;
+    (void)pvParameters;
+
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulQuietDoneCount < WORKER_NUM) {}
+
+    g_ulLoaded = 1;
+    while (g_ulDoneCount < WORKER_NUM) {
+        uint32_t ulStart = read_mcycle();
+
+        if (xPortRemoteCallAsync(uxWorkers, count_call, NULL, NULL) == pdPASS) {
+            ulSent++;
+        } else {
+            ulDropped++;
+        }
+        while ((read_mcycle() - ulStart) < SEND_GAP_CYCLES) {}
+    }
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[IRQOverhead] %d workers, a call every %u cycles, %u rounds (%u dropped)\n", WORKER_NUM, SEND_GAP_CYCLES,
+           ulSent, ulDropped);
+    for (int i = 0; i < CORE_NUM; i++) {
+        if (i == COORDINATOR_CORE) {
+            continue;
+        }
+        uint32_t ulQuiet = xStats[i].ulQuietIterations;
+        uint32_t ulLost = ulQuiet > xStats[i].ulLoadedIterations ? ulQuiet - xStats[i].ulLoadedIterations : 0;
+        uint32_t ulCalls = xStats[i].ulCalls;
+        uint32_t ulCost = (ulQuiet && ulCalls)
+            ? (uint32_t)(((uint64_t)BENCH_WINDOW_CYCLES * ulLost) / ((uint64_t)ulQuiet * ulCalls)) : 0;
+
+        printf("  core %2d: %8u calls, %5u cycles per interrupt\n", i, ulCalls, ulCost);
+    }
+#if (configPORT_TRAP_CYCLE_STATS == 1)
+    for (int i = 0; i < CORE_NUM; i++) {
+        uint32_t ulTraps = xPortCpuLocal[i].uxTraps;
+        printf("  core %2d traps: %8u (%u fast), entry %4u, exit %4u cycles each\n", i, ulTraps,
+               xPortCpuLocal[i].uxTrapFastReturns,
+               ulTraps ? xPortCpuLocal[i].uxTrapEntryCycles / ulTraps : 0,
+               ulTraps ? xPortCpuLocal[i].uxTrapExitCycles / ulTraps : 0);
+    }
+#endif
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;){}
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            if (i == COORDINATOR_CORE) {
+                xTaskCreateAffinitySet(vSenderTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+            } else {
+                xTaskCreateAffinitySet(vWorkerTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+            }
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
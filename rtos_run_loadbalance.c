@@ -0,0 +1,141 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Load balancing of migratable tasks with uxTaskBalanceLoad().
+ *
+ * WORKER_NUM worker tasks, created without an affinity mask and marked with
+ * xTaskSetMigratable(), each burn a different number of cycles per tick:
+ * worker i does i + 1 work units.  A balancer task on the coordinator core
+ * calls uxTaskBalanceLoad() every BALANCE_PERIOD ticks, which pins the
+ * workers to cores so the cores end up evenly loaded.  After ROUNDS periods
+ * it prints the number of moves of every round, then the core each worker
+ * was pinned to and its run time.
+ *
+ * Build with e.g. "make PROJ=rtos_run_loadbalance NUM_CORES=4", 8 or 16,
+ * which turns on the run time stats and the balancer (RUN_TIME_STATS=1
+ * LOAD_BALANCER=1).
+ */
+
+#if (configUSE_LOAD_BALANCER != 1)
+#error rtos_run_loadbalance needs configUSE_LOAD_BALANCER
+#endif
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define WORKER_NUM              configLOAD_BALANCER_MAX_TASKS
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define WORKER_PRIORITY         (tskIDLE_PRIORITY + 1)
+#define BALANCER_PRIORITY       (tskIDLE_PRIORITY + 2)
+#define COORDINATOR_CORE        0
+
+#define WORK_UNIT_CYCLES        2000u
+#define BALANCE_PERIOD          ((TickType_t)50)
+#define ROUNDS                  10
+
+static TaskHandle_t xWorkers[WORKER_NUM];
+static UBaseType_t uxMoves[ROUNDS];
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+void vWorkerTask(void *pvParameters) {
+    uint32_t ulBusyCycles = ((uint32_t)(uintptr_t)pvParameters + 1) * WORK_UNIT_CYCLES;
+
+    for(;;) {
+        uint32_t ulStart = read_mcycle();
+        while ((read_mcycle() - ulStart) < ulBusyCycles) {}
+        vTaskDelay(1);
+    }
+}
+
+void vBalancerTask(void *pvParameters) {
+    (void)pvParameters;
+
+    // The first call only starts the measurement period
+    (void)uxTaskBalanceLoad();
+
+    for (int round = 0; round < ROUNDS; round++) {
+        vTaskDelay(BALANCE_PERIOD);
+        uxMoves[round] = uxTaskBalanceLoad();
+    }
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[LoadBalance] %d workers on %d cores, moves per round:", WORKER_NUM, CORE_NUM);
+    for (int round = 0; round < ROUNDS; round++) {
+        printf(" %u", (unsigned)uxMoves[round]);
+    }
+    printf("\n");
+    for (int i = 0; i < WORKER_NUM; i++) {
+        printf("  worker %d: %u units, affinity 0x%x, run time %u\n", i, i + 1,
+               (unsigned)vTaskCoreAffinityGet(xWorkers[i]), (uint32_t)ulTaskGetRunTimeCounter(xWorkers[i]));
+    }
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < WORKER_NUM; i++) {
+            xTaskCreate(vWorkerTask, "Worker", TASK_STACK_SIZE, (void *)(uintptr_t)i, WORKER_PRIORITY, &xWorkers[i]);
+            BaseType_t xMarked = xTaskSetMigratable(xWorkers[i], pdTRUE);
+            configASSERT(xMarked == pdPASS);
+            (void)xMarked;
+        }
+        xTaskCreateAffinitySet(vBalancerTask, "Balancer", TASK_STACK_SIZE, NULL, BALANCER_PRIORITY,
+                               (1 << COORDINATOR_CORE), NULL);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
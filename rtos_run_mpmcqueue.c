@@ -0,0 +1,218 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include "mpmc_queue.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Inter-core channel throughput, kernel queue against MPMC queue.
+ *
+ * Every core runs one task: even cores produce, odd cores consume, all on the
+ * same queue.  Each producer sends ITEMS_PER_PRODUCER words followed by one
+ * STOP_ITEM, and each consumer receives until it gets a STOP_ITEM, so with as
+ * many producers as consumers every consumer gets exactly one.  The run is
+ * done twice, first through xQueueSend()/xQueueReceive() and then through
+ * xMpmcQueueSend()/xMpmcQueueReceive(), both with QUEUE_LENGTH slots and
+ * blocking calls.  A checksum over the received words catches lost or
+ * duplicated items.
+ *
+ * Build with e.g. "make PROJ=rtos_run_mpmcqueue NUM_CORES=4", 8 or 16.
+ */
+
+#if (configUSE_MPMC_QUEUES != 1)
+#error rtos_run_mpmcqueue needs configUSE_MPMC_QUEUES
+#endif
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define PRODUCER_NUM            (CORE_NUM / 2)
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define QUEUE_LENGTH            64
+#define ITEMS_PER_PRODUCER      20000u
+#define STOP_ITEM               0xffffffffu
+
+enum { MODE_KERNEL, MODE_MPMC, MODE_NUM };
+
+static const char *const pcModeNames[] = { "xQueue", "MPMC  " };
+
+typedef struct
+{
+    uint32_t ulItems;
+    uint32_t ulCycles;
+    uint32_t ulChecksum;
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[MODE_NUM][CORE_NUM];
+
+static QueueHandle_t xKernelQueue;
+static MpmcQueueHandle_t xMpmcQueue;
+
+volatile uint32_t g_ulStartCount[MODE_NUM] = {0};
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static void send(int mode, uint32_t ulItem) {
+    if (mode == MODE_KERNEL) {
+        xQueueSend(xKernelQueue, &ulItem, portMAX_DELAY);
+    } else {
+        xMpmcQueueSend(xMpmcQueue, &ulItem, portMAX_DELAY);
+    }
+}
+
+static uint32_t receive(int mode) {
+    uint32_t ulItem;
+
+    if (mode == MODE_KERNEL) {
+        xQueueReceive(xKernelQueue, &ulItem, portMAX_DELAY);
+    } else {
+        xMpmcQueueReceive(xMpmcQueue, &ulItem, portMAX_DELAY);
+    }
+    return ulItem;
+}
+
+// Sum of the words a producer sends, so the consumers' checksums must add up to PRODUCER_NUM times this
+static uint32_t producer_checksum(void) {
+    uint32_t ulSum = 0;
+
+    for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        ulSum += i;
+    }
+    return ulSum;
+}
+
+void vChannelTask(void *pvParameters) {
+    int core_id = rtos_core_id_get();
+    int producer = (core_id % 2) == 0;
+    (void)pvParameters;
+
+    for (int mode = 0; mode < MODE_NUM; mode++) {
+        CoreStats_t *pxStats = &xStats[mode][core_id];
+        uint32_t ulItems = 0, ulChecksum = 0;
+
+        // Start barrier
+        (void)Atomic_Increment_u32(&g_ulStartCount[mode]);
+        while (g_ulStartCount[mode] < CORE_NUM) {}
+
+        uint32_t ulStart = read_mcycle();
+
+        if (producer) {
+            for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+                send(mode, i);
+                ulItems++;
+            }
+            send(mode, STOP_ITEM);
+        } else {
+            for (;;) {
+                uint32_t ulItem = receive(mode);
+                if (ulItem == STOP_ITEM) {
+                    break;
+                }
+                ulChecksum += ulItem;
+                ulItems++;
+            }
+        }
+
+        pxStats->ulCycles = read_mcycle() - ulStart;
+        pxStats->ulItems = ulItems;
+        pxStats->ulChecksum = ulChecksum;
+    }
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE) {
+        while (g_ulDoneCount < CORE_NUM) {
+            taskYIELD();
+        }
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[MPMCQueue] %d producers, %d consumers, %u items each, queue length %d\n", PRODUCER_NUM,
+               CORE_NUM - PRODUCER_NUM, ITEMS_PER_PRODUCER, QUEUE_LENGTH);
+        for (int mode = 0; mode < MODE_NUM; mode++) {
+            uint32_t ulItems = 0, ulChecksum = 0, ulCycles = 0;
+
+            for (int i = 0; i < CORE_NUM; i++) {
+                if (i % 2) {
+                    ulItems += xStats[mode][i].ulItems;
+                    ulChecksum += xStats[mode][i].ulChecksum;
+                }
+                if (xStats[mode][i].ulCycles > ulCycles) {
+                    ulCycles = xStats[mode][i].ulCycles;
+                }
+            }
+            printf("  %s: %8u items in %10u cycles, %5u cycles per item, %u items per Mcycle (%s)\n",
+                   pcModeNames[mode], ulItems, ulCycles, ulItems ? ulCycles / ulItems : 0,
+                   ulCycles ? (uint32_t)(((uint64_t)ulItems * 1000000u) / ulCycles) : 0,
+                   (ulItems == PRODUCER_NUM * ITEMS_PER_PRODUCER &&
+                    ulChecksum == (uint32_t)PRODUCER_NUM * producer_checksum()) ? "ok" : "MISMATCH");
+        }
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xKernelQueue = xQueueCreate(QUEUE_LENGTH, sizeof(uint32_t));
+        xMpmcQueue = xMpmcQueueCreate(QUEUE_LENGTH, sizeof(uint32_t));
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vChannelTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -0,0 +1,165 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Priority disinheritance after a mutex timeout.
+ *
+ * A low priority task takes a mutex and lets a high priority task, pinned to
+ * the same core, block on it with a short timeout.  The low priority task
+ * inherits the high priority and keeps yielding, so it is still in a ready
+ * list, not blocked, when the high priority task times out and
+ * vTaskPriorityDisinheritAfterTimeout() moves it back to its own priority.
+ * That empties the ready list of the inherited priority, whose ready bit must
+ * be cleared, while the bit of the low priority must stay set.  With a wrong
+ * bit the low priority task is never selected again and the test stalls.
+ *
+ * Every round checks the priority of the low priority task before and after
+ * the timeout.  A coordinator on another core reports the result, or a stall
+ * if the rounds do not finish in time.
+ *
+ * Build with e.g. "make PROJ=rtos_run_mutex_timeout_test NUM_CORES=4", 8 or 16,
+ * which selects tasks from the ready-priority bit maps (TASK_SELECTION=1).
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define LOW_PRIORITY            (tskIDLE_PRIORITY + 1)
+#define HIGH_PRIORITY           (tskIDLE_PRIORITY + 3)
+#define TEST_CORE               0
+#define COORDINATOR_CORE        1
+
+#define ROUNDS                  20u
+#define TIMEOUT_TICKS           ((TickType_t)5)
+#define DEADLINE_TICKS          (ROUNDS * TIMEOUT_TICKS * 4u + 100u)
+
+static SemaphoreHandle_t xMutex;
+static TaskHandle_t xLowTask, xHighTask;
+
+static volatile uint32_t ulTimedOut = 0;
+static volatile uint32_t ulRounds = 0;
+static volatile uint32_t ulErrors = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+void vLowTask(void *pvParameters) {
+    (void)pvParameters;
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        if (xSemaphoreTake(xMutex, portMAX_DELAY) != pdPASS) {
+            ulErrors++;
+        }
+        ulTimedOut = 0;
+        xTaskNotifyGive(xHighTask);
+
+        // Let the high priority task run and block on the mutex
+        taskYIELD();
+        if (uxTaskPriorityGet(NULL) != HIGH_PRIORITY) {
+            ulErrors++;
+        }
+
+        // Stay ready, not blocked, until the high priority task has timed out
+        while (ulTimedOut == 0) {
+            taskYIELD();
+        }
+        if (uxTaskPriorityGet(NULL) != LOW_PRIORITY) {
+            ulErrors++;
+        }
+
+        xSemaphoreGive(xMutex);
+        ulRounds = round + 1;
+    }
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+void vHighTask(void *pvParameters) {
+    (void)pvParameters;
+
+    for(;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        if (xSemaphoreTake(xMutex, TIMEOUT_TICKS) == pdPASS) {
+            // The low priority task holds the mutex throughout
+            ulErrors++;
+            xSemaphoreGive(xMutex);
+        }
+        if (uxTaskPriorityGet(xLowTask) != LOW_PRIORITY) {
+            ulErrors++;
+        }
+        ulTimedOut = 1;
+    }
+}
+
+void vCoordinatorTask(void *pvParameters) {
+    TickType_t xStart = xTaskGetTickCount();
+    (void)pvParameters;
+
+    while ((ulRounds < ROUNDS) && ((xTaskGetTickCount() - xStart) < DEADLINE_TICKS)) {
+        vTaskDelay(10);
+    }
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[MutexTimeout] %lu of %u rounds, %lu errors: %s\n", ulRounds, ROUNDS, ulErrors,
+           (ulRounds == ROUNDS && ulErrors == 0) ? "PASSED" : (ulRounds < ROUNDS ? "FAILED (stalled)" : "FAILED"));
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == TEST_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xMutex = xSemaphoreCreateMutex();
+
+        xTaskCreateAffinitySet(vHighTask, "High", TASK_STACK_SIZE, NULL, HIGH_PRIORITY, (1 << TEST_CORE), &xHighTask);
+        xTaskCreateAffinitySet(vLowTask, "Low", TASK_STACK_SIZE, NULL, LOW_PRIORITY, (1 << TEST_CORE), &xLowTask);
+        xTaskCreateAffinitySet(vCoordinatorTask, "Coordinator", TASK_STACK_SIZE, NULL, LOW_PRIORITY,
+                               (1 << COORDINATOR_CORE), NULL);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -0,0 +1,232 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (configUSE_PER_CORE_TIMER_TASKS != 1)
+#error rtos_run_percoretimers needs configUSE_PER_CORE_TIMER_TASKS
+#endif
+
+/*
+ * Timer callbacks with a timer service task on every core
+ * (configUSE_PER_CORE_TIMER_TASKS).
+ *
+ * An owner task pinned to every core creates an auto-reload timer there.  The
+ * timer must report that core from xTimerGetCore(), and every one of its
+ * callbacks must run on that core, in the core's own timer service task.  The
+ * owner also pends a function call with xTimerPendFunctionCall(), which must
+ * run on the owner's core too.
+ *
+ * The coordinator, on core 0, then creates one one-shot timer for every core,
+ * moves it there with vTimerSetCore() before starting it from core 0, and
+ * checks that each callback runs on the core the timer was moved to.
+ *
+ * Build with e.g. "make PROJ=rtos_run_percoretimers NUM_CORES=4", 8 or 16,
+ * which switches the per-core timer tasks on (PER_CORE_TIMER_TASKS=1).
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define OWNER_PRIORITY          (tskIDLE_PRIORITY + 2)
+#define COORDINATOR_PRIORITY    (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define RELOADS                 5u
+#define OWNED_PERIOD_TICKS      ((TickType_t)3)
+#define MOVED_PERIOD_TICKS      ((TickType_t)5)
+#define DEADLINE_TICKS          ((TickType_t)500)
+
+#define NOT_RUN                 0xFFFFFFFFu
+
+// Timer IDs 0 to configNUMBER_OF_CORES - 1 are the owners' auto-reload timers,
+// the next configNUMBER_OF_CORES the timers moved by the coordinator.
+#define NUM_TIMERS              (2 * configNUMBER_OF_CORES)
+
+typedef struct {
+    uint32_t ulExpectedCore;
+    volatile uint32_t ulRanOn;          /* Core of the last callback, or NOT_RUN. */
+    volatile uint32_t ulCallbacks;
+    volatile uint32_t ulWrongCore;      /* Callbacks on another core or service task. */
+} TimerResult_t;
+
+static TimerResult_t xTimerResults[NUM_TIMERS];
+static volatile uint32_t ulPendedOn[configNUMBER_OF_CORES];
+static volatile uint32_t ulOwnersDone = 0;
+static volatile uint32_t ulErrors = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static void timer_callback(TimerHandle_t xTimer) {
+    uint32_t index = (uint32_t)(uintptr_t)pvTimerGetTimerID(xTimer);
+    TimerResult_t *pxResult = &xTimerResults[index];
+    uint32_t core = rtos_core_id_get();
+
+    // The callback runs in the timer service task of the core it is on
+    if ((core != pxResult->ulExpectedCore) ||
+        (xTaskGetCurrentTaskHandle() != xTimerGetTimerDaemonTaskHandle())) {
+        pxResult->ulWrongCore++;
+    }
+    pxResult->ulRanOn = core;
+    pxResult->ulCallbacks++;
+
+    if ((index < configNUMBER_OF_CORES) && (pxResult->ulCallbacks == RELOADS)) {
+        xTimerStop(xTimer, 0);
+    }
+}
+
+static void pended_function(void *pvParameter1, uint32_t ulParameter2) {
+    (void)pvParameter1;
+    ulPendedOn[ulParameter2] = rtos_core_id_get();
+}
+
+void vOwnerTask(void *pvParameters) {
+    uint32_t core = (uint32_t)(uintptr_t)pvParameters;
+    TimerHandle_t xTimer;
+
+    xTimerResults[core].ulExpectedCore = core;
+    xTimerResults[core].ulRanOn = NOT_RUN;
+
+    xTimer = xTimerCreate("Owned", OWNED_PERIOD_TICKS, pdTRUE, (void *)(uintptr_t)core, timer_callback);
+    if ((xTimer == NULL) || (xTimerGetCore(xTimer) != (BaseType_t)core)) {
+        ulErrors++;
+    } else if (xTimerStart(xTimer, portMAX_DELAY) != pdPASS) {
+        ulErrors++;
+    }
+
+    if (xTimerPendFunctionCall(pended_function, NULL, core, portMAX_DELAY) != pdPASS) {
+        ulErrors++;
+    }
+
+    while ((xTimerResults[core].ulCallbacks < RELOADS) || (ulPendedOn[core] == NOT_RUN)) {
+        vTaskDelay(1);
+    }
+
+    (void)Atomic_Increment_u32(&ulOwnersDone);
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+static uint32_t moved_done(void) {
+    for (uint32_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        if (xTimerResults[configNUMBER_OF_CORES + core].ulCallbacks == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void vCoordinatorTask(void *pvParameters) {
+    TickType_t xStart = xTaskGetTickCount();
+    TimerHandle_t xTimer;
+    uint32_t errors;
+    (void)pvParameters;
+
+    // Created on this core, then handed to the service task of every core
+    for (uint32_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        uint32_t index = configNUMBER_OF_CORES + core;
+
+        xTimerResults[index].ulExpectedCore = core;
+        xTimerResults[index].ulRanOn = NOT_RUN;
+
+        xTimer = xTimerCreate("Moved", MOVED_PERIOD_TICKS, pdFALSE, (void *)(uintptr_t)index, timer_callback);
+        if ((xTimer == NULL) || (xTimerGetCore(xTimer) != COORDINATOR_CORE)) {
+            ulErrors++;
+            continue;
+        }
+        vTimerSetCore(xTimer, core);
+        if (xTimerGetCore(xTimer) != (BaseType_t)core) {
+            ulErrors++;
+        }
+        if (xTimerStart(xTimer, portMAX_DELAY) != pdPASS) {
+            ulErrors++;
+        }
+    }
+
+    while (((ulOwnersDone < configNUMBER_OF_CORES) || !moved_done()) &&
+           ((xTaskGetTickCount() - xStart) < DEADLINE_TICKS)) {
+        vTaskDelay(10);
+    }
+
+    errors = ulErrors;
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[PerCoreTimers] %u cores\n", configNUMBER_OF_CORES);
+    for (uint32_t i = 0; i < NUM_TIMERS; i++) {
+        TimerResult_t *pxResult = &xTimerResults[i];
+
+        printf("  %s timer for core %lu: %lu callbacks, last on core %ld, %lu on a wrong core\n",
+               (i < configNUMBER_OF_CORES) ? "owned" : "moved", pxResult->ulExpectedCore,
+               pxResult->ulCallbacks, (long)(int32_t)pxResult->ulRanOn, pxResult->ulWrongCore);
+        errors += (pxResult->ulCallbacks == 0) + pxResult->ulWrongCore;
+    }
+    for (uint32_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        if (ulPendedOn[core] != core) {
+            printf("  function pended on core %lu ran on core %ld\n", core, (long)(int32_t)ulPendedOn[core]);
+            errors++;
+        }
+    }
+    printf("[PerCoreTimers] %lu errors: %s\n", errors, errors == 0 ? "PASSED" : "FAILED");
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (uint32_t core = 0; core < configNUMBER_OF_CORES; core++) {
+            ulPendedOn[core] = NOT_RUN;
+            xTaskCreateAffinitySet(vOwnerTask, "Owner", TASK_STACK_SIZE, (void *)(uintptr_t)core, OWNER_PRIORITY,
+                                   (1 << core), NULL);
+        }
+        xTaskCreateAffinitySet(vCoordinatorTask, "Coordinator", TASK_STACK_SIZE, NULL, COORDINATOR_PRIORITY,
+                               (1 << COORDINATOR_CORE), NULL);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
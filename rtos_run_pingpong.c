@@ -0,0 +1,152 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Semaphore ping-pong throughput on independent core pairs.
+ *
+ * Cores (2i, 2i+1) form pair i.  The ping task on core 2i gives xPing[i] and
+ * then takes xPong[i]; the pong task on core 2i+1 does the opposite.  Pairs
+ * never touch each other's semaphores, so with configUSE_PER_OBJECT_LOCKS the
+ * total round-trip count should grow linearly with the number of pairs.
+ *
+ * Build with e.g. "make PROJ=rtos_run_pingpong NUM_CORES=8".
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define PAIR_NUM                (CORE_NUM / 2)
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define BENCH_WINDOW_CYCLES     5000000u
+
+typedef struct
+{
+    SemaphoreHandle_t xPing;
+    SemaphoreHandle_t xPong;
+    uint32_t ulRoundTrips;
+    uint32_t ulCycles;
+} portCACHE_LINE_ALIGNED PairStats_t;
+
+static PairStats_t xPairs[PAIR_NUM];
+
+volatile uint32_t g_ulStartCount = 0;
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+void vPongTask(void *pvParameters) {
+    PairStats_t *pxPair = (PairStats_t *)pvParameters;
+
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+
+    for (;;) {
+        xSemaphoreTake(pxPair->xPing, portMAX_DELAY);
+        xSemaphoreGive(pxPair->xPong);
+    }
+}
+
+void vPingTask(void *pvParameters) {
+    PairStats_t *pxPair = (PairStats_t *)pvParameters;
+    uint32_t ulRoundTrips = 0;
+
+    // Start barrier, so all pairs run at the same time
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulStartCount < PAIR_NUM * 2) {}
+
+    uint32_t ulStart = read_mcycle();
+    uint32_t ulElapsed;
+
+    do {
+        xSemaphoreGive(pxPair->xPing);
+        xSemaphoreTake(pxPair->xPong, portMAX_DELAY);
+        ulRoundTrips++;
+        ulElapsed = read_mcycle() - ulStart;
+    } while (ulElapsed < BENCH_WINDOW_CYCLES);
+
+    pxPair->ulRoundTrips = ulRoundTrips;
+    pxPair->ulCycles = ulElapsed;
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (rtos_core_id_get() == COORDINATOR_CORE) {
+        uint32_t ulTotal = 0;
+
+        while (g_ulDoneCount < PAIR_NUM) {}
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[PingPong] %d pairs, per object locks %s\n", PAIR_NUM, configUSE_PER_OBJECT_LOCKS ? "on" : "off");
+        for (int i = 0; i < PAIR_NUM; i++) {
+            printf("  pair %2d (cores %2d/%2d): %8u round trips, %6u cycles each\n", i, 2 * i, 2 * i + 1,
+                   xPairs[i].ulRoundTrips, xPairs[i].ulRoundTrips ? xPairs[i].ulCycles / xPairs[i].ulRoundTrips : 0);
+            ulTotal += xPairs[i].ulRoundTrips;
+        }
+        printf("  total: %u round trips in %u cycles\n", ulTotal, BENCH_WINDOW_CYCLES);
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;){}
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < PAIR_NUM; i++) {
+            xPairs[i].xPing = xSemaphoreCreateBinary();
+            xPairs[i].xPong = xSemaphoreCreateBinary();
+            xTaskCreateAffinitySet(vPingTask, NULL, TASK_STACK_SIZE, &xPairs[i], TASK_PRIORITY, (1 << (2 * i)), NULL);
+            xTaskCreateAffinitySet(vPongTask, NULL, TASK_STACK_SIZE, &xPairs[i], TASK_PRIORITY, (1 << (2 * i + 1)), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -0,0 +1,435 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (configUSE_PRIORITY_QUEUES != 1)
+#error rtos_run_priorityqueue needs configUSE_PRIORITY_QUEUES
+#endif
+
+/*
+ * Functional test of priority queues (configUSE_PRIORITY_QUEUES).
+ *
+ * Every item carries its priority and a number counting up in the order the
+ * items were sent.  The test task keeps its own list of what the queue holds
+ * and checks that every receive gets the item with the highest priority, and
+ * among items of equal priority the one sent first.  On a queue of
+ * QUEUE_LENGTH items it checks:
+ * - Order: pseudo-random priorities, with few distinct values so many items
+ *   share one, sent and received in changing runs so the heap is reordered at
+ *   every size.  Back and front sends are mixed in as priority 0 and
+ *   queueMAX_ITEM_PRIORITY, and xQueuePeek() must return the item the next
+ *   receive gets.
+ * - A full queue: no send gets in, whatever its priority, until an item is
+ *   received.
+ * - Blocking: a helper task on core 1 blocked receiving from the empty queue
+ *   is woken by a send, and one blocked sending to the full queue is woken by
+ *   a receive, after which its item takes its place by priority.
+ * - The FromISR variants, called from the tick hook, including a send from
+ *   the ISR that wakes the blocked helper.
+ *
+ * Build with e.g. "make PROJ=rtos_run_priorityqueue NUM_CORES=4", 8 or 16,
+ * which switches priority queues on (PRIORITY_QUEUES=1).
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TEST_PRIORITY           (tskIDLE_PRIORITY + 2)
+#define TEST_CORE               0
+#define HELPER_CORE             1
+
+#define QUEUE_LENGTH            16u
+#define ORDER_ROUNDS            64u
+#define HELPER_TIMEOUT_TICKS    ((TickType_t)200)
+#define FULL_TIMEOUT_TICKS      ((TickType_t)5)
+#define WAIT_TICKS              ((TickType_t)300)
+
+// Priorities are drawn from these, so that many items share one
+static const uint32_t ulPriorities[] = { 0, 1, 1, 2, 7, 7, 7, 100, 254 };
+#define NUM_PRIORITIES          (sizeof(ulPriorities) / sizeof(ulPriorities[0]))
+
+typedef struct {
+    uint32_t ulPriority;
+    uint32_t ulSeq;
+} Item_t;
+
+enum { HELPER_RECEIVE = 1, HELPER_SEND };
+enum { ISR_NONE = 0, ISR_SEND, ISR_RECEIVE };
+
+static QueueHandle_t xQueue;
+static TaskHandle_t xHelperTask;
+
+// What the queue should hold, in the order it was sent
+static Item_t xModel[QUEUE_LENGTH];
+static uint32_t ulModelCount = 0;
+static uint32_t ulNextSeq = 0;
+static uint32_t ulRandom = 12345;
+
+static volatile uint32_t ulHelperCommand;
+static volatile uint32_t ulHelperWaiting;
+static volatile uint32_t ulHelperDone;
+static volatile BaseType_t xHelperResult;
+static Item_t xHelperItem;
+
+static volatile uint32_t ulIsrCommand = ISR_NONE;
+static volatile uint32_t ulIsrDone;
+static volatile BaseType_t xIsrResult;
+static Item_t xIsrItem;
+
+static volatile uint32_t ulChecks = 0;
+static volatile uint32_t ulErrors = 0;
+static volatile uint32_t ulFirstErrorLine = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+#define CHECK(x) check((x) ? 1 : 0, __LINE__)
+
+static void check(uint32_t ok, uint32_t line) {
+    ulChecks++;
+    if (!ok) {
+        if (ulErrors++ == 0) {
+            ulFirstErrorLine = line;
+        }
+    }
+}
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static uint32_t next_random(void) {
+    ulRandom = ulRandom * 1103515245u + 12345u;
+    return ulRandom >> 16;
+}
+
+static Item_t new_item(uint32_t priority) {
+    Item_t xItem = { priority, ulNextSeq++ };
+
+    return xItem;
+}
+
+static void model_add(const Item_t *pxItem) {
+    xModel[ulModelCount++] = *pxItem;
+}
+
+// Index in the model of the item the queue must hand out next
+static uint32_t model_front(void) {
+    uint32_t best = 0;
+
+    // The model is in send order, so the first of the highest priority wins
+    for (uint32_t i = 1; i < ulModelCount; i++) {
+        if (xModel[i].ulPriority > xModel[best].ulPriority) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Checks a received item against the model and drops it from the model
+static void model_receive(const Item_t *pxItem) {
+    uint32_t front;
+
+    CHECK(ulModelCount > 0);
+    if (ulModelCount == 0) {
+        return;
+    }
+    front = model_front();
+    CHECK((pxItem->ulPriority == xModel[front].ulPriority) && (pxItem->ulSeq == xModel[front].ulSeq));
+    memmove(&xModel[front], &xModel[front + 1], (ulModelCount - front - 1) * sizeof(Item_t));
+    ulModelCount--;
+}
+
+// Sends an item, which must fit
+static void send(uint32_t priority) {
+    Item_t xItem = new_item(priority);
+
+    CHECK(xQueueSendWithPriority(xQueue, &xItem, priority, 0) == pdPASS);
+    model_add(&xItem);
+}
+
+static void receive(void) {
+    Item_t xItem, xPeeked;
+
+    CHECK(xQueuePeek(xQueue, &xPeeked, 0) == pdPASS);
+    CHECK(xQueueReceive(xQueue, &xItem, 0) == pdPASS);
+    CHECK((xPeeked.ulPriority == xItem.ulPriority) && (xPeeked.ulSeq == xItem.ulSeq));
+    model_receive(&xItem);
+}
+
+static void drain(void) {
+    while (ulModelCount > 0) {
+        receive();
+    }
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+// Runs a blocking call in the helper task and returns once it has blocked
+static void start_helper(uint32_t command) {
+    ulHelperCommand = command;
+    ulHelperWaiting = 0;
+    ulHelperDone = 0;
+    xTaskNotifyGive(xHelperTask);
+
+    while ((ulHelperWaiting == 0) || (eTaskGetState(xHelperTask) != eBlocked)) {
+        vTaskDelay(1);
+    }
+    // Still blocked, so the queue really held the helper off
+    CHECK(Atomic_Load_u32_Acquire(&ulHelperDone) == 0);
+}
+
+static void wait_helper(void) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    while ((Atomic_Load_u32_Acquire(&ulHelperDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(ulHelperDone != 0);
+    CHECK(xHelperResult == pdPASS);
+}
+
+// Has the tick hook run command on xIsrItem and returns its result
+static BaseType_t run_isr(uint32_t command) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    ulIsrDone = 0;
+    Atomic_Store_u32_Release(&ulIsrCommand, command);
+
+    while ((Atomic_Load_u32_Acquire(&ulIsrDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(ulIsrDone != 0);
+    return xIsrResult;
+}
+
+static void test_order(void) {
+    Item_t xItem;
+
+    for (uint32_t round = 0; round < ORDER_ROUNDS; round++) {
+        uint32_t sends = next_random() % (QUEUE_LENGTH - ulModelCount + 1);
+        uint32_t receives;
+
+        for (uint32_t i = 0; i < sends; i++) {
+            switch (next_random() % 8u) {
+            case 0:
+                // Back sends have priority 0
+                xItem = new_item(0);
+                CHECK(xQueueSendToBack(xQueue, &xItem, 0) == pdPASS);
+                model_add(&xItem);
+                break;
+            case 1:
+                // Front sends have the highest priority, and keep their order
+                xItem = new_item(queueMAX_ITEM_PRIORITY);
+                CHECK(xQueueSendToFront(xQueue, &xItem, 0) == pdPASS);
+                model_add(&xItem);
+                break;
+            default:
+                send(ulPriorities[next_random() % NUM_PRIORITIES]);
+                break;
+            }
+        }
+        CHECK(uxQueueMessagesWaiting(xQueue) == ulModelCount);
+
+        receives = next_random() % (ulModelCount + 1);
+        for (uint32_t i = 0; i < receives; i++) {
+            receive();
+        }
+    }
+
+    drain();
+
+    // Items of one priority come out in the order they were sent
+    for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+        send(5);
+    }
+    drain();
+}
+
+static void test_full(void) {
+    Item_t xItem;
+    TickType_t xStart;
+
+    for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+        send(ulPriorities[i % NUM_PRIORITIES]);
+    }
+
+    // Not even the highest priority displaces an item
+    xItem = new_item(queueMAX_ITEM_PRIORITY);
+    CHECK(xQueueSendWithPriority(xQueue, &xItem, queueMAX_ITEM_PRIORITY, 0) == errQUEUE_FULL);
+    CHECK(xQueueSendToFront(xQueue, &xItem, 0) == errQUEUE_FULL);
+    xStart = xTaskGetTickCount();
+    CHECK(xQueueSendWithPriority(xQueue, &xItem, queueMAX_ITEM_PRIORITY, FULL_TIMEOUT_TICKS) == errQUEUE_FULL);
+    CHECK((xTaskGetTickCount() - xStart) >= FULL_TIMEOUT_TICKS);
+    CHECK(uxQueueMessagesWaiting(xQueue) == QUEUE_LENGTH);
+
+    // Once one is received there is room again, for any priority
+    receive();
+    send(0);
+    drain();
+}
+
+static void test_blocking(void) {
+    // A receiver blocked on the empty queue is woken by a send
+    start_helper(HELPER_RECEIVE);
+    send(7);
+    wait_helper();
+    model_receive(&xHelperItem);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+
+    // A sender blocked on the full queue is woken by a receive, and its item
+    // then goes in by priority
+    for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+        send(ulPriorities[i % NUM_PRIORITIES]);
+    }
+    xHelperItem = new_item(50);
+    start_helper(HELPER_SEND);
+    receive();
+    wait_helper();
+    model_add(&xHelperItem);
+    drain();
+}
+
+static void test_from_isr(void) {
+    // Sends from the ISR take their place by priority
+    send(1);
+    send(7);
+    xIsrItem = new_item(7);
+    CHECK(run_isr(ISR_SEND) == pdPASS);
+    model_add(&xIsrItem);
+    xIsrItem = new_item(100);
+    CHECK(run_isr(ISR_SEND) == pdPASS);
+    model_add(&xIsrItem);
+
+    // Receives from the ISR get the highest priority first
+    CHECK(run_isr(ISR_RECEIVE) == pdPASS);
+    model_receive(&xIsrItem);
+    CHECK(run_isr(ISR_RECEIVE) == pdPASS);
+    model_receive(&xIsrItem);
+    drain();
+    CHECK(run_isr(ISR_RECEIVE) == pdFAIL);
+
+    // A full queue turns the ISR away
+    for (uint32_t i = 0; i < QUEUE_LENGTH; i++) {
+        send(ulPriorities[i % NUM_PRIORITIES]);
+    }
+    xIsrItem = new_item(queueMAX_ITEM_PRIORITY);
+    CHECK(run_isr(ISR_SEND) == errQUEUE_FULL);
+    drain();
+
+    // A send from the ISR wakes a blocked receiver
+    start_helper(HELPER_RECEIVE);
+    xIsrItem = new_item(3);
+    CHECK(run_isr(ISR_SEND) == pdPASS);
+    model_add(&xIsrItem);
+    wait_helper();
+    model_receive(&xHelperItem);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+void vHelperTask(void *pvParameters) {
+    BaseType_t xResult;
+    (void)pvParameters;
+
+    for(;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ulHelperWaiting = 1;
+
+        if (ulHelperCommand == HELPER_RECEIVE) {
+            xResult = xQueueReceive(xQueue, &xHelperItem, HELPER_TIMEOUT_TICKS);
+        } else {
+            xResult = xQueueSendWithPriority(xQueue, &xHelperItem, xHelperItem.ulPriority, HELPER_TIMEOUT_TICKS);
+        }
+
+        xHelperResult = xResult;
+        Atomic_Store_u32_Release(&ulHelperDone, 1);
+    }
+}
+
+void vTestTask(void *pvParameters) {
+    (void)pvParameters;
+
+    test_order();
+    test_full();
+    test_blocking();
+    test_from_isr();
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[PriorityQueue] %lu items, %lu checks, %lu errors", ulNextSeq, ulChecks, ulErrors);
+    if (ulErrors != 0) {
+        printf(" (first at line %lu)", ulFirstErrorLine);
+    }
+    printf(": %s\n", ulErrors == 0 ? "PASSED" : "FAILED");
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == TEST_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xQueue = xQueueCreatePriority(QUEUE_LENGTH, sizeof(Item_t));
+
+        xTaskCreateAffinitySet(vTestTask, "Test", TASK_STACK_SIZE, NULL, TEST_PRIORITY, (1 << TEST_CORE), NULL);
+        xTaskCreateAffinitySet(vHelperTask, "Helper", TASK_STACK_SIZE, NULL, TEST_PRIORITY, (1 << HELPER_CORE),
+                               &xHelperTask);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+
+// Runs the FromISR variants requested by run_isr() in interrupt context
+void vApplicationTickHook(void) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t command = Atomic_Swap_u32(&ulIsrCommand, ISR_NONE);
+
+    switch (command) {
+    case ISR_SEND:
+        xIsrResult = xQueueSendWithPriorityFromISR(xQueue, &xIsrItem, xIsrItem.ulPriority, &xHigherPriorityTaskWoken);
+        break;
+    case ISR_RECEIVE:
+        xIsrResult = xQueueReceiveFromISR(xQueue, &xIsrItem, &xHigherPriorityTaskWoken);
+        break;
+    default:
+        return;
+    }
+
+    // Scheduling is cooperative, so a woken task runs when its core next yields
+    (void)xHigherPriorityTaskWoken;
+    Atomic_Store_u32_Release(&ulIsrDone, 1);
+}
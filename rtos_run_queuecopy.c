@@ -0,0 +1,187 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Per-item cost of xQueueSend()/xQueueReceive() against the item size.
+ *
+ * Every core runs one task with queues of its own, so the numbers are the
+ * uncontended cost of the calls.  The task fills a queue of QUEUE_LENGTH
+ * items with non-blocking sends and drains it again with non-blocking
+ * receives, ROUNDS times, and the send and receive bursts are timed
+ * separately.  This is done for 4, 8 and 64 byte items, which cover the word
+ * copy (configUSE_QUEUE_WORD_COPY) and the memcpy() path, and once more for 4
+ * byte items sent from and received into a buffer that is not word aligned,
+ * which falls back to memcpy() for the same queue.
+ *
+ * Build with e.g. "make PROJ=rtos_run_queuecopy NUM_CORES=4", 8 or 16.
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define QUEUE_LENGTH            32
+#define ROUNDS                  500u
+#define MAX_ITEM_SIZE           64
+
+enum { MODE_4_BYTES, MODE_4_BYTES_UNALIGNED, MODE_8_BYTES, MODE_64_BYTES, MODE_NUM };
+
+static const char *const pcModeNames[] = { " 4 bytes          ", " 4 bytes unaligned", " 8 bytes          ",
+                                           "64 bytes          " };
+static const UBaseType_t uxItemSizes[] = { 4, 4, 8, 64 };
+
+typedef struct
+{
+    uint32_t ulSendCycles;
+    uint32_t ulReceiveCycles;
+    uint32_t ulErrors;
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[MODE_NUM][CORE_NUM];
+
+static QueueHandle_t xQueues[MODE_NUM][CORE_NUM];
+
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+void vCopyTask(void *pvParameters) {
+    int core_id = rtos_core_id_get();
+    // One spare word so the unaligned mode can start the buffers a byte in
+    uint32_t ulSendBuffer[MAX_ITEM_SIZE / sizeof(uint32_t) + 1];
+    uint32_t ulReceiveBuffer[MAX_ITEM_SIZE / sizeof(uint32_t) + 1];
+    (void)pvParameters;
+
+    for (int mode = 0; mode < MODE_NUM; mode++) {
+        CoreStats_t *pxStats = &xStats[mode][core_id];
+        QueueHandle_t xQueue = xQueues[mode][core_id];
+        uint8_t *pucSend = (uint8_t *)ulSendBuffer + ((mode == MODE_4_BYTES_UNALIGNED) ? 1 : 0);
+        uint8_t *pucReceive = (uint8_t *)ulReceiveBuffer + ((mode == MODE_4_BYTES_UNALIGNED) ? 1 : 0);
+        uint32_t ulSendCycles = 0, ulReceiveCycles = 0, ulErrors = 0;
+
+        for (uint32_t round = 0; round < ROUNDS; round++) {
+            uint32_t ulStart;
+
+            // The first byte of each item carries its position, to check the order
+            ulStart = read_mcycle();
+            for (int i = 0; i < QUEUE_LENGTH; i++) {
+                pucSend[0] = (uint8_t)i;
+                if (xQueueSend(xQueue, pucSend, 0) != pdPASS) {
+                    ulErrors++;
+                }
+            }
+            ulSendCycles += read_mcycle() - ulStart;
+
+            ulStart = read_mcycle();
+            for (int i = 0; i < QUEUE_LENGTH; i++) {
+                if (xQueueReceive(xQueue, pucReceive, 0) != pdPASS || pucReceive[0] != (uint8_t)i) {
+                    ulErrors++;
+                }
+            }
+            ulReceiveCycles += read_mcycle() - ulStart;
+        }
+
+        pxStats->ulSendCycles = ulSendCycles;
+        pxStats->ulReceiveCycles = ulReceiveCycles;
+        pxStats->ulErrors = ulErrors;
+    }
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE) {
+        while (g_ulDoneCount < CORE_NUM) {
+            taskYIELD();
+        }
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[QueueCopy] %d cores, %u rounds of %d sends and %d receives each, word copy %s\n", CORE_NUM,
+               ROUNDS, QUEUE_LENGTH, QUEUE_LENGTH, configUSE_QUEUE_WORD_COPY ? "on" : "off");
+        for (int mode = 0; mode < MODE_NUM; mode++) {
+            uint64_t ullSendCycles = 0, ullReceiveCycles = 0;
+            uint32_t ulErrors = 0;
+            uint64_t ullItems = (uint64_t)CORE_NUM * ROUNDS * QUEUE_LENGTH;
+
+            for (int i = 0; i < CORE_NUM; i++) {
+                ullSendCycles += xStats[mode][i].ulSendCycles;
+                ullReceiveCycles += xStats[mode][i].ulReceiveCycles;
+                ulErrors += xStats[mode][i].ulErrors;
+            }
+            printf("  %s: %5u cycles per send, %5u cycles per receive (%s)\n", pcModeNames[mode],
+                   (uint32_t)(ullSendCycles / ullItems), (uint32_t)(ullReceiveCycles / ullItems),
+                   ulErrors ? "ERRORS" : "ok");
+        }
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int mode = 0; mode < MODE_NUM; mode++) {
+            for (int i = 0; i < CORE_NUM; i++) {
+                xQueues[mode][i] = xQueueCreate(QUEUE_LENGTH, uxItemSizes[mode]);
+            }
+        }
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vCopyTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
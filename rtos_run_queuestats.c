@@ -0,0 +1,212 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Queue and semaphore statistics under cross-core contention, and what they
+ * cost.
+ *
+ * Every core runs one task: even cores produce, odd cores consume, all on one
+ * short queue, so producers block on a full queue and consumers on an empty
+ * one.  Every SHARED_EVERY items each task also takes a mutex shared by all
+ * of them, the hot contention point.  The queue, the mutex and the print
+ * mutex are in the queue registry, and once every task is done the
+ * coordinator prints the throughput followed by uxQueueGetRegistryStats() for
+ * all three.
+ *
+ * Built with RUN_TIME_STATS=1 QUEUE_STATS=1 (the defaults for this app).
+ * "QUEUE_STATS=0" builds the same run without the statistics, to compare the
+ * throughput.
+ *
+ * Build with e.g. "make PROJ=rtos_run_queuestats NUM_CORES=4", 8 or 16.
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+#define PRODUCER_NUM            (CORE_NUM / 2)
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define QUEUE_LENGTH            4
+#define ITEMS_PER_PRODUCER      10000u
+#define SHARED_EVERY            16u
+#define STOP_ITEM               0xffffffffu
+
+typedef struct
+{
+    uint32_t ulItems;
+    uint32_t ulCycles;
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[CORE_NUM];
+
+static QueueHandle_t xWorkQueue;
+static SemaphoreHandle_t xSharedMutex;
+static uint32_t ulSharedCount = 0;
+
+volatile uint32_t g_ulStartCount = 0;
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static void touch_shared(void) {
+    xSemaphoreTake(xSharedMutex, portMAX_DELAY);
+    ulSharedCount++;
+    xSemaphoreGive(xSharedMutex);
+}
+
+#if (configUSE_QUEUE_STATS == 1)
+static void print_registry_stats(void) {
+    QueueRegistryStats_t xRegistryStats[configQUEUE_REGISTRY_SIZE];
+    UBaseType_t uxCount = uxQueueGetRegistryStats(xRegistryStats, configQUEUE_REGISTRY_SIZE);
+
+    printf("  %-8s %8s %8s %7s %7s %12s %10s %4s %7s\n", "name", "sends", "receives", "full", "empty",
+           "blocked cyc", "peak cyc", "hwm", "x-core");
+    for (UBaseType_t i = 0; i < uxCount; i++) {
+        const QueueStats_t *pxStats = &xRegistryStats[i].xStats;
+
+        printf("  %-8s %8u %8u %7u %7u %12u %10u %4u %7u\n", xRegistryStats[i].pcQueueName, pxStats->ulSends,
+               pxStats->ulReceives, pxStats->ulFullBlocks, pxStats->ulEmptyBlocks, (uint32_t)pxStats->ulBlockedTime,
+               (uint32_t)pxStats->ulPeakBlockedTime, (uint32_t)pxStats->uxMessagesWaitingHighWaterMark,
+               pxStats->ulCrossCoreWakeups);
+    }
+}
+#endif
+
+void vChannelTask(void *pvParameters) {
+    int core_id = rtos_core_id_get();
+    int producer = (core_id % 2) == 0;
+    uint32_t ulItems = 0;
+    (void)pvParameters;
+
+    // Start barrier
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulStartCount < CORE_NUM) {}
+
+    uint32_t ulStart = read_mcycle();
+
+    if (producer) {
+        for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+            xQueueSend(xWorkQueue, &i, portMAX_DELAY);
+            if ((++ulItems % SHARED_EVERY) == 0) {
+                touch_shared();
+            }
+        }
+        uint32_t ulStop = STOP_ITEM;
+        xQueueSend(xWorkQueue, &ulStop, portMAX_DELAY);
+    } else {
+        for (;;) {
+            uint32_t ulItem;
+            xQueueReceive(xWorkQueue, &ulItem, portMAX_DELAY);
+            if (ulItem == STOP_ITEM) {
+                break;
+            }
+            if ((++ulItems % SHARED_EVERY) == 0) {
+                touch_shared();
+            }
+        }
+    }
+
+    xStats[core_id].ulCycles = read_mcycle() - ulStart;
+    xStats[core_id].ulItems = ulItems;
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE) {
+        uint32_t ulReceived = 0, ulCycles = 0;
+
+        while (g_ulDoneCount < CORE_NUM) {
+            taskYIELD();
+        }
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            if (i % 2) {
+                ulReceived += xStats[i].ulItems;
+            }
+            if (xStats[i].ulCycles > ulCycles) {
+                ulCycles = xStats[i].ulCycles;
+            }
+        }
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[QueueStats] %d producers, %d consumers, %u items each, queue length %d, stats %s\n", PRODUCER_NUM,
+               CORE_NUM - PRODUCER_NUM, ITEMS_PER_PRODUCER, QUEUE_LENGTH, configUSE_QUEUE_STATS ? "on" : "off");
+        printf("  %u items in %u cycles, %u cycles per item (%s)\n", ulReceived, ulCycles,
+               ulReceived ? ulCycles / ulReceived : 0,
+               (ulReceived == PRODUCER_NUM * ITEMS_PER_PRODUCER) ? "ok" : "MISMATCH");
+#if (configUSE_QUEUE_STATS == 1)
+        print_registry_stats();
+#endif
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xWorkQueue = xQueueCreate(QUEUE_LENGTH, sizeof(uint32_t));
+        xSharedMutex = xSemaphoreCreateMutex();
+
+        vQueueAddToRegistry(xWorkQueue, "work");
+        vQueueAddToRegistry(xSharedMutex, "shared");
+        vQueueAddToRegistry(xPrintMutex, "print");
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vChannelTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
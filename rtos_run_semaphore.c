@@ -99,9 +99,19 @@ void vCoordinatorTask() {
         }
     }
     
+    // Software interrupts raised vs. merged into one already pending
+    PortIPIStats_t xIPIStats;
+    uint32_t ulIPIsSent = 0, ulIPIsSuppressed = 0;
+    for (int i = 0; i < CORE_NUM; i++) {
+        vPortGetIPIStats(i, &xIPIStats);
+        ulIPIsSent += xIPIStats.ulSent;
+        ulIPIsSuppressed += xIPIStats.ulSuppressed;
+    }
+
     lock_print();
     printf("\n----------------------------------------\n");
     printf("[Coordinator] Run %lu finished. Found %d errors.\n", g_ulRunCounter, errors);
+    printf("[Coordinator] IPIs: %u sent, %u suppressed.\n", ulIPIsSent, ulIPIsSuppressed);
     printf("[Coordinator] Compute complete.\n");
     printf("----------------------------------------\n");
     unlock_print();
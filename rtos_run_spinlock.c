@@ -0,0 +1,203 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Kernel lock contention benchmark.
+ *
+ * One task is pinned to every core.  After a common start barrier each task
+ * repeatedly enters and leaves a kernel critical section (which takes both
+ * the task and the ISR spinlock) for BENCH_WINDOW_CYCLES cycles.  For every
+ * core the number of acquisitions and the average/worst acquire latency are
+ * reported, followed by two fairness figures computed over the acquisition
+ * counts:
+ *   - min/max ratio (1000 = perfectly fair)
+ *   - Jain's fairness index (sum x)^2 / (n * sum x^2) (1000 = perfectly fair)
+ * Built with IRQ_OFF_STATS=1 the longest and average time every core ran
+ * with interrupts masked for a critical section is reported as well, which
+ * with LOCK_WAIT=0 includes the time spent spinning for the locks.
+ *
+ * Build with e.g. "make PROJ=rtos_run_spinlock NUM_CORES=8 SPINLOCK=1", and
+ * compare "IRQ_OFF_STATS=1" against "IRQ_OFF_STATS=1 LOCK_WAIT=0".
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define BENCH_WINDOW_CYCLES     2000000u
+#define BENCH_HOLD_LOOPS        16        /* work done while holding the lock */
+#define BENCH_GAP_LOOPS         32        /* work done between acquisitions */
+
+typedef struct
+{
+    uint32_t ulAcquisitions;
+    uint32_t ulMaxLatency;
+    uint64_t ullTotalLatency;
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[CORE_NUM];
+
+volatile uint32_t g_ulStartCount = 0;
+volatile uint32_t g_ulDoneCount = 0;
+volatile uint32_t g_ulSharedCounter = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static void spin(int loops) {
+    for (volatile int i = 0; i < loops; i++) {}
+}
+
+static const char *lock_type_name(void) {
+#if (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_TICKET)
+    return "ticket";
+#elif (configPORT_SPINLOCK_TYPE == portSPINLOCK_TYPE_MCS)
+    return "MCS";
+#else
+    return "test-and-set";
+#endif
+}
+
+void vContenderTask() {
+    int core_id = rtos_core_id_get();
+    CoreStats_t *pxStats = &xStats[core_id];
+    uint32_t ulAcquisitions = 0, ulMaxLatency = 0;
+    uint64_t ullTotalLatency = 0;
+
+    // Start barrier
+    (void)Atomic_Increment_u32(&g_ulStartCount);
+    while (g_ulStartCount < CORE_NUM) {}
+
+#if (configPORT_IRQ_OFF_STATS == 1)
+    vPortResetIrqOffStats();
+#endif
+
+    uint32_t ulStart = read_mcycle();
+
+    while ((read_mcycle() - ulStart) < BENCH_WINDOW_CYCLES) {
+        uint32_t t0 = read_mcycle();
+        taskENTER_CRITICAL();
+        uint32_t ulLatency = read_mcycle() - t0;
+
+        g_ulSharedCounter++;
+        spin(BENCH_HOLD_LOOPS);
+
+        taskEXIT_CRITICAL();
+
+        ulAcquisitions++;
+        ullTotalLatency += ulLatency;
+        if (ulLatency > ulMaxLatency) {
+            ulMaxLatency = ulLatency;
+        }
+
+        spin(BENCH_GAP_LOOPS);
+    }
+
+    pxStats->ulAcquisitions = ulAcquisitions;
+    pxStats->ulMaxLatency = ulMaxLatency;
+    pxStats->ullTotalLatency = ullTotalLatency;
+
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE) {
+        while (g_ulDoneCount < CORE_NUM) {}
+
+        uint32_t ulMin = UINT32_MAX, ulMax = 0;
+        uint64_t ullSum = 0, ullSumSq = 0;
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[Spinlock] %s lock, %d cores, window %u cycles, wait with interrupts %s\n", lock_type_name(), CORE_NUM,
+               BENCH_WINDOW_CYCLES, configPORT_INTERRUPTIBLE_LOCK_WAIT ? "enabled" : "masked");
+        for (int i = 0; i < CORE_NUM; i++) {
+            uint32_t n = xStats[i].ulAcquisitions;
+            uint32_t avg = n ? (uint32_t)(xStats[i].ullTotalLatency / n) : 0;
+
+            printf("  core %2d: %8u acquisitions, avg %6u, max %8u cycles\n", i, n, avg, xStats[i].ulMaxLatency);
+
+            if (n < ulMin) ulMin = n;
+            if (n > ulMax) ulMax = n;
+            ullSum += n;
+            ullSumSq += (uint64_t)n * n;
+        }
+
+        uint32_t ulMinMax = ulMax ? (uint32_t)(((uint64_t)ulMin * 1000) / ulMax) : 0;
+        uint32_t ulJain = ullSumSq ? (uint32_t)((ullSum * ullSum * 1000) / (CORE_NUM * ullSumSq)) : 0;
+
+        printf("  total %u acquisitions, shared counter %u (%s)\n", (uint32_t)ullSum, g_ulSharedCounter,
+               (ullSum == g_ulSharedCounter) ? "ok" : "MISMATCH");
+        printf("  fairness: min/max %u/1000, Jain %u/1000\n", ulMinMax, ulJain);
+#if (configPORT_IRQ_OFF_STATS == 1)
+        for (int i = 0; i < CORE_NUM; i++) {
+            PortIrqOffStats_t xIrqOff;
+
+            vPortGetIrqOffStats(i, &xIrqOff);
+            printf("  core %2d interrupts off: max %8u, avg %6u cycles over %u sections\n", i, xIrqOff.ulMaxCycles,
+                   xIrqOff.ulSections ? xIrqOff.ulTotalCycles / xIrqOff.ulSections : 0, xIrqOff.ulSections);
+        }
+#endif
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;){}
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vContenderTask, NULL, TASK_STACK_SIZE, NULL, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
@@ -5,6 +5,7 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "atomic.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -74,10 +75,6 @@ static inline void unlock_print() {
     __asm__ volatile("amoswap.w.rl zero, zero, %0" : : "A"(*PRINT_LOCK_ADDR) : "memory");
 }
 
-static void atomic_or(volatile uint32_t *addr, int val) {
-    __asm__ volatile("amoor.w.aqrl zero, %1, %0" : "+A"(*addr) : "r"(val) : "memory");
-}
-
 // Simple random number generator (since we don't have nr_routines.h)
 static FTYPE RanUnif(long *seed) {
     *seed = (*seed * 1103515245 + 12345) & 0x7fffffff;
@@ -220,7 +217,7 @@ void vWorkerTask() {
     }
 
     // Signal completion
-    atomic_or(&g_ulWorkersDoneMask, (1u << (core_idx + 1)));
+    (void)Atomic_OR_u32(&g_ulWorkersDoneMask, 1u << (core_idx + 1));
 
     for(;;) {
         vTaskDelay(pdMS_TO_TICKS(1000));
@@ -5,6 +5,7 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "atomic.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -75,10 +76,6 @@ static inline void unlock_print() {
     __asm__ volatile("amoswap.w.rl zero, zero, %0" : : "A"(*PRINT_LOCK_ADDR) : "memory");
 }
 
-static void atomic_or(volatile uint32_t *addr, int val) {
-    __asm__ volatile("amoor.w.aqrl zero, %1, %0" : "+A"(*addr) : "r"(val) : "memory");
-}
-
 // Fixed-point helper functions
 static void print_fixed_point(FTYPE_INT val, const char* name) {
     int whole = val / FIXED_POINT_SCALE;
@@ -254,7 +251,7 @@ void vWorkerTask() {
     }
 
     // Signal completion
-    atomic_or(&g_ulWorkersDoneMask, (1u << (core_idx + 1)));
+    (void)Atomic_OR_u32(&g_ulWorkersDoneMask, 1u << (core_idx + 1));
 
     // Task completes naturally instead of infinite loop
     vTaskDelete(NULL);
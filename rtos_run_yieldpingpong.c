@@ -0,0 +1,171 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Cost of a voluntary context switch, call path against trap path.
+ *
+ * Two tasks of the same priority are pinned to every core and hand the core
+ * back and forth for BENCH_WINDOW_CYCLES cycles, twice:
+ *   call - with taskYIELD(), which the port turns into a call to vPortYield()
+ *          that only saves ra, s0-s11 and mstatus
+ *   trap - with a bare ecall, which takes the full trap path and saves all
+ *          of x1-x31, mepc and mstatus
+ * Both tasks are resumed the way they gave the core up, so the figures are
+ * the cost of one switch with each kind of frame.
+ *
+ * Build with e.g. "make PROJ=rtos_run_yieldpingpong NUM_CORES=4".
+ */
+
+#define CORE_NUM                configNUMBER_OF_CORES
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TASK_PRIORITY           (tskIDLE_PRIORITY + 1)
+#define COORDINATOR_CORE        0
+
+#define BENCH_WINDOW_CYCLES     5000000u
+
+enum { MODE_CALL, MODE_TRAP, MODE_NUM };
+
+static const char *const pcModeNames[] = { "call", "trap" };
+
+typedef struct
+{
+    uint32_t ulSwitches[MODE_NUM];
+    uint32_t ulCycles[MODE_NUM];
+    volatile uint32_t ulStopped[MODE_NUM];
+} portCACHE_LINE_ALIGNED CoreStats_t;
+
+static CoreStats_t xStats[CORE_NUM];
+
+volatile uint32_t g_ulStartCount[MODE_NUM] = {0};
+volatile uint32_t g_ulDoneCount = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t ulCycles;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(ulCycles));
+    return ulCycles;
+}
+
+static inline void yield(int mode) {
+    if (mode == MODE_CALL) {
+        taskYIELD();
+    } else {
+        __asm__ volatile("ecall" ::: "memory");
+    }
+}
+
+void vSwitchTask(void *pvParameters) {
+    int task = (int)(uintptr_t)pvParameters;
+    int core_id = rtos_core_id_get();
+    CoreStats_t *pxStats = &xStats[core_id];
+
+    for (int mode = 0; mode < MODE_NUM; mode++) {
+        uint32_t ulSwitches = 0, ulElapsed = 0;
+
+        // Start barrier, yielding so the partner on this core gets there too
+        (void)Atomic_Increment_u32(&g_ulStartCount[mode]);
+        while (g_ulStartCount[mode] < CORE_NUM * 2) {
+            taskYIELD();
+        }
+
+        uint32_t ulStart = read_mcycle();
+
+        // Task 0 of every core times the window and stops its partner
+        while (!pxStats->ulStopped[mode]) {
+            yield(mode);
+            ulSwitches++;
+
+            if (task == 0) {
+                ulElapsed = read_mcycle() - ulStart;
+                if (ulElapsed >= BENCH_WINDOW_CYCLES) {
+                    pxStats->ulStopped[mode] = 1;
+                }
+            }
+        }
+
+        (void)Atomic_Add_u32(&pxStats->ulSwitches[mode], ulSwitches);
+        if (task == 0) {
+            pxStats->ulCycles[mode] = ulElapsed;
+        }
+    }
+    (void)Atomic_Increment_u32(&g_ulDoneCount);
+
+    if (core_id == COORDINATOR_CORE && task == 0) {
+        while (g_ulDoneCount < CORE_NUM * 2) {
+            taskYIELD();
+        }
+
+        lock_print();
+        printf("\n----------------------------------------\n");
+        printf("[YieldPingPong] %d cores, cycles per switch\n", CORE_NUM);
+        for (int i = 0; i < CORE_NUM; i++) {
+            printf("  core %2d:", i);
+            for (int mode = 0; mode < MODE_NUM; mode++) {
+                uint32_t ulSwitches = xStats[i].ulSwitches[mode];
+                printf("  %s %5u", pcModeNames[mode], ulSwitches ? xStats[i].ulCycles[mode] / ulSwitches : 0);
+            }
+            printf("\n");
+        }
+        printf("----------------------------------------\n");
+        unlock_print();
+    }
+
+    for(;;) {
+        taskYIELD();
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == COORDINATOR_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+
+        for (int i = 0; i < CORE_NUM; i++) {
+            xTaskCreateAffinitySet(vSwitchTask, NULL, TASK_STACK_SIZE, (void *)0, TASK_PRIORITY, (1 << i), NULL);
+            xTaskCreateAffinitySet(vSwitchTask, NULL, TASK_STACK_SIZE, (void *)1, TASK_PRIORITY, (1 << i), NULL);
+        }
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+void vApplicationTickHook(void) {}
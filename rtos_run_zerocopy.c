@@ -0,0 +1,429 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (configUSE_QUEUE_ZERO_COPY != 1)
+#error rtos_run_zerocopy needs configUSE_QUEUE_ZERO_COPY
+#endif
+
+/*
+ * Functional test of the zero-copy queue API (configUSE_QUEUE_ZERO_COPY).
+ *
+ * The test task on core 0 runs these checks on a queue of QUEUE_LENGTH items:
+ * - Ordering and wraparound: rounds of claim/commit followed by as many
+ *   borrow/release calls, with a different count every round, so the ring
+ *   wraps at every offset.  Items come out in order, every item is borrowed
+ *   in the slot it was claimed in, and plain sends and receives interleave
+ *   with them in order.
+ * - What a claimed slot and a borrowed item hold off: a claim blocks other
+ *   sends, a borrow blocks other receives and front sends but not back sends,
+ *   and releasing a borrowed item from a full queue frees its slot.
+ * - Blocking: a helper task on core 1 blocks in xQueueClaim() on a full queue
+ *   until the test task releases a borrowed item, and in xQueueBorrow() on an
+ *   empty queue until the test task commits a claimed slot.
+ * - The FromISR variants, called from the tick hook: claim/commit and
+ *   borrow/release, claim on a full queue and borrow on an empty one, and a
+ *   release from the ISR that wakes the helper blocked in xQueueClaim().
+ *
+ * Build with e.g. "make PROJ=rtos_run_zerocopy NUM_CORES=4", 8 or 16, which
+ * switches the zero-copy API on (QUEUE_ZERO_COPY=1).
+ */
+
+#define TASK_STACK_SIZE         (configMINIMAL_STACK_SIZE * 2)
+#define TEST_PRIORITY           (tskIDLE_PRIORITY + 2)
+#define TEST_CORE               0
+#define HELPER_CORE             1
+
+#define QUEUE_LENGTH            4u
+#define WRAP_ROUNDS             (3u * QUEUE_LENGTH)
+#define HELPER_TIMEOUT_TICKS    ((TickType_t)200)
+#define WAIT_TICKS              ((TickType_t)300)
+
+typedef struct {
+    uint32_t ulSeq;
+    uint32_t ulCheck;
+    uint32_t ulPayload[2];
+} Item_t;
+
+enum { HELPER_CLAIM = 1, HELPER_BORROW };
+enum { ISR_NONE = 0, ISR_CLAIM_COMMIT, ISR_BORROW_RELEASE, ISR_CLAIM_FULL, ISR_BORROW_EMPTY };
+
+static QueueHandle_t xQueue;
+static TaskHandle_t xHelperTask;
+
+static volatile uint32_t ulHelperCommand;
+static volatile uint32_t ulHelperSeq;
+static volatile uint32_t ulHelperWaiting;
+static volatile uint32_t ulHelperDone;
+static volatile BaseType_t xHelperResult;
+
+static volatile uint32_t ulIsrCommand = ISR_NONE;
+static volatile uint32_t ulIsrSeq;
+static volatile uint32_t ulIsrDone;
+static volatile BaseType_t xIsrResult;
+
+static volatile uint32_t ulChecks = 0;
+static volatile uint32_t ulErrors = 0;
+static volatile uint32_t ulFirstErrorLine = 0;
+
+SemaphoreHandle_t xPrintMutex;
+
+extern void xPortStartSchedulerOncore(void);
+
+#define CHECK(x) check((x) ? 1 : 0, __LINE__)
+
+static void check(uint32_t ok, uint32_t line) {
+    ulChecks++;
+    if (!ok) {
+        if (ulErrors++ == 0) {
+            ulFirstErrorLine = line;
+        }
+    }
+}
+
+static inline void lock_print() {
+    xSemaphoreTake(xPrintMutex, portMAX_DELAY);
+}
+
+static inline void unlock_print() {
+    xSemaphoreGive(xPrintMutex);
+}
+
+static void fill_item(Item_t *pxItem, uint32_t seq) {
+    pxItem->ulSeq = seq;
+    pxItem->ulCheck = ~seq;
+    pxItem->ulPayload[0] = seq * 3u;
+    pxItem->ulPayload[1] = seq * 7u;
+}
+
+static uint32_t item_ok(const Item_t *pxItem, uint32_t seq) {
+    return (pxItem->ulSeq == seq) && (pxItem->ulCheck == ~seq) &&
+           (pxItem->ulPayload[0] == seq * 3u) && (pxItem->ulPayload[1] == seq * 7u);
+}
+
+// Claims a slot without blocking, fills it in and commits it
+static void claim_commit(uint32_t seq) {
+    Item_t *pxItem;
+
+    CHECK(xQueueClaim(xQueue, (void **)&pxItem, 0) == pdPASS);
+    fill_item(pxItem, seq);
+    vQueueCommit(xQueue, pxItem);
+}
+
+// Borrows the front item without blocking, checks it and releases it
+static void borrow_release(uint32_t seq) {
+    Item_t *pxItem;
+
+    CHECK(xQueueBorrow(xQueue, (void **)&pxItem, 0) == pdPASS);
+    CHECK(item_ok(pxItem, seq));
+    vQueueRelease(xQueue, pxItem);
+}
+
+// Runs a blocking call in the helper task and returns once it has blocked
+static void start_helper(uint32_t command, uint32_t seq) {
+    ulHelperSeq = seq;
+    ulHelperCommand = command;
+    ulHelperWaiting = 0;
+    ulHelperDone = 0;
+    xTaskNotifyGive(xHelperTask);
+
+    while ((ulHelperWaiting == 0) || (eTaskGetState(xHelperTask) != eBlocked)) {
+        vTaskDelay(1);
+    }
+    // Still blocked, so the queue really held the helper off
+    CHECK(Atomic_Load_u32_Acquire(&ulHelperDone) == 0);
+}
+
+static void wait_helper(void) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    while ((Atomic_Load_u32_Acquire(&ulHelperDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(ulHelperDone != 0);
+    CHECK(xHelperResult == pdPASS);
+}
+
+// Has the tick hook run command with seq and returns its result
+static BaseType_t run_isr(uint32_t command, uint32_t seq) {
+    TickType_t xStart = xTaskGetTickCount();
+
+    ulIsrSeq = seq;
+    ulIsrDone = 0;
+    Atomic_Store_u32_Release(&ulIsrCommand, command);
+
+    while ((Atomic_Load_u32_Acquire(&ulIsrDone) == 0) && ((xTaskGetTickCount() - xStart) < WAIT_TICKS)) {
+        vTaskDelay(1);
+    }
+    CHECK(ulIsrDone != 0);
+    return xIsrResult;
+}
+
+static void test_order_and_wraparound(void) {
+    Item_t *pxSlots[QUEUE_LENGTH];
+    Item_t *pxItem;
+    Item_t xItem;
+    uint32_t next = 0, expected = 0;
+
+    for (uint32_t round = 0; round < WRAP_ROUNDS; round++) {
+        uint32_t count = 1u + (round % QUEUE_LENGTH);
+
+        for (uint32_t i = 0; i < count; i++, next++) {
+            CHECK(xQueueClaim(xQueue, (void **)&pxItem, 0) == pdPASS);
+            // The ring hands out the slots in turn
+            if (next < QUEUE_LENGTH) {
+                pxSlots[next] = pxItem;
+            } else {
+                CHECK(pxItem == pxSlots[next % QUEUE_LENGTH]);
+            }
+            fill_item(pxItem, next);
+            vQueueCommit(xQueue, pxItem);
+        }
+        CHECK(uxQueueMessagesWaiting(xQueue) == count);
+
+        for (uint32_t i = 0; i < count; i++, expected++) {
+            CHECK(xQueueBorrow(xQueue, (void **)&pxItem, 0) == pdPASS);
+            CHECK(pxItem == pxSlots[expected % QUEUE_LENGTH]);
+            CHECK(item_ok(pxItem, expected));
+            vQueueRelease(xQueue, pxItem);
+        }
+        CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+    }
+
+    // Plain sends and receives keep their place among claimed and borrowed items
+    fill_item(&xItem, next);
+    CHECK(xQueueSend(xQueue, &xItem, 0) == pdPASS);
+    claim_commit(next + 1);
+    fill_item(&xItem, next + 2);
+    CHECK(xQueueSend(xQueue, &xItem, 0) == pdPASS);
+
+    borrow_release(next);
+    CHECK(xQueueReceive(xQueue, &xItem, 0) == pdPASS);
+    CHECK(item_ok(&xItem, next + 1));
+    borrow_release(next + 2);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+static void test_holds(void) {
+    Item_t *pxClaimed, *pxBorrowed, *pxOther;
+    Item_t xItem;
+
+    // A claimed slot holds off other claims and sends, and is not visible
+    CHECK(xQueueClaim(xQueue, (void **)&pxClaimed, 0) == pdPASS);
+    CHECK(xQueueClaim(xQueue, (void **)&pxOther, 0) == errQUEUE_FULL);
+    fill_item(&xItem, 100);
+    CHECK(xQueueSend(xQueue, &xItem, 0) == errQUEUE_FULL);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+    CHECK(xQueueReceive(xQueue, &xItem, 0) == errQUEUE_EMPTY);
+    fill_item(pxClaimed, 100);
+    vQueueCommit(xQueue, pxClaimed);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 1);
+
+    // A borrowed item holds off receives, borrows and front sends, not back sends
+    CHECK(xQueueBorrow(xQueue, (void **)&pxBorrowed, 0) == pdPASS);
+    CHECK(item_ok(pxBorrowed, 100));
+    CHECK(uxQueueMessagesWaiting(xQueue) == 1);
+    CHECK(xQueueReceive(xQueue, &xItem, 0) == errQUEUE_EMPTY);
+    CHECK(xQueueBorrow(xQueue, (void **)&pxOther, 0) == errQUEUE_EMPTY);
+    fill_item(&xItem, 999);
+    CHECK(xQueueSendToFront(xQueue, &xItem, 0) == errQUEUE_FULL);
+    for (uint32_t seq = 101; seq < 100 + QUEUE_LENGTH; seq++) {
+        fill_item(&xItem, seq);
+        CHECK(xQueueSendToBack(xQueue, &xItem, 0) == pdPASS);
+    }
+
+    // The borrowed item still takes its slot until it is released
+    CHECK(uxQueueMessagesWaiting(xQueue) == QUEUE_LENGTH);
+    fill_item(&xItem, 100 + QUEUE_LENGTH);
+    CHECK(xQueueSendToBack(xQueue, &xItem, 0) == errQUEUE_FULL);
+    vQueueRelease(xQueue, pxBorrowed);
+    CHECK(uxQueueMessagesWaiting(xQueue) == QUEUE_LENGTH - 1);
+    CHECK(xQueueSendToBack(xQueue, &xItem, 0) == pdPASS);
+
+    for (uint32_t seq = 101; seq <= 100 + QUEUE_LENGTH; seq++) {
+        CHECK(xQueueReceive(xQueue, &xItem, 0) == pdPASS);
+        CHECK(item_ok(&xItem, seq));
+    }
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+static void test_blocking(void) {
+    Item_t *pxItem;
+
+    // A claim on a full queue is woken by a release
+    for (uint32_t seq = 200; seq < 200 + QUEUE_LENGTH; seq++) {
+        claim_commit(seq);
+    }
+    start_helper(HELPER_CLAIM, 200 + QUEUE_LENGTH);
+    CHECK(xQueueBorrow(xQueue, (void **)&pxItem, 0) == pdPASS);
+    CHECK(item_ok(pxItem, 200));
+    vQueueRelease(xQueue, pxItem);
+    wait_helper();
+    for (uint32_t seq = 201; seq <= 200 + QUEUE_LENGTH; seq++) {
+        borrow_release(seq);
+    }
+
+    // A borrow on an empty queue is woken by a commit
+    start_helper(HELPER_BORROW, 300);
+    claim_commit(300);
+    wait_helper();
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+static void test_from_isr(void) {
+    // Claim/commit in the ISR, borrow/release in the task
+    CHECK(run_isr(ISR_CLAIM_COMMIT, 400) == pdPASS);
+    borrow_release(400);
+
+    // Claim/commit in the task, borrow/release in the ISR
+    claim_commit(401);
+    CHECK(run_isr(ISR_BORROW_RELEASE, 401) == pdPASS);
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+
+    // Nothing to borrow, no slot to claim
+    CHECK(run_isr(ISR_BORROW_EMPTY, 0) == pdFAIL);
+    for (uint32_t seq = 402; seq < 402 + QUEUE_LENGTH; seq++) {
+        claim_commit(seq);
+    }
+    CHECK(run_isr(ISR_CLAIM_FULL, 0) == errQUEUE_FULL);
+
+    // A release in the ISR wakes a task blocked in xQueueClaim()
+    start_helper(HELPER_CLAIM, 402 + QUEUE_LENGTH);
+    CHECK(run_isr(ISR_BORROW_RELEASE, 402) == pdPASS);
+    wait_helper();
+    for (uint32_t seq = 403; seq <= 402 + QUEUE_LENGTH; seq++) {
+        borrow_release(seq);
+    }
+    CHECK(uxQueueMessagesWaiting(xQueue) == 0);
+}
+
+void vHelperTask(void *pvParameters) {
+    Item_t *pxItem;
+    BaseType_t xResult;
+    (void)pvParameters;
+
+    for(;;) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ulHelperWaiting = 1;
+
+        if (ulHelperCommand == HELPER_CLAIM) {
+            xResult = xQueueClaim(xQueue, (void **)&pxItem, HELPER_TIMEOUT_TICKS);
+            if (xResult == pdPASS) {
+                fill_item(pxItem, ulHelperSeq);
+                vQueueCommit(xQueue, pxItem);
+            }
+        } else {
+            xResult = xQueueBorrow(xQueue, (void **)&pxItem, HELPER_TIMEOUT_TICKS);
+            if (xResult == pdPASS) {
+                CHECK(item_ok(pxItem, ulHelperSeq));
+                vQueueRelease(xQueue, pxItem);
+            }
+        }
+
+        xHelperResult = xResult;
+        Atomic_Store_u32_Release(&ulHelperDone, 1);
+    }
+}
+
+void vTestTask(void *pvParameters) {
+    (void)pvParameters;
+
+    test_order_and_wraparound();
+    test_holds();
+    test_blocking();
+    test_from_isr();
+
+    lock_print();
+    printf("\n----------------------------------------\n");
+    printf("[ZeroCopy] %lu checks, %lu errors", ulChecks, ulErrors);
+    if (ulErrors != 0) {
+        printf(" (first at line %lu)", ulFirstErrorLine);
+    }
+    printf(": %s\n", ulErrors == 0 ? "PASSED" : "FAILED");
+    printf("----------------------------------------\n");
+    unlock_print();
+
+    for(;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+int main(void) {
+    int core_id = rtos_core_id_get();
+
+    if (core_id == TEST_CORE) {
+        xPrintMutex = xSemaphoreCreateMutex();
+        xQueue = xQueueCreate(QUEUE_LENGTH, sizeof(Item_t));
+
+        xTaskCreateAffinitySet(vTestTask, "Test", TASK_STACK_SIZE, NULL, TEST_PRIORITY, (1 << TEST_CORE), NULL);
+        xTaskCreateAffinitySet(vHelperTask, "Helper", TASK_STACK_SIZE, NULL, TEST_PRIORITY, (1 << HELPER_CORE),
+                               &xHelperTask);
+        vTaskStartScheduler();
+    } else {
+        xPortStartSchedulerOncore();
+    }
+
+    for (;;);
+    return 0;
+}
+
+void vApplicationMallocFailedHook(void) {
+    lock_print();
+    printf("Malloc failed!\n");
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t pxTask, char *pcTaskName) {
+    (void)pxTask;
+    lock_print();
+    printf("Stack overflow in %s\n", pcTaskName);
+    unlock_print();
+    for(;;);
+}
+
+void vApplicationIdleHook(void) {}
+
+// Runs the FromISR variants requested by run_isr() in interrupt context
+void vApplicationTickHook(void) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t command = Atomic_Swap_u32(&ulIsrCommand, ISR_NONE);
+    Item_t *pxItem;
+
+    switch (command) {
+    case ISR_CLAIM_COMMIT:
+        xIsrResult = xQueueClaimFromISR(xQueue, (void **)&pxItem);
+        if (xIsrResult == pdPASS) {
+            fill_item(pxItem, ulIsrSeq);
+            vQueueCommitFromISR(xQueue, pxItem, &xHigherPriorityTaskWoken);
+        }
+        break;
+    case ISR_BORROW_RELEASE:
+        xIsrResult = xQueueBorrowFromISR(xQueue, (void **)&pxItem);
+        if (xIsrResult == pdPASS) {
+            if (!item_ok(pxItem, ulIsrSeq)) {
+                xIsrResult = pdFAIL;
+            }
+            vQueueReleaseFromISR(xQueue, pxItem, &xHigherPriorityTaskWoken);
+        }
+        break;
+    case ISR_CLAIM_FULL:
+        xIsrResult = xQueueClaimFromISR(xQueue, (void **)&pxItem);
+        break;
+    case ISR_BORROW_EMPTY:
+        xIsrResult = xQueueBorrowFromISR(xQueue, (void **)&pxItem);
+        break;
+    default:
+        return;
+    }
+
+    // Scheduling is cooperative, so a woken task runs when its core next yields
+    (void)xHigherPriorityTaskWoken;
+    Atomic_Store_u32_Release(&ulIsrDone, 1);
+}